@@ -4,14 +4,32 @@
 
 #include <neaacdec.h>
 #include "audio_core/hle/aac_decoder.h"
+#include "common/assert.h"
 
 namespace AudioCore::HLE {
 
+namespace {
+
+BinaryMessage MakeDecodeResponse(const BinaryMessage& request) {
+    BinaryMessage response{};
+    response.header.codec = request.header.codec;
+    response.header.cmd = request.header.cmd;
+    response.decode_aac_response.size = request.decode_aac_request.size;
+    // This is a hack to continue games when a failure occurs.
+    response.decode_aac_response.sample_rate = DecoderSampleRate::Rate48000;
+    response.decode_aac_response.num_channels = 2;
+    response.decode_aac_response.num_samples = 1024;
+    return response;
+}
+
+} // Anonymous namespace
+
 AACDecoder::AACDecoder(Memory::MemorySystem& memory) : memory(memory) {
     OpenNewDecoder();
 }
 
 AACDecoder::~AACDecoder() {
+    worker.WaitForRequests();
     if (decoder) {
         NeAACDecClose(decoder);
         decoder = nullptr;
@@ -63,21 +81,72 @@ BinaryMessage AACDecoder::ProcessRequest(const BinaryMessage& request) {
     }
 }
 
-BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
-    BinaryMessage response{};
-    response.header.codec = request.header.codec;
-    response.header.cmd = request.header.cmd;
-    response.decode_aac_response.size = request.decode_aac_request.size;
-    // This is a hack to continue games when a failure occurs.
-    response.decode_aac_response.sample_rate = DecoderSampleRate::Rate48000;
-    response.decode_aac_response.num_channels = 2;
-    response.decode_aac_response.num_samples = 1024;
+void AACDecoder::QueueRequest(const BinaryMessage& request) {
+    QueuedRequest& queued = queued_requests.emplace_back();
+    queued.request = request;
 
-    if (decoder == nullptr) {
-        LOG_ERROR(Audio_DSP, "Failed to handle decode request: FAAD2 AAC decoder not open.");
-        return response;
+    if (request.header.codec == DecoderCodec::DecodeAAC &&
+        request.header.cmd == DecoderCommand::EncodeDecode) {
+        const u32 src_addr = request.decode_aac_request.src_addr;
+        const u32 size = request.decode_aac_request.size;
+        if (src_addr >= Memory::FCRAM_PADDR &&
+            src_addr + size <= Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+            const u8* data = memory.GetFCRAMPointer(src_addr - Memory::FCRAM_PADDR);
+            queued.input.assign(data, data + size);
+        }
+    }
+
+    worker.QueueWork([this, &queued] { RunRequest(queued); });
+}
+
+BinaryMessage AACDecoder::PopResponse() {
+    ASSERT(!queued_requests.empty());
+    QueuedRequest& queued = queued_requests.front();
+    {
+        std::unique_lock lock{done_mutex};
+        done_cv.wait(lock, [&queued] { return queued.done; });
     }
 
+    // Guest memory is only written here, on the emulation thread, at a fixed emulated time.
+    if (queued.decoded) {
+        WriteOutput(queued.request, queued.response, queued.output);
+    }
+    const BinaryMessage response = queued.response;
+    queued_requests.pop_front();
+    return response;
+}
+
+void AACDecoder::Reset() {
+    worker.WaitForRequests();
+    queued_requests.clear();
+    OpenNewDecoder();
+}
+
+void AACDecoder::RunRequest(QueuedRequest& queued) {
+    const BinaryMessage& request = queued.request;
+    if (request.header.codec != DecoderCodec::DecodeAAC ||
+        request.header.cmd != DecoderCommand::EncodeDecode) {
+        queued.response = ProcessRequest(request);
+    } else if (queued.input.size() != request.decode_aac_request.size) {
+        LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}",
+                  request.decode_aac_request.src_addr);
+        queued.response = MakeDecodeResponse(request);
+    } else {
+        queued.response = MakeDecodeResponse(request);
+        queued.decoded = DecodeFrames(queued.input.data(), static_cast<u32>(queued.input.size()),
+                                      queued.response, queued.output);
+    }
+
+    {
+        std::scoped_lock lock{done_mutex};
+        queued.done = true;
+    }
+    done_cv.notify_all();
+}
+
+BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
+    BinaryMessage response = MakeDecodeResponse(request);
+
     if (request.decode_aac_request.src_addr < Memory::FCRAM_PADDR ||
         request.decode_aac_request.src_addr + request.decode_aac_request.size >
             Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
@@ -85,35 +154,50 @@ BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
                   request.decode_aac_request.src_addr);
         return response;
     }
-    u8* data = memory.GetFCRAMPointer(request.decode_aac_request.src_addr - Memory::FCRAM_PADDR);
-    u32 data_len = request.decode_aac_request.size;
+    const u8* data =
+        memory.GetFCRAMPointer(request.decode_aac_request.src_addr - Memory::FCRAM_PADDR);
+
+    std::array<std::vector<s16>, 2> out_streams;
+    if (DecodeFrames(data, request.decode_aac_request.size, response, out_streams)) {
+        WriteOutput(request, response, out_streams);
+    }
+    return response;
+}
+
+bool AACDecoder::DecodeFrames(const u8* data, u32 data_len, BinaryMessage& response,
+                              std::array<std::vector<s16>, 2>& out_streams) {
+    if (decoder == nullptr) {
+        LOG_ERROR(Audio_DSP, "Failed to handle decode request: FAAD2 AAC decoder not open.");
+        return false;
+    }
+
+    // FAAD2 does not modify the input buffer, it is only missing const in its interface.
+    u8* input = const_cast<u8*>(data);
 
     if (!decoder_initialized) {
         unsigned long sample_rate;
         u8 num_channels;
-        auto init_result = NeAACDecInit(decoder, data, data_len, &sample_rate, &num_channels);
+        auto init_result = NeAACDecInit(decoder, input, data_len, &sample_rate, &num_channels);
         if (init_result < 0) {
             LOG_ERROR(Audio_DSP, "Could not initialize FAAD2 AAC decoder for request: {}",
                       init_result);
-            return response;
+            return false;
         }
 
         decoder_initialized = true;
 
         // Advance past the frame header if needed.
-        data += init_result;
+        input += init_result;
         data_len -= init_result;
     }
 
-    std::array<std::vector<s16>, 2> out_streams;
-
     while (data_len > 0) {
         NeAACDecFrameInfo frame_info;
         auto curr_sample_buffer =
-            static_cast<s16*>(NeAACDecDecode(decoder, &frame_info, data, data_len));
+            static_cast<s16*>(NeAACDecDecode(decoder, &frame_info, input, data_len));
         if (curr_sample_buffer == nullptr || frame_info.error != 0) {
             LOG_ERROR(Audio_DSP, "Failed to decode AAC buffer using FAAD2: {}", frame_info.error);
-            return response;
+            return false;
         }
 
         // Set the output frame info.
@@ -122,16 +206,24 @@ BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
 
         // Split the decode result into channels.
         u32 num_samples = frame_info.samples / frame_info.channels;
+        for (u32 ch = 0; ch < frame_info.channels; ch++) {
+            out_streams[ch].reserve(out_streams[ch].size() + num_samples);
+        }
         for (u32 sample = 0; sample < num_samples; sample++) {
             for (u32 ch = 0; ch < frame_info.channels; ch++) {
                 out_streams[ch].push_back(curr_sample_buffer[(sample * frame_info.channels) + ch]);
             }
         }
 
-        data += frame_info.bytesconsumed;
+        input += frame_info.bytesconsumed;
         data_len -= frame_info.bytesconsumed;
     }
 
+    return true;
+}
+
+void AACDecoder::WriteOutput(const BinaryMessage& request, BinaryMessage& response,
+                             const std::array<std::vector<s16>, 2>& out_streams) {
     // Transfer the decoded buffer from vector to the FCRAM.
     for (std::size_t ch = 0; ch < out_streams.size(); ch++) {
         if (out_streams[ch].empty()) {
@@ -143,7 +235,7 @@ BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
         if (dst < Memory::FCRAM_PADDR ||
             dst + byte_size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
             LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch{} {:08x}", ch, dst);
-            return response;
+            return;
         }
         std::memcpy(memory.GetFCRAMPointer(dst - Memory::FCRAM_PADDR), out_streams[ch].data(),
                     byte_size);
@@ -151,8 +243,6 @@ BinaryMessage AACDecoder::Decode(const BinaryMessage& request) {
 
     // Set the output frame info.
     response.decode_aac_response.num_samples = static_cast<u32_le>(out_streams[0].size());
-
-    return response;
 }
 
 bool AACDecoder::OpenNewDecoder() {
@@ -4,7 +4,16 @@
 
 #pragma once
 
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <boost/serialization/binary_object.hpp>
+#include <boost/serialization/deque.hpp>
+#include <boost/serialization/vector.hpp>
 #include "audio_core/hle/decoder.h"
+#include "common/thread_worker.h"
 
 namespace AudioCore::HLE {
 
@@ -16,13 +25,77 @@ public:
     ~AACDecoder() override;
     BinaryMessage ProcessRequest(const BinaryMessage& request) override;
 
+    /**
+     * Queues a request to be processed on the decode thread. The input of decode requests is
+     * copied from guest memory right away, so later guest writes cannot affect the result.
+     */
+    void QueueRequest(const BinaryMessage& request);
+
+    /// Returns whether there are queued requests that have not been collected yet.
+    [[nodiscard]] bool HasQueuedRequests() const {
+        return !queued_requests.empty();
+    }
+
+    /**
+     * Waits for the oldest queued request, writes its decoded output to guest memory and returns
+     * its response. Later requests keep being decoded in the background meanwhile.
+     */
+    BinaryMessage PopResponse();
+
+    /// Drops the queued requests and restarts FAAD2, as if the decoder had just been created.
+    void Reset();
+
 private:
+    struct QueuedRequest {
+        BinaryMessage request{};
+        std::vector<u8> input;
+
+        // Written by the decode thread
+        BinaryMessage response{};
+        std::array<std::vector<s16>, 2> output;
+        bool decoded = false;
+        bool done = false; ///< Guarded by done_mutex
+
+        template <class Archive>
+        void serialize(Archive& ar, const unsigned int) {
+            ar& boost::serialization::make_binary_object(&request, sizeof(request));
+            ar & input;
+        }
+        friend class boost::serialization::access;
+    };
+
+    void RunRequest(QueuedRequest& queued);
     BinaryMessage Decode(const BinaryMessage& request);
+    bool DecodeFrames(const u8* data, u32 data_len, BinaryMessage& response,
+                      std::array<std::vector<s16>, 2>& out_streams);
+    void WriteOutput(const BinaryMessage& request, BinaryMessage& response,
+                     const std::array<std::vector<s16>, 2>& out_streams);
     bool OpenNewDecoder();
 
     Memory::MemorySystem& memory;
     NeAACDecHandle decoder = nullptr;
     bool decoder_initialized = false;
+
+    std::deque<QueuedRequest> queued_requests;
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    Common::ThreadWorker worker{1, "AACDecoder"};
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        // Only the requests are saved, they are decoded again after loading.
+        worker.WaitForRequests();
+        ar & queued_requests;
+        if (Archive::is_loading::value) {
+            // The FAAD2 state is not saved, start over from a new decoder like the guest would
+            // after an Init request.
+            OpenNewDecoder();
+            for (auto& queued : queued_requests) {
+                worker.QueueWork([this, &queued] { RunRequest(queued); });
+            }
+        }
+    }
+    friend class boost::serialization::access;
 };
 
 } // namespace AudioCore::HLE
@@ -47,6 +47,10 @@ SERIALIZE_IMPL(DspHle)
 // This value has been verified against a rough hardware test with hardware and LLE
 static constexpr u64 audio_frame_ticks = samples_per_frame * 4096 * 2ull; ///< Units: ARM11 cycles
 
+// Fixed delay between a binary pipe request and its response when decoding asynchronously. Keeping
+// it constant in emulated time makes the response arrive at the same point on every run.
+static constexpr u64 binary_response_ticks = audio_frame_ticks / 4; ///< Units: ARM11 cycles
+
 struct DspHle::Impl final {
 public:
     explicit Impl(DspHle& parent, Memory::MemorySystem& memory, Core::Timing& timing);
@@ -77,6 +81,8 @@ private:
     StereoFrame16 GenerateCurrentFrame();
     bool Tick();
     void AudioTickCallback(s64 cycles_late);
+    void BinaryResponseCallback();
+    void WriteBinaryResponse(const HLE::BinaryMessage& response);
 
     DspState dsp_state = DspState::Off;
     std::array<std::vector<u8>, num_dsp_pipe> pipe_data{};
@@ -94,18 +100,25 @@ private:
     DspHle& parent;
     Core::Timing& core_timing;
     Core::TimingEventType* tick_event{};
+    Core::TimingEventType* binary_response_event{};
 
-    std::unique_ptr<HLE::DecoderBase> aac_decoder{};
+    std::unique_ptr<HLE::AACDecoder> aac_decoder{};
 
     std::function<void(Service::DSP::InterruptType type, DspPipe pipe)> interrupt_handler{};
 
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int) {
+    void serialize(Archive& ar, const unsigned int file_version) {
         ar & dsp_state;
         ar & pipe_data;
         ar & dsp_memory.raw_memory;
         ar & sources;
         ar & mixers;
+        if (file_version >= 1) {
+            ar&* aac_decoder;
+        } else if (Archive::is_loading::value) {
+            // Older states have no pending requests, and nothing is scheduled to answer any.
+            aac_decoder->Reset();
+        }
         // interrupt_handler is reregistered when loading state from DSP_DSP
     }
     friend class boost::serialization::access;
@@ -124,11 +137,15 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory, Core::Timing&
         core_timing.RegisterEvent("AudioCore::DspHle::tick_event", [this](u64, s64 cycles_late) {
             this->AudioTickCallback(cycles_late);
         });
+    binary_response_event = core_timing.RegisterEvent(
+        "AudioCore::DspHle::binary_response_event",
+        [this](u64, s64) { this->BinaryResponseCallback(); });
     core_timing.ScheduleEvent(audio_frame_ticks, tick_event);
 }
 
 DspHle::Impl::~Impl() {
     core_timing.UnscheduleEvent(tick_event, 0);
+    core_timing.UnscheduleEvent(binary_response_event, 0);
 }
 
 DspState DspHle::Impl::GetDspState() const {
@@ -256,7 +273,6 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, std::span<const u8> buffer) {
         return;
     }
     case DspPipe::Binary: {
-        // TODO(B3N30): Make this async, and signal the interrupt
         HLE::BinaryMessage request{};
         if (sizeof(request) != buffer.size()) {
             LOG_CRITICAL(Audio_DSP, "got binary pipe with wrong size {}", buffer.size());
@@ -269,11 +285,16 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, std::span<const u8> buffer) {
             UNIMPLEMENTED();
             return;
         }
-        const HLE::BinaryMessage response = aac_decoder->ProcessRequest(request);
-        pipe_data[static_cast<u32>(pipe_number)].resize(sizeof(response));
-        std::memcpy(pipe_data[static_cast<u32>(pipe_number)].data(), &response, sizeof(response));
+        if (!Settings::values.async_aac_decoding.GetValue() &&
+            !aac_decoder->HasQueuedRequests()) {
+            WriteBinaryResponse(aac_decoder->ProcessRequest(request));
+            break;
+        }
 
-        interrupt_handler(InterruptType::Pipe, DspPipe::Binary);
+        // Each request is answered a fixed time after it was made. The decode thread works
+        // through queued requests back to back in the meantime.
+        aac_decoder->QueueRequest(request);
+        core_timing.ScheduleEvent(binary_response_ticks, binary_response_event);
         break;
     }
     default:
@@ -426,6 +447,18 @@ void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
     core_timing.ScheduleEvent(adjusted_ticks, tick_event);
 }
 
+void DspHle::Impl::BinaryResponseCallback() {
+    WriteBinaryResponse(aac_decoder->PopResponse());
+}
+
+void DspHle::Impl::WriteBinaryResponse(const HLE::BinaryMessage& response) {
+    std::vector<u8>& data = pipe_data[static_cast<u32>(DspPipe::Binary)];
+    data.resize(sizeof(response));
+    std::memcpy(data.data(), &response, sizeof(response));
+
+    interrupt_handler(InterruptType::Pipe, DspPipe::Binary);
+}
+
 DspHle::DspHle(Core::System& system, Memory::MemorySystem& memory, Core::Timing& timing)
     : DspInterface(system), impl(std::make_unique<Impl>(*this, memory, timing)) {}
 DspHle::~DspHle() = default;
@@ -99,6 +99,11 @@ public:
         return static_cast<u32>(frame_pool.size());
     }
 
+    /// Returns the format of the images created by RecreateFrame.
+    [[nodiscard]] vk::Format FrameFormat() const noexcept {
+        return output_format;
+    }
+
 private:
     /// Creates the render pass for LibRetro output
     vk::RenderPass CreateRenderpass();
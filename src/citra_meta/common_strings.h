@@ -25,6 +25,9 @@ constexpr char help_string[] =
     // TODO: Move -m outside of this check when it is implemented in Qt frontend
     "-m, --multiplayer [nick:password@address:port]   Nickname, password, address and port for "
     "multiplayer (currently only usable with SDL frontend)\n"
+    "-H, --headless              Render offscreen without a display server (SDL frontend only)\n"
+    "-x, --dump-frame-hashes [path]   Write a hash of every presented frame to the given file path "
+    "(SDL frontend only)\n"
 #endif
 #ifdef ENABLE_ROOM
     "    --room                  Utilize dedicated multiplayer room functionality (equivalent to "
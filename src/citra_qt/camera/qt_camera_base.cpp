@@ -2,10 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <QImage>
 #include <QMessageBox>
-#include "citra_qt/camera/camera_util.h"
 #include "citra_qt/camera/qt_camera_base.h"
 #include "common/logging/log.h"
+#include "core/frontend/camera/image_processing.h"
 #include "core/hle/service/cam/cam.h"
 
 namespace Camera {
@@ -38,8 +39,24 @@ void QtCameraInterface::SetEffect(Service::CAM::Effect effect) {
 }
 
 std::vector<u16> QtCameraInterface::ReceiveFrame() {
-    return CameraUtil::ProcessImage(QtReceiveFrame(), width, height, output_rgb, flip_horizontal,
-                                    flip_vertical);
+    std::vector<u16> frame;
+    ReceiveFrameInto(frame);
+    return frame;
+}
+
+void QtCameraInterface::ReceiveFrameInto(std::vector<u16>& frame) {
+    frame.resize(width * height);
+    QImage image = QtReceiveFrame();
+    if (!image.isNull() && image.format() != QImage::Format_RGB888) {
+        image = image.convertToFormat(QImage::Format_RGB888);
+    }
+    const Rgb888Image source{
+        .data = {image.constBits(), static_cast<std::size_t>(image.sizeInBytes())},
+        .width = image.width(),
+        .height = image.height(),
+        .stride = static_cast<std::size_t>(image.bytesPerLine()),
+    };
+    ProcessImage(source, {width, height, output_rgb, flip_horizontal, flip_vertical}, frame);
 }
 
 std::unique_ptr<CameraInterface> QtCameraFactory::CreatePreview(const std::string& config,
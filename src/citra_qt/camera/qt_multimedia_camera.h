@@ -10,7 +10,6 @@
 #include <QImage>
 #include <QMediaCaptureSession>
 #include <QVideoSink>
-#include "citra_qt/camera/camera_util.h"
 #include "citra_qt/camera/qt_camera_base.h"
 #include "core/frontend/camera/interface.h"
 
@@ -6,7 +6,6 @@
 
 #include <vector>
 #include <QImage>
-#include "citra_qt/camera/camera_util.h"
 #include "citra_qt/camera/qt_camera_base.h"
 #include "core/frontend/camera/interface.h"
 
@@ -3428,13 +3428,15 @@ void GMainWindow::UpdateStatusBar() {
     game_fps_label->setText(tr("App: %1 FPS").arg(results.game_fps, 0, 'f', 0));
     if (UISettings::values.show_advanced_frametime_info) {
         emu_frametime_label->setText(
-            tr("Frame: %1 ms (GPU: [CMD: %2 ms, SWP: %3 ms], IPC: %4 ms, SVC: %5 ms, Rem: %6 ms)")
+            tr("Frame: %1 ms (GPU: [CMD: %2 ms, SWP: %3 ms], IPC: %4 ms, SVC: %5 ms, Rem: %6 ms, "
+               "P99: %7 ms)")
                 .arg(results.time_vblank_interval * 1000.0, 2, 'f', 2)
                 .arg(results.time_gpu * 1000.0, 2, 'f', 2)
                 .arg(results.time_swap * 1000.0, 2, 'f', 2)
                 .arg(results.time_hle_ipc * 1000.0, 2, 'f', 2)
                 .arg(results.time_hle_svc * 1000.0, 2, 'f', 2)
-                .arg(results.time_remaining * 1000.0, 2, 'f', 2));
+                .arg(results.time_remaining * 1000.0, 2, 'f', 2)
+                .arg(results.time_frame_p99 * 1000.0, 2, 'f', 2));
     } else {
         emu_frametime_label->setText(
             tr("Frame: %1 ms").arg(results.time_vblank_interval * 1000.0, 2, 'f', 2));
@@ -285,6 +285,7 @@ void QtConfig::ReadAudioValues() {
     ReadGlobalSetting(Settings::values.volume);
 
     if (global) {
+        ReadBasicSetting(Settings::values.async_aac_decoding);
         ReadBasicSetting(Settings::values.output_type);
         ReadBasicSetting(Settings::values.output_device);
         ReadBasicSetting(Settings::values.input_type);
@@ -917,6 +918,7 @@ void QtConfig::SaveAudioValues() {
     WriteGlobalSetting(Settings::values.volume);
 
     if (global) {
+        WriteBasicSetting(Settings::values.async_aac_decoding);
         WriteBasicSetting(Settings::values.output_type);
         WriteBasicSetting(Settings::values.output_device);
         WriteBasicSetting(Settings::values.input_type);
@@ -36,6 +36,7 @@
 #include "core/core.h"
 #include "core/dumping/backend.h"
 #include "core/dumping/ffmpeg_backend.h"
+#include "core/dumping/frame_hash_backend.h"
 #include "core/frontend/applets/default_applets.h"
 #include "core/frontend/framebuffer_layout.h"
 #include "core/hle/service/am/am.h"
@@ -184,6 +185,7 @@ void LaunchSdlFrontend(int argc, char** argv) {
     std::string movie_record_author;
     std::string movie_play;
     std::string dump_video;
+    std::string dump_frame_hashes;
 
     char* endarg;
 #ifdef _WIN32
@@ -199,6 +201,7 @@ void LaunchSdlFrontend(int argc, char** argv) {
 
     bool use_multiplayer = false;
     bool fullscreen = false;
+    bool headless = false;
     std::string nickname{};
     std::string password{};
     std::string address{};
@@ -206,8 +209,10 @@ void LaunchSdlFrontend(int argc, char** argv) {
 
     static struct option long_options[] = {
         {"dump-video", required_argument, 0, 'd'},
+        {"dump-frame-hashes", required_argument, 0, 'x'},
         {"fullscreen", no_argument, 0, 'f'},
         {"gdbport", required_argument, 0, 'g'},
+        {"headless", no_argument, 0, 'H'},
         {"help", no_argument, 0, 'h'},
         {"install", required_argument, 0, 'i'},
         {"movie-play", required_argument, 0, 'p'},
@@ -220,12 +225,15 @@ void LaunchSdlFrontend(int argc, char** argv) {
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "d:fg:hi:p:r:a:m:nvw", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "d:x:fg:Hhi:p:r:a:m:nvw", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'd':
                 dump_video = optarg;
                 break;
+            case 'x':
+                dump_frame_hashes = optarg;
+                break;
             case 'f':
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
@@ -241,6 +249,10 @@ void LaunchSdlFrontend(int argc, char** argv) {
                     exit(1);
                 }
                 break;
+            case 'H':
+                headless = true;
+                LOG_INFO(Frontend, "Starting in headless mode...");
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 exit(0);
@@ -347,7 +359,7 @@ void LaunchSdlFrontend(int argc, char** argv) {
     // Register frontend applets
     Frontend::RegisterDefaultApplets(system);
 
-    EmuWindow_SDL2::InitializeSDL2();
+    EmuWindow_SDL2::InitializeSDL2(headless);
 
     const auto create_emu_window = [&](bool fullscreen,
                                        bool is_secondary) -> std::unique_ptr<EmuWindow_SDL2> {
@@ -464,6 +476,19 @@ void LaunchSdlFrontend(int argc, char** argv) {
             system.RegisterVideoDumper(dumper);
         }
     }
+    if (!dump_frame_hashes.empty()) {
+        if (system.GetVideoDumper()) {
+            LOG_ERROR(Frontend, "Cannot dump frame hashes while dumping video");
+        } else {
+            auto& renderer = system.GPU().Renderer();
+            const auto layout{
+                Layout::FrameLayoutFromResolutionScale(renderer.GetResolutionScaleFactor())};
+            auto dumper = std::make_shared<VideoDumper::FrameHashBackend>(renderer);
+            if (dumper->StartDumping(dump_frame_hashes, layout)) {
+                system.RegisterVideoDumper(dumper);
+            }
+        }
+    }
 
 #ifdef __unix__
     Common::Linux::StartGamemode();
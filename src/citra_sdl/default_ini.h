@@ -253,6 +253,10 @@ enable_audio_stretching =
 # 0 (default): No, 1: Yes
 enable_realtime_audio =
 
+# Whether to decode AAC audio on a separate thread. Responses are delivered at a fixed emulated time.
+# 0: No, 1 (default): Yes
+async_aac_decoding =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
@@ -116,7 +116,13 @@ EmuWindow_SDL2::~EmuWindow_SDL2() {
     SDL_Quit();
 }
 
-void EmuWindow_SDL2::InitializeSDL2() {
+void EmuWindow_SDL2::InitializeSDL2(bool headless) {
+    if (headless) {
+        // The offscreen driver creates windows without a display server, OpenGL contexts are
+        // backed by EGL pbuffers while Vulkan renders to a headless surface.
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) < 0) {
         LOG_CRITICAL(Frontend, "Failed to initialize SDL2: {}! Exiting...", SDL_GetError());
         exit(1);
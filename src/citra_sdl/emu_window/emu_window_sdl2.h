@@ -21,7 +21,7 @@ public:
     ~EmuWindow_SDL2();
 
     /// Initializes SDL2
-    static void InitializeSDL2();
+    static void InitializeSDL2(bool headless = false);
 
     /// Presents the most recent frame from the video backend
     virtual void Present() {}
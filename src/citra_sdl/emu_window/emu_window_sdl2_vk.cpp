@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <SDL.h>
@@ -25,6 +26,27 @@ EmuWindow_SDL2_VK::EmuWindow_SDL2_VK(Core::System& system, bool fullscreen, bool
                          SDL_WINDOWPOS_UNDEFINED, // y position
                          Core::kScreenTopWidth, Core::kScreenTopHeight + Core::kScreenBottomHeight,
                          SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+
+    if (fullscreen) {
+        Fullscreen();
+        SDL_ShowCursor(false);
+    }
+
+    if (std::strcmp(SDL_GetCurrentVideoDriver(), "offscreen") == 0) {
+        window_info.type = Frontend::WindowSystemType::Headless;
+        window_info.render_surface = nullptr;
+    } else {
+        InitializeWindowInfo();
+    }
+
+    render_window_id = SDL_GetWindowID(render_window);
+
+    OnResize();
+    OnMinimalClientAreaChangeRequest(GetActiveConfig().min_client_area_size);
+    SDL_PumpEvents();
+}
+
+void EmuWindow_SDL2_VK::InitializeWindowInfo() {
     SDL_SysWMinfo wm;
     SDL_VERSION(&wm.version);
     if (SDL_GetWindowWMInfo(render_window, &wm) == SDL_FALSE) {
@@ -32,11 +54,6 @@ EmuWindow_SDL2_VK::EmuWindow_SDL2_VK(Core::System& system, bool fullscreen, bool
         std::exit(EXIT_FAILURE);
     }
 
-    if (fullscreen) {
-        Fullscreen();
-        SDL_ShowCursor(false);
-    }
-
     switch (wm.subsystem) {
 #ifdef SDL_VIDEO_DRIVER_WINDOWS
     case SDL_SYSWM_TYPE::SDL_SYSWM_WINDOWS:
@@ -75,12 +92,6 @@ EmuWindow_SDL2_VK::EmuWindow_SDL2_VK(Core::System& system, bool fullscreen, bool
         std::exit(EXIT_FAILURE);
         break;
     }
-
-    render_window_id = SDL_GetWindowID(render_window);
-
-    OnResize();
-    OnMinimalClientAreaChangeRequest(GetActiveConfig().min_client_area_size);
-    SDL_PumpEvents();
 }
 
 EmuWindow_SDL2_VK::~EmuWindow_SDL2_VK() = default;
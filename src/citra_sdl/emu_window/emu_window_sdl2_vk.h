@@ -21,4 +21,8 @@ public:
     ~EmuWindow_SDL2_VK() override;
 
     std::unique_ptr<Frontend::GraphicsContext> CreateSharedContext() const override;
+
+private:
+    /// Fills the window info with the native handles of the window system backing the window.
+    void InitializeWindowInfo();
 };
@@ -0,0 +1,278 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/cow_memory.h"
+#include "common/logging/log.h"
+
+namespace Common {
+
+#ifdef __linux__
+namespace {
+
+/// Ranges smaller than this are cleared with memset, as punching them out costs more than it saves.
+constexpr std::size_t MIN_RELEASE_SIZE = 64 * 1024;
+
+/// Number of /proc/self/pagemap entries read at once when looking for dirty pages.
+constexpr std::size_t PAGEMAP_BATCH = 4096;
+
+constexpr u64 PAGEMAP_PRESENT = 1ULL << 63;
+constexpr u64 PAGEMAP_SWAPPED = 1ULL << 62;
+constexpr u64 PAGEMAP_FILE_OR_SHARED = 1ULL << 61;
+
+int CreateMemoryFile(std::size_t size) {
+    // Invoked through syscall as older C libraries do not provide a wrapper.
+    const int fd = static_cast<int>(syscall(SYS_memfd_create, "citra_cow_memory", 0));
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool WriteAll(int fd, const u8* data, std::size_t size, std::size_t offset) {
+    while (size > 0) {
+        const ssize_t written = pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        offset += static_cast<std::size_t>(written);
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+} // Anonymous namespace
+#endif
+
+CowSnapshot::~CowSnapshot() {
+#ifdef __linux__
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+}
+
+CowMemory::CowMemory(std::size_t size, bool huge_pages_)
+    : alloc_size{size}, huge_pages{huge_pages_} {
+#ifdef __linux__
+    live_fd = CreateMemoryFile(size);
+    if (live_fd >= 0) {
+        // Reserve the address range first so it is aligned for huge pages, then place the view.
+        base_ptr = static_cast<u8*>(AllocateMemoryPages(size, huge_pages));
+        if (base_ptr && MapFile(live_fd, true)) {
+            return;
+        }
+        LOG_WARNING(Common_Memory, "Unable to map memory file, snapshots will be copies");
+        FreeMemoryPages(base_ptr, size);
+        close(live_fd);
+        live_fd = -1;
+    }
+#endif
+    fallback = VirtualBuffer<u8>(size, huge_pages);
+    base_ptr = fallback.data();
+}
+
+CowMemory::~CowMemory() {
+    if (fallback.data()) {
+        return;
+    }
+    FreeMemoryPages(base_ptr, alloc_size);
+#ifdef __linux__
+    if (live_fd >= 0) {
+        close(live_fd);
+    }
+#endif
+}
+
+void CowMemory::Clear(std::size_t offset, std::size_t size) {
+    ASSERT(offset + size <= alloc_size);
+    if (fallback.data()) {
+        fallback.Clear(offset, size);
+        return;
+    }
+#ifdef __linux__
+    if (live_fd >= 0 && size >= MIN_RELEASE_SIZE) {
+        // Punching a hole in the file frees its pages, and the view reads them back as zero.
+        const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t start = AlignUp(offset, page_size);
+        const std::size_t end = AlignDown(offset + size, page_size);
+        if (fallocate(live_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                      static_cast<off_t>(start), static_cast<off_t>(end - start)) == 0) {
+            std::memset(base_ptr + offset, 0, start - offset);
+            std::memset(base_ptr + end, 0, offset + size - end);
+            return;
+        }
+    }
+#endif
+    // The private view would read released pages back from the snapshot, so write the zeroes.
+    std::memset(base_ptr + offset, 0, size);
+}
+
+std::shared_ptr<const CowSnapshot> CowMemory::TakeSnapshot() {
+    if (fallback.data()) {
+        std::shared_ptr<CowSnapshot> snapshot{new CowSnapshot(alloc_size)};
+        snapshot->copy = VirtualBuffer<u8>(alloc_size);
+        if (!snapshot->copy.data()) {
+            return nullptr;
+        }
+        std::memcpy(snapshot->copy.data(), base_ptr, alloc_size);
+        return snapshot;
+    }
+
+#ifdef __linux__
+    if (live_fd >= 0) {
+        // Freeze the file as it is and keep running on a private view of it.
+        std::shared_ptr<CowSnapshot> snapshot{new CowSnapshot(alloc_size)};
+        snapshot->fd = live_fd;
+        live_fd = -1;
+        if (!MapFile(snapshot->fd, false)) {
+            live_fd = std::exchange(snapshot->fd, -1);
+            return nullptr;
+        }
+        base = snapshot;
+        return snapshot;
+    }
+
+    if (base.use_count() == 1) {
+        // Nobody else holds the snapshot behind the view, so bring it up to date in place.
+        if (FoldDirtyPages(base->fd) && MapFile(base->fd, false)) {
+            return base;
+        }
+        return nullptr;
+    }
+
+    // The snapshot behind the view is still in use, so the contents go to a new file.
+    std::shared_ptr<CowSnapshot> snapshot{new CowSnapshot(alloc_size)};
+    snapshot->fd = CreateMemoryFile(alloc_size);
+    if (snapshot->fd < 0 || !WriteAll(snapshot->fd, base_ptr, alloc_size, 0) ||
+        !MapFile(snapshot->fd, false)) {
+        LOG_ERROR(Common_Memory, "Failed to create memory snapshot: {}", std::strerror(errno));
+        return nullptr;
+    }
+    base = snapshot;
+    return snapshot;
+#else
+    return nullptr;
+#endif
+}
+
+bool CowMemory::RestoreSnapshot(const std::shared_ptr<const CowSnapshot>& snapshot) {
+    ASSERT(snapshot && snapshot->GetSize() == alloc_size);
+    if (snapshot->copy.data()) {
+        std::memcpy(base_ptr, snapshot->copy.data(), alloc_size);
+        return true;
+    }
+
+#ifdef __linux__
+    if (fallback.data()) {
+        return false;
+    }
+    // Mapping the snapshot again drops every page written since it was taken.
+    if (!MapFile(snapshot->fd, false)) {
+        return false;
+    }
+    if (live_fd >= 0) {
+        close(std::exchange(live_fd, -1));
+    }
+    base = std::const_pointer_cast<CowSnapshot>(snapshot);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CowMemory::MapFile([[maybe_unused]] int fd, [[maybe_unused]] bool shared) {
+#ifdef __linux__
+    const int flags = (shared ? MAP_SHARED : MAP_PRIVATE | MAP_NORESERVE) | MAP_FIXED;
+    if (mmap(base_ptr, alloc_size, PROT_READ | PROT_WRITE, flags, fd, 0) == MAP_FAILED) {
+        LOG_CRITICAL(Common_Memory, "Failed to map memory file: {}", std::strerror(errno));
+        return false;
+    }
+    if (huge_pages) {
+        madvise(base_ptr, alloc_size, MADV_HUGEPAGE);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CowMemory::FoldDirtyPages([[maybe_unused]] int fd) {
+#ifdef __linux__
+    const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const int pagemap = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (pagemap < 0) {
+        return WriteAll(fd, base_ptr, alloc_size, 0);
+    }
+
+    // Pages written through the private view were copied into anonymous memory, which is the
+    // only kind of page the view holds that is not backed by the file.
+    const std::size_t num_pages = alloc_size / page_size;
+    const std::size_t first_page = reinterpret_cast<std::uintptr_t>(base_ptr) / page_size;
+    std::array<u64, PAGEMAP_BATCH> entries;
+    std::size_t run_start = 0;
+    std::size_t run_length = 0;
+    bool success = true;
+    for (std::size_t batch = 0; batch < num_pages && success; batch += PAGEMAP_BATCH) {
+        const std::size_t count = std::min(PAGEMAP_BATCH, num_pages - batch);
+        const auto bytes = static_cast<ssize_t>(count * sizeof(u64));
+        if (pread(pagemap, entries.data(), bytes,
+                  static_cast<off_t>((first_page + batch) * sizeof(u64))) != bytes) {
+            success = WriteAll(fd, base_ptr, alloc_size, 0);
+            run_length = 0;
+            break;
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            const u64 entry = entries[i];
+            const bool dirty = (entry & (PAGEMAP_PRESENT | PAGEMAP_SWAPPED)) != 0 &&
+                               (entry & PAGEMAP_FILE_OR_SHARED) == 0;
+            if (dirty) {
+                if (run_length == 0) {
+                    run_start = batch + i;
+                }
+                run_length++;
+                continue;
+            }
+            if (run_length != 0) {
+                const std::size_t offset = run_start * page_size;
+                success = success &&
+                          WriteAll(fd, base_ptr + offset, run_length * page_size, offset);
+                run_length = 0;
+            }
+        }
+    }
+    if (success && run_length != 0) {
+        const std::size_t offset = run_start * page_size;
+        success = WriteAll(fd, base_ptr + offset, run_length * page_size, offset);
+    }
+    close(pagemap);
+    return success;
+#else
+    return false;
+#endif
+}
+
+} // namespace Common
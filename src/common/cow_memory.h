@@ -0,0 +1,91 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+#include "common/virtual_buffer.h"
+
+namespace Common {
+
+/// Immutable copy of the contents of a CowMemory region.
+class CowSnapshot {
+public:
+    ~CowSnapshot();
+
+    CowSnapshot(const CowSnapshot&) = delete;
+    CowSnapshot& operator=(const CowSnapshot&) = delete;
+
+    [[nodiscard]] std::size_t GetSize() const {
+        return size;
+    }
+
+private:
+    friend class CowMemory;
+
+    explicit CowSnapshot(std::size_t size_) : size{size_} {}
+
+    std::size_t size;
+    int fd = -1;               ///< Memory file holding the contents, when supported
+    VirtualBuffer<u8> copy;    ///< Plain copy of the contents otherwise
+};
+
+/**
+ * Host memory region that can capture and restore snapshots of its contents.
+ * Where the host supports memory files (Linux), the region is a view of such a file. Taking a
+ * snapshot freezes the file and turns the view into a private copy-on-write mapping of it, so only
+ * the pages written afterwards are ever duplicated. Restoring a snapshot remaps the view, which
+ * discards those pages without copying anything. On other hosts snapshots are plain copies.
+ * The address of the region never changes, so pointers into it remain valid throughout.
+ */
+class CowMemory {
+public:
+    explicit CowMemory(std::size_t size, bool huge_pages = false);
+    ~CowMemory();
+
+    CowMemory(const CowMemory&) = delete;
+    CowMemory& operator=(const CowMemory&) = delete;
+
+    [[nodiscard]] u8* data() {
+        return base_ptr;
+    }
+
+    [[nodiscard]] const u8* data() const {
+        return base_ptr;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return alloc_size;
+    }
+
+    /// Zeroes a range of the region, returning the host pages it covers when possible.
+    void Clear(std::size_t offset, std::size_t size);
+
+    /**
+     * Captures the current contents of the region.
+     * The previous snapshot should be released beforehand, as the dirty pages can then be folded
+     * into its file instead of copying the whole region into a new one.
+     * @returns The snapshot or nullptr on failure
+     */
+    [[nodiscard]] std::shared_ptr<const CowSnapshot> TakeSnapshot();
+
+    /// Replaces the contents of the region with those of a snapshot taken from a region of the
+    /// same size.
+    bool RestoreSnapshot(const std::shared_ptr<const CowSnapshot>& snapshot);
+
+private:
+    bool MapFile(int fd, bool shared);
+    bool FoldDirtyPages(int fd);
+
+    std::size_t alloc_size{};
+    u8* base_ptr{};
+    bool huge_pages{};
+    int live_fd = -1;                   ///< File behind the shared view, -1 while it is private
+    std::shared_ptr<CowSnapshot> base;  ///< Snapshot behind the private view
+    VirtualBuffer<u8> fallback;         ///< Backing of the region without memory file support
+};
+
+} // namespace Common
@@ -475,6 +475,25 @@ u64 GetSize(FILE* f) {
     return size;
 }
 
+u64 GetModificationTime(const std::string& filename) {
+#ifdef _WIN32
+    struct _stat64 buf;
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0) {
+        return static_cast<u64>(buf.st_mtime);
+    }
+#elif defined(ANDROID) && !defined(HAVE_LIBRETRO_VFS)
+    // Not exposed through the storage access framework
+    return 0;
+#else
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) == 0) {
+        return static_cast<u64>(buf.st_mtime);
+    }
+#endif
+    LOG_TRACE(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+}
+
 bool CreateEmptyFile(const std::string& filename) {
     LOG_TRACE(Common_Filesystem, "{}", filename);
 
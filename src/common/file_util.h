@@ -131,6 +131,9 @@ private:
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(CORE_FILE* f);
 
+// Returns the last modification time of filename in seconds, or 0 if it is not available
+[[nodiscard]] u64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
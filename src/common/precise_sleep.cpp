@@ -0,0 +1,123 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <thread>
+#include "common/arch.h"
+#include "common/precise_sleep.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#elif CITRA_ARCH(x86_64)
+#include <immintrin.h>
+#endif
+
+namespace Common {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// The spin time is kept within these bounds whatever the measured slack is
+constexpr PreciseSleeper::Clock::duration MIN_SPIN_TIME = 50us;
+constexpr PreciseSleeper::Clock::duration MAX_SPIN_TIME = 2ms;
+/// Spin time added on top of the measured slack
+constexpr PreciseSleeper::Clock::duration SPIN_MARGIN = 50us;
+
+void CpuRelax() {
+#if CITRA_ARCH(x86_64)
+    _mm_pause();
+#elif CITRA_ARCH(arm64)
+#ifdef _MSC_VER
+    __yield();
+#else
+    asm volatile("yield");
+#endif
+#endif
+}
+
+} // Anonymous namespace
+
+PreciseSleeper::PreciseSleeper() : spin_time{500us} {
+#ifdef _WIN32
+    timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                   TIMER_ALL_ACCESS);
+    if (!timer) {
+        // High resolution timers are only available since Windows 10 1803
+        timer = CreateWaitableTimerW(nullptr, TRUE, nullptr);
+    }
+#endif
+}
+
+PreciseSleeper::~PreciseSleeper() {
+#ifdef _WIN32
+    if (timer) {
+        CloseHandle(timer);
+    }
+#endif
+}
+
+void PreciseSleeper::SleepUntil(Clock::time_point deadline) {
+    const auto target = deadline - spin_time;
+    if (Now() < target) {
+        CoarseSleepUntil(target);
+
+        // Late wake-ups grow the spin time at once, while it only shrinks slowly, so that a single
+        // quick wake-up does not make the next deadline late.
+        const auto wanted = (Now() - target) + SPIN_MARGIN;
+        if (wanted > spin_time) {
+            spin_time = wanted;
+        } else {
+            spin_time -= (spin_time - wanted) / 16;
+        }
+        spin_time = std::clamp(spin_time, MIN_SPIN_TIME, MAX_SPIN_TIME);
+    }
+
+    while (Now() < deadline) {
+        CpuRelax();
+    }
+}
+
+PreciseSleeper::Clock::time_point PreciseSleeper::Now() const {
+    return Clock::now();
+}
+
+void PreciseSleeper::CoarseSleepUntil(Clock::time_point target) {
+#ifdef _WIN32
+    if (timer) {
+        // Negative due times are relative, in 100ns units
+        const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            target - Clock::now());
+        LARGE_INTEGER due_time;
+        due_time.QuadPart = -std::max<LONGLONG>(remaining.count() / 100, 1);
+        if (SetWaitableTimer(timer, &due_time, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(timer, INFINITE);
+            return;
+        }
+    }
+    std::this_thread::sleep_until(target);
+#elif defined(__linux__)
+    // steady_clock is CLOCK_MONOTONIC, so the deadline can be given as an absolute time, which
+    // is not affected by how long it takes to get to the wait.
+    const auto since_epoch = target.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    timespec deadline{};
+    deadline.tv_sec = static_cast<time_t>(seconds.count());
+    deadline.tv_nsec = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count());
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(target);
+#endif
+}
+
+} // namespace Common
@@ -0,0 +1,49 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+
+namespace Common {
+
+/**
+ * Waits until a deadline with sub-millisecond accuracy. Most of the wait is left to the OS, which
+ * wakes the thread late by its scheduler slack, and the remainder is spent spinning. The slack is
+ * measured on every wait, so the spin only lasts as long as the host needs.
+ */
+class PreciseSleeper {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PreciseSleeper();
+    virtual ~PreciseSleeper();
+
+    PreciseSleeper(const PreciseSleeper&) = delete;
+    PreciseSleeper& operator=(const PreciseSleeper&) = delete;
+
+    /// Blocks the calling thread until the deadline has passed.
+    void SleepUntil(Clock::time_point deadline);
+
+    /// Returns how long before the deadline the OS wait currently ends.
+    Clock::duration GetSpinTime() const {
+        return spin_time;
+    }
+
+protected:
+    /// Returns the current time. Tests override this and CoarseSleepUntil to simulate the host.
+    virtual Clock::time_point Now() const;
+
+    /// Waits on the OS until roughly the given point, possibly returning late.
+    virtual void CoarseSleepUntil(Clock::time_point target);
+
+private:
+    Clock::duration spin_time;
+
+#ifdef _WIN32
+    void* timer = nullptr;
+#endif
+};
+
+} // namespace Common
@@ -0,0 +1,416 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <boost/mpl/bool.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/version.hpp>
+#include "common/common_types.h"
+
+/**
+ * Binary archives that drive the existing `serialize` member templates without going through
+ * Boost's archive machinery. They skip the per-class preambles, object tracking and the virtual
+ * dispatch of boost::archive, which makes them suitable for large, mostly plain-data state.
+ *
+ * - Arithmetic types, enums and types marked with BOOST_IS_BITWISE_SERIALIZABLE are copied as
+ *   raw bytes. Arrays, std::array, std::vector and std::basic_string of those are copied in bulk.
+ * - Other class types are serialized through their `serialize` (or `save`/`load`) member, or a
+ *   free `serialize` overload in boost::serialization, exactly as Boost would call them.
+ * - Raw pointers, std::unique_ptr and std::shared_ptr go through a flat pointer-id table: the
+ *   first occurrence of an address stores the pointee, later ones only its id. This keeps
+ *   aliasing intact without Boost's tracking maps. Polymorphic pointees are not supported, those
+ *   still need Boost's class export.
+ *
+ * The class version passed to `serialize` is always the current one, so the data is only meant
+ * to be read back by the same build.
+ */
+
+namespace Common {
+
+namespace Detail {
+
+template <typename T>
+constexpr bool IsBitwiseSerializable =
+    std::is_trivially_copyable_v<T> &&
+    (std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+     boost::serialization::is_bitwise_serializable<T>::value);
+
+template <typename T>
+struct IsStdVector : std::false_type {};
+template <typename T, typename A>
+struct IsStdVector<std::vector<T, A>> : std::true_type {};
+
+template <typename T>
+struct IsStdString : std::false_type {};
+template <typename C, typename Tr, typename A>
+struct IsStdString<std::basic_string<C, Tr, A>> : std::true_type {};
+
+template <typename T>
+struct IsStdArray : std::false_type {};
+template <typename T, std::size_t N>
+struct IsStdArray<std::array<T, N>> : std::true_type {};
+
+template <typename T>
+struct IsStdOptional : std::false_type {};
+template <typename T>
+struct IsStdOptional<std::optional<T>> : std::true_type {};
+
+template <typename T>
+struct IsStdPair : std::false_type {};
+template <typename A, typename B>
+struct IsStdPair<std::pair<A, B>> : std::true_type {};
+
+template <typename T>
+struct IsUniquePtr : std::false_type {};
+template <typename T>
+struct IsUniquePtr<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct IsSharedPtr : std::false_type {};
+template <typename T>
+struct IsSharedPtr<std::shared_ptr<T>> : std::true_type {};
+
+/// Sequences that are restored by appending elements in order.
+template <typename T>
+struct IsSequence : std::false_type {};
+template <typename T, typename A>
+struct IsSequence<std::deque<T, A>> : std::true_type {};
+template <typename T, typename A>
+struct IsSequence<std::list<T, A>> : std::true_type {};
+
+/// Associative containers that are restored by inserting elements in order.
+template <typename T>
+struct IsAssociative : std::false_type {};
+template <typename K, typename C, typename A>
+struct IsAssociative<std::set<K, C, A>> : std::true_type {};
+template <typename K, typename C, typename A>
+struct IsAssociative<std::multiset<K, C, A>> : std::true_type {};
+template <typename K, typename V, typename C, typename A>
+struct IsAssociative<std::map<K, V, C, A>> : std::true_type {};
+template <typename K, typename V, typename C, typename A>
+struct IsAssociative<std::multimap<K, V, C, A>> : std::true_type {};
+template <typename K, typename H, typename E, typename A>
+struct IsAssociative<std::unordered_set<K, H, E, A>> : std::true_type {};
+template <typename K, typename V, typename H, typename E, typename A>
+struct IsAssociative<std::unordered_map<K, V, H, E, A>> : std::true_type {};
+
+template <typename T>
+constexpr unsigned int ClassVersion() {
+    if constexpr (std::is_class_v<T>) {
+        return boost::serialization::version<T>::value;
+    } else {
+        return 0;
+    }
+}
+
+} // namespace Detail
+
+class BinaryOArchive {
+public:
+    using is_saving = boost::mpl::true_;
+    using is_loading = boost::mpl::false_;
+
+    explicit BinaryOArchive(std::vector<u8>& buffer_) : buffer{buffer_} {}
+
+    template <typename T>
+    BinaryOArchive& operator<<(const T& t) {
+        Save(t);
+        return *this;
+    }
+
+    template <typename T>
+    BinaryOArchive& operator&(const T& t) {
+        Save(t);
+        return *this;
+    }
+
+    void save_binary(const void* data, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        const std::size_t offset = buffer.size();
+        buffer.resize(offset + size);
+        std::memcpy(buffer.data() + offset, data, size);
+    }
+
+private:
+    template <typename T>
+    void Save(const T& t) {
+        if constexpr (Detail::IsBitwiseSerializable<T>) {
+            save_binary(&t, sizeof(T));
+        } else if constexpr (std::is_array_v<T>) {
+            SaveRange(t, std::extent_v<T>);
+        } else if constexpr (Detail::IsStdArray<T>::value) {
+            SaveRange(t.data(), t.size());
+        } else if constexpr (Detail::IsStdVector<T>::value || Detail::IsStdString<T>::value) {
+            SaveSize(t.size());
+            if constexpr (std::is_same_v<T, std::vector<bool>>) {
+                for (const bool value : t) {
+                    Save(value);
+                }
+            } else {
+                SaveRange(t.data(), t.size());
+            }
+        } else if constexpr (Detail::IsSequence<T>::value || Detail::IsAssociative<T>::value) {
+            SaveSize(t.size());
+            for (const auto& element : t) {
+                Save(element);
+            }
+        } else if constexpr (Detail::IsStdPair<T>::value) {
+            Save(t.first);
+            Save(t.second);
+        } else if constexpr (Detail::IsStdOptional<T>::value) {
+            Save(t.has_value());
+            if (t) {
+                Save(*t);
+            }
+        } else if constexpr (Detail::IsUniquePtr<T>::value || Detail::IsSharedPtr<T>::value) {
+            SavePointer(t.get());
+        } else if constexpr (std::is_pointer_v<T>) {
+            SavePointer(t);
+        } else {
+            static_assert(std::is_class_v<T>, "Type cannot be serialized");
+            boost::serialization::serialize_adl(*this, const_cast<T&>(t),
+                                                Detail::ClassVersion<T>());
+        }
+    }
+
+    template <typename T>
+    void SaveRange(const T* data, std::size_t count) {
+        if constexpr (Detail::IsBitwiseSerializable<T>) {
+            save_binary(data, count * sizeof(T));
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                Save(data[i]);
+            }
+        }
+    }
+
+    void SaveSize(std::size_t size) {
+        Save(static_cast<u64>(size));
+    }
+
+    template <typename T>
+    void SavePointer(const T* pointer) {
+        static_assert(!std::is_polymorphic_v<T>,
+                      "Polymorphic pointees must be serialized with a Boost archive");
+        if (!pointer) {
+            Save(u32{0});
+            return;
+        }
+        const auto [it, is_new] =
+            pointer_ids.try_emplace(pointer, static_cast<u32>(pointer_ids.size() + 1));
+        Save(it->second);
+        if (is_new) {
+            Save(*pointer);
+        }
+    }
+
+    std::vector<u8>& buffer;
+    std::unordered_map<const void*, u32> pointer_ids;
+};
+
+class BinaryIArchive {
+public:
+    using is_saving = boost::mpl::false_;
+    using is_loading = boost::mpl::true_;
+
+    explicit BinaryIArchive(std::span<const u8> data_) : data{data_} {}
+
+    /// Accepts rvalues as well, for wrappers like make_binary_object and make_nvp.
+    template <typename T>
+    BinaryIArchive& operator>>(T&& t) {
+        Load(const_cast<std::remove_cvref_t<T>&>(t));
+        return *this;
+    }
+
+    template <typename T>
+    BinaryIArchive& operator&(T&& t) {
+        Load(const_cast<std::remove_cvref_t<T>&>(t));
+        return *this;
+    }
+
+    void load_binary(void* dest, std::size_t size) {
+        if (size > data.size() - offset) {
+            throw std::out_of_range("Binary archive read past the end of the data");
+        }
+        if (size == 0) {
+            return;
+        }
+        std::memcpy(dest, data.data() + offset, size);
+        offset += size;
+    }
+
+    /// Returns true once every byte of the data has been consumed.
+    bool AtEnd() const {
+        return offset == data.size();
+    }
+
+private:
+    template <typename T>
+    void Load(T& t) {
+        if constexpr (Detail::IsBitwiseSerializable<T>) {
+            load_binary(&t, sizeof(T));
+        } else if constexpr (std::is_array_v<T>) {
+            LoadRange(t, std::extent_v<T>);
+        } else if constexpr (Detail::IsStdArray<T>::value) {
+            LoadRange(t.data(), t.size());
+        } else if constexpr (Detail::IsStdVector<T>::value || Detail::IsStdString<T>::value) {
+            t.resize(LoadSize<typename T::value_type>());
+            if constexpr (std::is_same_v<T, std::vector<bool>>) {
+                for (auto&& value : t) {
+                    bool element;
+                    Load(element);
+                    value = element;
+                }
+            } else {
+                LoadRange(t.data(), t.size());
+            }
+        } else if constexpr (Detail::IsSequence<T>::value) {
+            t.clear();
+            const std::size_t size = LoadSize<typename T::value_type>();
+            for (std::size_t i = 0; i < size; i++) {
+                Load(t.emplace_back());
+            }
+        } else if constexpr (Detail::IsAssociative<T>::value) {
+            t.clear();
+            const std::size_t size = LoadSize<typename T::value_type>();
+            for (std::size_t i = 0; i < size; i++) {
+                typename T::value_type element{};
+                Load(element);
+                t.insert(t.end(), std::move(element));
+            }
+        } else if constexpr (Detail::IsStdPair<T>::value) {
+            Load(const_cast<std::remove_const_t<typename T::first_type>&>(t.first));
+            Load(t.second);
+        } else if constexpr (Detail::IsStdOptional<T>::value) {
+            bool has_value;
+            Load(has_value);
+            if (has_value) {
+                Load(t.emplace());
+            } else {
+                t.reset();
+            }
+        } else if constexpr (Detail::IsUniquePtr<T>::value) {
+            const auto loaded = LoadPointer<typename T::element_type>();
+            if (loaded.pointer) {
+                auto& entry = pointers[loaded.id - 1];
+                if (entry.owned) {
+                    throw std::runtime_error("Binary archive contains a shared unique_ptr");
+                }
+                entry.owned = true;
+            }
+            t.reset(loaded.pointer);
+        } else if constexpr (Detail::IsSharedPtr<T>::value) {
+            using Pointee = typename T::element_type;
+            const auto loaded = LoadPointer<Pointee>();
+            if (!loaded.pointer) {
+                t.reset();
+                return;
+            }
+            // The first shared_ptr takes ownership, even if raw pointers were loaded before it.
+            auto& entry = pointers[loaded.id - 1];
+            if (!entry.shared_owner) {
+                if (entry.owned) {
+                    throw std::runtime_error("Binary archive shares a unique_ptr");
+                }
+                entry.shared_owner = std::shared_ptr<Pointee>(loaded.pointer);
+                entry.owned = true;
+            }
+            t = std::static_pointer_cast<Pointee>(entry.shared_owner);
+        } else if constexpr (std::is_pointer_v<T>) {
+            t = LoadPointer<std::remove_pointer_t<T>>().pointer;
+        } else {
+            static_assert(std::is_class_v<T>, "Type cannot be deserialized");
+            boost::serialization::serialize_adl(*this, t, Detail::ClassVersion<T>());
+        }
+    }
+
+    template <typename T>
+    void LoadRange(T* dest, std::size_t count) {
+        if constexpr (Detail::IsBitwiseSerializable<T>) {
+            load_binary(dest, count * sizeof(T));
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                Load(dest[i]);
+            }
+        }
+    }
+
+    /// Reads a container size, rejecting sizes the remaining data can't possibly hold so that a
+    /// corrupted archive doesn't trigger a huge allocation.
+    template <typename T>
+    std::size_t LoadSize() {
+        u64 size;
+        Load(size);
+        if constexpr (Detail::IsBitwiseSerializable<T>) {
+            if (size > (data.size() - offset) / sizeof(T)) {
+                throw std::out_of_range("Binary archive container size exceeds the data");
+            }
+        } else if (size > data.size() - offset) {
+            throw std::out_of_range("Binary archive container size exceeds the data");
+        }
+        return static_cast<std::size_t>(size);
+    }
+
+    template <typename T>
+    struct LoadedPointer {
+        T* pointer;
+        u32 id;
+    };
+
+    /// Resolves a pointer id, loading the pointee when it is seen for the first time.
+    template <typename T>
+    LoadedPointer<T> LoadPointer() {
+        static_assert(!std::is_polymorphic_v<T>,
+                      "Polymorphic pointees must be serialized with a Boost archive");
+        u32 id;
+        Load(id);
+        if (id == 0) {
+            return {nullptr, 0};
+        }
+        if (id <= pointers.size()) {
+            return {static_cast<T*>(pointers[id - 1].pointer), id};
+        }
+        if (id != pointers.size() + 1) {
+            throw std::runtime_error("Binary archive contains an invalid pointer id");
+        }
+        auto pointee = std::make_unique<T>();
+        // Register before loading the contents so that cycles resolve to this object.
+        pointers.push_back({pointee.get()});
+        Load(*pointee);
+        return {pointee.release(), id};
+    }
+
+    /// A loaded pointee. Pointees only referenced by raw pointers are never freed, as with Boost.
+    struct PointerEntry {
+        void* pointer;
+        std::shared_ptr<void> shared_owner;
+        bool owned = false; ///< Whether a unique_ptr or a shared_ptr took ownership.
+    };
+
+    std::span<const u8> data;
+    std::size_t offset = 0;
+    std::vector<PointerEntry> pointers;
+};
+
+} // namespace Common
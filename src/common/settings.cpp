@@ -132,6 +132,7 @@ void LogSettings() {
     log_setting("Audio_InputDevice", values.input_device.GetValue());
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
     log_setting("Audio_EnableRealtime", values.enable_realtime_audio.GetValue());
+    log_setting("Audio_AsyncAacDecoding", values.async_aac_decoding.GetValue());
     using namespace Service::CAM;
     log_setting("Camera_OuterRightName", values.camera_name[OuterRightCamera]);
     log_setting("Camera_OuterRightConfig", values.camera_config[OuterRightCamera]);
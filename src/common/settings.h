@@ -583,6 +583,7 @@ struct Values {
     SwitchableSetting<AudioEmulation> audio_emulation{AudioEmulation::HLE, "audio_emulation"};
     SwitchableSetting<bool> enable_audio_stretching{true, "enable_audio_stretching"};
     SwitchableSetting<bool> enable_realtime_audio{false, "enable_realtime_audio"};
+    Setting<bool> async_aac_decoding{true, "async_aac_decoding"};
     SwitchableSetting<float, true> volume{1.f, 0.f, 1.f, "volume"};
     Setting<AudioCore::SinkType> output_type{AudioCore::SinkType::Auto, "output_type"};
     Setting<std::string> output_device{"Auto", "output_device"};
@@ -186,4 +186,60 @@ private:
     SPSCQueue<T, with_stop_token> spsc_queue;
     std::mutex write_lock;
 };
+
+// a lockless thread-safe,
+// single reader, multiple writer queue without blocking waits.
+// Writers never take a lock: each one swaps itself in as the new head, then links the previous
+// head to its node. A reader may briefly see the queue as empty while a writer is between these
+// two steps, the element then becomes visible on a later Pop.
+
+template <typename T>
+class LockFreeMPSCQueue {
+public:
+    LockFreeMPSCQueue() {
+        head.store(tail, std::memory_order_relaxed);
+    }
+    ~LockFreeMPSCQueue() {
+        while (tail) {
+            Node* next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    LockFreeMPSCQueue(const LockFreeMPSCQueue&) = delete;
+    LockFreeMPSCQueue& operator=(const LockFreeMPSCQueue&) = delete;
+
+    [[nodiscard]] bool Empty() const {
+        return tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    template <typename Arg>
+    void Push(Arg&& t) {
+        Node* node = new Node{std::forward<Arg>(t)};
+        Node* prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // only called by the reader
+    bool Pop(T& t) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        t = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        T value{};
+        std::atomic<Node*> next{nullptr};
+    };
+
+    std::atomic<Node*> head;
+    Node* tail = new Node(); ///< Already consumed node, its successor is the front
+};
 } // namespace Common
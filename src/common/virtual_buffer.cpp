@@ -0,0 +1,155 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include "common/alignment.h"
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "common/logging/log.h"
+#include "common/virtual_buffer.h"
+
+namespace Common {
+
+namespace {
+
+using namespace Common::Literals;
+
+/// Size of a transparent huge page on the hosts that support them.
+[[maybe_unused]] constexpr std::size_t HUGE_PAGE_SIZE = 2_MiB;
+
+/// Ranges smaller than this are cleared with memset, as releasing them costs more than it saves.
+constexpr std::size_t MIN_RELEASE_SIZE = 64_KiB;
+
+std::size_t GetHostPageSize() {
+#ifdef _WIN32
+    static const std::size_t page_size = [] {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<std::size_t>(info.dwPageSize);
+    }();
+#else
+    static const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return page_size;
+}
+
+/// Replaces a page aligned range with fresh zero pages.
+void ReleasePages(void* base, std::size_t size) {
+#ifdef _WIN32
+    VirtualFree(base, size, MEM_DECOMMIT);
+    VirtualAlloc(base, size, MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+    // Private anonymous pages read back as zero after MADV_DONTNEED.
+    if (madvise(base, size, MADV_DONTNEED) != 0) {
+        std::memset(base, 0, size);
+    }
+#else
+    // MADV_DONTNEED does not guarantee zeroed pages here, so map over the range instead.
+    if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) ==
+        MAP_FAILED) {
+        std::memset(base, 0, size);
+    }
+#endif
+}
+
+} // Anonymous namespace
+
+void* AllocateMemoryPages(std::size_t size, [[maybe_unused]] bool huge_pages) noexcept {
+    if (size == 0) {
+        return nullptr;
+    }
+
+#ifdef _WIN32
+    // Committed pages are only backed by physical memory once touched.
+    void* base = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!base) {
+        LOG_CRITICAL(Common_Memory, "Failed to allocate {} bytes, error {}", size,
+                     GetLastError());
+    }
+    return base;
+#else
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+
+#ifdef MADV_HUGEPAGE
+    if (huge_pages && size >= HUGE_PAGE_SIZE) {
+        // Over-reserve so the region can start on a huge page boundary, then trim the excess.
+        const std::size_t reserve_size = size + HUGE_PAGE_SIZE;
+        void* reserve = mmap(nullptr, reserve_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (reserve != MAP_FAILED) {
+            const auto start = reinterpret_cast<std::uintptr_t>(reserve);
+            const auto aligned = Common::AlignUp(start, HUGE_PAGE_SIZE);
+            const std::size_t head = aligned - start;
+            const std::size_t tail = reserve_size - head - size;
+            if (head != 0) {
+                munmap(reserve, head);
+            }
+            if (tail != 0) {
+                munmap(reinterpret_cast<void*>(aligned + size), tail);
+            }
+            void* base = reinterpret_cast<void*>(aligned);
+            if (madvise(base, size, MADV_HUGEPAGE) != 0) {
+                LOG_DEBUG(Common_Memory, "Transparent huge pages are unavailable");
+            }
+            return base;
+        }
+    }
+#endif
+
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (base == MAP_FAILED) {
+        LOG_CRITICAL(Common_Memory, "Failed to allocate {} bytes: {}", size,
+                     std::strerror(errno));
+        return nullptr;
+    }
+    return base;
+#endif
+}
+
+void FreeMemoryPages(void* base, [[maybe_unused]] std::size_t size) noexcept {
+    if (!base) {
+        return;
+    }
+
+#ifdef _WIN32
+    if (!VirtualFree(base, 0, MEM_RELEASE)) {
+        LOG_CRITICAL(Common_Memory, "Failed to free memory, error {}", GetLastError());
+    }
+#else
+    if (munmap(base, size) != 0) {
+        LOG_CRITICAL(Common_Memory, "Failed to free memory: {}", std::strerror(errno));
+    }
+#endif
+}
+
+void ClearMemoryPages(void* base, std::size_t offset, std::size_t size) noexcept {
+    u8* const begin = static_cast<u8*>(base) + offset;
+    if (size < MIN_RELEASE_SIZE) {
+        std::memset(begin, 0, size);
+        return;
+    }
+
+    const std::size_t page_size = GetHostPageSize();
+    const auto start = reinterpret_cast<std::uintptr_t>(begin);
+    const auto end = start + size;
+    const auto page_start = Common::AlignUp(start, page_size);
+    const auto page_end = Common::AlignDown(end, page_size);
+
+    std::memset(begin, 0, page_start - start);
+    ReleasePages(reinterpret_cast<void*>(page_start), page_end - page_start);
+    std::memset(reinterpret_cast<void*>(page_end), 0, end - page_end);
+}
+
+} // namespace Common
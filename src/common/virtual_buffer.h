@@ -0,0 +1,96 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace Common {
+
+/**
+ * Reserves a zero initialized region of host memory directly from the operating system.
+ * Pages are only committed when first touched, so untouched parts of the region do not count
+ * towards the resident set. When huge_pages is set the region is aligned and advised for
+ * transparent huge pages where the host supports them.
+ * @returns Pointer to the region or nullptr on failure
+ */
+void* AllocateMemoryPages(std::size_t size, bool huge_pages = false) noexcept;
+
+/// Releases a region previously returned by AllocateMemoryPages.
+void FreeMemoryPages(void* base, std::size_t size) noexcept;
+
+/**
+ * Zeroes a range of a region returned by AllocateMemoryPages. Host pages fully covered by the
+ * range are handed back to the operating system instead of being written to.
+ */
+void ClearMemoryPages(void* base, std::size_t offset, std::size_t size) noexcept;
+
+/// Fixed size buffer of trivial elements backed by lazily committed host pages.
+template <typename T>
+class VirtualBuffer final {
+    static_assert(std::is_trivially_constructible_v<T>,
+                  "T must be trivially constructible, as non-trivial constructors will not be "
+                  "executed with the current allocator");
+
+public:
+    constexpr VirtualBuffer() = default;
+
+    explicit VirtualBuffer(std::size_t count, bool huge_pages = false) : alloc_size{count} {
+        base_ptr = static_cast<T*>(AllocateMemoryPages(alloc_size * sizeof(T), huge_pages));
+        if (!base_ptr) {
+            alloc_size = 0;
+        }
+    }
+
+    ~VirtualBuffer() noexcept {
+        FreeMemoryPages(base_ptr, alloc_size * sizeof(T));
+    }
+
+    VirtualBuffer(const VirtualBuffer&) = delete;
+    VirtualBuffer& operator=(const VirtualBuffer&) = delete;
+
+    VirtualBuffer(VirtualBuffer&& other) noexcept
+        : alloc_size{std::exchange(other.alloc_size, 0)},
+          base_ptr{std::exchange(other.base_ptr, nullptr)} {}
+
+    VirtualBuffer& operator=(VirtualBuffer&& other) noexcept {
+        FreeMemoryPages(base_ptr, alloc_size * sizeof(T));
+        alloc_size = std::exchange(other.alloc_size, 0);
+        base_ptr = std::exchange(other.base_ptr, nullptr);
+        return *this;
+    }
+
+    /// Zeroes count elements starting at index, releasing the host pages that are covered.
+    void Clear(std::size_t index, std::size_t count) noexcept {
+        ClearMemoryPages(base_ptr, index * sizeof(T), count * sizeof(T));
+    }
+
+    [[nodiscard]] T& operator[](std::size_t index) {
+        return base_ptr[index];
+    }
+
+    [[nodiscard]] const T& operator[](std::size_t index) const {
+        return base_ptr[index];
+    }
+
+    [[nodiscard]] T* data() {
+        return base_ptr;
+    }
+
+    [[nodiscard]] const T* data() const {
+        return base_ptr;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return alloc_size;
+    }
+
+private:
+    std::size_t alloc_size{};
+    T* base_ptr{};
+};
+
+} // namespace Common
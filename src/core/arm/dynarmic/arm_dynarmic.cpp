@@ -26,41 +26,53 @@ public:
     ~DynarmicUserCallbacks() = default;
 
     std::uint8_t MemoryRead8(VAddr vaddr) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read8(vaddr);
     }
     std::uint16_t MemoryRead16(VAddr vaddr) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read16(vaddr);
     }
     std::uint32_t MemoryRead32(VAddr vaddr) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read32(vaddr);
     }
     std::uint64_t MemoryRead64(VAddr vaddr) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read64(vaddr);
     }
 
     void MemoryWrite8(VAddr vaddr, std::uint8_t value) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write8(vaddr, value);
     }
     void MemoryWrite16(VAddr vaddr, std::uint16_t value) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write16(vaddr, value);
     }
     void MemoryWrite32(VAddr vaddr, std::uint32_t value) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write32(vaddr, value);
     }
     void MemoryWrite64(VAddr vaddr, std::uint64_t value) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write64(vaddr, value);
     }
 
     bool MemoryWriteExclusive8(u32 vaddr, u8 value, u8 expected) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         return memory.WriteExclusive8(vaddr, value, expected);
     }
     bool MemoryWriteExclusive16(u32 vaddr, u16 value, u16 expected) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         return memory.WriteExclusive16(vaddr, value, expected);
     }
     bool MemoryWriteExclusive32(u32 vaddr, u32 value, u32 expected) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         return memory.WriteExclusive32(vaddr, value, expected);
     }
     bool MemoryWriteExclusive64(u32 vaddr, u64 value, u64 expected) override {
+        CheckMemoryBreakpoint(vaddr, GDBStub::BreakpointType::Write);
         return memory.WriteExclusive64(vaddr, value, expected);
     }
 
@@ -117,6 +129,19 @@ public:
         return Core::TicksForInstruction(is_thumb, instruction);
     }
 
+#ifdef ANDROID
+    void CheckMemoryBreakpoint(VAddr vaddr, GDBStub::BreakpointType type) {}
+#else
+    /// Watched pages are hidden from the JIT, so their accesses always end up here.
+    void CheckMemoryBreakpoint(VAddr vaddr, GDBStub::BreakpointType type) {
+        if (GDBStub::IsServerEnabled() && GDBStub::CheckBreakpoint(vaddr, type)) {
+            LOG_DEBUG(Debug, "Found memory breakpoint @ {:08x}", vaddr);
+            GDBStub::Break(true);
+            parent.jit->HaltExecution();
+        }
+    }
+#endif
+
     ARM_Dynarmic& parent;
     Kernel::SVCContext svc_context;
     Memory::MemorySystem& memory;
@@ -140,6 +165,10 @@ void ARM_Dynarmic::Run() {
     MICROPROFILE_SCOPE(ARM_Jit);
 
     jit->Run();
+
+    if (GDBStub::IsMemoryBreak()) {
+        ServeBreak();
+    }
 }
 
 void ARM_Dynarmic::Step() {
@@ -309,6 +338,8 @@ std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     }
     config.coprocessors[15] = std::make_shared<DynarmicCP15>(cp15_state);
     config.define_unpredictable_behaviour = true;
+    // Lets a watchpoint stop execution right after the access that hit it.
+    config.check_halt_on_memory_access = GDBStub::IsServerEnabled();
 
     // Multi-process state
     config.processor_id = GetID();
@@ -453,7 +453,10 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
                                   const Kernel::New3dsHwCapabilities& n3ds_hw_caps, u32 num_cores) {
     LOG_DEBUG(HW_Memory, "initialized OK");
 
-    memory = std::make_unique<Memory::MemorySystem>(*this);
+    // Savestate loads keep the memory system, as the GPU caches refer to it.
+    if (!memory) {
+        memory = std::make_unique<Memory::MemorySystem>(*this);
+    }
 
     timing = std::make_unique<Timing>(num_cores, Settings::values.cpu_clock_percentage.GetValue(),
                                       movie.GetOverrideBaseTicks());
@@ -521,10 +524,14 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
         registered_image_interface = std::make_shared<Frontend::ImageInterface>();
     }
 
-    custom_tex_manager = std::make_unique<VideoCore::CustomTexManager>(*this);
-
     auto gsp = service_manager->GetService<Service::GSP::GSP_GPU>("gsp::Gpu");
-    gpu = std::make_unique<VideoCore::GPU>(*this, emu_window, secondary_window);
+    if (gpu) {
+        // Kept alive by a savestate load, so only the new core timing has to be attached.
+        gpu->RebindTiming();
+    } else {
+        custom_tex_manager = std::make_unique<VideoCore::CustomTexManager>(*this);
+        gpu = std::make_unique<VideoCore::GPU>(*this, emu_window, secondary_window);
+    }
     gpu->SetInterruptHandler(
         [gsp](Service::GSP::InterruptId interrupt_id) { gsp->SignalInterrupt(interrupt_id); });
 
@@ -634,14 +641,18 @@ void System::Shutdown(bool is_deserializing) {
     // Shutdown emulation session
     is_powered_on = false;
 
-    gpu.reset();
-    if (!is_deserializing) {
+    if (is_deserializing) {
+        // The renderer and its caches survive a savestate load. The GSP service that receives
+        // interrupts is torn down though, so drop the handler pointing to it.
+        gpu->SetInterruptHandler({});
+    } else {
+        gpu.reset();
         lle_modules.clear();
         GDBStub::Shutdown();
         perf_stats.reset();
         app_loader.reset();
+        custom_tex_manager.reset();
     }
-    custom_tex_manager.reset();
 #ifdef ENABLE_SCRIPTING
     rpc_server.reset();
 #endif
@@ -662,7 +673,9 @@ void System::Shutdown(bool is_deserializing) {
         room_member->SendGameInfo(game_info);
     }
 
-    memory.reset();
+    if (!is_deserializing) {
+        memory.reset();
+    }
 
     if (self_delete_pending)
         FileUtil::Delete(m_filepath);
@@ -779,6 +792,10 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
     ar & lle_modules;
 
     if (Archive::is_loading::value) {
+        // Remember what the rasterizer cache was built from, so that only the parts the loaded
+        // state changed need to be thrown away.
+        gpu->PrepareStateLoad();
+
         // When loading, we want to make sure any lingering state gets cleared out before we begin.
         // Shutdown, but persist a few things between loads...
         Shutdown(true);
@@ -790,9 +807,10 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
             *m_emu_window, m_secondary_window, *memory_mode.first, *n3ds_hw_caps.first, num_cores);
     }
 
-    // Flush on save, don't flush on load
-    const bool should_flush = !Archive::is_loading::value;
-    gpu->ClearAll(should_flush);
+    // Write back GPU modified memory on save. The cache itself is kept in both directions.
+    if (Archive::is_saving::value) {
+        gpu->FlushAll();
+    }
     ar&* timing.get();
     for (u32 i = 0; i < num_cores; i++) {
         ar&* cpu_cores[i].get();
@@ -809,7 +827,11 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         throw std::runtime_error("LLE audio not supported for save states");
     }
 
+    memory->SetSerializeRam(serialize_guest_ram && !restore_guest_ram);
     ar&* memory.get();
+    if (restore_guest_ram && !memory->RestoreSnapshot(*restore_guest_ram)) {
+        throw std::runtime_error("Could not restore guest RAM snapshot");
+    }
     ar&* kernel.get();
     ar&* gpu.get();
     ar & movie;
@@ -822,6 +844,11 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         memory->SetDSP(*dsp_core);
         cheat_engine.Connect(cheats_pid);
 
+        // The loaded page tables reflect the cache at the time of saving, rebuild them from the
+        // surfaces that are still valid for the loaded memory.
+        memory->ResetRasterizerCachedPages();
+        gpu->FinishStateLoad();
+
         // Re-register gpu callback, because gsp service changed after service_manager got
         // serialized
         auto gsp = service_manager->GetService<Service::GSP::GSP_GPU>("gsp::Gpu");
@@ -28,7 +28,8 @@ class SoftwareKeyboard;
 
 namespace Memory {
 class MemorySystem;
-}
+struct MemorySnapshot;
+} // namespace Memory
 
 namespace AudioCore {
 class DspInterface;
@@ -75,6 +76,7 @@ namespace Core {
 class ARM_Interface;
 class ExclusiveMonitor;
 class Timing;
+struct StateSnapshot;
 
 class System {
 public:
@@ -360,6 +362,16 @@ public:
 
     void LoadState(u32 slot);
 
+    /**
+     * Captures the emulation state in host memory. Guest RAM is shared copy-on-write with the
+     * running emulation rather than serialized, which makes this cheap enough for run-ahead.
+     * Must be called from the emulation thread between frames, like SaveState.
+     */
+    std::unique_ptr<StateSnapshot> TakeStateSnapshot();
+
+    /// Restores a state captured by TakeStateSnapshot.
+    void RestoreStateSnapshot(const StateSnapshot& snapshot);
+
 #ifdef HAVE_LIBRETRO
     std::vector<u8> SaveStateBuffer() const;
 
@@ -457,6 +469,8 @@ private:
     std::atomic_bool is_powered_on{};
 
     SaveStateStatus save_state_status = SaveStateStatus::NONE;
+    bool serialize_guest_ram = true;
+    const Memory::MemorySnapshot* restore_guest_ram = nullptr;
     SaveStateStatus save_state_request_status = SaveStateStatus::NONE;
     u32 save_state_slot = 0;
     std::chrono::steady_clock::time_point save_state_request_time{};
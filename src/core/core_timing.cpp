@@ -83,8 +83,8 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
         // of MAX_SLICE_LENGTH * 2 cycles into the future.
         cycles_into_future = std::max(static_cast<s64>(MAX_SLICE_LENGTH * 2), cycles_into_future);
 
-        timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
-                                   user_data, event_type});
+        timer->PushInboundEvent(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
+                                      user_data, event_type});
     } else {
         s64 timeout = timer->GetTicks() + cycles_into_future;
         if (current_timer == timer) {
@@ -96,8 +96,8 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
                 Event{timeout, timer->event_fifo_id++, user_data, event_type});
             std::push_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
         } else {
-            timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
-                                       user_data, event_type});
+            timer->PushInboundEvent(Event{
+                static_cast<s64>(timer->GetTicks() + cycles_into_future), 0, user_data, event_type});
         }
     }
 }
@@ -116,8 +116,8 @@ void Timing::UnscheduleEvent(const TimingEventType* event_type, std::uintptr_t u
             timer->event_queue.erase(itr, timer->event_queue.end());
             std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
         }
+        timer->CancelInboundEvents(event_type, user_data, true);
     }
-    // TODO:remove events from ts_queue
 }
 
 void Timing::RemoveEvent(const TimingEventType* event_type) {
@@ -133,8 +133,8 @@ void Timing::RemoveEvent(const TimingEventType* event_type) {
             timer->event_queue.erase(itr, timer->event_queue.end());
             std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
         }
+        timer->CancelInboundEvents(event_type, 0, false);
     }
-    // TODO:remove events from ts_queue
 }
 
 void Timing::SetCurrentTimer(std::size_t core_id) {
@@ -191,12 +191,54 @@ void Timing::Timer::ForceExceptionCheck(s64 cycles) {
     }
 }
 
+void Timing::Timer::PushInboundEvent(const Event& event) {
+    ts_queue.Push(InboundEvent{event, ts_sequence.fetch_add(1, std::memory_order_acq_rel),
+                               std::chrono::steady_clock::now()});
+}
+
+void Timing::Timer::CancelInboundEvents(const TimingEventType* type, std::uintptr_t user_data,
+                                        bool match_user_data) {
+    const u64 sequence = ts_sequence.load(std::memory_order_acquire);
+    if (sequence == ts_drained) {
+        // Nothing is in flight
+        return;
+    }
+    ts_cancellations.push_back({type, user_data, match_user_data, sequence});
+}
+
 void Timing::Timer::MoveEvents() {
-    for (Event ev; ts_queue.Pop(ev);) {
-        ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
+    if (ts_queue.Empty()) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    for (InboundEvent inbound; ts_queue.Pop(inbound);) {
+        ts_drained++;
+
+        const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now - std::min(now, inbound.push_time));
+        inbound_stats.count++;
+        inbound_stats.total_latency += latency;
+        inbound_stats.max_latency = std::max(inbound_stats.max_latency, latency);
+
+        const Event& ev = inbound.event;
+        const bool cancelled = std::any_of(
+            ts_cancellations.begin(), ts_cancellations.end(), [&](const auto& cancellation) {
+                return inbound.sequence < cancellation.sequence && ev.type == cancellation.type &&
+                       (!cancellation.match_user_data || ev.user_data == cancellation.user_data);
+            });
+        if (cancelled) {
+            continue;
+        }
+
+        event_queue.emplace_back(std::move(inbound.event));
+        event_queue.back().fifo_order = event_fifo_id++;
         std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
     }
+
+    if (!ts_cancellations.empty() && ts_drained == ts_sequence.load(std::memory_order_acquire)) {
+        ts_cancellations.clear();
+    }
 }
 
 s64 Timing::Timer::GetMaxSliceLength() const {
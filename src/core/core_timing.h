@@ -17,6 +17,7 @@
  *   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
  */
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <limits>
@@ -183,6 +184,13 @@ public:
     // scheduled and repated.
     static constexpr int MAX_SLICE_LENGTH = BASE_CLOCK_RATE_ARM11 / 234;
 
+    /// Host side latency of the events scheduled from other threads.
+    struct InboundStats {
+        u64 count = 0; ///< Number of events moved to the event queue
+        std::chrono::nanoseconds total_latency{};
+        std::chrono::nanoseconds max_latency{};
+    };
+
     class Timer {
     public:
         Timer(s64 base_ticks = 0);
@@ -207,8 +215,36 @@ public:
 
         void MoveEvents();
 
+        /// Returns the latency between events being scheduled from other threads and being moved
+        /// to the event queue.
+        InboundStats GetInboundStats() const {
+            return inbound_stats;
+        }
+
     private:
         friend class Timing;
+
+        struct InboundEvent {
+            Event event;
+            u64 sequence;
+            std::chrono::steady_clock::time_point push_time;
+        };
+
+        /// Cancels the inbound events scheduled before it that match it.
+        struct InboundCancellation {
+            const TimingEventType* type;
+            std::uintptr_t user_data;
+            bool match_user_data;
+            u64 sequence;
+        };
+
+        /// Schedules an event from any thread.
+        void PushInboundEvent(const Event& event);
+
+        /// Cancels matching events that were scheduled from other threads but not moved yet.
+        void CancelInboundEvents(const TimingEventType* type, std::uintptr_t user_data,
+                                 bool match_user_data);
+
         // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
         // We don't use std::priority_queue because we need to be able to serialize, unserialize and
         // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
@@ -217,7 +253,15 @@ public:
         u64 event_fifo_id = 0;
         // the queue for storing the events from other threads threadsafe until they will be added
         // to the event_queue by the emu thread
-        Common::MPSCQueue<Event> ts_queue;
+        Common::LockFreeMPSCQueue<InboundEvent> ts_queue;
+        // Number of events pushed to and taken from ts_queue. Each pushed event takes the next
+        // sequence number, which tells which cancellations were requested after it.
+        std::atomic<u64> ts_sequence{0};
+        u64 ts_drained = 0;
+        // Cancellations that may still match events in ts_queue. They are dropped once every
+        // event pushed so far has been moved.
+        std::vector<InboundCancellation> ts_cancellations;
+        InboundStats inbound_stats;
         // Are we in a function that has been called from Advance()
         // If events are sheduled from a function that gets called from Advance(),
         // don't change slice_length and downcount.
@@ -0,0 +1,80 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fmt/format.h>
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/dumping/frame_hash_backend.h"
+#include "video_core/renderer_base.h"
+
+namespace VideoDumper {
+
+FrameHashBackend::FrameHashBackend(VideoCore::RendererBase& renderer_) : renderer{renderer_} {}
+
+FrameHashBackend::~FrameHashBackend() {
+    if (hashing_thread.joinable()) {
+        frame_queue.Push(VideoFrame());
+        hashing_thread.join();
+    }
+}
+
+bool FrameHashBackend::StartDumping(const std::string& path,
+                                    const Layout::FramebufferLayout& layout) {
+    file = FileUtil::IOFile(path, "w");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render, "Could not open frame hash file {}", path);
+        return false;
+    }
+
+    video_layout = layout;
+    hashing_thread = std::thread([this] { ProcessFrames(); });
+
+    renderer.PrepareVideoDumping();
+    is_dumping = true;
+
+    return true;
+}
+
+void FrameHashBackend::AddVideoFrame(VideoFrame frame) {
+    frame_queue.Push(std::move(frame));
+}
+
+void FrameHashBackend::StopDumping() {
+    is_dumping = false;
+    renderer.CleanupVideoDumping();
+
+    // An empty frame marks the end of frame data
+    frame_queue.Push(VideoFrame());
+    if (hashing_thread.joinable()) {
+        hashing_thread.join();
+    }
+    file.Close();
+}
+
+bool FrameHashBackend::IsDumping() const {
+    return is_dumping.load(std::memory_order_relaxed);
+}
+
+Layout::FramebufferLayout FrameHashBackend::GetLayout() const {
+    return video_layout;
+}
+
+void FrameHashBackend::ProcessFrames() {
+    Common::SetCurrentThreadName("FrameHashing");
+
+    u64 frame_number = 0;
+    while (true) {
+        const VideoFrame frame = frame_queue.PopWait();
+        if (frame.width == 0 && frame.height == 0) {
+            break;
+        }
+        const u64 hash = Common::ComputeHash64(frame.data.data(), frame.data.size());
+        file.WriteString(fmt::format("{} {:016x}\n", frame_number++, hash));
+    }
+    file.Flush();
+    LOG_INFO(Render, "Hashed {} frames", frame_number);
+}
+
+} // namespace VideoDumper
@@ -0,0 +1,48 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include "common/file_util.h"
+#include "common/threadsafe_queue.h"
+#include "core/dumping/backend.h"
+
+namespace VideoCore {
+class RendererBase;
+}
+
+namespace VideoDumper {
+
+/**
+ * Video dumping backend that writes a hash of every frame to a text file instead of encoding it.
+ * Useful to check renderer output for regressions in automated (headless) runs.
+ * Each line has the form "<frame number> <hash>", audio is ignored.
+ */
+class FrameHashBackend : public Backend {
+public:
+    explicit FrameHashBackend(VideoCore::RendererBase& renderer);
+    ~FrameHashBackend() override;
+    bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) override;
+    void AddVideoFrame(VideoFrame frame) override;
+    void AddAudioFrame(AudioCore::StereoFrame16 frame) override {}
+    void AddAudioSample(const std::array<s16, 2>& sample) override {}
+    void StopDumping() override;
+    bool IsDumping() const override;
+    Layout::FramebufferLayout GetLayout() const override;
+
+private:
+    void ProcessFrames();
+
+    VideoCore::RendererBase& renderer;
+    std::atomic_bool is_dumping = false; ///< Whether the backend is currently dumping
+
+    Layout::FramebufferLayout video_layout;
+    FileUtil::IOFile file;
+    Common::SPSCQueue<VideoFrame> frame_queue;
+    std::thread hashing_thread;
+};
+
+} // namespace VideoDumper
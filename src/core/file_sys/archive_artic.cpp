@@ -78,8 +78,10 @@ ResultVal<std::unique_ptr<ArchiveBackend>> ArticArchive::Open(
         return ResultUnknown;
     }
 
+    // Save data and extdata can be written through another handle, only NCCH contents are fixed.
+    const bool read_only = archive_id == Service::FS::ArchiveIdCode::NCCH;
     return std::make_unique<ArticArchive>(client, *handle_opt, report_artic_event, cache_provider,
-                                          path, clear_cache_on_close);
+                                          path, clear_cache_on_close, read_only);
 }
 
 void ArticArchive::Close() {
@@ -142,7 +144,7 @@ ResultVal<std::unique_ptr<FileBackend>> ArticArchive::OpenFile(const Path& path,
     }
 
     return std::make_unique<ArticFileBackend>(client, *handle_opt, open_reporter, archive_path,
-                                              *cache_provider, path);
+                                              *cache_provider, path, read_only);
 }
 
 Result ArticArchive::DeleteFile(const Path& path) const {
@@ -24,10 +24,10 @@ public:
     explicit ArticArchive(std::shared_ptr<Network::ArticBase::Client>& _client, s64 _archive_handle,
                           Core::PerfStats::PerfArticEventBits _report_artic_event,
                           ArticCacheProvider& _cache_provider, const Path& _archive_path,
-                          bool _clear_cache_on_close)
+                          bool _clear_cache_on_close, bool _read_only)
         : client(_client), archive_handle(_archive_handle), report_artic_event(_report_artic_event),
           cache_provider(&_cache_provider), archive_path(_archive_path),
-          clear_cache_on_close(_clear_cache_on_close) {
+          clear_cache_on_close(_clear_cache_on_close), read_only(_read_only) {
         open_reporter = std::make_shared<OpenFileReporter>(_client, _report_artic_event);
     }
     ~ArticArchive() override;
@@ -163,6 +163,7 @@ private:
     ArticCacheProvider* cache_provider = nullptr;
     Path archive_path;
     bool clear_cache_on_close;
+    bool read_only = false;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -178,9 +179,10 @@ public:
                               s32 _file_handle,
                               const std::shared_ptr<ArticArchive::OpenFileReporter>& _open_reporter,
                               const Path& _archive_path, ArticCacheProvider& _cache_provider,
-                              const Path& _file_path)
+                              const Path& _file_path, bool _read_only)
         : client(_client), file_handle(_file_handle), open_reporter(_open_reporter),
-          archive_path(_archive_path), cache_provider(&_cache_provider), file_path(_file_path) {}
+          archive_path(_archive_path), cache_provider(&_cache_provider), file_path(_file_path),
+          read_only(_read_only) {}
     ~ArticFileBackend() override;
 
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
@@ -200,6 +202,10 @@ public:
         return true;
     }
 
+    bool IsReadOnly() const override {
+        return read_only;
+    }
+
     bool CacheReady(std::size_t file_offset, std::size_t length) override {
         auto cache = cache_provider->ProvideCache(
             client, cache_provider->PathsToVector(archive_path, file_path), true);
@@ -219,6 +225,7 @@ private:
     Path archive_path;
     ArticCacheProvider* cache_provider = nullptr;
     Path file_path;
+    bool read_only = false;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
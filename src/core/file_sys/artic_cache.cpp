@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include "artic_cache.h"
 
 namespace FileSys {
@@ -113,6 +115,9 @@ void ArticCache::Clear() {
     big_cache.clear();
     very_big_cache.clear();
     data_size = std::nullopt;
+
+    std::scoped_lock prefetch_guard(prefetch_mutex);
+    prefetch.clear();
 }
 
 ResultVal<size_t> ArticCache::Write(s32 file_handle, std::size_t offset, std::size_t length,
@@ -182,37 +187,198 @@ ResultVal<size_t> ArticCache::GetSize(s32 file_handle) {
 
 ResultVal<size_t> ArticCache::ReadFromArtic(s32 file_handle, u8* buffer, size_t len,
                                             size_t offset) {
-    size_t read_amount = 0;
-    while (read_amount != len) {
-        size_t to_read =
-            std::min<size_t>(client->GetServerRequestMaxSize() - 0x100, len - read_amount);
+    if (!disk_cache) {
+        return FetchFromArtic(file_handle, buffer, len, offset);
+    }
 
-        auto req = client->NewRequest("FSFILE_Read");
-        req.AddParameterS32(file_handle);
-        req.AddParameterS64(static_cast<s64>(offset + read_amount));
-        req.AddParameterS32(static_cast<s32>(to_read));
-        auto resp = client->Send(req);
-        if (!resp.has_value() || !resp->Succeeded())
-            return Result(-1);
+    size_t stored_len = len;
+    if (data_size.has_value()) {
+        stored_len = offset < *data_size ? std::min(len, *data_size - offset) : 0;
+    }
+    if (stored_len != 0 && disk_cache->Read(offset, stored_len, buffer)) {
+        LOG_TRACE(Service_FS, "ArticCache DHIT: offset={}, length={}", offset, stored_len);
+        return stored_len;
+    }
 
-        auto res = Result(static_cast<u32>(resp->GetMethodResult()));
-        if (res.IsError())
-            return res;
+    // Fetch whole blocks, so that everything read from the server can be stored.
+    const auto [aligned_offset, aligned_len] = disk_cache->AlignRange(offset, len);
+    if (aligned_offset == offset && aligned_len == len) {
+        auto res = FetchFromArtic(file_handle, buffer, len, offset);
+        if (res.Succeeded()) {
+            disk_cache->Write(offset, res.Unwrap(), buffer);
+        }
+        return res;
+    }
+
+    std::vector<u8> aligned_buffer(aligned_len);
+    auto res = FetchFromArtic(file_handle, aligned_buffer.data(), aligned_len, aligned_offset);
+    if (res.Failed())
+        return res;
+    const size_t read_amount = res.Unwrap();
+    disk_cache->Write(aligned_offset, read_amount, aligned_buffer.data());
+
+    const size_t into = offset - aligned_offset;
+    const size_t copy_amount = read_amount > into ? std::min(len, read_amount - into) : 0;
+    std::memcpy(buffer, aligned_buffer.data() + into, copy_amount);
+    return copy_amount;
+}
+
+ResultVal<size_t> ArticCache::FetchFromArtic(s32 file_handle, u8* buffer, size_t len,
+                                             size_t offset) {
+    bool sequential = false;
+    if (ReadPrefetched(buffer, len, offset, sequential)) {
+        LOG_TRACE(Service_FS, "ArticCache PHIT: offset={}, length={}", offset, len);
+        StartPrefetch(file_handle, len, offset);
+        return len;
+    }
 
-        auto read_buff = resp->GetResponseBuffer(0);
-        size_t actually_read = 0;
-        if (read_buff.has_value()) {
-            actually_read = read_buff->second;
-            memcpy(buffer + read_amount, read_buff->first, actually_read);
+    // Keep several requests in flight, so that the latency is only paid once.
+    const size_t chunk_size = client->GetServerRequestMaxSize() - 0x100;
+    std::deque<std::pair<std::shared_ptr<PendingResponse>, size_t>> in_flight;
+    size_t sent_amount = 0;
+    size_t read_amount = 0;
+    while (read_amount != len) {
+        while (sent_amount != len && in_flight.size() < max_requests_in_flight) {
+            const size_t to_read = std::min<size_t>(chunk_size, len - sent_amount);
+            auto pending = SendReadRequest(file_handle, to_read, offset + sent_amount);
+            if (!pending)
+                return Result(-1);
+            in_flight.emplace_back(std::move(pending), to_read);
+            sent_amount += to_read;
         }
 
+        const auto [pending, to_read] = std::move(in_flight.front());
+        in_flight.pop_front();
+        auto res = ReceiveReadResponse(*pending, buffer + read_amount, to_read);
+        if (res.Failed())
+            return res;
+
+        const size_t actually_read = res.Unwrap();
         read_amount += actually_read;
         if (actually_read != to_read)
             break;
     }
+
+    if (sequential && read_amount == len) {
+        StartPrefetch(file_handle, len, offset);
+    }
     return read_amount;
 }
 
+std::shared_ptr<ArticCache::PendingResponse> ArticCache::SendReadRequest(s32 file_handle,
+                                                                        size_t len,
+                                                                        size_t offset) {
+    auto req = client->NewRequest("FSFILE_Read");
+    req.AddParameterS32(file_handle);
+    req.AddParameterS64(static_cast<s64>(offset));
+    req.AddParameterS32(static_cast<s32>(len));
+    return client->SendAsync(req);
+}
+
+ResultVal<size_t> ArticCache::ReceiveReadResponse(PendingResponse& pending, u8* buffer,
+                                                  size_t len) {
+    auto resp = pending.Wait();
+    if (!resp.has_value() || !resp->Succeeded())
+        return Result(-1);
+
+    auto res = Result(static_cast<u32>(resp->GetMethodResult()));
+    if (res.IsError())
+        return res;
+
+    auto read_buff = resp->GetResponseBuffer(0);
+    size_t actually_read = 0;
+    if (read_buff.has_value()) {
+        actually_read = std::min(read_buff->second, len);
+        memcpy(buffer, read_buff->first, actually_read);
+    }
+    return actually_read;
+}
+
+bool ArticCache::ReadPrefetched(u8* buffer, size_t len, size_t offset, bool& sequential) {
+    std::scoped_lock prefetch_guard(prefetch_mutex);
+    sequential = offset == last_read_end && len <= prefetch_max_size;
+    last_read_end = offset + len;
+
+    while (!prefetch.empty()) {
+        auto& window = prefetch.front();
+        if (offset < window.offset) {
+            // The window is ahead of this read, keep it for later
+            return false;
+        }
+        if (offset + len > window.offset + window.length) {
+            // The reads have moved past the window
+            prefetch.pop_front();
+            continue;
+        }
+
+        if (!window.received) {
+            window.data.resize(window.length);
+            size_t received = 0;
+            for (auto& [pending, to_read] : window.requests) {
+                auto res = ReceiveReadResponse(*pending, window.data.data() + received, to_read);
+                if (res.Failed())
+                    break;
+                received += res.Unwrap();
+                if (res.Unwrap() != to_read)
+                    break;
+            }
+            window.requests.clear();
+            window.data.resize(received);
+            window.received = true;
+        }
+
+        const size_t into = offset - window.offset;
+        if (into + len > window.data.size()) {
+            prefetch.pop_front();
+            return false;
+        }
+        std::memcpy(buffer, window.data.data() + into, len);
+        sequential = true;
+        return true;
+    }
+    return false;
+}
+
+void ArticCache::StartPrefetch(s32 file_handle, size_t len, size_t offset) {
+    std::scoped_lock prefetch_guard(prefetch_mutex);
+
+    // Only request a new window once the reads have reached the last one.
+    size_t window_offset = offset + len;
+    if (!prefetch.empty()) {
+        const auto& last = prefetch.back();
+        if (offset < last.offset) {
+            return;
+        }
+        window_offset = std::max(window_offset, last.offset + last.length);
+    }
+
+    size_t window_len = std::clamp(len * 4, prefetch_min_size, prefetch_max_size);
+    if (data_size.has_value()) {
+        if (window_offset >= *data_size) {
+            return;
+        }
+        window_len = std::min(window_len, *data_size - window_offset);
+    }
+
+    PrefetchWindow window{.offset = window_offset, .length = window_len};
+    const size_t chunk_size = client->GetServerRequestMaxSize() - 0x100;
+    for (size_t sent_amount = 0; sent_amount != window_len;) {
+        const size_t to_read = std::min<size_t>(chunk_size, window_len - sent_amount);
+        auto pending = SendReadRequest(file_handle, to_read, window_offset + sent_amount);
+        if (!pending) {
+            return;
+        }
+        window.requests.emplace_back(std::move(pending), to_read);
+        sent_amount += to_read;
+    }
+    LOG_TRACE(Service_FS, "ArticCache PREFETCH: offset={}, length={}", window_offset, window_len);
+
+    prefetch.push_back(std::move(window));
+    if (prefetch.size() > prefetch_windows) {
+        prefetch.pop_front();
+    }
+}
+
 std::vector<std::pair<std::size_t, std::size_t>> ArticCache::BreakupRead(std::size_t offset,
                                                                          std::size_t length) {
     std::vector<std::pair<std::size_t, std::size_t>> ret;
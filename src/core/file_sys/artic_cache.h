@@ -5,6 +5,8 @@
 #pragma once
 
 #include <array>
+#include <deque>
+#include <mutex>
 #include <shared_mutex>
 #include "vector"
 
@@ -15,6 +17,7 @@
 #include "common/common_types.h"
 #include "common/static_lru_cache.h"
 #include "core/file_sys/archive_backend.h"
+#include "core/file_sys/artic_disk_cache.h"
 #include "core/hle/result.h"
 #include "network/artic_base/artic_base_client.h"
 
@@ -41,9 +44,18 @@ public:
         data_size = size;
     }
 
+    /// Keeps the data read from the server in a persistent store, and serves reads from it.
+    /// Must only be used for data that cannot be written to.
+    void SetDiskCache(std::shared_ptr<ArticDiskCache> cache) {
+        disk_cache = std::move(cache);
+    }
+
 private:
+    using PendingResponse = Network::ArticBase::Client::PendingResponse;
+
     std::shared_ptr<Network::ArticBase::Client> client;
     std::optional<size_t> data_size;
+    std::shared_ptr<ArticDiskCache> disk_cache;
 
     // Total cache size: 32MB small, 512MB big (worst case), 160MB very big (worst case).
     // The worst case values are unrealistic, they will never happen in any real game.
@@ -76,8 +88,39 @@ private:
         very_big_cache;
     std::shared_mutex very_big_cache_mutex;
 
+    // Read requests are pipelined, up to this many can be waiting for the server at once.
+    static constexpr std::size_t max_requests_in_flight = 8;
+
+    // Sequential reads are followed by requests for the data after them, in windows of this size.
+    static constexpr std::size_t prefetch_min_size = 128 * 1024;
+    static constexpr std::size_t prefetch_max_size = 1024 * 1024;
+    static constexpr std::size_t prefetch_windows = 2;
+
+    struct PrefetchWindow {
+        std::size_t offset;
+        std::size_t length;
+        std::vector<std::pair<std::shared_ptr<PendingResponse>, std::size_t>> requests;
+        std::vector<u8> data;
+        bool received = false;
+    };
+    std::deque<PrefetchWindow> prefetch;
+    std::size_t last_read_end = 0;
+    std::mutex prefetch_mutex;
+
     ResultVal<std::size_t> ReadFromArtic(s32 file_handle, u8* buffer, size_t len, size_t offset);
 
+    ResultVal<std::size_t> FetchFromArtic(s32 file_handle, u8* buffer, size_t len, size_t offset);
+
+    std::shared_ptr<PendingResponse> SendReadRequest(s32 file_handle, size_t len, size_t offset);
+
+    ResultVal<std::size_t> ReceiveReadResponse(PendingResponse& pending, u8* buffer, size_t len);
+
+    /// Copies the range from a prefetch window if one holds it. Returns false otherwise.
+    bool ReadPrefetched(u8* buffer, size_t len, size_t offset, bool& sequential);
+
+    /// Requests the data after a sequential read, if it is not already being prefetched.
+    void StartPrefetch(s32 file_handle, size_t len, size_t offset);
+
     std::size_t OffsetToPage(std::size_t offset) {
         return Common::AlignDown<std::size_t>(offset, cache_line_size);
     }
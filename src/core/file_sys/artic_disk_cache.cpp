@@ -0,0 +1,248 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <string_view>
+#include <fmt/format.h>
+#include "common/alignment.h"
+#include "common/common_funcs.h"
+#include "common/common_paths.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "core/file_sys/artic_disk_cache.h"
+#include "core/loader/loader.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr u32 BLOCK_MAP_MAGIC = Loader::MakeMagic('A', 'D', 'C', 'M');
+constexpr u32 BLOCK_MAP_VERSION = 2;
+
+/// Number of newly stored blocks after which the block map is written out again.
+constexpr std::size_t FLUSH_INTERVAL = 1024;
+
+struct BlockMapHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le data_size;
+    u32_le block_size;
+    INSERT_PADDING_WORDS(1);
+    u64_le content_hash;
+};
+static_assert(sizeof(BlockMapHeader) == 0x20, "BlockMapHeader has incorrect size.");
+
+constexpr std::string_view DATA_EXTENSION = ".bin";
+
+std::string GetMapPath(const std::string& path) {
+    return path + ".map";
+}
+
+} // Anonymous namespace
+
+ArticDiskCache::ArticDiskCache(const std::string& path_, std::size_t data_size_,
+                               u64 content_hash_)
+    : path{path_}, data_size{data_size_}, content_hash{content_hash_},
+      stored_blocks((Common::AlignUp(data_size_, BLOCK_SIZE) / BLOCK_SIZE + 7) / 8) {
+    if (!FileUtil::CreateFullPath(path)) {
+        return;
+    }
+
+    bool valid = false;
+    {
+        FileUtil::IOFile map_file(GetMapPath(path), "rb");
+        BlockMapHeader header;
+        if (map_file && map_file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+            header.magic == BLOCK_MAP_MAGIC && header.version == BLOCK_MAP_VERSION &&
+            header.data_size == data_size && header.block_size == BLOCK_SIZE &&
+            header.content_hash == content_hash) {
+            valid = map_file.ReadBytes(stored_blocks.data(), stored_blocks.size()) ==
+                    stored_blocks.size();
+        }
+    }
+
+    if (valid) {
+        data_file = FileUtil::IOFile(path, "r+b");
+    }
+    if (!data_file.IsOpen()) {
+        // Start over if anything is missing, as the blocks cannot be trusted without their map.
+        // The file grows as blocks are stored, it is not allocated up front.
+        std::fill(stored_blocks.begin(), stored_blocks.end(), u8{0});
+        FileUtil::Delete(GetMapPath(path));
+        data_file = FileUtil::IOFile(path, "w+b");
+        if (!data_file.IsOpen()) {
+            LOG_WARNING(Service_FS, "Could not create Artic disk cache {}", path);
+        }
+    }
+}
+
+ArticDiskCache::~ArticDiskCache() {
+    Flush();
+}
+
+std::string ArticDiskCache::GetPath(u64 title_id, std::span<const u8> archive_path) {
+    const u64 path_hash = Common::ComputeHash64(archive_path.data(), archive_path.size());
+    return fmt::format("{}{}{:016X}{}{:016X}{}", GetDirectory(), DIR_SEP, title_id, DIR_SEP,
+                       path_hash, DATA_EXTENSION);
+}
+
+std::string ArticDiskCache::GetDirectory() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "artic";
+}
+
+void ArticDiskCache::Prune(const std::string& directory, u64 max_size,
+                           const std::string& keep_path) {
+    struct Store {
+        std::string path;
+        u64 size;
+        u64 modification_time;
+    };
+    std::vector<Store> stores;
+    u64 total_size = 0;
+
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, directory,
+        [&stores, &total_size](u64*, const std::string& directory, const std::string& name) {
+            const std::string title_directory = directory + DIR_SEP + name;
+            if (!FileUtil::IsDirectory(title_directory)) {
+                return true;
+            }
+            FileUtil::ForeachDirectoryEntry(
+                nullptr, title_directory,
+                [&stores, &total_size](u64*, const std::string& directory,
+                                       const std::string& name) {
+                    if (!name.ends_with(DATA_EXTENSION)) {
+                        return true;
+                    }
+                    // The map is rewritten as blocks are stored, so it tells when the store was
+                    // last used.
+                    const std::string path = directory + DIR_SEP + name;
+                    const std::string map_path = GetMapPath(path);
+                    const u64 size = FileUtil::GetSize(path) + FileUtil::GetSize(map_path);
+                    stores.push_back({path, size, FileUtil::GetModificationTime(map_path)});
+                    total_size += size;
+                    return true;
+                });
+            return true;
+        });
+    if (total_size <= max_size) {
+        return;
+    }
+
+    std::sort(stores.begin(), stores.end(), [](const auto& a, const auto& b) {
+        return a.modification_time < b.modification_time;
+    });
+    for (const auto& store : stores) {
+        if (total_size <= max_size) {
+            break;
+        }
+        if (store.path == keep_path) {
+            continue;
+        }
+        FileUtil::Delete(GetMapPath(store.path));
+        if (FileUtil::Delete(store.path)) {
+            total_size -= store.size;
+        }
+    }
+}
+
+std::pair<std::size_t, std::size_t> ArticDiskCache::AlignRange(std::size_t offset,
+                                                               std::size_t length) const {
+    const std::size_t start = Common::AlignDown(offset, BLOCK_SIZE);
+    const std::size_t end = std::min(Common::AlignUp(offset + length, BLOCK_SIZE), data_size);
+    return {start, end > start ? end - start : 0};
+}
+
+bool ArticDiskCache::Read(std::size_t offset, std::size_t length, u8* buffer) {
+    if (length == 0 || offset + length > data_size) {
+        return false;
+    }
+
+    std::scoped_lock lock{mutex};
+    if (!data_file.IsOpen()) {
+        return false;
+    }
+    const std::size_t last_block = (offset + length - 1) / BLOCK_SIZE;
+    for (std::size_t block = offset / BLOCK_SIZE; block <= last_block; block++) {
+        if (!IsBlockStored(block)) {
+            return false;
+        }
+    }
+    return data_file.ReadAtBytes(buffer, length, offset) == length;
+}
+
+void ArticDiskCache::Write(std::size_t offset, std::size_t length, const u8* buffer) {
+    const std::size_t end = std::min(offset + length, data_size);
+    if (end <= offset) {
+        return;
+    }
+
+    // The last block of the source is shorter, it is complete once the range reaches the end.
+    const std::size_t first_block = Common::AlignUp(offset, BLOCK_SIZE) / BLOCK_SIZE;
+    const std::size_t end_block =
+        end == data_size ? Common::AlignUp(end, BLOCK_SIZE) / BLOCK_SIZE : end / BLOCK_SIZE;
+    if (first_block >= end_block) {
+        return;
+    }
+
+    std::scoped_lock lock{mutex};
+    if (!data_file.IsOpen()) {
+        return;
+    }
+    const std::size_t write_offset = first_block * BLOCK_SIZE;
+    const std::size_t write_length = std::min(end_block * BLOCK_SIZE, end) - write_offset;
+    if (!data_file.Seek(static_cast<s64>(write_offset), SEEK_SET) ||
+        data_file.WriteBytes(buffer + (write_offset - offset), write_length) != write_length) {
+        LOG_WARNING(Service_FS, "Could not write to Artic disk cache {}", path);
+        return;
+    }
+
+    for (std::size_t block = first_block; block < end_block; block++) {
+        if (!IsBlockStored(block)) {
+            stored_blocks[block / 8] |= static_cast<u8>(1 << (block % 8));
+            unflushed_blocks++;
+        }
+    }
+    if (unflushed_blocks >= FLUSH_INTERVAL) {
+        FlushLocked();
+    }
+}
+
+void ArticDiskCache::Flush() {
+    std::scoped_lock lock{mutex};
+    FlushLocked();
+}
+
+void ArticDiskCache::FlushLocked() {
+    if (unflushed_blocks == 0 || !data_file.IsOpen()) {
+        return;
+    }
+    // The blocks have to reach the disk before the map that claims they are there.
+    data_file.Flush();
+
+    const std::string map_path = GetMapPath(path);
+    const std::string temp_path = map_path + ".tmp";
+    {
+        FileUtil::IOFile map_file(temp_path, "wb");
+        BlockMapHeader header{};
+        header.magic = BLOCK_MAP_MAGIC;
+        header.version = BLOCK_MAP_VERSION;
+        header.data_size = data_size;
+        header.block_size = static_cast<u32>(BLOCK_SIZE);
+        header.content_hash = content_hash;
+        if (!map_file || map_file.WriteObject(header) != 1 ||
+            map_file.WriteBytes(stored_blocks.data(), stored_blocks.size()) !=
+                stored_blocks.size()) {
+            LOG_WARNING(Service_FS, "Could not write Artic disk cache map {}", map_path);
+            return;
+        }
+    }
+    FileUtil::Delete(map_path);
+    if (FileUtil::Rename(temp_path, map_path)) {
+        unflushed_blocks = 0;
+    }
+}
+
+} // namespace FileSys
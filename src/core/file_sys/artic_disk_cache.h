@@ -0,0 +1,85 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace FileSys {
+
+/**
+ * Persistent store of read-only content fetched through Artic Base. The content is kept in a file
+ * laid out like the source, next to a bitmap of the blocks that have been fetched, so that later
+ * sessions can read those blocks locally. Writes to the source are not tracked, so only content
+ * that cannot change (such as a title's RomFS) should be stored. The store is tied to a hash of
+ * content that covers the whole source, so that it is dropped when the source is updated.
+ */
+class ArticDiskCache {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 4 * 1024;
+
+    /// Total size the stores are pruned to when a new one is opened.
+    static constexpr u64 MAX_TOTAL_SIZE = 4ULL * 1024 * 1024 * 1024;
+
+    /**
+     * Opens the store at the given path, discarding its contents if they were stored for a source
+     * of a different size or content hash.
+     */
+    ArticDiskCache(const std::string& path, std::size_t data_size, u64 content_hash);
+    ~ArticDiskCache();
+
+    ArticDiskCache(const ArticDiskCache&) = delete;
+    ArticDiskCache& operator=(const ArticDiskCache&) = delete;
+
+    /// Returns the path of the store for a title's content at the given archive path.
+    static std::string GetPath(u64 title_id, std::span<const u8> archive_path);
+
+    /// Returns the directory holding the stores of all titles.
+    static std::string GetDirectory();
+
+    /**
+     * Deletes the least recently written stores in the directory until their total size is at
+     * most max_size, except for the one at keep_path.
+     */
+    static void Prune(const std::string& directory, u64 max_size, const std::string& keep_path);
+
+    [[nodiscard]] bool IsOpen() const {
+        return data_file.IsOpen();
+    }
+
+    /// Returns the range covering whole blocks that contains the given one.
+    std::pair<std::size_t, std::size_t> AlignRange(std::size_t offset, std::size_t length) const;
+
+    /// Reads a range if all of its blocks have been stored. Returns false otherwise.
+    bool Read(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Stores a range read from the source. Only the blocks it covers entirely are recorded.
+    void Write(std::size_t offset, std::size_t length, const u8* buffer);
+
+    /// Writes the bitmap of stored blocks to disk.
+    void Flush();
+
+private:
+    bool IsBlockStored(std::size_t block) const {
+        return (stored_blocks[block / 8] >> (block % 8)) & 1;
+    }
+
+    void FlushLocked();
+
+    std::string path;
+    std::size_t data_size;
+    u64 content_hash;
+    FileUtil::IOFile data_file;
+    std::vector<u8> stored_blocks;
+    std::size_t unflushed_blocks = 0;
+    std::mutex mutex;
+};
+
+} // namespace FileSys
@@ -93,6 +93,13 @@ public:
         return false;
     }
 
+    /**
+     * Whether the file cannot change while it is open, so reads of it may be served ahead of time.
+     */
+    virtual bool IsReadOnly() const {
+        return false;
+    }
+
     /**
      * Whether the cache is ready for a specified offset and length.
      */
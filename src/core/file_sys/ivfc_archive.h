@@ -135,6 +135,10 @@ public:
         return romfs_file->AllowsCachedReads();
     }
 
+    bool IsReadOnly() const override {
+        return true;
+    }
+
     bool CacheReady(std::size_t file_offset, std::size_t length) override {
         return romfs_file->CacheReady(file_offset, length);
     }
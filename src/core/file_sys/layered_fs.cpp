@@ -4,15 +4,20 @@
 
 #include <algorithm>
 #include <cstring>
+#include <type_traits>
+#include <fmt/format.h>
 #include "common/alignment.h"
 #include "common/archives.h"
 #include "common/assert.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
+#include "common/literals.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/patch.h"
+#include "core/loader/loader.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::LayeredFS)
 
@@ -24,6 +29,8 @@ struct FileRelocationInfo {
     std::string replace_file_path; // Type 1
     std::vector<u8> patched_file;  // Type 2
     u64 size;                      // Relocated file size
+    u64 original_size;             // Type 2. Size and hash of the unpatched file, which the build
+    u64 original_hash;             // cache is validated against
 };
 struct LayeredFS::File {
     std::string name;
@@ -54,6 +61,41 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+using namespace Common::Literals;
+
+constexpr u32 BUILD_CACHE_MAGIC = Loader::MakeMagic('L', 'F', 'S', 'C');
+constexpr u32 BUILD_CACHE_VERSION = 2;
+
+/// Build caches are evicted, oldest first, once they take up more than this in total.
+constexpr u64 BUILD_CACHE_MAX_SIZE = 256_MiB;
+
+struct BuildCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le metadata_size;
+    u64_le data_size;
+    u64_le file_count;
+};
+static_assert(std::is_trivially_copyable_v<BuildCacheHeader>);
+
+struct BuildCacheFile {
+    u64_le data_offset;
+    u64_le original_offset;
+    u64_le size;
+    u64_le patched_size;
+    u32_le type;
+    u32_le path_length;
+    u32_le replace_path_length;
+    u32_le padding;
+    u64_le original_size;
+    u64_le original_hash;
+    // Followed by the path, the replacement path and the patched file
+};
+static_assert(std::is_trivially_copyable_v<BuildCacheFile>);
+
+/// Replacement files are read ahead in chunks of this size.
+constexpr std::size_t READAHEAD_SIZE = 256_KiB;
+
 LayeredFS::LayeredFS() = default;
 
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
@@ -68,24 +110,41 @@ void LayeredFS::Load() {
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
-    // TODO: is root always the first directory in table?
-    root.parent = &root;
-    LoadDirectory(root, 0);
+    // Read all of the original metadata at once rather than entry by entry
+    original_metadata.resize(header.file_data_offset);
+    romfs->ReadFile(0, original_metadata.size(), original_metadata.data());
 
+    std::string cache_path;
     if (load_relocations) {
-        LoadRelocations();
-        LoadExtRelocations();
+        cache_path = GetCachePath();
     }
 
-    RebuildMetadata();
+    if (cache_path.empty() || !LoadCache(cache_path)) {
+        // TODO: is root always the first directory in table?
+        root.parent = &root;
+        LoadDirectory(root, 0);
+
+        if (load_relocations) {
+            LoadRelocations();
+            LoadExtRelocations();
+        }
+
+        RebuildMetadata();
+
+        if (!cache_path.empty()) {
+            SaveCache(cache_path);
+        }
+    }
+
+    original_metadata = {};
 }
 
 LayeredFS::~LayeredFS() = default;
 
 u32 LayeredFS::LoadDirectory(Directory& current, u32 offset) {
     DirectoryMetadata metadata;
-    romfs->ReadFile(header.directory_metadata_table.offset + offset, sizeof(metadata),
-                    reinterpret_cast<u8*>(&metadata));
+    std::memcpy(&metadata, original_metadata.data() + header.directory_metadata_table.offset + offset,
+                sizeof(metadata));
 
     current.name = ReadName(header.directory_metadata_table.offset + offset + sizeof(metadata),
                             metadata.name_length);
@@ -111,8 +170,8 @@ u32 LayeredFS::LoadDirectory(Directory& current, u32 offset) {
 
 u32 LayeredFS::LoadFile(Directory& parent, u32 offset) {
     FileMetadata metadata;
-    romfs->ReadFile(header.file_metadata_table.offset + offset, sizeof(metadata),
-                    reinterpret_cast<u8*>(&metadata));
+    std::memcpy(&metadata, original_metadata.data() + header.file_metadata_table.offset + offset,
+                sizeof(metadata));
 
     auto file = std::make_unique<File>();
     file->name = ReadName(header.file_metadata_table.offset + offset + sizeof(metadata),
@@ -130,7 +189,7 @@ u32 LayeredFS::LoadFile(Directory& parent, u32 offset) {
 
 std::string LayeredFS::ReadName(u32 offset, u32 name_length) {
     std::vector<u16_le> buffer(name_length / sizeof(u16_le));
-    romfs->ReadFile(offset, name_length, reinterpret_cast<u8*>(buffer.data()));
+    std::memcpy(buffer.data(), original_metadata.data() + offset, name_length);
 
     std::u16string name(buffer.size(), 0);
     std::transform(buffer.begin(), buffer.end(), name.begin(), [](u16_le character) {
@@ -246,6 +305,8 @@ void LayeredFS::LoadExtRelocations() {
             auto& file = *file_path_map[file_path];
             std::vector<u8> buffer(file.relocation.size); // Original size
             romfs->ReadFile(file.relocation.original_offset, buffer.size(), buffer.data());
+            const u64 original_size = buffer.size();
+            const u64 original_hash = Common::ComputeHash64(buffer.data(), buffer.size());
 
             bool ret = false;
             if (extension == ".ips") {
@@ -260,6 +321,8 @@ void LayeredFS::LoadExtRelocations() {
                 file.relocation.type = 2;
                 file.relocation.size = buffer.size();
                 file.relocation.patched_file = std::move(buffer);
+                file.relocation.original_size = original_size;
+                file.relocation.original_hash = original_hash;
             } else {
                 LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file_path);
             }
@@ -483,6 +546,233 @@ void LayeredFS::RebuildMetadata() {
                 header.file_metadata_table.length);
 }
 
+std::string LayeredFS::GetCachePath() const {
+    // List every patch file, so that adding, removing or changing one invalidates the cache
+    std::vector<std::string> manifest;
+    bool valid = true;
+    const auto add_entries = [&manifest, &valid](const std::string& path) {
+        if (path.empty() || !FileUtil::Exists(path)) {
+            return;
+        }
+        std::string directory = path;
+        if (directory.back() == '/' || directory.back() == '\\') {
+            // ScanDirectoryTree expects a path without trailing '/'
+            directory.pop_back();
+        }
+        FileUtil::FSTEntry result;
+        FileUtil::ScanDirectoryTree(directory, result, 256);
+
+        const auto add_entry = [&](const FileUtil::FSTEntry& entry, const auto& self) -> void {
+            if (entry.isDirectory) {
+                for (const auto& child : entry.children) {
+                    self(child, self);
+                }
+                return;
+            }
+            const u64 modification_time = FileUtil::GetModificationTime(entry.physicalName);
+            valid &= modification_time != 0;
+            manifest.push_back(
+                fmt::format("{}|{}|{}", entry.physicalName, entry.size, modification_time));
+        };
+        for (const auto& entry : result.children) {
+            add_entry(entry, add_entry);
+        }
+    };
+    add_entries(patch_path);
+    add_entries(patch_ext_path);
+    if (!valid) {
+        return {};
+    }
+    std::sort(manifest.begin(), manifest.end());
+
+    u64 key = Common::ComputeHash64(original_metadata.data(), original_metadata.size());
+    key = Common::HashCombine(key, romfs->GetSize());
+    for (const auto& entry : manifest) {
+        key = Common::HashCombine(key, Common::ComputeHash64(entry.data(), entry.size()));
+    }
+
+    return fmt::format("{}layeredfs{}{:016X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), DIR_SEP, key);
+}
+
+bool LayeredFS::LoadCache(const std::string& cache_path) {
+    FileUtil::IOFile file(cache_path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    BuildCacheHeader cache_header;
+    if (file.ReadBytes(&cache_header, sizeof(cache_header)) != sizeof(cache_header) ||
+        cache_header.magic != BUILD_CACHE_MAGIC || cache_header.version != BUILD_CACHE_VERSION) {
+        return false;
+    }
+
+    const auto read_string = [&file](std::string& string, std::size_t length) {
+        string.resize(length);
+        return file.ReadBytes(string.data(), length) == length;
+    };
+
+    metadata.resize(cache_header.metadata_size);
+    bool success = file.ReadBytes(metadata.data(), metadata.size()) == metadata.size();
+    for (u64 i = 0; i < cache_header.file_count && success; i++) {
+        BuildCacheFile entry;
+        if (file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry)) {
+            success = false;
+            break;
+        }
+
+        auto cached_file = std::make_unique<File>();
+        cached_file->relocation.type = entry.type;
+        cached_file->relocation.original_offset = entry.original_offset;
+        cached_file->relocation.size = entry.size;
+        cached_file->relocation.patched_file.resize(entry.patched_size);
+        cached_file->relocation.original_size = entry.original_size;
+        cached_file->relocation.original_hash = entry.original_hash;
+        success = read_string(cached_file->path, entry.path_length) &&
+                  read_string(cached_file->relocation.replace_file_path,
+                              entry.replace_path_length) &&
+                  file.ReadBytes(cached_file->relocation.patched_file.data(),
+                                 entry.patched_size) == entry.patched_size;
+
+        data_offset_map.emplace(entry.data_offset, cached_file.get());
+        cached_files.emplace_back(std::move(cached_file));
+    }
+
+    if (!success) {
+        LOG_WARNING(Service_FS, "LayeredFS build cache {} is corrupted", cache_path);
+    } else if (!std::all_of(cached_files.begin(), cached_files.end(), [this](const auto& file) {
+                   return IsPatchBaseUnchanged(file->relocation);
+               })) {
+        // The patched files embed the base RomFS data, which an update can change without
+        // touching the layout.
+        LOG_INFO(Service_FS, "LayeredFS build cache {} is out of date", cache_path);
+        success = false;
+    }
+
+    if (!success) {
+        metadata.clear();
+        data_offset_map.clear();
+        cached_files.clear();
+        return false;
+    }
+
+    current_data_offset = cache_header.data_size;
+    LOG_INFO(Service_FS, "LayeredFS loaded {} relocated files from build cache",
+             cached_files.size());
+    return true;
+}
+
+void LayeredFS::SaveCache(const std::string& cache_path) const {
+    if (!FileUtil::CreateFullPath(cache_path)) {
+        return;
+    }
+
+    // Write to a temporary file, so that an interrupted write never leaves a partial cache
+    const std::string temp_path = cache_path + ".tmp";
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file) {
+            LOG_WARNING(Service_FS, "Could not create LayeredFS build cache {}", cache_path);
+            return;
+        }
+
+        BuildCacheHeader cache_header{};
+        cache_header.magic = BUILD_CACHE_MAGIC;
+        cache_header.version = BUILD_CACHE_VERSION;
+        cache_header.metadata_size = metadata.size();
+        cache_header.data_size = current_data_offset;
+        cache_header.file_count = data_offset_map.size();
+
+        bool success = file.WriteObject(cache_header) == 1 &&
+                       file.WriteBytes(metadata.data(), metadata.size()) == metadata.size();
+        for (const auto& [data_offset, data_file] : data_offset_map) {
+            const auto& relocation = data_file->relocation;
+
+            BuildCacheFile entry{};
+            entry.data_offset = data_offset;
+            entry.original_offset = relocation.original_offset;
+            entry.size = relocation.size;
+            entry.patched_size = relocation.patched_file.size();
+            entry.type = relocation.type;
+            entry.path_length = static_cast<u32>(data_file->path.size());
+            entry.replace_path_length = static_cast<u32>(relocation.replace_file_path.size());
+            if (relocation.type == 2) {
+                entry.original_size = relocation.original_size;
+                entry.original_hash = relocation.original_hash;
+            }
+
+            success = success && file.WriteObject(entry) == 1 &&
+                      file.WriteString(data_file->path) == data_file->path.size() &&
+                      file.WriteString(relocation.replace_file_path) ==
+                          relocation.replace_file_path.size() &&
+                      file.WriteBytes(relocation.patched_file.data(),
+                                      relocation.patched_file.size()) ==
+                          relocation.patched_file.size();
+        }
+
+        if (!success) {
+            LOG_WARNING(Service_FS, "Could not write LayeredFS build cache {}", cache_path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+
+    FileUtil::Delete(cache_path);
+    FileUtil::Rename(temp_path, cache_path);
+
+    PruneCache(cache_path);
+}
+
+bool LayeredFS::IsPatchBaseUnchanged(const FileRelocationInfo& relocation) const {
+    if (relocation.type != 2) {
+        return true;
+    }
+    std::vector<u8> buffer(relocation.original_size);
+    return romfs->ReadFile(relocation.original_offset, buffer.size(), buffer.data()) ==
+               buffer.size() &&
+           Common::ComputeHash64(buffer.data(), buffer.size()) == relocation.original_hash;
+}
+
+void LayeredFS::PruneCache(const std::string& keep_path) {
+    struct CacheFile {
+        std::string path;
+        u64 size;
+        u64 modification_time;
+    };
+    std::vector<CacheFile> cache_files;
+    u64 total_size = 0;
+
+    const std::string directory =
+        fmt::format("{}layeredfs", FileUtil::GetUserPath(FileUtil::UserPath::CacheDir));
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, directory,
+        [&cache_files, &total_size](u64*, const std::string& directory, const std::string& name) {
+            const std::string path = directory + DIR_SEP + name;
+            if (!FileUtil::IsDirectory(path)) {
+                const u64 size = FileUtil::GetSize(path);
+                cache_files.push_back({path, size, FileUtil::GetModificationTime(path)});
+                total_size += size;
+            }
+            return true;
+        });
+    if (total_size <= BUILD_CACHE_MAX_SIZE) {
+        return;
+    }
+
+    std::sort(cache_files.begin(), cache_files.end(), [](const auto& a, const auto& b) {
+        return a.modification_time < b.modification_time;
+    });
+    for (const auto& file : cache_files) {
+        if (total_size <= BUILD_CACHE_MAX_SIZE) {
+            break;
+        }
+        if (file.path != keep_path && FileUtil::Delete(file.path)) {
+            total_size -= file.size;
+        }
+    }
+}
+
 std::size_t LayeredFS::GetSize() const {
     return metadata.size() + current_data_offset;
 }
@@ -522,14 +812,7 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
             romfs->ReadFile(relocation.original_offset + relative_offset, to_read,
                             buffer + read_size);
         } else if (relocation.type == 1) { // replace
-            FileUtil::IOFile replace_file(relocation.replace_file_path, "rb");
-            if (replace_file) {
-                replace_file.Seek(relative_offset, SEEK_SET);
-                replace_file.ReadBytes(buffer + read_size, to_read);
-            } else {
-                LOG_ERROR(Service_FS, "Could not open replacement file for {}",
-                          current->second->path);
-            }
+            ReadReplacementFile(*current->second, relative_offset, to_read, buffer + read_size);
         } else if (relocation.type == 2) { // patch
             std::memcpy(buffer + read_size, relocation.patched_file.data() + relative_offset,
                         to_read);
@@ -547,6 +830,42 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
     return read_size;
 }
 
+void LayeredFS::ReadReplacementFile(const File& file, u64 offset, std::size_t length,
+                                    u8* buffer) {
+    if (length == 0) {
+        return;
+    }
+
+    if (readahead.file != &file) {
+        readahead.data.clear();
+        readahead.handle = FileUtil::IOFile(file.relocation.replace_file_path, "rb");
+        if (!readahead.handle) {
+            LOG_ERROR(Service_FS, "Could not open replacement file for {}", file.path);
+            readahead.file = nullptr;
+            return;
+        }
+        readahead.file = &file;
+    }
+
+    if (offset >= readahead.offset && offset + length <= readahead.offset + readahead.data.size()) {
+        std::memcpy(buffer, readahead.data.data() + (offset - readahead.offset), length);
+        return;
+    }
+
+    readahead.handle.Seek(offset, SEEK_SET);
+    if (length >= READAHEAD_SIZE) {
+        // Large reads would not benefit from the buffer
+        readahead.handle.ReadBytes(buffer, length);
+        return;
+    }
+
+    readahead.offset = offset;
+    readahead.data.resize(std::max<std::size_t>(
+        length, std::min<u64>(READAHEAD_SIZE, file.relocation.size - offset)));
+    readahead.data.resize(readahead.handle.ReadBytes(readahead.data.data(), readahead.data.size()));
+    std::memcpy(buffer, readahead.data.data(), std::min(length, readahead.data.size()));
+}
+
 bool LayeredFS::ExtractDirectory(Directory& current, const std::string& target_path) {
     if (!FileUtil::CreateFullPath(target_path + current.path)) {
         LOG_ERROR(Service_FS, "Could not create path {}", target_path + current.path);
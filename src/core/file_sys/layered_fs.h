@@ -33,6 +33,8 @@ struct RomFSHeader {
 };
 static_assert(sizeof(RomFSHeader) == 0x28, "Size of RomFSHeader is not correct");
 
+struct FileRelocationInfo;
+
 /**
  * LayeredFS implementation. This basically adds a layer to another RomFSReader.
  *
@@ -41,6 +43,9 @@ static_assert(sizeof(RomFSHeader) == 0x28, "Size of RomFSHeader is not correct")
  * patch_ext_path: Path for RomFS extensions. Files present in this path:
  *  - When with an extension of ".stub", remove the corresponding file in the RomFS.
  *  - When with an extension of ".ips" or ".bps", patch the file in the RomFS.
+ *
+ * The rebuilt metadata and relocations are cached on disk, keyed by the original RomFS metadata
+ * and the path, size and modification time of every file in the patch paths.
  */
 class LayeredFS : public RomFSReader {
 public:
@@ -106,6 +111,25 @@ private:
 
     void RebuildMetadata();
 
+    // Returns the path of the build cache for the current RomFS and patches, or an empty string
+    // if the patches cannot be validated.
+    std::string GetCachePath() const;
+
+    // Loads the rebuilt metadata and relocations from the build cache.
+    bool LoadCache(const std::string& cache_path);
+
+    // Writes the build cache, then evicts the oldest build caches beyond the size limit.
+    void SaveCache(const std::string& cache_path) const;
+
+    // Returns whether the base RomFS data a patched file was built from is still the same.
+    bool IsPatchBaseUnchanged(const FileRelocationInfo& relocation) const;
+
+    // Deletes the oldest build caches until they fit in the size limit, except for keep_path.
+    static void PruneCache(const std::string& keep_path);
+
+    // Reads from a replacement file through the readahead buffer.
+    void ReadReplacementFile(const File& file, u64 offset, std::size_t length, u8* buffer);
+
     void Load();
 
     std::shared_ptr<RomFSReader> romfs;
@@ -114,7 +138,9 @@ private:
     bool load_relocations;
 
     RomFSHeader header;
+    std::vector<u8> original_metadata; // Original header, hash tables and metadata, while loading
     Directory root;
+    std::vector<std::unique_ptr<File>> cached_files; // Relocated files loaded from the build cache
     std::unordered_map<std::string, File*> file_path_map;
     std::unordered_map<std::string, Directory*> directory_path_map;
     std::map<u64, File*> data_offset_map; // assigned data offset -> file
@@ -136,6 +162,16 @@ private:
     std::vector<u8> file_metadata_table; // rebuilt file metadata table
     u64 current_data_offset{};           // current assigned data offset
 
+    // Replacement files are usually read sequentially in small chunks, so they are read ahead
+    // into a buffer shared by all of them.
+    struct ReadaheadBuffer {
+        const File* file{};
+        FileUtil::IOFile handle;
+        u64 offset{};
+        std::vector<u8> data;
+    };
+    ReadaheadBuffer readahead;
+
     LayeredFS();
 
     template <class Archive>
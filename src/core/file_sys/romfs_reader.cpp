@@ -7,6 +7,7 @@
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "common/archives.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "core/file_sys/archive_artic.h"
 #include "core/file_sys/archive_backend.h"
@@ -108,7 +109,7 @@ std::vector<std::pair<std::size_t, std::size_t>> DirectRomFSReader::BreakupRead(
 }
 
 ArticRomFSReader::ArticRomFSReader(std::shared_ptr<Network::ArticBase::Client>& cli,
-                                   bool is_update_romfs)
+                                   bool is_update_romfs, u64 title_id, u16 title_version)
     : client(cli), cache(cli) {
     auto req = client->NewRequest("FSUSER_OpenFileDirectly");
 
@@ -168,6 +169,24 @@ ArticRomFSReader::ArticRomFSReader(std::shared_ptr<Network::ArticBase::Client>&
     }
 
     data_size = static_cast<size_t>(*reinterpret_cast<u64*>(size_buf->first));
+    cache.ForceSetSize(data_size);
+    if (title_id != 0) {
+        // Tie the stored data to the title version and the start of the RomFS, which holds its
+        // header and file tables, so that an update of the same size does not reuse it.
+        std::vector<u8> first_block(std::min(ArticDiskCache::BLOCK_SIZE, data_size));
+        const auto read = cache.Read(romfs_handle, 0, first_block.size(), first_block.data());
+        if (read.Succeeded() && *read == first_block.size()) {
+            const std::string path = ArticDiskCache::GetPath(title_id, fileVec);
+            const u64 content_hash = Common::HashCombine(
+                Common::ComputeHash64(first_block.data(), first_block.size()), title_version);
+            auto disk_cache = std::make_shared<ArticDiskCache>(path, data_size, content_hash);
+            if (disk_cache->IsOpen()) {
+                cache.SetDiskCache(std::move(disk_cache));
+            }
+            ArticDiskCache::Prune(ArticDiskCache::GetDirectory(), ArticDiskCache::MAX_TOTAL_SIZE,
+                                  path);
+        }
+    }
     load_status = Loader::ResultStatus::Success;
 }
 
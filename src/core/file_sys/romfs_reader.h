@@ -99,7 +99,12 @@ private:
 class ArticRomFSReader : public RomFSReader {
 public:
     ArticRomFSReader() = default;
-    ArticRomFSReader(std::shared_ptr<Network::ArticBase::Client>& cli, bool is_update_romfs);
+    /**
+     * Opens the RomFS of the running title through Artic Base. If title_id is not zero, the data
+     * read is also kept on disk for later sessions, for as long as title_version is unchanged.
+     */
+    ArticRomFSReader(std::shared_ptr<Network::ArticBase::Client>& cli, bool is_update_romfs,
+                     u64 title_id = 0, u16 title_version = 0);
 
     ~ArticRomFSReader() override;
 
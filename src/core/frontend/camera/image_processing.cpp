@@ -0,0 +1,459 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "common/arch.h"
+#include "common/assert.h"
+#include "core/frontend/camera/image_processing.h"
+
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+namespace Camera {
+
+namespace {
+
+// The following are data tables for RGB -> YUV conversions.
+namespace YuvTable {
+
+constexpr std::array<int, 256> Y_R = {
+    53,  53,  53,  54,  54,  54,  55,  55,  55,  56,  56,  56,  56,  57,  57,  57,  58,  58,  58,
+    59,  59,  59,  59,  60,  60,  60,  61,  61,  61,  62,  62,  62,  62,  63,  63,  63,  64,  64,
+    64,  65,  65,  65,  65,  66,  66,  66,  67,  67,  67,  67,  68,  68,  68,  69,  69,  69,  70,
+    70,  70,  70,  71,  71,  71,  72,  72,  72,  73,  73,  73,  73,  74,  74,  74,  75,  75,  75,
+    76,  76,  76,  76,  77,  77,  77,  78,  78,  78,  79,  79,  79,  79,  80,  80,  80,  81,  81,
+    81,  82,  82,  82,  82,  83,  83,  83,  84,  84,  84,  85,  85,  85,  85,  86,  86,  86,  87,
+    87,  87,  87,  88,  88,  88,  89,  89,  89,  90,  90,  90,  90,  91,  91,  91,  92,  92,  92,
+    93,  93,  93,  93,  94,  94,  94,  95,  95,  95,  96,  96,  96,  96,  97,  97,  97,  98,  98,
+    98,  99,  99,  99,  99,  100, 100, 100, 101, 101, 101, 102, 102, 102, 102, 103, 103, 103, 104,
+    104, 104, 105, 105, 105, 105, 106, 106, 106, 107, 107, 107, 108, 108, 108, 108, 109, 109, 109,
+    110, 110, 110, 110, 111, 111, 111, 112, 112, 112, 113, 113, 113, 113, 114, 114, 114, 115, 115,
+    115, 116, 116, 116, 116, 117, 117, 117, 118, 118, 118, 119, 119, 119, 119, 120, 120, 120, 121,
+    121, 121, 122, 122, 122, 122, 123, 123, 123, 124, 124, 124, 125, 125, 125, 125, 126, 126, 126,
+    127, 127, 127, 128, 128, 128, 128, 129, 129,
+};
+
+constexpr std::array<int, 256> Y_G = {
+    -79, -79, -78, -78, -77, -77, -76, -75, -75, -74, -74, -73, -72, -72, -71, -71, -70, -70, -69,
+    -68, -68, -67, -67, -66, -65, -65, -64, -64, -63, -62, -62, -61, -61, -60, -60, -59, -58, -58,
+    -57, -57, -56, -55, -55, -54, -54, -53, -52, -52, -51, -51, -50, -50, -49, -48, -48, -47, -47,
+    -46, -45, -45, -44, -44, -43, -42, -42, -41, -41, -40, -40, -39, -38, -38, -37, -37, -36, -35,
+    -35, -34, -34, -33, -33, -32, -31, -31, -30, -30, -29, -28, -28, -27, -27, -26, -25, -25, -24,
+    -24, -23, -23, -22, -21, -21, -20, -20, -19, -18, -18, -17, -17, -16, -15, -15, -14, -14, -13,
+    -13, -12, -11, -11, -10, -10, -9,  -8,  -8,  -7,  -7,  -6,  -5,  -5,  -4,  -4,  -3,  -3,  -2,
+    -1,  -1,  0,   0,   0,   1,   1,   2,   2,   3,   4,   4,   5,   5,   6,   6,   7,   8,   8,
+    9,   9,   10,  11,  11,  12,  12,  13,  13,  14,  15,  15,  16,  16,  17,  18,  18,  19,  19,
+    20,  21,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,  29,  30,  31,
+    31,  32,  32,  33,  33,  34,  35,  35,  36,  36,  37,  38,  38,  39,  39,  40,  41,  41,  42,
+    42,  43,  43,  44,  45,  45,  46,  46,  47,  48,  48,  49,  49,  50,  50,  51,  52,  52,  53,
+    53,  54,  55,  55,  56,  56,  57,  58,  58,  59,  59,  60,  60,  61,  62,  62,  63,  63,  64,
+    65,  65,  66,  66,  67,  68,  68,  69,  69,
+};
+
+constexpr std::array<int, 256> Y_B = {
+    25, 25, 26, 26, 26, 26, 26, 26, 26, 26, 26, 27, 27, 27, 27, 27, 27, 27, 27, 27, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 29, 29, 29, 29, 29, 29, 29, 29, 30, 30, 30, 30, 30, 30, 30, 30, 30, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32, 32, 32, 32, 33, 33, 33, 33, 33, 33, 33, 33,
+    34, 34, 34, 34, 34, 34, 34, 34, 34, 35, 35, 35, 35, 35, 35, 35, 35, 35, 36, 36, 36, 36, 36, 36,
+    36, 36, 36, 37, 37, 37, 37, 37, 37, 37, 37, 38, 38, 38, 38, 38, 38, 38, 38, 38, 39, 39, 39, 39,
+    39, 39, 39, 39, 39, 40, 40, 40, 40, 40, 40, 40, 40, 40, 41, 41, 41, 41, 41, 41, 41, 41, 41, 42,
+    42, 42, 42, 42, 42, 42, 42, 43, 43, 43, 43, 43, 43, 43, 43, 43, 44, 44, 44, 44, 44, 44, 44, 44,
+    44, 45, 45, 45, 45, 45, 45, 45, 45, 45, 46, 46, 46, 46, 46, 46, 46, 46, 47, 47, 47, 47, 47, 47,
+    47, 47, 47, 48, 48, 48, 48, 48, 48, 48, 48, 48, 49, 49, 49, 49, 49, 49, 49, 49, 49, 50, 50, 50,
+    50, 50, 50, 50, 50, 51, 51, 51, 51, 51, 51, 51, 51, 51, 52, 52, 52, 52, 52, 52, 52, 52, 52, 53,
+    53, 53, 53, 53, 53, 53, 53, 53, 54, 54, 54, 54, 54, 54, 54, 54,
+};
+
+static constexpr int Y(int r, int g, int b) {
+    return Y_R[r] + Y_G[g] + Y_B[b];
+}
+
+constexpr std::array<int, 256> U_R = {
+    30, 30, 30, 30, 30, 30, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32, 33, 33, 33, 33, 33, 33, 34,
+    34, 34, 34, 34, 34, 35, 35, 35, 35, 35, 35, 36, 36, 36, 36, 36, 36, 37, 37, 37, 37, 37, 37, 38,
+    38, 38, 38, 38, 38, 39, 39, 39, 39, 39, 39, 40, 40, 40, 40, 40, 40, 41, 41, 41, 41, 41, 41, 42,
+    42, 42, 42, 42, 42, 43, 43, 43, 43, 43, 43, 44, 44, 44, 44, 44, 45, 45, 45, 45, 45, 45, 46, 46,
+    46, 46, 46, 46, 47, 47, 47, 47, 47, 47, 48, 48, 48, 48, 48, 48, 49, 49, 49, 49, 49, 49, 50, 50,
+    50, 50, 50, 50, 51, 51, 51, 51, 51, 51, 52, 52, 52, 52, 52, 52, 53, 53, 53, 53, 53, 53, 54, 54,
+    54, 54, 54, 54, 55, 55, 55, 55, 55, 55, 56, 56, 56, 56, 56, 56, 57, 57, 57, 57, 57, 57, 58, 58,
+    58, 58, 58, 59, 59, 59, 59, 59, 59, 60, 60, 60, 60, 60, 60, 61, 61, 61, 61, 61, 61, 62, 62, 62,
+    62, 62, 62, 63, 63, 63, 63, 63, 63, 64, 64, 64, 64, 64, 64, 65, 65, 65, 65, 65, 65, 66, 66, 66,
+    66, 66, 66, 67, 67, 67, 67, 67, 67, 68, 68, 68, 68, 68, 68, 69, 69, 69, 69, 69, 69, 70, 70, 70,
+    70, 70, 70, 71, 71, 71, 71, 71, 72, 72, 72, 72, 72, 72, 73, 73,
+};
+
+constexpr std::array<int, 256> U_G = {
+    -45, -44, -44, -44, -43, -43, -43, -42, -42, -42, -41, -41, -41, -40, -40, -40, -39, -39, -39,
+    -38, -38, -38, -37, -37, -37, -36, -36, -36, -35, -35, -35, -34, -34, -34, -33, -33, -33, -32,
+    -32, -32, -31, -31, -31, -30, -30, -30, -29, -29, -29, -28, -28, -28, -27, -27, -27, -26, -26,
+    -26, -25, -25, -25, -24, -24, -24, -23, -23, -23, -22, -22, -22, -21, -21, -21, -20, -20, -20,
+    -19, -19, -19, -18, -18, -18, -17, -17, -17, -16, -16, -16, -15, -15, -15, -14, -14, -14, -14,
+    -13, -13, -13, -12, -12, -12, -11, -11, -11, -10, -10, -10, -9,  -9,  -9,  -8,  -8,  -8,  -7,
+    -7,  -7,  -6,  -6,  -6,  -5,  -5,  -5,  -4,  -4,  -4,  -3,  -3,  -3,  -2,  -2,  -2,  -1,  -1,
+    -1,  0,   0,   0,   0,   0,   0,   1,   1,   1,   2,   2,   2,   3,   3,   3,   4,   4,   4,
+    5,   5,   5,   6,   6,   6,   7,   7,   7,   8,   8,   8,   9,   9,   9,   10,  10,  10,  11,
+    11,  11,  12,  12,  12,  13,  13,  13,  14,  14,  14,  15,  15,  15,  16,  16,  16,  17,  17,
+    17,  18,  18,  18,  19,  19,  19,  20,  20,  20,  21,  21,  21,  22,  22,  22,  23,  23,  23,
+    24,  24,  24,  25,  25,  25,  26,  26,  26,  27,  27,  27,  28,  28,  28,  29,  29,  29,  30,
+    30,  30,  31,  31,  31,  32,  32,  32,  33,  33,  33,  34,  34,  34,  35,  35,  35,  36,  36,
+    36,  37,  37,  37,  38,  38,  38,  39,  39,
+};
+
+constexpr std::array<int, 256> U_B = {
+    113, 113, 114, 114, 115, 115, 116, 116, 117, 117, 118, 118, 119, 119, 120, 120, 121, 121, 122,
+    122, 123, 123, 124, 124, 125, 125, 126, 126, 127, 127, 128, 128, 129, 129, 130, 130, 131, 131,
+    132, 132, 133, 133, 134, 134, 135, 135, 136, 136, 137, 137, 138, 138, 139, 139, 140, 140, 141,
+    141, 142, 142, 143, 143, 144, 144, 145, 145, 146, 146, 147, 147, 148, 148, 149, 149, 150, 150,
+    151, 151, 152, 152, 153, 153, 154, 154, 155, 155, 156, 156, 157, 157, 158, 158, 159, 159, 160,
+    160, 161, 161, 162, 162, 163, 163, 164, 164, 165, 165, 166, 166, 167, 167, 168, 168, 169, 169,
+    170, 170, 171, 171, 172, 172, 173, 173, 174, 174, 175, 175, 176, 176, 177, 177, 178, 178, 179,
+    179, 180, 180, 181, 181, 182, 182, 183, 183, 184, 184, 185, 185, 186, 186, 187, 187, 188, 188,
+    189, 189, 190, 190, 191, 191, 192, 192, 193, 193, 194, 194, 195, 195, 196, 196, 197, 197, 198,
+    198, 199, 199, 200, 200, 201, 201, 202, 202, 203, 203, 204, 204, 205, 205, 206, 206, 207, 207,
+    208, 208, 209, 209, 210, 210, 211, 211, 212, 212, 213, 213, 214, 214, 215, 215, 216, 216, 217,
+    217, 218, 218, 219, 219, 220, 220, 221, 221, 222, 222, 223, 223, 224, 224, 225, 225, 226, 226,
+    227, 227, 228, 228, 229, 229, 230, 230, 231, 231, 232, 232, 233, 233, 234, 234, 235, 235, 236,
+    236, 237, 237, 238, 238, 239, 239, 240, 240,
+};
+
+static constexpr int U(int r, int g, int b) {
+    return -U_R[r] - U_G[g] + U_B[b];
+}
+
+constexpr std::array<int, 256> V_R = {
+    89,  90,  90,  91,  91,  92,  92,  93,  93,  94,  94,  95,  95,  96,  96,  97,  97,  98,  98,
+    99,  99,  100, 100, 101, 101, 102, 102, 103, 103, 104, 104, 105, 105, 106, 106, 107, 107, 108,
+    108, 109, 109, 110, 110, 111, 111, 112, 112, 113, 113, 114, 114, 115, 115, 116, 116, 117, 117,
+    118, 118, 119, 119, 120, 120, 121, 121, 122, 122, 123, 123, 124, 124, 125, 125, 126, 126, 127,
+    127, 128, 128, 129, 129, 130, 130, 131, 131, 132, 132, 133, 133, 134, 134, 135, 135, 136, 136,
+    137, 137, 138, 138, 139, 139, 140, 140, 141, 141, 142, 142, 143, 143, 144, 144, 145, 145, 146,
+    146, 147, 147, 148, 148, 149, 149, 150, 150, 151, 151, 152, 152, 153, 153, 154, 154, 155, 155,
+    156, 156, 157, 157, 158, 158, 159, 159, 160, 160, 161, 161, 162, 162, 163, 163, 164, 164, 165,
+    165, 166, 166, 167, 167, 168, 168, 169, 169, 170, 170, 171, 171, 172, 172, 173, 173, 174, 174,
+    175, 175, 176, 176, 177, 177, 178, 178, 179, 179, 180, 180, 181, 181, 182, 182, 183, 183, 184,
+    184, 185, 185, 186, 186, 187, 187, 188, 188, 189, 189, 190, 190, 191, 191, 192, 192, 193, 193,
+    194, 194, 195, 195, 196, 196, 197, 197, 198, 198, 199, 199, 200, 200, 201, 201, 202, 202, 203,
+    203, 204, 205, 205, 206, 206, 207, 207, 208, 208, 209, 209, 210, 210, 211, 211, 212, 212, 213,
+    213, 214, 214, 215, 215, 216, 216, 217, 217,
+};
+
+constexpr std::array<int, 256> V_G = {
+    -57, -56, -56, -55, -55, -55, -54, -54, -53, -53, -52, -52, -52, -51, -51, -50, -50, -50, -49,
+    -49, -48, -48, -47, -47, -47, -46, -46, -45, -45, -45, -44, -44, -43, -43, -42, -42, -42, -41,
+    -41, -40, -40, -39, -39, -39, -38, -38, -37, -37, -37, -36, -36, -35, -35, -34, -34, -34, -33,
+    -33, -32, -32, -31, -31, -31, -30, -30, -29, -29, -29, -28, -28, -27, -27, -26, -26, -26, -25,
+    -25, -24, -24, -24, -23, -23, -22, -22, -21, -21, -21, -20, -20, -19, -19, -18, -18, -18, -17,
+    -17, -16, -16, -16, -15, -15, -14, -14, -13, -13, -13, -12, -12, -11, -11, -10, -10, -10, -9,
+    -9,  -8,  -8,  -8,  -7,  -7,  -6,  -6,  -5,  -5,  -5,  -4,  -4,  -3,  -3,  -3,  -2,  -2,  -1,
+    -1,  0,   0,   0,   0,   0,   1,   1,   2,   2,   2,   3,   3,   4,   4,   4,   5,   5,   6,
+    6,   7,   7,   7,   8,   8,   9,   9,   10,  10,  10,  11,  11,  12,  12,  12,  13,  13,  14,
+    14,  15,  15,  15,  16,  16,  17,  17,  17,  18,  18,  19,  19,  20,  20,  20,  21,  21,  22,
+    22,  23,  23,  23,  24,  24,  25,  25,  25,  26,  26,  27,  27,  28,  28,  28,  29,  29,  30,
+    30,  31,  31,  31,  32,  32,  33,  33,  33,  34,  34,  35,  35,  36,  36,  36,  37,  37,  38,
+    38,  38,  39,  39,  40,  40,  41,  41,  41,  42,  42,  43,  43,  44,  44,  44,  45,  45,  46,
+    46,  46,  47,  47,  48,  48,  49,  49,  49,
+};
+
+constexpr std::array<int, 256> V_B = {
+    18, 18, 18, 18, 18, 18, 18, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 20, 20, 20, 20,
+    20, 20, 20, 20, 20, 20, 20, 20, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 22, 22, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 26, 26, 26,
+    26, 26, 26, 26, 26, 26, 26, 26, 26, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 29, 29, 29, 29, 29, 29, 29, 29, 29, 29, 29, 29, 30, 30,
+    30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 34,
+    34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35,
+    36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 39, 39, 39, 39,
+};
+
+static constexpr int V(int r, int g, int b) {
+    return V_R[r] - V_G[g] - V_B[b];
+}
+} // namespace YuvTable
+
+/// Describes a table as (scale * i + bias) / 2^TABLE_SHIFT, rounded towards zero.
+struct TableFit {
+    s32 scale;
+    s32 bias;
+};
+
+constexpr int TABLE_SHIFT = 15;
+
+constexpr TableFit Y_R_FIT{9782, 1748855};
+constexpr TableFit Y_G_FIT{19245, -2620953};
+constexpr TableFit Y_B_FIT{3736, 845588};
+constexpr TableFit U_R_FIT{5529, 988133};
+constexpr TableFit U_G_FIT{10855, -1479170};
+constexpr TableFit U_B_FIT{16320, 3719136};
+constexpr TableFit V_R_FIT{16385, 2948891};
+constexpr TableFit V_G_FIT{13759, -1873576};
+constexpr TableFit V_B_FIT{2673, 604464};
+
+constexpr bool MatchesTable(TableFit fit, const std::array<int, 256>& table) {
+    for (int i = 0; i < 256; i++) {
+        if ((fit.scale * i + fit.bias) / (1 << TABLE_SHIFT) != table[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The SIMD paths evaluate the fits instead of looking the tables up, so they must match exactly.
+static_assert(MatchesTable(Y_R_FIT, YuvTable::Y_R));
+static_assert(MatchesTable(Y_G_FIT, YuvTable::Y_G));
+static_assert(MatchesTable(Y_B_FIT, YuvTable::Y_B));
+static_assert(MatchesTable(U_R_FIT, YuvTable::U_R));
+static_assert(MatchesTable(U_G_FIT, YuvTable::U_G));
+static_assert(MatchesTable(U_B_FIT, YuvTable::U_B));
+static_assert(MatchesTable(V_R_FIT, YuvTable::V_R));
+static_assert(MatchesTable(V_G_FIT, YuvTable::V_G));
+static_assert(MatchesTable(V_B_FIT, YuvTable::V_B));
+
+#if CITRA_ARCH(x86_64)
+/// Evaluates a table fit for four channel values held in 32-bit lanes.
+__m128i EvaluateFit(__m128i channel, TableFit fit) {
+    // The scale fits in 16 bits, and so does the channel, so a single madd does the product.
+    const __m128i x = _mm_add_epi32(_mm_madd_epi16(channel, _mm_set1_epi32(fit.scale)),
+                                    _mm_set1_epi32(fit.bias));
+    const __m128i round = _mm_srli_epi32(_mm_srai_epi32(x, 31), 32 - TABLE_SHIFT);
+    return _mm_srai_epi32(_mm_add_epi32(x, round), TABLE_SHIFT);
+}
+#elif CITRA_ARCH(arm64)
+/// Evaluates a table fit for four channel values held in 32-bit lanes.
+int32x4_t EvaluateFit(int32x4_t channel, TableFit fit) {
+    const int32x4_t x = vmlaq_n_s32(vdupq_n_s32(fit.bias), channel, fit.scale);
+    const int32x4_t round = vreinterpretq_s32_u32(
+        vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(x, 31)), 32 - TABLE_SHIFT));
+    return vshrq_n_s32(vaddq_s32(x, round), TABLE_SHIFT);
+}
+#endif
+
+constexpr u16 PackRgb565(u32 pixel) {
+    return static_cast<u16>(((pixel & 0xF8) << 8) | ((pixel >> 5) & 0x7E0) |
+                            ((pixel >> 19) & 0x1F));
+}
+
+/// Maps a frame coordinate to the two source texels around it and the 8-bit weight of the second.
+struct Sample {
+    u32 index0;
+    u32 index1;
+    u32 weight;
+};
+
+Sample MapCoordinate(s64 position, s64 scaled_size, int size) {
+    // Texel centres are at half-integer positions in both the scaled and the source image.
+    const s64 fixed = ((2 * position + 1) * size * 256) / (2 * scaled_size) - 128;
+    const s64 clamped = std::clamp<s64>(fixed, 0, static_cast<s64>(size - 1) * 256);
+    const u32 index = static_cast<u32>(clamped >> 8);
+    return {index, std::min<u32>(index + 1, size - 1), static_cast<u32>(clamped & 0xFF)};
+}
+
+} // Anonymous namespace
+
+void ConvertToRgb565Scalar(std::span<const u32> src, std::span<u16> dest) {
+    DEBUG_ASSERT(dest.size() >= src.size());
+    std::transform(src.begin(), src.end(), dest.begin(), PackRgb565);
+}
+
+void ConvertToYuv422Scalar(std::span<const u32> src, std::span<u16> dest) {
+    DEBUG_ASSERT(dest.size() >= src.size());
+    const auto clamp = [](int value) { return static_cast<u16>(std::clamp(value, 0, 0xFF)); };
+    std::size_t i = 0;
+    for (; i + 1 < src.size(); i += 2) {
+        const int r0 = src[i] & 0xFF;
+        const int g0 = (src[i] >> 8) & 0xFF;
+        const int b0 = (src[i] >> 16) & 0xFF;
+        const int r1 = src[i + 1] & 0xFF;
+        const int g1 = (src[i + 1] >> 8) & 0xFF;
+        const int b1 = (src[i + 1] >> 16) & 0xFF;
+
+        // The following transformation is a reverse of the one in Y2R using ITU_Rec601
+        const int u = (YuvTable::U(r0, g0, b0) + YuvTable::U(r1, g1, b1)) / 2;
+        const int v = (YuvTable::V(r0, g0, b0) + YuvTable::V(r1, g1, b1)) / 2;
+        dest[i] = clamp(YuvTable::Y(r0, g0, b0)) | (clamp(u) << 8);
+        dest[i + 1] = clamp(YuvTable::Y(r1, g1, b1)) | (clamp(v) << 8);
+    }
+    if (i < src.size()) {
+        dest[i] = 0;
+    }
+}
+
+void ConvertToRgb565(std::span<const u32> src, std::span<u16> dest) {
+    DEBUG_ASSERT(dest.size() >= src.size());
+    std::size_t i = 0;
+#if CITRA_ARCH(x86_64)
+    const auto pack = [](__m128i pixels) {
+        const __m128i r = _mm_slli_epi32(_mm_and_si128(pixels, _mm_set1_epi32(0xF8)), 8);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 5), _mm_set1_epi32(0x7E0));
+        const __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 19), _mm_set1_epi32(0x1F));
+        // Sign-extends the 16-bit results so that the signed pack below keeps them intact.
+        return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(_mm_or_si128(r, g), b), 16), 16);
+    };
+    for (; i + 8 <= src.size(); i += 8) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest.data() + i),
+                         _mm_packs_epi32(pack(lo), pack(hi)));
+    }
+#elif CITRA_ARCH(arm64)
+    for (; i + 4 <= src.size(); i += 4) {
+        const uint32x4_t pixels = vld1q_u32(src.data() + i);
+        const uint32x4_t r = vshlq_n_u32(vandq_u32(pixels, vdupq_n_u32(0xF8)), 8);
+        const uint32x4_t g = vandq_u32(vshrq_n_u32(pixels, 5), vdupq_n_u32(0x7E0));
+        const uint32x4_t b = vandq_u32(vshrq_n_u32(pixels, 19), vdupq_n_u32(0x1F));
+        vst1_u16(dest.data() + i, vmovn_u32(vorrq_u32(vorrq_u32(r, g), b)));
+    }
+#endif
+    ConvertToRgb565Scalar(src.subspan(i), dest.subspan(i));
+}
+
+void ConvertToYuv422(std::span<const u32> src, std::span<u16> dest) {
+    DEBUG_ASSERT(dest.size() >= src.size());
+    std::size_t i = 0;
+#if CITRA_ARCH(x86_64)
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i even_lanes = _mm_setr_epi32(-1, 0, -1, 0);
+    for (; i + 4 <= src.size(); i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i));
+        const __m128i r = _mm_and_si128(pixels, byte_mask);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), byte_mask);
+        const __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 16), byte_mask);
+
+        const __m128i y =
+            _mm_add_epi32(_mm_add_epi32(EvaluateFit(r, Y_R_FIT), EvaluateFit(g, Y_G_FIT)),
+                          EvaluateFit(b, Y_B_FIT));
+        const __m128i u =
+            _mm_sub_epi32(_mm_sub_epi32(EvaluateFit(b, U_B_FIT), EvaluateFit(r, U_R_FIT)),
+                          EvaluateFit(g, U_G_FIT));
+        const __m128i v =
+            _mm_sub_epi32(_mm_sub_epi32(EvaluateFit(r, V_R_FIT), EvaluateFit(g, V_G_FIT)),
+                          EvaluateFit(b, V_B_FIT));
+
+        // Each pixel pair shares its chroma: the first pixel carries U and the second V. Halving
+        // with a shift instead of a division only differs for negative sums, which clamp to zero.
+        const __m128i u_sum = _mm_add_epi32(u, _mm_shuffle_epi32(u, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m128i v_sum = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m128i chroma = _mm_srai_epi32(
+            _mm_or_si128(_mm_and_si128(even_lanes, u_sum), _mm_andnot_si128(even_lanes, v_sum)), 1);
+
+        // The saturating packs clamp both to [0, 255].
+        const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(y, chroma), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest.data() + i),
+                         _mm_unpacklo_epi8(bytes, _mm_srli_si128(bytes, 4)));
+    }
+#elif CITRA_ARCH(arm64)
+    static constexpr std::array<u32, 4> even_lane_mask{0xFFFFFFFF, 0, 0xFFFFFFFF, 0};
+    const uint32x4_t byte_mask = vdupq_n_u32(0xFF);
+    const uint32x4_t even_lanes = vld1q_u32(even_lane_mask.data());
+    for (; i + 4 <= src.size(); i += 4) {
+        const uint32x4_t pixels = vld1q_u32(src.data() + i);
+        const int32x4_t r = vreinterpretq_s32_u32(vandq_u32(pixels, byte_mask));
+        const int32x4_t g = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(pixels, 8), byte_mask));
+        const int32x4_t b = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(pixels, 16), byte_mask));
+
+        const int32x4_t y = vaddq_s32(vaddq_s32(EvaluateFit(r, Y_R_FIT), EvaluateFit(g, Y_G_FIT)),
+                                      EvaluateFit(b, Y_B_FIT));
+        const int32x4_t u = vsubq_s32(vsubq_s32(EvaluateFit(b, U_B_FIT), EvaluateFit(r, U_R_FIT)),
+                                      EvaluateFit(g, U_G_FIT));
+        const int32x4_t v = vsubq_s32(vsubq_s32(EvaluateFit(r, V_R_FIT), EvaluateFit(g, V_G_FIT)),
+                                      EvaluateFit(b, V_B_FIT));
+
+        // Each pixel pair shares its chroma: the first pixel carries U and the second V. Halving
+        // with a shift instead of a division only differs for negative sums, which clamp to zero.
+        const int32x4_t u_sum = vaddq_s32(u, vrev64q_s32(u));
+        const int32x4_t v_sum = vaddq_s32(v, vrev64q_s32(v));
+        const int32x4_t chroma = vshrq_n_s32(vbslq_s32(even_lanes, u_sum, v_sum), 1);
+
+        // The saturating narrows clamp both to [0, 255].
+        const uint8x8_t bytes = vqmovun_s16(vcombine_s16(vqmovn_s32(y), vqmovn_s32(chroma)));
+        vst1_u8(reinterpret_cast<u8*>(dest.data() + i),
+                vzip_u8(bytes, vext_u8(bytes, bytes, 4)).val[0]);
+    }
+#endif
+    ConvertToYuv422Scalar(src.subspan(i), dest.subspan(i));
+}
+
+void ProcessImage(const Rgb888Image& image, const FrameParameters& params, std::span<u16> frame) {
+    const int width = params.width;
+    const int height = params.height;
+    frame = frame.first(static_cast<std::size_t>(width) * height);
+    if (image.data.empty() || image.width <= 0 || image.height <= 0) {
+        std::fill(frame.begin(), frame.end(), u16{0});
+        return;
+    }
+    ASSERT(image.data.size() >= (image.height - 1) * image.stride + image.width * 3);
+
+    // Scales the image to cover the frame, as Qt::KeepAspectRatioByExpanding does, then crops
+    // the centre of it.
+    s64 scaled_width = static_cast<s64>(height) * image.width / image.height;
+    s64 scaled_height = height;
+    if (scaled_width < width) {
+        scaled_width = width;
+        scaled_height = static_cast<s64>(width) * image.height / image.width;
+    }
+    const s64 crop_x = (scaled_width - width) / 2;
+    const s64 crop_y = (scaled_height - height) / 2;
+    const bool unscaled = scaled_width == image.width && scaled_height == image.height;
+
+    std::vector<Sample> columns(width);
+    for (int x = 0; x < width; x++) {
+        const int flipped = params.flip_horizontal ? width - 1 - x : x;
+        const Sample sample = MapCoordinate(flipped + crop_x, scaled_width, image.width);
+        columns[x] = {sample.index0 * 3, sample.index1 * 3, sample.weight};
+    }
+
+    const auto sample_row = [&](int y, u32* dest) {
+        const int flipped = params.flip_vertical ? height - 1 - y : y;
+        const Sample row = MapCoordinate(flipped + crop_y, scaled_height, image.height);
+        const u8* row0 = image.data.data() + row.index0 * image.stride;
+        const u8* row1 = image.data.data() + row.index1 * image.stride;
+        if (unscaled) {
+            for (int x = 0; x < width; x++) {
+                const u8* texel = row0 + columns[x].index0;
+                dest[x] = texel[0] | (texel[1] << 8) | (texel[2] << 16);
+            }
+            return;
+        }
+        for (int x = 0; x < width; x++) {
+            const Sample& column = columns[x];
+            u32 pixel = 0;
+            for (u32 c = 0; c < 3; c++) {
+                const u32 top = row0[column.index0 + c] * (256 - column.weight) +
+                                row0[column.index1 + c] * column.weight;
+                const u32 bottom = row1[column.index0 + c] * (256 - column.weight) +
+                                   row1[column.index1 + c] * column.weight;
+                const u32 value = (top * (256 - row.weight) + bottom * row.weight + 0x8000) >> 16;
+                pixel |= value << (c * 8);
+            }
+            dest[x] = pixel;
+        }
+    };
+
+    // YUV422 pairs pixels across rows when the width is odd, so two rows are converted at once
+    // then.
+    const int rows_per_chunk = width % 2 == 0 ? 1 : 2;
+    std::vector<u32> rgbx(static_cast<std::size_t>(width) * rows_per_chunk);
+    for (int y = 0; y < height; y += rows_per_chunk) {
+        const int rows = std::min(rows_per_chunk, height - y);
+        for (int row = 0; row < rows; row++) {
+            sample_row(y + row, rgbx.data() + row * width);
+        }
+        const auto src = std::span<const u32>(rgbx).first(static_cast<std::size_t>(rows) * width);
+        const auto dest = frame.subspan(static_cast<std::size_t>(y) * width, src.size());
+        if (params.output_rgb) {
+            ConvertToRgb565(src, dest);
+        } else {
+            ConvertToYuv422(src, dest);
+        }
+    }
+}
+
+} // namespace Camera
@@ -0,0 +1,49 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include "common/common_types.h"
+
+namespace Camera {
+
+/// An RGB888 image delivered by a frontend, rows `stride` bytes apart.
+struct Rgb888Image {
+    std::span<const u8> data;
+    int width;
+    int height;
+    std::size_t stride;
+};
+
+/// Layout of the frames sent to the CAM service.
+struct FrameParameters {
+    int width;
+    int height;
+    bool output_rgb;
+    bool flip_horizontal;
+    bool flip_vertical;
+};
+
+/**
+ * Scales the image to cover the frame while keeping its aspect ratio, crops the centre of it,
+ * applies the flips and converts it to RGB565 or YUV422.
+ * @param frame Destination of width * height pixels. It is zeroed if the image is empty.
+ */
+void ProcessImage(const Rgb888Image& image, const FrameParameters& params, std::span<u16> frame);
+
+/// Converts RGBX8888 pixels, red in the lowest byte, to RGB565.
+void ConvertToRgb565(std::span<const u32> src, std::span<u16> dest);
+
+/**
+ * Converts RGBX8888 pixels, red in the lowest byte, to YUV422. Each pair of pixels shares its
+ * averaged U and V values. An unpaired last pixel is written as zero.
+ */
+void ConvertToYuv422(std::span<const u32> src, std::span<u16> dest);
+
+/// Table-driven versions of the conversions above, used for the tails of the SIMD loops.
+void ConvertToRgb565Scalar(std::span<const u32> src, std::span<u16> dest);
+void ConvertToYuv422Scalar(std::span<const u32> src, std::span<u16> dest);
+
+} // namespace Camera
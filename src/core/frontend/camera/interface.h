@@ -67,6 +67,13 @@ public:
      */
     virtual std::vector<u16> ReceiveFrame() = 0;
 
+    /**
+     * Receives a frame from the camera into the given buffer, reusing its storage. The default
+     * implementation forwards to ReceiveFrame.
+     * @param frame Buffer resized to width * height and filled with the pixels of the frame
+     */
+    virtual void ReceiveFrameInto(std::vector<u16>& frame);
+
     /**
      * Test if the camera is opened successfully and can receive a preview frame. Only used for
      * preview. This function should be only called between a StartCapture call and a StopCapture
@@ -416,6 +416,9 @@ static void RemoveBreakpoint(BreakpointType type, VAddr addr) {
         for (u32 i = 0; i < num_cores; ++i) {
             Core::GetCore(i).ClearInstructionCache();
         }
+    } else {
+        Core::System::GetInstance().Memory().SetRegionWatched(bp->second.addr, bp->second.len,
+                                                              false);
     }
     p.erase(addr);
 }
@@ -442,11 +445,13 @@ bool CheckBreakpoint(VAddr addr, BreakpointType type) {
     }
 
     const BreakpointMap& p = GetBreakpointMap(type);
-    const auto bp = p.find(addr);
 
-    if (bp == p.end()) {
+    // Watchpoints cover a range, so look at the closest one starting at or before the address.
+    auto bp = p.upper_bound(addr);
+    if (bp == p.begin()) {
         return false;
     }
+    --bp;
 
     u32 len = bp->second.len;
 
@@ -938,8 +943,14 @@ static bool CommitBreakpoint(BreakpointType type, VAddr addr, u32 len) {
             *Core::System::GetInstance().Kernel().GetCurrentProcess(), addr, btrap.data(),
             btrap.size());
         Core::GetRunningCore().ClearInstructionCache();
+    } else {
+        // Keep the JIT from accessing the watched pages directly, so the access can be checked.
+        if (const auto it = p.find(addr); it != p.end()) {
+            Core::System::GetInstance().Memory().SetRegionWatched(addr, it->second.len, false);
+        }
+        Core::System::GetInstance().Memory().SetRegionWatched(addr, len, true);
     }
-    p.insert({addr, breakpoint});
+    p.insert_or_assign(addr, breakpoint);
 
     LOG_DEBUG(Debug_GDBStub, "gdb: added {} breakpoint: {:08x} bytes at {:08x}\n", type,
               breakpoint.len, breakpoint.addr);
@@ -1157,6 +1168,11 @@ static void Init(u16 port) {
     halt_loop = true;
     step_loop = false;
 
+    for (const auto* watchpoints : {&breakpoints_read, &breakpoints_write}) {
+        for (const auto& [addr, watchpoint] : *watchpoints) {
+            Core::System::GetInstance().Memory().SetRegionWatched(addr, watchpoint.len, false);
+        }
+    }
     breakpoints_execute.clear();
     breakpoints_read.clear();
     breakpoints_write.clear();
@@ -18,6 +18,7 @@
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
+#include "core/memory.h"
 
 SERIALIZE_EXPORT_IMPL(Kernel::SessionRequestHandler)
 SERIALIZE_EXPORT_IMPL(Kernel::SessionRequestHandler::SessionDataBase)
@@ -359,4 +360,15 @@ void MappedBuffer::Write(const void* src_buffer, std::size_t offset, std::size_t
     memory->WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
 }
 
+ResultVal<std::vector<std::pair<MemoryRef, u32>>> MappedBuffer::GetBackingBlocks() {
+    ASSERT(perms & IPC::W);
+    return process->vm_manager.GetBackingBlocksForRange(address, size);
+}
+
+void MappedBuffer::PrepareDirectWrite(std::size_t size) {
+    ASSERT(size <= this->size);
+    memory->RasterizerFlushVirtualRegion(address, static_cast<u32>(size),
+                                         Memory::FlushMode::Invalidate);
+}
+
 } // namespace Kernel
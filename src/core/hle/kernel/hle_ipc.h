@@ -14,6 +14,7 @@
 #include <boost/container/small_vector.hpp>
 #include <boost/serialization/export.hpp>
 #include "common/common_types.h"
+#include "common/memory_ref.h"
 #include "common/serialization/boost_small_vector.hpp"
 #include "common/settings.h"
 #include "common/swap.h"
@@ -127,6 +128,17 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+
+    /**
+     * Returns the host memory backing the buffer, so that it can be written in place without an
+     * intermediate copy. PrepareDirectWrite must be called before the data is written, on the
+     * emulation thread.
+     */
+    ResultVal<std::vector<std::pair<MemoryRef, u32>>> GetBackingBlocks();
+
+    /// Invalidates the rasterizer cache over the first size bytes about to be written in place.
+    void PrepareDirectWrite(std::size_t size);
+
     std::size_t GetSize() const {
         return size;
     }
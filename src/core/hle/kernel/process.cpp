@@ -311,8 +311,7 @@ Result Process::HeapAllocate(VAddr* out_addr, VAddr target, u32 size, VMAPermiss
         u32 interval_size = interval.upper() - interval.lower();
         LOG_DEBUG(Kernel, "Allocated FCRAM region lower={:08X}, upper={:08X}", interval.lower(),
                   interval.upper());
-        std::fill(kernel.memory.GetFCRAMPointer(interval.lower()),
-                  kernel.memory.GetFCRAMPointer(interval.upper()), 0);
+        kernel.memory.ClearFCRAM(interval.lower(), interval_size);
         auto vma = vm_manager.MapBackingMemory(interval_target,
                                                kernel.memory.GetFCRAMRef(interval.lower()),
                                                interval_size, memory_state);
@@ -390,7 +389,7 @@ Result Process::LinearAllocate(VAddr* out_addr, VAddr target, u32 size, VMAPermi
 
     auto backing_memory = kernel.memory.GetFCRAMRef(physical_offset);
 
-    std::fill(backing_memory.GetPtr(), backing_memory.GetPtr() + size, 0);
+    kernel.memory.ClearFCRAM(physical_offset, size);
     auto vma = vm_manager.MapBackingMemory(target, backing_memory, size, MemoryState::Continuous);
     ASSERT(vma.Succeeded());
     vm_manager.Reprotect(vma.Unwrap(), perms);
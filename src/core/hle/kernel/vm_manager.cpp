@@ -383,7 +383,7 @@ ResultVal<std::vector<std::pair<MemoryRef, u32>>> VMManager::GetBackingBlocksFor
     while (interval_target != address + size) {
         auto vma = FindVMA(interval_target);
         if (vma->second.type != VMAType::BackingMemory) {
-            LOG_ERROR(Kernel, "Trying to use already freed memory");
+            LOG_DEBUG(Kernel, "Trying to use already freed memory");
             return ResultInvalidAddressState;
         }
 
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
+#include <span>
 #include "common/archives.h"
 #include "common/bit_set.h"
 #include "common/logging/log.h"
@@ -27,6 +29,12 @@ namespace Service::CAM {
 template <class Archive>
 void Module::serialize(Archive& ar, const unsigned int file_version) {
     DEBUG_SERIALIZATION_POINT;
+    if (Archive::is_loading::value) {
+        // Captures in flight write into the ports being replaced, so let them finish first.
+        for (std::size_t i = 0; i < ports.size(); i++) {
+            WaitForCapture(static_cast<int>(i));
+        }
+    }
     ar & cameras;
     ar & ports;
     ar & is_camera_reload_pending;
@@ -101,63 +109,87 @@ void Module::PortConfig::Clear() {
 
 void Module::CompletionEventCallBack(u64 port_id, s64) {
     PortConfig& port = ports[port_id];
-    const CameraConfig& camera = cameras[port.camera_id];
-    const auto buffer = port.capture_result.get();
-
-    if (port.is_trimming) {
-        u32 trim_width;
-        u32 trim_height;
-        const int original_width = camera.contexts[camera.current_context].resolution.width;
-        const int original_height = camera.contexts[camera.current_context].resolution.height;
-        if (port.x1 <= port.x0 || port.y1 <= port.y0 || port.x1 > original_width ||
-            port.y1 > original_height) {
-            LOG_ERROR(Service_CAM, "Invalid trimming coordinates x0={}, y0={}, x1={}, y1={}",
-                      port.x0, port.y0, port.x1, port.y1);
-            trim_width = 0;
-            trim_height = 0;
-        } else {
-            trim_width = port.x1 - port.x0;
-            trim_height = port.y1 - port.y0;
-        }
+    WaitForCapture(static_cast<int>(port_id));
 
-        u32 trim_size = (port.x1 - port.x0) * (port.y1 - port.y0) * 2;
-        if (port.dest_size != trim_size) {
-            LOG_ERROR(Service_CAM, "The destination size ({}) doesn't match the source ({})!",
-                      port.dest_size, trim_size);
-        }
+    // The next capture goes into the other frame, leaving this one to be copied.
+    const std::vector<u16>& frame = port.frames[port.capture_frame];
+    port.capture_frame ^= 1;
+    WriteFrame(static_cast<int>(port_id), frame);
 
-        const u32 src_offset = port.y0 * original_width + port.x0;
-        const u16* src_ptr = buffer.data() + src_offset;
-        // Note: src_size_left is int because it can be negative if the buffer size doesn't match.
-        int src_size_left = static_cast<int>((buffer.size() - src_offset) * sizeof(u16));
-        VAddr dest_ptr = port.dest;
-        // Note: dest_size_left and line_bytes are int to match the type of src_size_left.
-        int dest_size_left = static_cast<int>(port.dest_size);
-        const int line_bytes = static_cast<int>(trim_width * sizeof(u16));
-
-        for (u32 y = 0; y < trim_height; ++y) {
-            int copy_length = std::min({line_bytes, dest_size_left, src_size_left});
-            if (copy_length <= 0) {
-                break;
-            }
-            system.Memory().WriteBlock(*port.dest_process, dest_ptr, src_ptr, copy_length);
-            dest_ptr += copy_length;
-            dest_size_left -= copy_length;
-            src_ptr += original_width;
-            src_size_left -= original_width * sizeof(u16);
-        }
-    } else {
+    port.is_receiving = false;
+    port.completion_event->Signal();
+}
+
+void Module::WriteFrame(int port_id, const std::vector<u16>& buffer) {
+    PortConfig& port = ports[port_id];
+    const CameraConfig& camera = cameras[port.camera_id];
+    auto& memory = system.Memory();
+
+    if (!port.is_trimming) {
         std::size_t buffer_size = buffer.size() * sizeof(u16);
         if (port.dest_size != buffer_size) {
             LOG_ERROR(Service_CAM, "The destination size ({}) doesn't match the source ({})!",
                       port.dest_size, buffer_size);
         }
-        system.Memory().WriteBlock(*port.dest_process, port.dest, buffer.data(),
-                                   std::min<std::size_t>(port.dest_size, buffer_size));
+        memory.WriteBlock(*port.dest_process, port.dest, buffer.data(),
+                          std::min<std::size_t>(port.dest_size, buffer_size));
+        return;
     }
 
-    port.is_receiving = false;
-    port.completion_event->Signal();
+    u32 trim_width;
+    u32 trim_height;
+    const int original_width = camera.contexts[camera.current_context].resolution.width;
+    const int original_height = camera.contexts[camera.current_context].resolution.height;
+    if (port.x1 <= port.x0 || port.y1 <= port.y0 || port.x1 > original_width ||
+        port.y1 > original_height) {
+        LOG_ERROR(Service_CAM, "Invalid trimming coordinates x0={}, y0={}, x1={}, y1={}", port.x0,
+                  port.y0, port.x1, port.y1);
+        trim_width = 0;
+        trim_height = 0;
+    } else {
+        trim_width = port.x1 - port.x0;
+        trim_height = port.y1 - port.y0;
+    }
+
+    u32 trim_size = (port.x1 - port.x0) * (port.y1 - port.y0) * 2;
+    if (port.dest_size != trim_size) {
+        LOG_ERROR(Service_CAM, "The destination size ({}) doesn't match the source ({})!",
+                  port.dest_size, trim_size);
+    }
+
+    // The rows are gathered straight into guest memory when the destination is contiguous in
+    // host memory, otherwise into a staging buffer written with a single WriteBlock.
+    std::span<u8> dest = memory.GetWritableSpan(*port.dest_process, port.dest, port.dest_size);
+    const bool is_staged = dest.empty();
+    if (is_staged) {
+        port.trim_buffer.resize(port.dest_size);
+        dest = port.trim_buffer;
+    }
+
+    const u32 src_offset = port.y0 * original_width + port.x0;
+    const u16* src_ptr = buffer.data() + src_offset;
+    // Note: src_size_left is int because it can be negative if the buffer size doesn't match.
+    int src_size_left = static_cast<int>((buffer.size() - src_offset) * sizeof(u16));
+    std::size_t dest_offset = 0;
+    // Note: dest_size_left and line_bytes are int to match the type of src_size_left.
+    int dest_size_left = static_cast<int>(port.dest_size);
+    const int line_bytes = static_cast<int>(trim_width * sizeof(u16));
+
+    for (u32 y = 0; y < trim_height; ++y) {
+        int copy_length = std::min({line_bytes, dest_size_left, src_size_left});
+        if (copy_length <= 0) {
+            break;
+        }
+        std::memcpy(dest.data() + dest_offset, src_ptr, copy_length);
+        dest_offset += copy_length;
+        dest_size_left -= copy_length;
+        src_ptr += original_width;
+        src_size_left -= original_width * sizeof(u16);
+    }
+
+    if (is_staged) {
+        memory.WriteBlock(*port.dest_process, port.dest, dest.data(), dest_offset);
+    }
 }
 
 static constexpr std::size_t MaxVsyncTimings = 5;
@@ -185,16 +217,20 @@ void Module::StartReceiving(int port_id) {
     PortConfig& port = ports[port_id];
     port.is_receiving = true;
 
-    // launches a capture task asynchronously
+    // queues a capture task on the capture worker
     CameraConfig& camera = cameras[port.camera_id];
-    port.capture_result = std::async(std::launch::async, [&camera, &port, this] {
+    std::vector<u16>& frame = port.frames[port.capture_frame];
+    port.is_capturing = true;
+    capture_worker.QueueWork([&camera, &port, &frame, this] {
         if (is_camera_reload_pending.exchange(false)) {
             // reinitialize the camera according to new settings
             camera.impl->StopCapture();
             LoadCameraImplementation(camera, port.camera_id);
             camera.impl->StartCapture();
         }
-        return camera.impl->ReceiveFrame();
+        camera.impl->ReceiveFrameInto(frame);
+        port.is_capturing = false;
+        port.is_capturing.notify_all();
     });
 
     // schedules a completion event according to the frame rate. The event will block on the
@@ -209,10 +245,14 @@ void Module::CancelReceiving(int port_id) {
         return;
     LOG_WARNING(Service_CAM, "tries to cancel an ongoing receiving process.");
     system.CoreTiming().UnscheduleEvent(completion_event_callback, port_id);
-    ports[port_id].capture_result.wait();
+    WaitForCapture(port_id);
     ports[port_id].is_receiving = false;
 }
 
+void Module::WaitForCapture(int port_id) {
+    ports[port_id].is_capturing.wait(true);
+}
+
 void Module::ActivatePort(int port_id, int camera_id) {
     if (ports[port_id].is_busy && ports[port_id].camera_id != camera_id) {
         CancelReceiving(port_id);
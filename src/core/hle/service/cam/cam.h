@@ -5,8 +5,8 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <deque>
-#include <future>
 #include <memory>
 #include <vector>
 #include <boost/serialization/array.hpp>
@@ -16,6 +16,7 @@
 #include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/global.h"
 #include "core/hle/result.h"
 #include "core/hle/service/cam/cam_params.h"
@@ -643,6 +644,12 @@ private:
     // and is_receiving = false.
     void StartReceiving(int port_id);
 
+    // Blocks until the capture worker is done with the specified port.
+    void WaitForCapture(int port_id);
+
+    // Copies the captured frame of the specified port to its destination in guest memory.
+    void WriteFrame(int port_id, const std::vector<u16>& frame);
+
     // Cancels any ongoing receiving processes at the specified port. This is used by functions that
     // stop capturing.
     // TODO: what is the exact behaviour on real 3DS when stopping capture during an ongoing
@@ -716,7 +723,12 @@ private:
 
         std::deque<s64> vsync_timings;
 
-        std::future<std::vector<u16>> capture_result; // will hold the received frame.
+        // Frames filled by the capture worker, alternately so that a new capture never writes
+        // into the frame being copied to the guest.
+        std::array<std::vector<u16>, 2> frames;
+        std::size_t capture_frame{0}; // index of the frame the ongoing capture writes into.
+        std::atomic<bool> is_capturing{false}; // set while the capture worker fills a frame.
+        std::vector<u8> trim_buffer; // staging for trimmed frames when dest isn't contiguous.
         Kernel::Process* dest_process{nullptr};
         VAddr dest{0};    // the destination address of the receiving process
         u32 dest_size{0}; // the destination size of the receiving process
@@ -741,7 +753,7 @@ private:
             ar & buffer_error_interrupt_event;
             ar & vsync_interrupt_event;
             ar & vsync_timings;
-            // Ignore capture_result. In-progress captures might be affected but this is OK.
+            // Ignore the frames. In-progress captures might be affected but this is OK.
             ar & dest_process;
             ar & dest;
             ar & dest_size;
@@ -759,6 +771,10 @@ private:
     Core::TimingEventType* vsync_interrupt_event_callback;
     std::atomic<bool> is_camera_reload_pending{false};
 
+    // Runs the captures, one thread per port. Declared last so that it stops before the state
+    // its tasks refer to is destroyed.
+    Common::ThreadWorker capture_worker{2, "CAM:Capture"};
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version);
     friend class boost::serialization::access;
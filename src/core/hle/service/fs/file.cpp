@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <boost/serialization/unique_ptr.hpp>
 #include "common/archives.h"
 #include "common/logging/log.h"
@@ -53,6 +54,52 @@ File::File(Kernel::KernelSystem& kernel)
     RegisterHandlers(functions);
 }
 
+namespace {
+
+/// Reads larger than this are not read ahead.
+constexpr u32 MAX_READAHEAD_LENGTH = 16 * 1024;
+
+/// Amount of data read at once when reading ahead.
+constexpr u64 READAHEAD_SIZE = 128 * 1024;
+
+/// Number of consecutive sequential reads after which a file is read ahead.
+constexpr u32 SEQUENTIAL_READ_THRESHOLD = 2;
+
+/// Reads from a file backend straight into the memory backing a guest buffer.
+ResultVal<std::size_t> ReadToBlocks(FileSys::FileBackend& backend, u64 offset, u32 length,
+                                    std::vector<std::pair<MemoryRef, u32>>& blocks) {
+    std::size_t total = 0;
+    for (auto& [block, block_size] : blocks) {
+        const u32 to_read = std::min<u32>(block_size, length - static_cast<u32>(total));
+        if (to_read == 0) {
+            break;
+        }
+        const auto read = backend.Read(offset + total, to_read, block.GetPtr());
+        if (read.Failed()) {
+            return read.Code();
+        }
+        total += *read;
+        if (*read < to_read) {
+            break;
+        }
+    }
+    return total;
+}
+
+} // Anonymous namespace
+
+bool File::UpdateReadahead(u64 offset, u32 length) {
+    if (offset == readahead.next_offset) {
+        readahead.sequential_reads++;
+    } else {
+        readahead.sequential_reads = 0;
+    }
+    readahead.next_offset = offset + length;
+
+    return length <= MAX_READAHEAD_LENGTH &&
+           readahead.sequential_reads >= SEQUENTIAL_READ_THRESHOLD;
+}
+
 void File::Read(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
     u64 offset = rp.Pop<u64>();
@@ -75,17 +122,28 @@ void File::Read(Kernel::HLERequestContext& ctx) {
                   offset, length, backend->GetSize());
     }
 
+    auto& buffer = rp.PopMappedBuffer();
+
     // Conventional reading if the backend does not support cache.
     if (!backend->AllowsCachedReads()) {
-        auto& buffer = rp.PopMappedBuffer();
         IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-        std::unique_ptr<u8[]> data = std::make_unique_for_overwrite<u8[]>(length);
-        const auto read = backend->Read(offset, length, data.get());
+        // Read straight into the guest pages where possible, instead of going through a copy.
+        auto blocks = buffer.GetBackingBlocks();
+        ResultVal<std::size_t> read = 0;
+        if (blocks.Succeeded()) {
+            buffer.PrepareDirectWrite(length);
+            read = ReadToBlocks(*backend, offset, length, *blocks);
+        } else {
+            std::unique_ptr<u8[]> data = std::make_unique_for_overwrite<u8[]>(length);
+            read = backend->Read(offset, length, data.get());
+            if (read.Succeeded()) {
+                buffer.Write(data.get(), 0, *read);
+            }
+        }
         if (read.Failed()) {
             rb.Push(read.Code());
             rb.Push<u32>(0);
         } else {
-            buffer.Write(data.get(), 0, *read);
             rb.Push(ResultSuccess);
             rb.Push<u32>(static_cast<u32>(*read));
         }
@@ -96,25 +154,57 @@ void File::Read(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    // Files that can be written through another handle are not read ahead, as a write there would
+    // not drop this handle's buffer.
+    const bool read_ahead = backend->IsReadOnly() && UpdateReadahead(offset, length);
+
+    // Small sequential reads that were already read ahead are answered right away.
+    if (read_ahead && readahead.Contains(offset, length)) {
+        buffer.Write(readahead.buffer.data() + (offset - readahead.buffer_offset), 0, length);
+
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+        rb.Push(ResultSuccess);
+        rb.Push<u32>(length);
+        rb.PushMappedBuffer(buffer);
+
+        std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
+        ctx.SleepClientThread("file::read", read_timeout_ns, nullptr);
+        return;
+    }
+
+    // The read runs on a worker thread, so it goes through a request owned buffer and only the
+    // emulation thread writes it to guest memory.
     struct AsyncData {
         // Input
         u32 length;
         u64 offset;
+        u64 read_length;
         std::chrono::steady_clock::time_point pre_timer;
         bool cache_ready;
+        bool read_ahead;
 
         // Output
         Result ret{0};
         Kernel::MappedBuffer* buffer;
-        std::unique_ptr<u8[]> data;
+        std::vector<u8> data;
         std::size_t read_size;
     };
 
     auto async_data = std::make_shared<AsyncData>();
-    async_data->buffer = &rp.PopMappedBuffer();
+    async_data->buffer = &buffer;
     async_data->length = length;
     async_data->offset = offset;
-    async_data->cache_ready = backend->CacheReady(offset, length);
+    async_data->read_ahead = read_ahead;
+    if (read_ahead) {
+        // Read ahead into a buffer owned by the request, which becomes the file's readahead buffer
+        // once the request completes on the emulation thread.
+        const u64 file_size = backend->GetSize();
+        const u64 remaining = file_size > offset ? file_size - offset : 0;
+        async_data->read_length = std::max<u64>(length, std::min(READAHEAD_SIZE, remaining));
+    } else {
+        async_data->read_length = length;
+    }
+    async_data->cache_ready = backend->CacheReady(offset, async_data->read_length);
     if (!async_data->cache_ready) {
         async_data->pre_timer = std::chrono::steady_clock::now();
     }
@@ -122,9 +212,9 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     // LOG_DEBUG(Service_FS, "cache={}, offset={}, length={}", cache_ready, offset, length);
     ctx.RunAsync(
         [this, async_data](Kernel::HLERequestContext& ctx) {
-            async_data->data = std::make_unique_for_overwrite<u8[]>(async_data->length);
-            const auto read =
-                backend->Read(async_data->offset, async_data->length, async_data->data.get());
+            async_data->data.resize(async_data->read_length);
+            const auto read = backend->Read(async_data->offset, async_data->data.size(),
+                                            async_data->data.data());
             if (read.Failed()) {
                 async_data->ret = read.Code();
                 async_data->read_size = 0;
@@ -149,16 +239,24 @@ void File::Read(Kernel::HLERequestContext& ctx) {
                 return static_cast<s64>(read_delay);
             }
         },
-        [async_data](Kernel::HLERequestContext& ctx) {
+        [this, async_data](Kernel::HLERequestContext& ctx) {
             IPC::RequestBuilder rb(ctx, 0x0802, 2, 2);
             if (async_data->ret.IsError()) {
                 rb.Push(async_data->ret);
                 rb.Push<u32>(0);
-            } else {
-                async_data->buffer->Write(async_data->data.get(), 0, async_data->read_size);
-                rb.Push(ResultSuccess);
-                rb.Push<u32>(static_cast<u32>(async_data->read_size));
+                rb.PushMappedBuffer(*async_data->buffer);
+                return;
             }
+
+            const auto read_size = std::min<std::size_t>(async_data->read_size, async_data->length);
+            async_data->buffer->Write(async_data->data.data(), 0, read_size);
+            if (async_data->read_ahead) {
+                async_data->data.resize(async_data->read_size);
+                readahead.buffer_offset = async_data->offset;
+                readahead.buffer = std::move(async_data->data);
+            }
+            rb.Push(ResultSuccess);
+            rb.Push<u32>(static_cast<u32>(read_size));
             rb.PushMappedBuffer(*async_data->buffer);
         },
         !async_data->cache_ready);
@@ -186,6 +284,9 @@ void File::Write(Kernel::HLERequestContext& ctx) {
     }
     bool flush = (flags & 0xFF) != 0, update_timestamp = (flags & 0xFF00) != 0;
 
+    // Data read ahead may be overwritten
+    readahead = {};
+
     if (!backend->AllowsCachedReads()) {
         std::vector<u8> data(length);
         buffer.Read(data.data(), 0, data.size());
@@ -274,6 +375,8 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    readahead = {};
+
     if (!backend->AllowsCachedReads()) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
         file->size = size;
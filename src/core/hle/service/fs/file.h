@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <boost/serialization/base_object.hpp>
 #include "core/file_sys/archive_backend.h"
 #include "core/global.h"
@@ -73,7 +74,23 @@ private:
     void OpenLinkFile(Kernel::HLERequestContext& ctx);
     void OpenSubFile(Kernel::HLERequestContext& ctx);
 
+    /// Data read ahead of sequential reads from read-only backends that allow cached reads.
+    struct Readahead {
+        u64 next_offset{};      ///< Offset right after the previous read
+        u32 sequential_reads{}; ///< Number of consecutive reads continuing the previous one
+        u64 buffer_offset{};    ///< Offset of the buffered data
+        std::vector<u8> buffer;
+
+        bool Contains(u64 offset, u32 length) const {
+            return offset >= buffer_offset && offset + length <= buffer_offset + buffer.size();
+        }
+    };
+
+    /// Tracks whether a read continues the previous one, returning whether it should be read ahead.
+    bool UpdateReadahead(u64 offset, u32 length);
+
     Kernel::KernelSystem& kernel;
+    Readahead readahead;
 
     File(Kernel::KernelSystem& kernel);
     File();
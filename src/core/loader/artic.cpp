@@ -776,12 +776,22 @@ ResultStatus Apploader_Artic::ReadExtdataId(u64& out_extdata_id) {
 }
 
 ResultStatus Apploader_Artic::ReadRomFS(std::shared_ptr<FileSys::RomFSReader>& romfs_file) {
-    main_romfs_reader = romfs_file = std::make_shared<FileSys::ArticRomFSReader>(client, false);
+    u64 program_id = 0;
+    ReadProgramId(program_id);
+    Service::FS::FS_USER::ProductInfo product_info{};
+    LoadProductInfo(product_info);
+    main_romfs_reader = romfs_file = std::make_shared<FileSys::ArticRomFSReader>(
+        client, false, program_id, product_info.remaster_version);
     return static_cast<FileSys::ArticRomFSReader*>(romfs_file.get())->OpenStatus();
 }
 
 ResultStatus Apploader_Artic::ReadUpdateRomFS(std::shared_ptr<FileSys::RomFSReader>& romfs_file) {
-    update_romfs_reader = romfs_file = std::make_shared<FileSys::ArticRomFSReader>(client, true);
+    u64 program_id = 0;
+    ReadProgramId(program_id);
+    Service::FS::FS_USER::ProductInfo product_info{};
+    LoadProductInfo(product_info);
+    update_romfs_reader = romfs_file = std::make_shared<FileSys::ArticRomFSReader>(
+        client, true, program_id, product_info.remaster_version);
     return static_cast<FileSys::ArticRomFSReader*>(romfs_file.get())->OpenStatus();
 }
 
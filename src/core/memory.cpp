@@ -4,6 +4,7 @@
 
 #include <array>
 #include <cstring>
+#include <unordered_map>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/binary_object.hpp>
 #include "audio_core/dsp_interface.h"
@@ -11,6 +12,7 @@
 #include "common/assert.h"
 #include "common/atomic_ops.h"
 #include "common/common_types.h"
+#include "common/cow_memory.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "common/swap.h"
@@ -86,17 +88,23 @@ private:
 
 class MemorySystem::Impl {
 public:
-    // Visual Studio would try to allocate these on compile time
-    // if they are std::array which would exceed the memory limit.
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
+    // Guest RAM is lazily committed by the host, so the New 3DS sized FCRAM only takes up
+    // physical memory for the pages the emulated software actually touches.
+    Common::CowMemory fcram{Memory::FCRAM_N3DS_SIZE, true};
+    Common::CowMemory vram{Memory::VRAM_SIZE, true};
+    Common::CowMemory n3ds_extra_ram{Memory::N3DS_EXTRA_RAM_SIZE};
+
+    /// Guest RAM is left out of the archive for in-memory snapshots, which capture it separately.
+    bool serialize_ram = true;
 
     Core::System& system;
     std::shared_ptr<PageTable> current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
     std::vector<std::shared_ptr<PageTable>> page_table_list;
 
+    /// Number of debugger watches covering each watched virtual page.
+    std::unordered_map<u32, u32> watched_pages;
+
     AudioCore::DspInterface* dsp = nullptr;
 
     std::shared_ptr<BackingMem> fcram_mem;
@@ -109,28 +117,41 @@ public:
     const u8* GetPtr(Region r) const {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram.data();
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram.data();
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram.data();
         default:
             UNREACHABLE();
         }
     }
 
+    bool IsPageWatched(u32 page) const {
+        return watched_pages.contains(page);
+    }
+
+    /// Hides the watched pages of a page table from the JIT.
+    void ApplyWatches(PageTable& page_table) {
+        for (const auto& [page, count] : watched_pages) {
+            if (page_table.attributes[page] == PageType::Memory) {
+                page_table.pointers.SetHidden(page, true);
+            }
+        }
+    }
+
     u8* GetPtr(Region r) {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram.data();
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram.data();
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram.data();
         default:
             UNREACHABLE();
         }
@@ -180,9 +201,9 @@ public:
                 break;
             }
             case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
+                DEBUG_ASSERT(page_table.pointers.GetBacking(page_index));
 
-                const u8* src_ptr = page_table.pointers[page_index] + page_offset;
+                const u8* src_ptr = page_table.pointers.GetBacking(page_index) + page_offset;
                 std::memcpy(dest_buffer, src_ptr, copy_amount);
                 break;
             }
@@ -228,9 +249,9 @@ public:
                 break;
             }
             case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
+                DEBUG_ASSERT(page_table.pointers.GetBacking(page_index));
 
-                u8* dest_ptr = page_table.pointers[page_index] + page_offset;
+                u8* dest_ptr = page_table.pointers.GetBacking(page_index) + page_offset;
                 std::memcpy(dest_ptr, src_buffer, copy_amount);
                 break;
             }
@@ -317,13 +338,21 @@ private:
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version) {
-        bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
-        ar & save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+        if (serialize_ram) {
+            bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
+            ar & save_n3ds_ram;
+            ar& boost::serialization::make_binary_object(vram.data(), Memory::VRAM_SIZE);
+            ar& boost::serialization::make_binary_object(
+                fcram.data(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
+            ar& boost::serialization::make_binary_object(
+                n3ds_extra_ram.data(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+            if (Archive::is_loading::value && !save_n3ds_ram) {
+                // The memory outlives loads, so clear what an O3DS state does not cover instead
+                // of leaving the previous session's data there.
+                fcram.Clear(Memory::FCRAM_SIZE, Memory::FCRAM_N3DS_SIZE - Memory::FCRAM_SIZE);
+                n3ds_extra_ram.Clear(0, Memory::N3DS_EXTRA_RAM_SIZE);
+            }
+        }
         ar & cache_marker;
         ar & page_table_list;
         // dsp is set from Core::System at startup
@@ -332,6 +361,12 @@ private:
         ar & vram_mem;
         ar & n3ds_extra_ram_mem;
         ar & dsp_mem;
+        if (Archive::is_loading::value) {
+            // Debugger watches are not saved, but outlive the page tables being replaced.
+            for (auto& page_table : page_table_list) {
+                ApplyWatches(*page_table);
+            }
+        }
     }
 };
 
@@ -411,6 +446,8 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
         if (type == PageType::Memory && impl->cache_marker.IsCached(base * CITRA_PAGE_SIZE)) {
             page_table.attributes[base] = PageType::RasterizerCachedMemory;
             page_table.pointers[base] = nullptr;
+        } else if (type == PageType::Memory && impl->IsPageWatched(base)) {
+            page_table.pointers.SetHidden(base, true);
         }
 
         base += 1;
@@ -437,6 +474,7 @@ MemoryRef MemorySystem::GetPointerForRasterizerCache(VAddr addr) const {
 }
 
 void MemorySystem::RegisterPageTable(std::shared_ptr<PageTable> page_table) {
+    impl->ApplyWatches(*page_table);
     impl->page_table_list.push_back(page_table);
 }
 
@@ -478,9 +516,14 @@ T MemorySystem::Read(const std::shared_ptr<PageTable>& page_table, const VAddr v
         LOG_ERROR(HW_Memory, "unmapped Read{} @ 0x{:08X} at PC 0x{:08X}", sizeof(T) * 8, vaddr,
                   impl->GetPC());
         return 0;
-    case PageType::Memory:
-        ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
-        break;
+    case PageType::Memory: {
+        // Watched page hidden from the JIT
+        const u8* backing = page_table->pointers.GetBacking(vaddr >> CITRA_PAGE_BITS);
+        ASSERT_MSG(backing, "Mapped memory page without a pointer @ {:08X}", vaddr);
+        T value;
+        std::memcpy(&value, &backing[vaddr & CITRA_PAGE_MASK], sizeof(T));
+        return value;
+    }
     case PageType::RasterizerCachedMemory: {
         RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Flush);
 
@@ -528,9 +571,13 @@ void MemorySystem::Write(const std::shared_ptr<PageTable>& page_table, const VAd
         LOG_ERROR(HW_Memory, "unmapped Write{} 0x{:08X} @ 0x{:08X} at PC 0x{:08X}",
                   sizeof(data) * 8, (u32)data, vaddr, impl->GetPC());
         return;
-    case PageType::Memory:
-        ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
+    case PageType::Memory: {
+        // Watched page hidden from the JIT
+        u8* backing = page_table->pointers.GetBacking(vaddr >> CITRA_PAGE_BITS);
+        ASSERT_MSG(backing, "Mapped memory page without a pointer @ {:08X}", vaddr);
+        std::memcpy(&backing[vaddr & CITRA_PAGE_MASK], &data, sizeof(T));
         break;
+    }
     case PageType::RasterizerCachedMemory: {
         RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Invalidate);
         std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
@@ -557,9 +604,14 @@ bool MemorySystem::WriteExclusive(const VAddr vaddr, const T data, const T expec
         LOG_ERROR(HW_Memory, "unmapped Write{} 0x{:08X} @ 0x{:08X} at PC 0x{:08X}",
                   sizeof(data) * 8, static_cast<u32>(data), vaddr, impl->GetPC());
         return true;
-    case PageType::Memory:
-        ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
-        return true;
+    case PageType::Memory: {
+        // Watched page hidden from the JIT
+        u8* backing = impl->current_page_table->pointers.GetBacking(vaddr >> CITRA_PAGE_BITS);
+        ASSERT_MSG(backing, "Mapped memory page without a pointer @ {:08X}", vaddr);
+        const auto volatile_pointer =
+            reinterpret_cast<volatile T*>(&backing[vaddr & CITRA_PAGE_MASK]);
+        return Common::AtomicCompareAndSwap(volatile_pointer, data, expected);
+    }
     case PageType::RasterizerCachedMemory: {
         RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Invalidate);
         const auto volatile_pointer =
@@ -575,7 +627,7 @@ bool MemorySystem::WriteExclusive(const VAddr vaddr, const T data, const T expec
 bool MemorySystem::IsValidVirtualAddress(const Kernel::Process& process, const VAddr vaddr) {
     auto& page_table = *process.vm_manager.page_table;
 
-    auto page_pointer = page_table.pointers[vaddr >> CITRA_PAGE_BITS];
+    auto page_pointer = page_table.pointers.GetBacking(vaddr >> CITRA_PAGE_BITS);
     if (page_pointer) {
         return true;
     }
@@ -592,7 +644,7 @@ bool MemorySystem::IsValidPhysicalAddress(const PAddr paddr) {
 }
 
 u8* MemorySystem::GetPointer(const VAddr vaddr) {
-    u8* page_pointer = impl->current_page_table->pointers[vaddr >> CITRA_PAGE_BITS];
+    u8* page_pointer = impl->current_page_table->pointers.GetBacking(vaddr >> CITRA_PAGE_BITS);
     if (page_pointer) {
         return page_pointer + (vaddr & CITRA_PAGE_MASK);
     }
@@ -607,7 +659,8 @@ u8* MemorySystem::GetPointer(const VAddr vaddr) {
 }
 
 const u8* MemorySystem::GetPointer(const VAddr vaddr) const {
-    const u8* page_pointer = impl->current_page_table->pointers[vaddr >> CITRA_PAGE_BITS];
+    const u8* page_pointer =
+        impl->current_page_table->pointers.GetBacking(vaddr >> CITRA_PAGE_BITS);
     if (page_pointer) {
         return page_pointer + (vaddr & CITRA_PAGE_MASK);
     }
@@ -762,6 +815,9 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                         page_type = PageType::Memory;
                         page_table->pointers[vaddr >> CITRA_PAGE_BITS] =
                             GetPointerForRasterizerCache(vaddr & ~CITRA_PAGE_MASK);
+                        if (impl->IsPageWatched(vaddr >> CITRA_PAGE_BITS)) {
+                            page_table->pointers.SetHidden(vaddr >> CITRA_PAGE_BITS, true);
+                        }
                         break;
                     }
                     default:
@@ -773,6 +829,56 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
     }
 }
 
+void MemorySystem::SetRegionWatched(VAddr start, u32 size, bool watched) {
+    if (size == 0) {
+        return;
+    }
+
+    const u32 first_page = start >> CITRA_PAGE_BITS;
+    const u32 last_page = (start + size - 1) >> CITRA_PAGE_BITS;
+    for (u32 page = first_page; page <= last_page; ++page) {
+        if (watched) {
+            if (impl->watched_pages[page]++ != 0) {
+                continue;
+            }
+        } else {
+            auto it = impl->watched_pages.find(page);
+            if (it == impl->watched_pages.end() || --it->second != 0) {
+                continue;
+            }
+            impl->watched_pages.erase(it);
+        }
+        for (auto& page_table : impl->page_table_list) {
+            if (page_table->attributes[page] == PageType::Memory) {
+                page_table->pointers.SetHidden(page, watched);
+            }
+        }
+    }
+}
+
+void MemorySystem::ResetRasterizerCachedPages() {
+    const auto reset_range = [&](VAddr start, VAddr end) {
+        for (VAddr vaddr = start; vaddr < end; vaddr += CITRA_PAGE_SIZE) {
+            impl->cache_marker.Mark(vaddr, false);
+            for (auto& page_table : impl->page_table_list) {
+                PageType& page_type = page_table->attributes[vaddr >> CITRA_PAGE_BITS];
+                if (page_type == PageType::RasterizerCachedMemory) {
+                    page_type = PageType::Memory;
+                    page_table->pointers[vaddr >> CITRA_PAGE_BITS] =
+                        GetPointerForRasterizerCache(vaddr);
+                    if (impl->IsPageWatched(vaddr >> CITRA_PAGE_BITS)) {
+                        page_table->pointers.SetHidden(vaddr >> CITRA_PAGE_BITS, true);
+                    }
+                }
+            }
+        }
+    };
+    reset_range(VRAM_VADDR, VRAM_VADDR_END);
+    reset_range(LINEAR_HEAP_VADDR, LINEAR_HEAP_VADDR_END);
+    reset_range(NEW_LINEAR_HEAP_VADDR, NEW_LINEAR_HEAP_VADDR_END);
+    reset_range(PLUGIN_3GX_FB_VADDR, PLUGIN_3GX_FB_VADDR_END);
+}
+
 u8 MemorySystem::Read8(const VAddr addr) {
     return Read<u8>(impl->current_page_table, addr);
 }
@@ -874,6 +980,40 @@ void MemorySystem::WriteBlock(const VAddr dest_addr, const void* src_buffer,
     return impl->WriteBlockImpl<false>(process, dest_addr, src_buffer, size);
 }
 
+std::span<u8> MemorySystem::GetWritableSpan(const Kernel::Process& process, const VAddr vaddr,
+                                            const std::size_t size) {
+    auto& page_table = *process.vm_manager.page_table;
+    const auto get_host_pointer = [&](VAddr addr) -> u8* {
+        const std::size_t page_index = addr >> CITRA_PAGE_BITS;
+        switch (page_table.attributes[page_index]) {
+        case PageType::Memory:
+            return page_table.pointers.GetBacking(page_index) + (addr & CITRA_PAGE_MASK);
+        case PageType::RasterizerCachedMemory:
+            return GetPointerForRasterizerCache(addr);
+        default:
+            return nullptr;
+        }
+    };
+
+    if (size == 0 || static_cast<u64>(vaddr) + size > (1ULL << 32)) {
+        return {};
+    }
+    u8* const base = get_host_pointer(vaddr);
+    if (!base) {
+        return {};
+    }
+    // Every following page must continue right after the previous one in host memory.
+    for (u64 page = (vaddr & ~CITRA_PAGE_MASK) + CITRA_PAGE_SIZE; page < vaddr + size;
+         page += CITRA_PAGE_SIZE) {
+        if (get_host_pointer(static_cast<VAddr>(page)) != base + (page - vaddr)) {
+            return {};
+        }
+    }
+
+    RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(size), FlushMode::Invalidate);
+    return {base, size};
+}
+
 void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_addr,
                              const std::size_t size) {
     auto& page_table = *process.vm_manager.page_table;
@@ -895,9 +1035,9 @@ void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_ad
             break;
         }
         case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
+            DEBUG_ASSERT(page_table.pointers.GetBacking(page_index));
 
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
+            u8* dest_ptr = page_table.pointers.GetBacking(page_index) + page_offset;
             std::memset(dest_ptr, 0, copy_amount);
             break;
         }
@@ -945,8 +1085,8 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
             break;
         }
         case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
+            DEBUG_ASSERT(page_table.pointers.GetBacking(page_index));
+            const u8* src_ptr = page_table.pointers.GetBacking(page_index) + page_offset;
             WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
             break;
         }
@@ -970,18 +1110,23 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
 }
 
 u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+    ASSERT(pointer >= impl->fcram.data() && pointer <= impl->fcram.data() + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram.data());
 }
 
 u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram.data() + offset;
 }
 
 const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram.data() + offset;
+}
+
+void MemorySystem::ClearFCRAM(std::size_t offset, std::size_t size) {
+    ASSERT(offset + size <= Memory::FCRAM_N3DS_SIZE);
+    impl->fcram.Clear(offset, size);
 }
 
 MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
@@ -993,4 +1138,27 @@ void MemorySystem::SetDSP(AudioCore::DspInterface& dsp) {
     impl->dsp = &dsp;
 }
 
+std::optional<MemorySnapshot> MemorySystem::TakeSnapshot() {
+    MemorySnapshot snapshot{
+        .fcram = impl->fcram.TakeSnapshot(),
+        .vram = impl->vram.TakeSnapshot(),
+        .n3ds_extra_ram = impl->n3ds_extra_ram.TakeSnapshot(),
+    };
+    if (!snapshot.fcram || !snapshot.vram || !snapshot.n3ds_extra_ram) {
+        LOG_ERROR(HW_Memory, "Failed to take guest RAM snapshot");
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+bool MemorySystem::RestoreSnapshot(const MemorySnapshot& snapshot) {
+    return impl->fcram.RestoreSnapshot(snapshot.fcram) &&
+           impl->vram.RestoreSnapshot(snapshot.vram) &&
+           impl->n3ds_extra_ram.RestoreSnapshot(snapshot.n3ds_extra_ram);
+}
+
+void MemorySystem::SetSerializeRam(bool serialize_ram) {
+    impl->serialize_ram = serialize_ram;
+}
+
 } // namespace Memory
@@ -5,12 +5,19 @@
 #pragma once
 #include <array>
 #include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
 #include "common/memory_ref.h"
 
+namespace Common {
+class CowSnapshot;
+}
+
 namespace Kernel {
 class Process;
 }
@@ -53,7 +60,9 @@ enum class PageType {
 struct PageTable {
     /**
      * Array of memory pointers backing each page. An entry can only be non-null if the
-     * corresponding entry in the `attributes` array is of type `Memory`.
+     * corresponding entry in the `attributes` array is of type `Memory`. The raw pointer handed to
+     * the JIT is also null for `Memory` pages that are watched by the debugger, so that accesses
+     * to them leave compiled code and can be checked.
      */
 
     // The reason for this rigmarole is to keep the 'raw' and 'refs' arrays in sync.
@@ -82,6 +91,16 @@ struct PageTable {
             return Entry(*this, static_cast<VAddr>(idx));
         }
 
+        /// Returns the memory backing a page, including pages hidden from the JIT.
+        u8* GetBacking(std::size_t idx) {
+            return refs[idx].GetPtr();
+        }
+
+        /// Hides a page from the JIT, or exposes it again.
+        void SetHidden(std::size_t idx, bool hidden) {
+            raw[idx] = hidden ? nullptr : refs[idx].GetPtr();
+        }
+
     private:
         std::array<u8*, PAGE_TABLE_NUM_ENTRIES> raw;
         std::array<MemoryRef, PAGE_TABLE_NUM_ENTRIES> refs;
@@ -235,6 +254,13 @@ enum class FlushMode {
     FlushAndInvalidate,
 };
 
+/// Copy-on-write snapshot of guest RAM, taken by MemorySystem::TakeSnapshot.
+struct MemorySnapshot {
+    std::shared_ptr<const Common::CowSnapshot> fcram;
+    std::shared_ptr<const Common::CowSnapshot> vram;
+    std::shared_ptr<const Common::CowSnapshot> n3ds_extra_ram;
+};
+
 class MemorySystem {
 public:
     explicit MemorySystem(Core::System& system);
@@ -568,6 +594,21 @@ public:
      */
     void WriteBlock(VAddr dest_addr, const void* src_buffer, std::size_t size);
 
+    /**
+     * Gets a host span over a range of a given process' address space, so that it can be written
+     * directly instead of through WriteBlock.
+     *
+     * @param process The process owning the address space.
+     * @param vaddr   The virtual address the range starts at.
+     * @param size    The size of the range, in bytes.
+     *
+     * @returns The span, or an empty span if the range isn't mapped to contiguous host memory.
+     *
+     * @post Any region of the range that is considered cached rasterizer memory has been
+     *       invalidated, as if it was written by WriteBlock.
+     */
+    std::span<u8> GetWritableSpan(const Kernel::Process& process, VAddr vaddr, std::size_t size);
+
     /**
      * Zeros a range of bytes within the current process' address space at the specified
      * virtual address.
@@ -608,6 +649,9 @@ public:
      */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
+    /// Marks every page as uncached, used when the rasterizer cache is rebuilt after a load.
+    void ResetRasterizerCachedPages();
+
     /// For a rasterizer-accessible PAddr, gets a list of all possible VAddr
     std::vector<VAddr> PhysicalToVirtualAddressForRasterizer(PAddr addr);
 
@@ -632,6 +676,9 @@ public:
     /// Gets pointer in FCRAM with given offset
     const u8* GetFCRAMPointer(std::size_t offset) const;
 
+    /// Zeroes a range of FCRAM, returning the host pages it covers to the operating system
+    void ClearFCRAM(std::size_t offset, std::size_t size);
+
     /// Gets a serializable ref to FCRAM with the given offset
     MemoryRef GetFCRAMRef(std::size_t offset) const;
 
@@ -641,8 +688,28 @@ public:
     /// Unregisters page table for rasterizer cache marking
     void UnregisterPageTable(std::shared_ptr<PageTable> page_table);
 
+    /**
+     * Adds or removes a debugger watch on a virtual address range. Watched pages are hidden from
+     * the JIT so that their accesses go through the memory callbacks, where watchpoints are
+     * checked. Watches are reference counted per page.
+     */
+    void SetRegionWatched(VAddr start, u32 size, bool watched);
+
     void SetDSP(AudioCore::DspInterface& dsp);
 
+    /**
+     * Captures the contents of guest RAM. Pages are only duplicated once written to afterwards
+     * when the host supports it, so this is cheap enough to do every frame.
+     * @returns The snapshot, or std::nullopt if it could not be taken
+     */
+    std::optional<MemorySnapshot> TakeSnapshot();
+
+    /// Replaces the contents of guest RAM with a snapshot.
+    bool RestoreSnapshot(const MemorySnapshot& snapshot);
+
+    /// Sets whether guest RAM is written to and read from savestate archives.
+    void SetSerializeRam(bool serialize_ram);
+
     void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode);
 
 private:
@@ -4,14 +4,15 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iterator>
 #include <mutex>
 #include <numeric>
 #include <sstream>
-#include <thread>
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
+#include "common/logging/log.h"
 #include "common/settings.h"
 #include "core/core_timing.h"
 #include "core/perf_stats.h"
@@ -29,6 +30,39 @@ constexpr std::size_t IgnoreFrames = 5;
 
 namespace Core {
 
+void FrameTimeHistogram::Add(double frame_ms) {
+    const auto bin = static_cast<std::size_t>(std::max(frame_ms, 0.0) / BIN_WIDTH_MS);
+    bins[std::min(bin, NUM_BINS - 1)]++;
+    count++;
+    max_ms = std::max(max_ms, frame_ms);
+}
+
+double FrameTimeHistogram::GetPercentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    const u64 rank = std::max<u64>(
+        static_cast<u64>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * count)), 1);
+    u64 seen = 0;
+    for (std::size_t bin = 0; bin < NUM_BINS; bin++) {
+        seen += bins[bin];
+        if (seen >= rank) {
+            if (bin == NUM_BINS - 1) {
+                break;
+            }
+            return std::min(static_cast<double>(bin + 1) * BIN_WIDTH_MS, max_ms);
+        }
+    }
+    return max_ms;
+}
+
+void FrameTimeHistogram::Reset() {
+    bins.fill(0);
+    count = 0;
+    max_ms = 0;
+}
+
 PerfStats::PerfStats(u64 title_id) : title_id(title_id) {}
 
 PerfStats::~PerfStats() {
@@ -36,6 +70,10 @@ PerfStats::~PerfStats() {
         return;
     }
 
+    LOG_INFO(Core, "Frame times: p50 {:.2f} ms, p90 {:.2f} ms, p99 {:.2f} ms, p99.9 {:.2f} ms",
+             frame_histogram.GetPercentile(50), frame_histogram.GetPercentile(90),
+             frame_histogram.GetPercentile(99), frame_histogram.GetPercentile(99.9));
+
     const std::time_t t = std::time(nullptr);
     std::ostringstream stream;
     std::copy(perf_history.begin() + IgnoreFrames, perf_history.begin() + current_index,
@@ -46,6 +84,27 @@ PerfStats::~PerfStats() {
         fmt::format("{}/{:%F-%H-%M}_{:016X}.csv", path, *std::localtime(&t), title_id);
     FileUtil::IOFile file(filename, "w");
     file.WriteString(stream.str());
+
+    // The timeline is exported next to the frametimes so GPU bound frames can be told apart.
+    std::ostringstream timeline_stream;
+    timeline_stream << "frame,cpu_frame_ms,cpu_gpu_ms,cpu_swap_ms,gpu_render_pass_ms,"
+                       "gpu_texture_upload_ms,gpu_blit_ms,gpu_present_ms\n";
+    for (const FrameTimeline& record : GetTimeline()) {
+        timeline_stream << fmt::format("{},{},{},{}", record.frame, record.cpu_frame_ms,
+                                       record.cpu_gpu_ms, record.cpu_swap_ms);
+        for (const double gpu_ms : record.gpu_ms) {
+            if (record.has_gpu_times) {
+                timeline_stream << ',' << gpu_ms;
+            } else {
+                timeline_stream << ',';
+            }
+        }
+        timeline_stream << '\n';
+    }
+    const std::string timeline_filename =
+        fmt::format("{}/{:%F-%H-%M}_{:016X}_timeline.csv", path, *std::localtime(&t), title_id);
+    FileUtil::IOFile timeline_file(timeline_filename, "w");
+    timeline_file.WriteString(timeline_stream.str());
 }
 
 void PerfStats::BeginSVCProcessing() {
@@ -69,7 +128,9 @@ void PerfStats::BeginGPUProcessing() {
 }
 
 void PerfStats::EndGPUProcessing() {
-    accumulated_gpu_time += (Clock::now() - start_gpu_time);
+    const auto gpu_time = Clock::now() - start_gpu_time;
+    accumulated_gpu_time += gpu_time;
+    frame_gpu_time += gpu_time;
 }
 
 void PerfStats::StartSwap() {
@@ -77,7 +138,53 @@ void PerfStats::StartSwap() {
 }
 
 void PerfStats::EndSwap() {
-    accumulated_swap_time += (Clock::now() - start_swap_time);
+    const auto swap_end = Clock::now();
+    const auto swap_time = swap_end - start_swap_time;
+    accumulated_swap_time += swap_time;
+
+    std::scoped_lock lock{object_mutex};
+
+    using DoubleMillis = std::chrono::duration<double, std::milli>;
+    FrameTimeline& record = timeline[timeline_frames % timeline.size()];
+    record = FrameTimeline{
+        .frame = timeline_frames,
+        .cpu_frame_ms = DoubleMillis(swap_end - previous_swap_end).count(),
+        .cpu_gpu_ms = DoubleMillis(frame_gpu_time).count(),
+        .cpu_swap_ms = DoubleMillis(swap_time).count(),
+    };
+    timeline_frames++;
+    previous_swap_end = swap_end;
+    frame_gpu_time = Clock::duration::zero();
+}
+
+u64 PerfStats::GetTimelineFrame() const {
+    std::scoped_lock lock{object_mutex};
+
+    return timeline_frames;
+}
+
+void PerfStats::AddGPUTimeline(u64 frame, const GPUStageTimes& gpu_ms) {
+    std::scoped_lock lock{object_mutex};
+
+    FrameTimeline& record = timeline[frame % timeline.size()];
+    if (frame >= timeline_frames || record.frame != frame) {
+        // The frame has not been swapped yet or was already overwritten in the ring.
+        return;
+    }
+    record.gpu_ms = gpu_ms;
+    record.has_gpu_times = true;
+}
+
+std::vector<FrameTimeline> PerfStats::GetTimeline() const {
+    std::scoped_lock lock{object_mutex};
+
+    const u64 num_records = std::min<u64>(timeline_frames, timeline.size());
+    std::vector<FrameTimeline> records;
+    records.reserve(num_records);
+    for (u64 frame = timeline_frames - num_records; frame < timeline_frames; frame++) {
+        records.push_back(timeline[frame % timeline.size()]);
+    }
+    return records;
 }
 
 void PerfStats::BeginSystemFrame() {
@@ -103,6 +210,13 @@ void PerfStats::EndSystemFrame() {
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
+
+    if (current_index > IgnoreFrames) {
+        const double frame_length_ms =
+            std::chrono::duration<double, std::milli>(previous_frame_length).count();
+        frame_histogram.Add(frame_length_ms);
+        interval_frame_histogram.Add(frame_length_ms);
+    }
 }
 
 void PerfStats::EndGameFrame() {
@@ -163,6 +277,8 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
                          static_cast<double>(system_frames))
                       : 0;
     last_stats.emulation_speed = system_us_per_second.count() / 1'000'000.0;
+    last_stats.time_frame_p50 = interval_frame_histogram.GetPercentile(50) / 1000.0;
+    last_stats.time_frame_p99 = interval_frame_histogram.GetPercentile(99) / 1000.0;
     last_stats.artic_transmitted = static_cast<double>(artic_transmitted) / interval;
     last_stats.artic_events.raw = artic_events.raw | prev_artic_event.raw;
 
@@ -176,6 +292,7 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     accumulated_gpu_time = Clock::duration::zero();
     accumulated_swap_time = Clock::duration::zero();
     game_frames = 0;
+    interval_frame_histogram.Reset();
     artic_transmitted = 0;
     prev_artic_event.raw &= artic_events.raw;
 
@@ -240,7 +357,7 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
         std::clamp(frame_limiting_delta_err, -max_lag_time_us, max_lag_time_us);
 
     if (frame_limiting_delta_err > microseconds::zero()) {
-        std::this_thread::sleep_for(frame_limiting_delta_err);
+        sleeper.SleepUntil(now + frame_limiting_delta_err);
         auto now_after_sleep = Clock::now();
         frame_limiting_delta_err -= duration_cast<microseconds>(now_after_sleep - now);
         now = now_after_sleep;
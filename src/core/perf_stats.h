@@ -9,12 +9,73 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <vector>
 #include "common/bit_field.h"
 #include "common/common_types.h"
+#include "common/precise_sleep.h"
 #include "common/thread.h"
 
 namespace Core {
 
+/// Categories of host GPU work measured by the renderer with timestamp queries.
+enum class GPUTimelineStage : u32 {
+    RenderPass,    ///< Render passes drawing into guest surfaces
+    TextureUpload, ///< Texture uploads and downloads
+    Blit,          ///< Surface copies, blits and format conversions
+    Present,       ///< Post-processing and drawing the screens to the window
+    Count,
+};
+
+using GPUStageTimes = std::array<double, static_cast<std::size_t>(GPUTimelineStage::Count)>;
+
+/**
+ * Host timings of a single presented frame. The CPU side is filled in when the frame is swapped,
+ * the GPU side once the renderer has resolved its timestamp queries, which is a few frames later.
+ */
+struct FrameTimeline {
+    /// Index of the presented frame
+    u64 frame = 0;
+    /// Walltime in milliseconds since the previous frame was swapped
+    double cpu_frame_ms = 0;
+    /// Walltime in milliseconds spent in GPU command processing for this frame
+    double cpu_gpu_ms = 0;
+    /// Walltime in milliseconds spent in Renderer::SwapBuffers
+    double cpu_swap_ms = 0;
+    /// Host GPU time in milliseconds spent in each GPUTimelineStage
+    GPUStageTimes gpu_ms{};
+    /// Whether the renderer reported GPU timings for this frame
+    bool has_gpu_times = false;
+};
+
+/**
+ * Distribution of frame times in bins of fixed width, used to report percentiles without keeping
+ * every sample. Frame times past the last bin are counted in it.
+ */
+class FrameTimeHistogram {
+public:
+    static constexpr double BIN_WIDTH_MS = 0.1;
+    static constexpr std::size_t NUM_BINS = 1000;
+
+    void Add(double frame_ms);
+
+    /**
+     * Returns the frame time in milliseconds that the given percentage of the frames did not
+     * exceed, within the width of a bin. Returns 0 if no frames have been added.
+     */
+    double GetPercentile(double percentile) const;
+
+    u64 GetCount() const {
+        return count;
+    }
+
+    void Reset();
+
+private:
+    std::array<u32, NUM_BINS> bins{};
+    u64 count = 0;
+    double max_ms = 0;
+};
+
 /**
  * Class to manage and query performance/timing statistics. All public functions of this class are
  * thread-safe unless stated otherwise.
@@ -69,6 +130,9 @@ public:
         double time_remaining;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Walltime in seconds between system frames, at the 50th and 99th percentile
+        double time_frame_p50 = 0;
+        double time_frame_p99 = 0;
         /// Artic base bytes per second
         double artic_transmitted = 0;
         /// Artic base events
@@ -83,6 +147,15 @@ public:
     void EndGPUProcessing();
     void StartSwap();
     void EndSwap();
+
+    /// Returns the index of the frame that will be recorded by the next EndSwap call.
+    u64 GetTimelineFrame() const;
+
+    /// Stores the host GPU timings of a previously swapped frame.
+    void AddGPUTimeline(u64 frame, const GPUStageTimes& gpu_ms);
+
+    /// Returns the recorded frame timelines, oldest first.
+    std::vector<FrameTimeline> GetTimeline() const;
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
@@ -159,6 +232,11 @@ private:
     /// Visible duration for the frame prior to previous_frame_length
     Clock::duration previous_previous_frame_length = Clock::duration::zero();
 
+    /// Visible durations of the system frames since the title was started
+    FrameTimeHistogram frame_histogram;
+    /// Visible durations of the system frames since last reset
+    FrameTimeHistogram interval_frame_histogram;
+
     Clock::time_point start_svc_time = reset_point;
     Clock::duration accumulated_svc_time = Clock::duration::zero();
 
@@ -171,13 +249,22 @@ private:
     Clock::time_point start_swap_time = reset_point;
     Clock::duration accumulated_swap_time = Clock::duration::zero();
 
+    /// Ring of the most recent per-frame timelines, indexed by frame modulo its size
+    std::array<FrameTimeline, 1024> timeline{};
+    /// Number of frames recorded in the timeline
+    u64 timeline_frames = 0;
+    /// Point when the previous frame was swapped
+    Clock::time_point previous_swap_end = reset_point;
+    /// GPU command processing time accumulated since the previous frame was swapped
+    Clock::duration frame_gpu_time = Clock::duration::zero();
+
     /// Last recorded performance statistics.
     Results last_stats;
 };
 
 class FrameLimiter {
 public:
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = Common::PreciseSleeper::Clock;
 
     void DoFrameLimiting(std::chrono::microseconds current_system_time_us);
 
@@ -200,6 +287,9 @@ private:
     /// Accumulated difference between walltime and emulated time
     std::chrono::microseconds frame_limiting_delta_err{0};
 
+    /// Waits out the difference without the scheduler slack of a plain sleep
+    Common::PreciseSleeper sleeper;
+
     /// Whether to use frame advancing (i.e. frame by frame)
     std::atomic_bool frame_advancing_enabled;
 
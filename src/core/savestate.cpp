@@ -10,6 +10,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/scope_exit.h"
 #include "common/swap.h"
 #include "common/zstd_compression.h"
 #include "core/core.h"
@@ -217,6 +218,39 @@ void System::LoadState(u32 slot) {
     ia&* this;
 }
 
+std::unique_ptr<StateSnapshot> System::TakeStateSnapshot() {
+    if (app_loader && !app_loader->SupportsSaveStates()) {
+        throw std::runtime_error("The current app loader doesn't support save states");
+    }
+
+    auto snapshot = std::make_unique<StateSnapshot>();
+    std::ostringstream sstream{std::ios_base::binary};
+    serialize_guest_ram = false;
+    {
+        SCOPE_EXIT({ serialize_guest_ram = true; });
+        oarchive oa{sstream};
+        oa&* this;
+    }
+    snapshot->state = std::move(sstream).str();
+
+    auto memory_snapshot = memory->TakeSnapshot();
+    if (!memory_snapshot) {
+        throw std::runtime_error("Could not take guest RAM snapshot");
+    }
+    snapshot->memory = std::move(*memory_snapshot);
+    return snapshot;
+}
+
+void System::RestoreStateSnapshot(const StateSnapshot& snapshot) {
+    // Guest RAM is restored while deserializing, so the rasterizer cache is revalidated against
+    // the snapshot contents.
+    std::istringstream sstream{snapshot.state, std::ios_base::binary};
+    restore_guest_ram = &snapshot.memory;
+    SCOPE_EXIT({ restore_guest_ram = nullptr; });
+    iarchive ia{sstream};
+    ia&* this;
+}
+
 #ifdef HAVE_LIBRETRO
 std::vector<u8> System::SaveStateBuffer() const {
     std::ostringstream sstream{std::ios_base::binary};
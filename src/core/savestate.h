@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include "common/common_types.h"
+#include "core/memory.h"
 
 namespace Core {
 
@@ -22,6 +23,12 @@ struct SaveStateInfo {
 
 constexpr u32 SaveStateSlotCount = 11; // Maximum count of savestate slots
 
+/// Emulation state captured in host memory by System::TakeStateSnapshot.
+struct StateSnapshot {
+    std::string state;             ///< Serialized emulation state, excluding guest RAM
+    Memory::MemorySnapshot memory; ///< Copy-on-write snapshot of guest RAM
+};
+
 std::vector<SaveStateInfo> ListSaveStates(u64 program_id, u64 movie_id);
 
 } // namespace Core
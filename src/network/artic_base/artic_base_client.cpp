@@ -467,29 +467,41 @@ std::optional<std::pair<void*, size_t>> Client::Response::GetResponseBuffer(u32
     return std::nullopt;
 }
 
+std::optional<Client::Response> Client::PendingResponse::Wait() {
+    std::unique_lock cv_lk(cv_mutex);
+    cv.wait(cv_lk, [this]() { return is_done; });
+
+    return std::optional<Client::Response>(std::move(response));
+}
+
 std::optional<Client::Response> Client::Send(Request& request) {
-    if (stopped)
+    auto resp = SendAsync(request);
+    if (!resp) {
         return std::nullopt;
+    }
+    return resp->Wait();
+}
+
+std::shared_ptr<Client::PendingResponse> Client::SendAsync(Request& request) {
+    if (stopped)
+        return nullptr;
 
     request.request_packet.parameterCount = static_cast<u32>(request.parameters.size());
-    PendingResponse resp(request);
+    std::shared_ptr<PendingResponse> resp{new PendingResponse(request)};
 
     {
         std::scoped_lock l(recv_map_mutex);
-        pending_responses[request.request_packet.requestID] = &resp;
+        pending_responses[request.request_packet.requestID] = resp;
     }
 
     auto respPacket = SendRequestPacket(request.request_packet, false, request.parameters);
     if (stopped || !respPacket.has_value()) {
         std::scoped_lock l(recv_map_mutex);
         pending_responses.erase(request.request_packet.requestID);
-        return std::nullopt;
+        return nullptr;
     }
 
-    std::unique_lock cv_lk(resp.cv_mutex);
-    resp.cv.wait(cv_lk, [&resp]() { return resp.is_done; });
-
-    return std::optional<Client::Response>(std::move(resp.response));
+    return resp;
 }
 
 void Client::LogOnServer(ArticBaseCommon::LogOnServerType log_type, const std::string& message) {
@@ -765,7 +777,7 @@ void Client::Handler::RunLoop() {
         }
         retry_count = 0;
 
-        PendingResponse* pending_response;
+        std::shared_ptr<PendingResponse> pending_response;
         {
             std::scoped_lock l(client.recv_map_mutex);
             auto it = client.pending_responses.find(dataPacket.requestID);
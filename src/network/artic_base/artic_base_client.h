@@ -238,9 +238,9 @@ private:
         u16 port;
     };
 
+public:
     class PendingResponse;
 
-public:
     class Response {
     public:
         Response() {}
@@ -341,13 +341,14 @@ public:
         size_t resp_data_size = 0;
     };
 
-    std::optional<Response> Send(Request& request);
-
-private:
+    /// Request that has been sent to the server and whose response may not have arrived yet.
     class PendingResponse {
     public:
         bool is_done = false;
 
+        /// Waits for the response to arrive and takes it. Can only be called once.
+        std::optional<Response> Wait();
+
     private:
         friend class Client;
         friend class Client::Handler;
@@ -355,13 +356,23 @@ private:
         std::condition_variable cv;
         std::mutex cv_mutex;
 
-        const Request& request;
+        // Kept here so that big buffers can still be provided after the sender has moved on.
+        const Request request;
 
         Response response{};
     };
 
+    std::optional<Response> Send(Request& request);
+
+    /**
+     * Sends a request without waiting for its response, so that several requests can be in
+     * flight at once. Returns nullptr if the request could not be sent.
+     */
+    std::shared_ptr<PendingResponse> SendAsync(Request& request);
+
+private:
     std::mutex recv_map_mutex;
-    std::map<u32, PendingResponse*> pending_responses;
+    std::map<u32, std::shared_ptr<PendingResponse>> pending_responses;
 
     std::vector<Handler*> handlers;
     std::atomic<size_t> running_handlers;
@@ -1,8 +1,9 @@
 // Copyright 2019 Citra Emulator Project
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
-#if defined(HAVE_MF) || defined(HAVE_FFMPEG)
 
+#include <algorithm>
+#include <cstring>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -11,6 +12,7 @@
 #include "core/hle/kernel/shared_page.h"
 #include "core/memory.h"
 
+#include "audio_core/hle/aac_decoder.h"
 #include "audio_core/hle/decoder.h"
 #ifdef HAVE_MF
 #include "audio_core/hle/wmf_decoder.h"
@@ -19,6 +21,8 @@
 #endif
 #include "audio_fixures.h"
 
+#if defined(HAVE_MF) || defined(HAVE_FFMPEG)
+
 TEST_CASE("DSP HLE Audio Decoder", "[audio_core]") {
     Core::System system;
     Memory::MemorySystem memory{system};
@@ -53,3 +57,57 @@ TEST_CASE("DSP HLE Audio Decoder", "[audio_core]") {
 }
 
 #endif
+
+TEST_CASE("DSP HLE AAC decoder queued requests", "[audio_core]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    u8* fcram = memory.GetFCRAMPointer(0);
+    std::memcpy(fcram, fixure_buffer, fixure_buffer_size);
+    // Mark the outputs, so that a decode that fails and writes nothing is caught.
+    std::memset(fcram + 0x10000, 0xAA, 0x40000);
+
+    AudioCore::HLE::BinaryMessage init{};
+    init.header.codec = AudioCore::HLE::DecoderCodec::DecodeAAC;
+    init.header.cmd = AudioCore::HLE::DecoderCommand::Init;
+
+    AudioCore::HLE::BinaryMessage decode = init;
+    decode.header.cmd = AudioCore::HLE::DecoderCommand::EncodeDecode;
+    decode.decode_aac_request.src_addr = Memory::FCRAM_PADDR;
+    decode.decode_aac_request.size = fixure_buffer_size;
+
+    // Reference output decoded on the calling thread.
+    AudioCore::HLE::AACDecoder direct{memory};
+    AudioCore::HLE::BinaryMessage direct_decode = decode;
+    direct_decode.decode_aac_request.dst_addr_ch0 = Memory::FCRAM_PADDR + 0x10000;
+    direct_decode.decode_aac_request.dst_addr_ch1 = Memory::FCRAM_PADDR + 0x20000;
+    direct.ProcessRequest(init);
+    const AudioCore::HLE::BinaryMessage direct_response = direct.ProcessRequest(direct_decode);
+
+    AudioCore::HLE::AACDecoder queued{memory};
+    AudioCore::HLE::BinaryMessage queued_decode = decode;
+    queued_decode.decode_aac_request.dst_addr_ch0 = Memory::FCRAM_PADDR + 0x30000;
+    queued_decode.decode_aac_request.dst_addr_ch1 = Memory::FCRAM_PADDR + 0x40000;
+    queued.QueueRequest(init);
+    queued.QueueRequest(queued_decode);
+
+    // The input has to be captured when the request is queued.
+    std::memset(fcram, 0, fixure_buffer_size);
+
+    REQUIRE(queued.HasQueuedRequests());
+    const AudioCore::HLE::BinaryMessage init_response = queued.PopResponse();
+    REQUIRE(init_response.header.result == AudioCore::HLE::ResultStatus::Success);
+    const AudioCore::HLE::BinaryMessage queued_response = queued.PopResponse();
+    REQUIRE_FALSE(queued.HasQueuedRequests());
+
+    REQUIRE(std::memcmp(&queued_response, &direct_response, sizeof(direct_response)) == 0);
+    const std::size_t output_size = direct_response.decode_aac_response.num_samples * sizeof(s16);
+    REQUIRE(output_size != 0);
+    const auto written = [fcram, output_size](std::size_t offset) {
+        return std::any_of(fcram + offset, fcram + offset + output_size,
+                           [](u8 value) { return value != 0xAA; });
+    };
+    REQUIRE(written(0x10000));
+    REQUIRE(written(0x20000));
+    REQUIRE(std::memcmp(fcram + 0x30000, fcram + 0x10000, output_size) == 0);
+    REQUIRE(std::memcmp(fcram + 0x40000, fcram + 0x20000, output_size) == 0);
+}
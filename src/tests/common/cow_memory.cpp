@@ -0,0 +1,55 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "common/cow_memory.h"
+#include "common/logging/backend.h"
+
+namespace Common {
+
+TEST_CASE("CowMemory restores snapshots", "[common]") {
+    Common::Log::DisableLoggingInTests();
+    constexpr std::size_t size = 4 * 1024 * 1024;
+    CowMemory memory{size};
+    u8* const data = memory.data();
+    REQUIRE(data != nullptr);
+    REQUIRE(data[0] == 0);
+
+    data[0] = 1;
+    auto first = memory.TakeSnapshot();
+    REQUIRE(first != nullptr);
+
+    data[0] = 2;
+    data[size - 1] = 3;
+    REQUIRE(memory.RestoreSnapshot(first));
+    REQUIRE(memory.data() == data);
+    REQUIRE(data[0] == 1);
+    REQUIRE(data[size - 1] == 0);
+
+    // The first snapshot is still held, so this one gets its own copy.
+    data[4096] = 4;
+    auto second = memory.TakeSnapshot();
+    REQUIRE(second != nullptr);
+    data[4096] = 5;
+    REQUIRE(memory.RestoreSnapshot(first));
+    REQUIRE(data[4096] == 0);
+    REQUIRE(memory.RestoreSnapshot(second));
+    REQUIRE(data[4096] == 4);
+
+    // Releasing every snapshot lets the next one reuse the previous storage.
+    first.reset();
+    second.reset();
+    data[8192] = 6;
+    auto third = memory.TakeSnapshot();
+    REQUIRE(third != nullptr);
+    memory.Clear(0, size);
+    REQUIRE(data[0] == 0);
+    REQUIRE(data[8192] == 0);
+    REQUIRE(memory.RestoreSnapshot(third));
+    REQUIRE(data[0] == 1);
+    REQUIRE(data[4096] == 4);
+    REQUIRE(data[8192] == 6);
+}
+
+} // namespace Common
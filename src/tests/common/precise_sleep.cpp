@@ -0,0 +1,82 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <catch2/catch_test_macros.hpp>
+#include "common/precise_sleep.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = Common::PreciseSleeper::Clock;
+
+/**
+ * Runs the sleeper on a simulated clock. Every time query advances the clock a little, like a spin
+ * iteration would, and the OS wait wakes up late by the configured slack.
+ */
+class FakeSleeper final : public Common::PreciseSleeper {
+public:
+    Clock::duration slack = 300us;
+    mutable Clock::time_point now{1s};
+
+    void Work(Clock::duration length) {
+        now += length;
+    }
+
+protected:
+    Clock::time_point Now() const override {
+        now += 1us;
+        return now;
+    }
+
+    void CoarseSleepUntil(Clock::time_point target) override {
+        now = std::max(now, target) + slack;
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("PreciseSleeper jitter", "[common]") {
+    FakeSleeper sleeper;
+
+    // Paces frames the way the frame limiter does, with some work at the start of each frame.
+    constexpr auto frame_length = 16666us;
+    auto deadline = sleeper.now;
+    const auto run_frames = [&](int frames) {
+        Clock::duration max_lateness{};
+        for (int frame = 0; frame < frames; frame++) {
+            sleeper.Work(2ms);
+            deadline += frame_length;
+            sleeper.SleepUntil(deadline);
+            REQUIRE(sleeper.now >= deadline);
+            max_lateness = std::max(max_lateness, sleeper.now - deadline);
+        }
+        return max_lateness;
+    };
+
+    // The spin absorbs the OS slack, so frames end as soon as the spin notices the deadline.
+    REQUIRE(run_frames(60) <= 2us);
+    REQUIRE(sleeper.GetSpinTime() >= sleeper.slack);
+    REQUIRE(sleeper.GetSpinTime() <= 2ms);
+
+    // A slower host grows the spin time at once, only the first frame is late.
+    sleeper.slack = 1200us;
+    REQUIRE(run_frames(1) > 2us);
+    REQUIRE(sleeper.GetSpinTime() >= sleeper.slack);
+    REQUIRE(run_frames(60) <= 2us);
+
+    // Once the host is quick again, the spin time shrinks back without late frames.
+    sleeper.slack = 100us;
+    const auto spin_time = sleeper.GetSpinTime();
+    REQUIRE(run_frames(60) <= 2us);
+    REQUIRE(sleeper.GetSpinTime() < spin_time);
+    REQUIRE(sleeper.GetSpinTime() >= sleeper.slack);
+
+    // The spin time stays bounded however late the OS wakes up.
+    sleeper.slack = 5ms;
+    run_frames(10);
+    REQUIRE(sleeper.GetSpinTime() == 2ms);
+}
@@ -7,6 +7,8 @@
 #include <array>
 #include <bitset>
 #include <string>
+#include <thread>
+#include <vector>
 #include "common/file_util.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -196,4 +198,40 @@ TEST_CASE("CoreTiming[ChainScheduling]", "[core]") {
     REQUIRE(MAX_SLICE_LENGTH == timing.GetTimer(0)->GetDowncount());
 }
 
+TEST_CASE("CoreTiming[ThreadSafeUnschedule]", "[core]") {
+    Core::Timing timing(1, 100);
+
+    std::vector<std::uintptr_t> ran;
+    Core::TimingEventType* cb = timing.RegisterEvent(
+        "callbackA", [&ran](std::uintptr_t user_data, s64) { ran.push_back(user_data); });
+
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+
+    // Schedule from other threads, as async workers do, and cancel the first event before the
+    // emulation thread has picked it up.
+    std::thread([&] { timing.ScheduleEvent(0, cb, CB_IDS[0], 0, true); }).join();
+    timing.UnscheduleEvent(cb, CB_IDS[0]);
+    std::thread([&] { timing.ScheduleEvent(0, cb, CB_IDS[1], 0, true); }).join();
+
+    // Thread safe events are scheduled at least two slices into the future
+    for (int i = 0; i < 3; i++) {
+        timing.GetTimer(0)->AddTicks(timing.GetTimer(0)->GetDowncount());
+        timing.GetTimer(0)->Advance();
+        timing.GetTimer(0)->SetNextSlice();
+    }
+
+    REQUIRE(ran == std::vector<std::uintptr_t>{CB_IDS[1]});
+    REQUIRE(timing.GetTimer(0)->GetInboundStats().count == 2);
+
+    // The cancellation does not apply to events scheduled after it
+    std::thread([&] { timing.ScheduleEvent(0, cb, CB_IDS[0], 0, true); }).join();
+    for (int i = 0; i < 3; i++) {
+        timing.GetTimer(0)->AddTicks(timing.GetTimer(0)->GetDowncount());
+        timing.GetTimer(0)->Advance();
+        timing.GetTimer(0)->SetNextSlice();
+    }
+    REQUIRE(ran == std::vector<std::uintptr_t>{CB_IDS[1], CB_IDS[0]});
+}
+
 // TODO: Add tests for multiple timers
@@ -0,0 +1,452 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "core/file_sys/artic_cache.h"
+#include "core/file_sys/artic_disk_cache.h"
+#include "network/artic_base/artic_base_client.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define closesocket(x) close(x)
+#endif
+
+#ifdef _WIN32
+#define SHUT_RDWR SD_BOTH
+#define SEND_FLAGS 0
+#elif defined(MSG_NOSIGNAL)
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+namespace FileSys {
+
+namespace {
+
+namespace ArticBaseCommon = Network::ArticBaseCommon;
+
+constexpr s32 FILE_HANDLE = 1;
+constexpr std::size_t REQUEST_SIZE = 16 * 1024;
+
+u8 ByteAt(std::size_t offset) {
+    return static_cast<u8>((offset * 7) ^ (offset >> 12));
+}
+
+bool RecvAll(SocketHolder sock, void* buffer, std::size_t size) {
+    auto* data = static_cast<char*>(buffer);
+    while (size != 0) {
+        const auto received = ::recv(sock, data, static_cast<int>(size), 0);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+bool SendAll(SocketHolder sock, const void* buffer, std::size_t size) {
+    const auto* data = static_cast<const char*>(buffer);
+    while (size != 0) {
+        const auto sent = ::send(sock, data, static_cast<int>(size), SEND_FLAGS);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+SocketHolder ListenLocal(u16& port) {
+    const SocketHolder sock = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    REQUIRE(::bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    REQUIRE(::listen(sock, 1) == 0);
+    REQUIRE(::getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0);
+    port = ntohs(addr.sin_port);
+    return sock;
+}
+
+/**
+ * Minimal Artic Base server on the loopback interface. It serves a single file whose contents are
+ * given by ByteAt, and answers every request after a fixed latency so that the effect of
+ * pipelining can be observed.
+ */
+class FakeArticServer {
+public:
+    FakeArticServer(std::size_t data_size_, std::chrono::milliseconds latency_)
+        : data_size{data_size_}, latency{latency_} {
+        Network::SocketManager::EnableSockets();
+        main_listener = ListenLocal(main_port);
+        worker_listener = ListenLocal(worker_port);
+        main_thread = std::thread([this] { MainLoop(); });
+        worker_thread = std::thread([this] { WorkerLoop(); });
+    }
+
+    ~FakeArticServer() {
+        {
+            std::scoped_lock lock{mutex};
+            stop = true;
+        }
+        cv.notify_all();
+        shutdown(main_listener, SHUT_RDWR);
+        closesocket(main_listener);
+        shutdown(worker_listener, SHUT_RDWR);
+        closesocket(worker_listener);
+        main_thread.join();
+        worker_thread.join();
+        Network::SocketManager::DisableSockets();
+    }
+
+    u16 GetPort() const {
+        return main_port;
+    }
+
+    std::size_t GetReadCount() const {
+        return read_count;
+    }
+
+    std::size_t GetMaxReadsInFlight() const {
+        return max_reads_in_flight;
+    }
+
+private:
+    struct Reply {
+        std::chrono::steady_clock::time_point due;
+        std::vector<u8> data;
+        bool is_read;
+    };
+
+    void MainLoop() {
+        const SocketHolder conn = ::accept(main_listener, nullptr, nullptr);
+        if (conn == static_cast<SocketHolder>(-1)) {
+            return;
+        }
+
+        ArticBaseCommon::RequestPacket req;
+        while (RecvAll(conn, &req, sizeof(req))) {
+            const std::string method(req.method.data(),
+                                     ::strnlen(req.method.data(), req.method.size()));
+            if (!method.empty() && method[0] == '$') {
+                ArticBaseCommon::DataPacket resp{};
+                resp.requestID = req.requestID;
+                const std::string body = SimpleReply(method.substr(1));
+                std::memcpy(resp.dataRaw, body.data(), body.size());
+                if (!SendAll(conn, &resp, sizeof(resp)) || method == "$STOP") {
+                    break;
+                }
+                continue;
+            }
+
+            std::vector<ArticBaseCommon::RequestParameter> params(req.parameterCount);
+            if (!params.empty() &&
+                !RecvAll(conn, params.data(),
+                         params.size() * sizeof(ArticBaseCommon::RequestParameter))) {
+                break;
+            }
+            QueueReply(req.requestID, method, params);
+        }
+        shutdown(conn, SHUT_RDWR);
+        closesocket(conn);
+    }
+
+    std::string SimpleReply(const std::string& method) const {
+        if (method == "VERSION") {
+            return "2";
+        }
+        if (method == "MAXSIZE") {
+            return std::to_string(REQUEST_SIZE + 0x100);
+        }
+        if (method == "MAXPARAM") {
+            return "8";
+        }
+        if (method == "PORTS") {
+            return std::to_string(worker_port);
+        }
+        if (method == "READY") {
+            return "1";
+        }
+        return "";
+    }
+
+    void QueueReply(u32 request_id, const std::string& method,
+                    const std::vector<ArticBaseCommon::RequestParameter>& params) {
+        ArticBaseCommon::DataPacket header{};
+        header.requestID = request_id;
+        header.resp.articResult = ArticBaseCommon::ResponseMethod::ArticResult::METHOD_NOT_FOUND;
+
+        std::vector<u8> body;
+        const bool is_read = method == "FSFILE_Read" && params.size() == 3;
+        if (is_read) {
+            s64 offset;
+            s32 size;
+            std::memcpy(&offset, params[1].data, sizeof(offset));
+            std::memcpy(&size, params[2].data, sizeof(size));
+            const std::size_t start = static_cast<std::size_t>(offset);
+            const u32 length =
+                start < data_size
+                    ? static_cast<u32>(std::min<std::size_t>(size, data_size - start))
+                    : 0;
+
+            // A single buffer with ID 0 holding the data
+            body.resize(2 * sizeof(u32) + length);
+            const u32 buffer_id = 0;
+            std::memcpy(body.data(), &buffer_id, sizeof(u32));
+            std::memcpy(body.data() + sizeof(u32), &length, sizeof(u32));
+            for (u32 i = 0; i < length; i++) {
+                body[2 * sizeof(u32) + i] = ByteAt(start + i);
+            }
+            header.resp.articResult = ArticBaseCommon::ResponseMethod::ArticResult::SUCCESS;
+        }
+        header.resp.bufferSize = static_cast<int>(body.size());
+
+        Reply reply{.due = std::chrono::steady_clock::now() + latency, .is_read = is_read};
+        reply.data.resize(sizeof(header) + body.size());
+        std::memcpy(reply.data.data(), &header, sizeof(header));
+        std::copy(body.begin(), body.end(), reply.data.begin() + sizeof(header));
+        {
+            std::scoped_lock lock{mutex};
+            replies.push_back(std::move(reply));
+            if (is_read) {
+                read_count++;
+                reads_in_flight++;
+                max_reads_in_flight = std::max<std::size_t>(max_reads_in_flight, reads_in_flight);
+            }
+        }
+        cv.notify_all();
+    }
+
+    void WorkerLoop() {
+        const SocketHolder conn = ::accept(worker_listener, nullptr, nullptr);
+        if (conn == static_cast<SocketHolder>(-1)) {
+            return;
+        }
+
+        std::unique_lock lock{mutex};
+        while (true) {
+            cv.wait(lock, [this] { return stop || !replies.empty(); });
+            if (stop) {
+                break;
+            }
+            Reply reply = std::move(replies.front());
+            replies.pop_front();
+            lock.unlock();
+
+            std::this_thread::sleep_until(reply.due);
+            const bool sent = SendAll(conn, reply.data.data(), reply.data.size());
+
+            lock.lock();
+            if (reply.is_read) {
+                reads_in_flight--;
+            }
+            if (!sent) {
+                break;
+            }
+        }
+        lock.unlock();
+        shutdown(conn, SHUT_RDWR);
+        closesocket(conn);
+    }
+
+    const std::size_t data_size;
+    const std::chrono::milliseconds latency;
+
+    SocketHolder main_listener;
+    SocketHolder worker_listener;
+    u16 main_port = 0;
+    u16 worker_port = 0;
+    std::thread main_thread;
+    std::thread worker_thread;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Reply> replies;
+    bool stop = false;
+    std::atomic<std::size_t> read_count = 0;
+    std::size_t reads_in_flight = 0;
+    std::atomic<std::size_t> max_reads_in_flight = 0;
+};
+
+std::shared_ptr<Network::ArticBase::Client> ConnectClient(const FakeArticServer& server) {
+    auto client = std::make_shared<Network::ArticBase::Client>("127.0.0.1", server.GetPort());
+    REQUIRE(client->Connect());
+    return client;
+}
+
+constexpr u64 CONTENT_HASH = 0x0123456789ABCDEF;
+
+bool CheckData(const std::vector<u8>& buffer, std::size_t offset) {
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+        if (buffer[i] != ByteAt(offset + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ArticCache pipelines large reads", "[core][file_sys]") {
+    constexpr std::size_t data_size = 1024 * 1024;
+    FakeArticServer server(data_size, std::chrono::milliseconds(20));
+    auto client = ConnectClient(server);
+
+    ArticCache cache(client);
+    cache.ForceSetSize(data_size);
+
+    std::vector<u8> buffer(16 * REQUEST_SIZE);
+    const std::size_t offset = 3 * REQUEST_SIZE;
+    auto res = cache.Read(FILE_HANDLE, offset, buffer.size(), buffer.data());
+    REQUIRE(res.Succeeded());
+    REQUIRE(res.Unwrap() == buffer.size());
+    REQUIRE(CheckData(buffer, offset));
+    REQUIRE(server.GetMaxReadsInFlight() > 1);
+}
+
+TEST_CASE("ArticCache prefetches sequential reads", "[core][file_sys]") {
+    constexpr std::size_t data_size = 1024 * 1024;
+    FakeArticServer server(data_size, std::chrono::milliseconds(2));
+    auto client = ConnectClient(server);
+
+    ArticCache cache(client);
+    cache.ForceSetSize(data_size);
+
+    constexpr std::size_t read_size = 4 * 1024;
+    constexpr std::size_t read_count = 64;
+    std::vector<u8> buffer(read_size);
+    for (std::size_t i = 0; i < read_count; i++) {
+        auto res = cache.Read(FILE_HANDLE, i * read_size, read_size, buffer.data());
+        REQUIRE(res.Succeeded());
+        REQUIRE(res.Unwrap() == read_size);
+        REQUIRE(CheckData(buffer, i * read_size));
+    }
+    REQUIRE(server.GetReadCount() < read_count / 2);
+}
+
+TEST_CASE("ArticCache serves reads from the disk cache", "[core][file_sys]") {
+    constexpr std::size_t data_size = 1024 * 1024 + 123;
+    FakeArticServer server(data_size, std::chrono::milliseconds(2));
+    auto client = ConnectClient(server);
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_tests" / "artic_disk_cache.bin").string();
+    FileUtil::Delete(path);
+    FileUtil::Delete(path + ".map");
+
+    // Neither read starts where the last one ended, so nothing is prefetched.
+    const std::size_t offset = 5 * 1024 + 17;
+    const std::size_t tail_offset = data_size - 1000;
+    std::vector<u8> buffer(12 * 1024);
+    std::vector<u8> tail(1000);
+    {
+        ArticCache cache(client);
+        cache.ForceSetSize(data_size);
+        cache.SetDiskCache(std::make_shared<ArticDiskCache>(path, data_size, CONTENT_HASH));
+        REQUIRE(cache.Read(FILE_HANDLE, offset, buffer.size(), buffer.data()).Succeeded());
+        REQUIRE(cache.Read(FILE_HANDLE, tail_offset, tail.size(), tail.data()).Succeeded());
+    }
+    const std::size_t read_count = server.GetReadCount();
+    REQUIRE(read_count != 0);
+
+    std::fill(buffer.begin(), buffer.end(), u8{0});
+    std::fill(tail.begin(), tail.end(), u8{0});
+    {
+        ArticCache cache(client);
+        cache.ForceSetSize(data_size);
+        auto disk_cache = std::make_shared<ArticDiskCache>(path, data_size, CONTENT_HASH);
+        REQUIRE(disk_cache->IsOpen());
+        cache.SetDiskCache(std::move(disk_cache));
+
+        auto res = cache.Read(FILE_HANDLE, offset, buffer.size(), buffer.data());
+        REQUIRE(res.Succeeded());
+        REQUIRE(res.Unwrap() == buffer.size());
+        REQUIRE(CheckData(buffer, offset));
+
+        res = cache.Read(FILE_HANDLE, tail_offset, tail.size(), tail.data());
+        REQUIRE(res.Succeeded());
+        REQUIRE(res.Unwrap() == tail.size());
+        REQUIRE(CheckData(tail, tail_offset));
+    }
+    REQUIRE(server.GetReadCount() == read_count);
+
+    // A store made for a source of a different size is discarded.
+    {
+        ArticDiskCache disk_cache(path, data_size + 1, CONTENT_HASH);
+        REQUIRE(disk_cache.IsOpen());
+        REQUIRE(!disk_cache.Read(offset, buffer.size(), buffer.data()));
+    }
+
+    // So is one made for different content of the same size.
+    {
+        ArticDiskCache disk_cache(path, data_size, CONTENT_HASH);
+        disk_cache.Write(0, buffer.size(), buffer.data());
+    }
+    {
+        ArticDiskCache disk_cache(path, data_size, CONTENT_HASH + 1);
+        REQUIRE(disk_cache.IsOpen());
+        REQUIRE(!disk_cache.Read(0, buffer.size(), buffer.data()));
+    }
+
+    FileUtil::Delete(path);
+    FileUtil::Delete(path + ".map");
+}
+
+TEST_CASE("ArticDiskCache prunes the least recently written stores", "[core][file_sys]") {
+    const auto directory = std::filesystem::temp_directory_path() / "citra_tests" / "artic_prune";
+    std::filesystem::remove_all(directory);
+
+    constexpr std::size_t data_size = 64 * 1024;
+    const std::vector<u8> data(data_size, 0xAB);
+    std::vector<std::string> paths;
+    for (u64 title = 0; title < 3; title++) {
+        const std::string path = (directory / fmt::format("{:016X}", title) / "store.bin").string();
+        {
+            ArticDiskCache disk_cache(path, data_size, CONTENT_HASH);
+            REQUIRE(disk_cache.IsOpen());
+            disk_cache.Write(0, data.size(), data.data());
+        }
+        // Modification times have a resolution of a second.
+        std::filesystem::last_write_time(
+            path + ".map", std::filesystem::file_time_type::clock::now() +
+                               std::chrono::seconds(static_cast<int>(title) - 10));
+        paths.push_back(path);
+    }
+
+    // Only two stores fit. The oldest one is in use, so the next oldest goes.
+    ArticDiskCache::Prune(directory.string(), 2 * data_size + 1024, paths[0]);
+    REQUIRE(FileUtil::Exists(paths[0]));
+    REQUIRE(!FileUtil::Exists(paths[1]));
+    REQUIRE(!FileUtil::Exists(paths[1] + ".map"));
+    REQUIRE(FileUtil::Exists(paths[2]));
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace FileSys
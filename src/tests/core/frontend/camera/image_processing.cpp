@@ -0,0 +1,141 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "core/frontend/camera/image_processing.h"
+
+namespace {
+
+constexpr u32 MakeRgbx(u32 r, u32 g, u32 b) {
+    return r | (g << 8) | (b << 16);
+}
+
+/// Synthetic pixels: every value of each channel against the extremes of the others, followed by
+/// random colours. The unused high byte is filled in as well, the conversions must ignore it.
+std::vector<u32> MakeSyntheticPixels() {
+    std::vector<u32> pixels;
+    for (u32 i = 0; i < 256; i++) {
+        for (const u32 other : {0u, 255u}) {
+            pixels.push_back(MakeRgbx(i, other, other));
+            pixels.push_back(MakeRgbx(other, i, other));
+            pixels.push_back(MakeRgbx(other, other, i));
+            pixels.push_back(MakeRgbx(i, i, other) | 0xFF000000);
+        }
+    }
+    std::mt19937 random{0x3D5};
+    for (int i = 0; i < 0x10000; i++) {
+        pixels.push_back(static_cast<u32>(random()));
+    }
+    return pixels;
+}
+
+template <typename Converter, typename Reference>
+void CheckConversion(Converter convert, Reference reference) {
+    const std::vector<u32> pixels = MakeSyntheticPixels();
+    // Every length up to a few SIMD widths, so that all tail handling is covered.
+    for (std::size_t size = 0; size <= 19; size++) {
+        for (std::size_t offset = 0; offset < 3; offset++) {
+            const auto src = std::span<const u32>(pixels).subspan(offset * 101, size);
+            std::vector<u16> expected(size, 0xDEAD);
+            std::vector<u16> result(size, 0xBEEF);
+            reference(src, expected);
+            convert(src, result);
+            REQUIRE(result == expected);
+        }
+    }
+    std::vector<u16> expected(pixels.size());
+    std::vector<u16> result(pixels.size());
+    reference(pixels, expected);
+    convert(pixels, result);
+    REQUIRE(result == expected);
+}
+
+/// Packs RGBX pixels into an RGB888 image with padded rows.
+std::vector<u8> MakeRgb888(const std::vector<u32>& pixels, int width, std::size_t stride) {
+    std::vector<u8> data(stride * (pixels.size() / width));
+    for (std::size_t i = 0; i < pixels.size(); i++) {
+        u8* texel = data.data() + (i / width) * stride + (i % width) * 3;
+        texel[0] = static_cast<u8>(pixels[i]);
+        texel[1] = static_cast<u8>(pixels[i] >> 8);
+        texel[2] = static_cast<u8>(pixels[i] >> 16);
+    }
+    return data;
+}
+
+std::vector<u16> ToRgb565(const std::vector<u32>& pixels) {
+    std::vector<u16> result(pixels.size());
+    Camera::ConvertToRgb565Scalar(pixels, result);
+    return result;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ConvertToRgb565 matches the scalar conversion", "[core][camera]") {
+    REQUIRE(ToRgb565({MakeRgbx(0xFF, 0, 0), MakeRgbx(0, 0xFF, 0), MakeRgbx(0, 0, 0xFF)}) ==
+            std::vector<u16>{0xF800, 0x07E0, 0x001F});
+    CheckConversion(Camera::ConvertToRgb565, Camera::ConvertToRgb565Scalar);
+}
+
+TEST_CASE("ConvertToYuv422 matches the scalar tables", "[core][camera]") {
+    std::vector<u16> black(2);
+    Camera::ConvertToYuv422Scalar(std::vector<u32>{0, 0}, black);
+    REQUIRE(black == std::vector<u16>{0x8000, 0x8000});
+    CheckConversion(Camera::ConvertToYuv422, Camera::ConvertToYuv422Scalar);
+}
+
+TEST_CASE("ProcessImage flips the image", "[core][camera]") {
+    // clang-format off
+    const std::vector<u32> pixels{
+        MakeRgbx(0x10, 0, 0), MakeRgbx(0x20, 0, 0), MakeRgbx(0x30, 0, 0),
+        MakeRgbx(0, 0x40, 0), MakeRgbx(0, 0x50, 0), MakeRgbx(0, 0x60, 0),
+    };
+    // clang-format on
+    const std::vector<u8> data = MakeRgb888(pixels, 3, 12);
+    const Camera::Rgb888Image image{data, 3, 2, 12};
+
+    std::vector<u16> frame(6);
+    Camera::ProcessImage(image, {3, 2, true, false, false}, frame);
+    REQUIRE(frame == ToRgb565(pixels));
+
+    Camera::ProcessImage(image, {3, 2, true, true, true}, frame);
+    REQUIRE(frame == ToRgb565({pixels[5], pixels[4], pixels[3], pixels[2], pixels[1], pixels[0]}));
+}
+
+TEST_CASE("ProcessImage crops the centre of wider images", "[core][camera]") {
+    const u32 red = MakeRgbx(0xFF, 0, 0);
+    const u32 blue = MakeRgbx(0, 0, 0xFF);
+    const std::vector<u32> pixels{red, red, red, blue, blue, red, red, red,
+                                  red, red, red, blue, blue, red, red, red};
+    const std::vector<u8> data = MakeRgb888(pixels, 8, 24);
+
+    std::vector<u16> frame(4);
+    Camera::ProcessImage({data, 8, 2, 24}, {2, 2, false, false, false}, frame);
+
+    std::vector<u16> expected(4);
+    Camera::ConvertToYuv422Scalar(std::vector<u32>(4, blue), expected);
+    REQUIRE(frame == expected);
+}
+
+TEST_CASE("ProcessImage scales the image", "[core][camera]") {
+    const u32 colour = MakeRgbx(0x12, 0x9A, 0xE4);
+    const std::vector<u8> data = MakeRgb888(std::vector<u32>(64 * 48, colour), 64, 64 * 3);
+
+    // Uniform images stay uniform whatever the filtering, in both directions.
+    for (const auto& [width, height] : {std::pair{16, 12}, std::pair{160, 120}}) {
+        std::vector<u16> frame(width * height);
+        Camera::ProcessImage({data, 64, 48, 64 * 3}, {width, height, false, false, false}, frame);
+
+        std::vector<u16> expected(width * height);
+        Camera::ConvertToYuv422Scalar(std::vector<u32>(width * height, colour), expected);
+        REQUIRE(frame == expected);
+    }
+}
+
+TEST_CASE("ProcessImage outputs black for empty images", "[core][camera]") {
+    std::vector<u16> frame(4, 0xFFFF);
+    Camera::ProcessImage({{}, 0, 0, 0}, {2, 2, false, false, false}, frame);
+    REQUIRE(frame == std::vector<u16>(4, 0));
+}
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -402,4 +403,73 @@ TEST_CASE("HLERequestContext::WriteToOutgoingCommandBuffer", "[core][kernel]") {
     }
 }
 
+
+TEST_CASE("MappedBuffer::GetBackingBlocks", "[core][kernel]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto [server, client] = kernel.CreateSessionPair();
+    HLERequestContext context(kernel, std::move(server), nullptr);
+
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    // Two separately backed pages, so the buffer spans two blocks.
+    auto first_mem = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE);
+    auto second_mem = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE);
+    MemoryRef first_buffer{first_mem};
+    MemoryRef second_buffer{second_mem};
+
+    const VAddr target_address = 0x10000000;
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(target_address, first_buffer, Memory::CITRA_PAGE_SIZE,
+                                  MemoryState::Private)
+                .Code() == ResultSuccess);
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(target_address + Memory::CITRA_PAGE_SIZE, second_buffer,
+                                  Memory::CITRA_PAGE_SIZE, MemoryState::Private)
+                .Code() == ResultSuccess);
+
+    const u32 buffer_size = Memory::CITRA_PAGE_SIZE + 0x10;
+    const u32_le input_cmdbuff[]{
+        IPC::MakeHeader(0, 0, 2),
+        IPC::MappedBufferDesc(buffer_size, IPC::W),
+        target_address,
+    };
+    context.PopulateFromIncomingCommandBuffer(input_cmdbuff, process);
+    auto& mapped_buffer = context.GetMappedBuffer(0);
+
+    SECTION("returns the blocks backing the buffer") {
+        auto blocks = mapped_buffer.GetBackingBlocks();
+        REQUIRE(blocks.Succeeded());
+        REQUIRE(blocks->size() == 2);
+        CHECK((*blocks)[0].first.GetPtr() == first_buffer.GetPtr());
+        CHECK((*blocks)[0].second == Memory::CITRA_PAGE_SIZE);
+        CHECK((*blocks)[1].first.GetPtr() == second_buffer.GetPtr());
+        CHECK((*blocks)[1].second == 0x10);
+
+        // Data written through the blocks lands in the guest pages.
+        mapped_buffer.PrepareDirectWrite(buffer_size);
+        std::fill_n((*blocks)[0].first.GetPtr(), (*blocks)[0].second, 0xAB);
+        std::fill_n((*blocks)[1].first.GetPtr(), (*blocks)[1].second, 0xCD);
+
+        std::vector<u8> guest(buffer_size);
+        memory.ReadBlock(*process, target_address, guest.data(), guest.size());
+        CHECK(std::all_of(guest.begin(), guest.begin() + Memory::CITRA_PAGE_SIZE,
+                          [](u8 v) { return v == 0xAB; }));
+        CHECK(std::all_of(guest.begin() + Memory::CITRA_PAGE_SIZE, guest.end(),
+                          [](u8 v) { return v == 0xCD; }));
+    }
+
+    SECTION("fails once the memory is unmapped") {
+        REQUIRE(process->vm_manager.UnmapRange(target_address + Memory::CITRA_PAGE_SIZE,
+                                               Memory::CITRA_PAGE_SIZE) == ResultSuccess);
+        CHECK(mapped_buffer.GetBackingBlocks().Failed());
+    }
+
+    process->vm_manager.UnmapRange(target_address, 2 * Memory::CITRA_PAGE_SIZE);
+}
+
 } // namespace Kernel
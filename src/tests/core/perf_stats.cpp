@@ -0,0 +1,36 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "core/perf_stats.h"
+
+namespace Core {
+
+TEST_CASE("FrameTimeHistogram percentiles", "[core]") {
+    FrameTimeHistogram histogram;
+    REQUIRE(histogram.GetPercentile(50) == 0);
+
+    // 98 frames on time, one late and one very late past the last bin
+    for (int i = 0; i < 98; i++) {
+        histogram.Add(16.65);
+    }
+    histogram.Add(33.35);
+    histogram.Add(250.0);
+    REQUIRE(histogram.GetCount() == 100);
+
+    const auto near = [](double value, double expected) {
+        return value >= expected - FrameTimeHistogram::BIN_WIDTH_MS && value <= expected;
+    };
+    REQUIRE(near(histogram.GetPercentile(0), 16.7));
+    REQUIRE(near(histogram.GetPercentile(50), 16.7));
+    REQUIRE(near(histogram.GetPercentile(98), 16.7));
+    REQUIRE(near(histogram.GetPercentile(99), 33.4));
+    REQUIRE(histogram.GetPercentile(100) == 250.0);
+
+    histogram.Reset();
+    REQUIRE(histogram.GetCount() == 0);
+    REQUIRE(histogram.GetPercentile(99) == 0);
+}
+
+} // namespace Core
@@ -0,0 +1,156 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <nihstro/inline_assembly.h>
+#include "tests/video_core/shader_test_utils.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/glsl_shader_decompiler.h"
+
+using Pica::Shader::Generator::GLSL::DecompileGeometryProgram;
+using Pica::Shader::Generator::GLSL::DecompileProgram;
+using Pica::Shader::Generator::GLSL::GSDecompileResult;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+
+static GSDecompileResult Decompile(const Pica::ShaderSetup& setup) {
+    const auto get_input_reg = [](u32 reg) { return fmt::format("vs_out_attr0[{}]", reg); };
+    const auto get_output_reg = [](u32 reg) -> std::string {
+        return reg == 0 ? "gs_out_reg0" : "";
+    };
+    return DecompileGeometryProgram(setup.program_code, setup.swizzle_data, 0, get_input_reg,
+                                    get_output_reg, {}, false);
+}
+
+TEST_CASE("Geometry shader emitting a triangle per invocation", "[video_core][shader]") {
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::NOP}, // setemit 0
+        {OpCode::Id::MOV, sh_output, SourceRegister::MakeInput(0)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::NOP}, // setemit 1
+        {OpCode::Id::MOV, sh_output, SourceRegister::MakeInput(1)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::NOP}, // setemit 2, prim
+        {OpCode::Id::MOV, sh_output, SourceRegister::MakeInput(2)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::END},
+    });
+    for (u32 vertex = 0; vertex < 3; ++vertex) {
+        InsertSetEmit(*setup, vertex * 3, vertex, vertex == 2);
+        InsertEmit(*setup, vertex * 3 + 2);
+    }
+
+    const auto result = Decompile(*setup);
+    REQUIRE(!result.code.empty());
+    REQUIRE(result.max_vertices == 3);
+    REQUIRE(result.code.find("setemit(2u, true, false);") != std::string::npos);
+    REQUIRE(result.code.find("emit();") != std::string::npos);
+}
+
+TEST_CASE("Geometry shader reading registers no invocation writes", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::NOP}, // setemit 0
+        // The temporary and the unwritten vertex slots come from the shader unit state
+        {OpCode::Id::ADD, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0),
+         SourceRegister::MakeTemporary(1)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::END},
+    });
+    InsertSetEmit(*setup, 0, 0, false);
+    InsertEmit(*setup, 2);
+
+    REQUIRE(!Decompile(*setup).code.empty());
+}
+
+TEST_CASE("Geometry shader carrying a temporary between invocations", "[video_core][shader]") {
+    const auto sh_temp = SourceRegister::MakeTemporary(0);
+
+    auto setup = CompileShaderSetup({
+        // Accumulating into r0 depends on the previous invocation
+        {OpCode::Id::ADD, DestRegister::MakeTemporary(0), sh_temp, SourceRegister::MakeInput(0)},
+        {OpCode::Id::NOP}, // setemit 0
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), sh_temp},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::END},
+    });
+    InsertSetEmit(*setup, 1, 0, false);
+    InsertEmit(*setup, 3);
+
+    REQUIRE(Decompile(*setup).code.empty());
+}
+
+TEST_CASE("Geometry shader completing a primitive of earlier invocations",
+          "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::NOP}, // setemit 2, prim
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::END},
+    });
+    InsertSetEmit(*setup, 0, 2, true);
+    InsertEmit(*setup, 2);
+
+    REQUIRE(Decompile(*setup).code.empty());
+}
+
+TEST_CASE("Geometry shader writing a temporary in some invocations", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::NOP}, // cmp v0, v1
+        {OpCode::Id::NOP}, // ifc 3, 0
+        // Only invocations taking the branch leave their input in r1
+        {OpCode::Id::MOV, DestRegister::MakeTemporary(1), SourceRegister::MakeInput(0)},
+        {OpCode::Id::NOP}, // setemit 0
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::END},
+    });
+    InsertCompare(*setup, 0, SourceRegister::MakeInput(0), SourceRegister::MakeInput(1));
+    InsertFlowControl(*setup, 1, OpCode::Id::IFC, 3, 0);
+    InsertSetEmit(*setup, 3, 0, false);
+    InsertEmit(*setup, 5);
+
+    REQUIRE(Decompile(*setup).code.empty());
+}
+
+TEST_CASE("Geometry shader writing a temporary on both branches", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::NOP}, // cmp v0, v1
+        {OpCode::Id::NOP}, // ifc 3, 1
+        {OpCode::Id::MOV, DestRegister::MakeTemporary(1), SourceRegister::MakeInput(0)},
+        {OpCode::Id::MOV, DestRegister::MakeTemporary(1), SourceRegister::MakeInput(1)},
+        {OpCode::Id::NOP}, // setemit 0
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::END},
+    });
+    InsertCompare(*setup, 0, SourceRegister::MakeInput(0), SourceRegister::MakeInput(1));
+    InsertFlowControl(*setup, 1, OpCode::Id::IFC, 3, 1);
+    InsertSetEmit(*setup, 4, 0, false);
+    InsertEmit(*setup, 6);
+
+    REQUIRE(!Decompile(*setup).code.empty());
+}
+
+TEST_CASE("DPH replaces the w of its first operand with 1", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::DPH, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0),
+         SourceRegister::MakeInput(1)},
+        {OpCode::Id::END},
+    });
+
+    const auto get_input_reg = [](u32 reg) { return fmt::format("vs_in_reg{}", reg); };
+    const auto get_output_reg = [](u32 reg) -> std::string {
+        return reg == 0 ? "vs_out_attr0" : "";
+    };
+    for (const bool sanitize_mul : {false, true}) {
+        const auto code = DecompileProgram(setup->program_code, setup->swizzle_data, 0,
+                                           get_input_reg, get_output_reg, sanitize_mul);
+        REQUIRE(code.find(".xyz, 1.0), vs_in_reg1.") != std::string::npos);
+    }
+}
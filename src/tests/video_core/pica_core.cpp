@@ -0,0 +1,476 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/memory.h"
+#include "tests/video_core/shader_test_utils.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/pica/pica_core.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/shader/generator/glsl_shader_decompiler.h"
+
+namespace {
+
+class CommandListBuilder {
+public:
+    void Write(u32 id, std::initializer_list<u32> values, bool group = true, u32 mask = 0xF) {
+        Write(id, std::vector<u32>(values), group, mask);
+    }
+
+    void Write(u32 id, const std::vector<u32>& values, bool group = true, u32 mask = 0xF) {
+        const u32 header = id | (mask << 16) | (static_cast<u32>(values.size() - 1) << 20) |
+                           (static_cast<u32>(group) << 31);
+        words.push_back(values[0]);
+        words.push_back(header);
+        words.insert(words.end(), values.begin() + 1, values.end());
+        if (words.size() % 2 != 0) {
+            words.push_back(0);
+        }
+    }
+
+    std::vector<u32> words;
+};
+
+/// Writes that WriteInternalReg can always handle without a rasterizer or an interrupt handler.
+bool IsSafeReg(u32 id) {
+    const auto in_range = [id](std::size_t first, std::size_t count) {
+        return id >= first && id < first + count;
+    };
+    return !(id == PICA_REG_INDEX(irq_request) ||
+             in_range(PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[0]), 3) ||
+             in_range(PICA_REG_INDEX(pipeline.command_buffer.trigger[0]), 2) ||
+             id == PICA_REG_INDEX(pipeline.trigger_draw) ||
+             id == PICA_REG_INDEX(pipeline.trigger_draw_indexed) ||
+             in_range(PICA_REG_INDEX(gs.uniform_setup.set_value[0]), 8) ||
+             in_range(PICA_REG_INDEX(gs.program.set_word[0]), 8) ||
+             in_range(PICA_REG_INDEX(gs.swizzle_patterns.set_word[0]), 8) ||
+             in_range(PICA_REG_INDEX(vs.uniform_setup.set_value[0]), 8) ||
+             in_range(PICA_REG_INDEX(vs.program.set_word[0]), 8) ||
+             in_range(PICA_REG_INDEX(vs.swizzle_patterns.set_word[0]), 8) ||
+             in_range(PICA_REG_INDEX(lighting.lut_data[0]), 8));
+}
+
+bool IsSafeRange(u32 first, u32 count) {
+    if (first + count > Pica::RegsInternal::NUM_REGS) {
+        return false;
+    }
+    for (u32 id = first; id < first + count; ++id) {
+        if (!IsSafeReg(id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Builds a command list shaped like the ones games submit: runs of state registers mixed with
+/// uniform uploads and table writes.
+std::vector<u32> BuildCommandList(u32 seed) {
+    std::mt19937 rng{seed};
+    CommandListBuilder builder;
+
+    for (u32 batch = 0; batch < 64; ++batch) {
+        for (u32 i = 0; i < 16; ++i) {
+            const u32 id = rng() % Pica::RegsInternal::NUM_REGS;
+            const u32 count = 1 + rng() % 16;
+            const bool group = rng() % 4 != 0;
+            const u32 mask = rng() % 4 == 0 ? rng() % 16 : 0xF;
+            if (!IsSafeRange(id, group ? count : 1)) {
+                continue;
+            }
+            std::vector<u32> values(count);
+            std::generate(values.begin(), values.end(), [&rng] { return rng(); });
+            builder.Write(id, values, group, mask);
+        }
+
+        // Upload a few float24 or float32 uniforms, starting the group at the setup register.
+        std::vector<u32> uniforms(1 + 8);
+        uniforms[0] = (rng() % 2) << 31 | (rng() % 90);
+        std::generate(uniforms.begin() + 1, uniforms.end(), [&rng] { return rng(); });
+        builder.Write(PICA_REG_INDEX(vs.uniform_setup), uniforms);
+        std::generate(uniforms.begin(), uniforms.end(), [&rng] { return rng(); });
+        builder.Write(PICA_REG_INDEX(vs.uniform_setup.set_value[0]), uniforms, false);
+
+        builder.Write(PICA_REG_INDEX(pipeline.restart_primitive), {1});
+    }
+    return builder.words;
+}
+
+/// Whether the geometry shader of the setup can run on the host.
+bool CanDecompileGeometryShader(const Pica::ShaderSetup& setup) {
+    const auto get_input_reg = [](u32 reg) { return fmt::format("vs_out_attr0[{}]", reg); };
+    const auto get_output_reg = [](u32 reg) -> std::string {
+        return reg == 0 ? "gs_out_reg0" : "";
+    };
+    const auto get_uniform_reg = [](u32 index) { return fmt::format("uniforms.f[{}]", index); };
+    return !Pica::Shader::Generator::GLSL::DecompileGeometryProgram(
+                setup.program_code, setup.swizzle_data, 0, get_input_reg, get_output_reg,
+                get_uniform_reg, false)
+                .code.empty();
+}
+
+/// Rasterizer that either draws every batch on the host or leaves all of them to the CPU. When a
+/// geometry shader is given, it is only drawn on the host if the decompiler accepts it, as the
+/// OpenGL rasterizer does.
+class FakeRasterizer final : public VideoCore::RasterizerInterface {
+public:
+    explicit FakeRasterizer(bool accelerate_) : accelerate{accelerate_} {}
+
+    void AddTriangle(const Pica::OutputVertex&, const Pica::OutputVertex&,
+                     const Pica::OutputVertex&) override {
+        ++triangles;
+    }
+    void DrawTriangles() override {}
+    void FlushAll() override {}
+    void FlushRegion(PAddr, u32) override {}
+    void InvalidateRegion(PAddr, u32) override {}
+    void FlushAndInvalidateRegion(PAddr, u32) override {}
+    void ClearAll(bool) override {}
+
+    bool AccelerateDrawBatch(bool) override {
+        return accelerate && (!gs_setup || CanDecompileGeometryShader(*gs_setup));
+    }
+
+    bool accelerate;
+    const Pica::ShaderSetup* gs_setup = nullptr;
+    u32 triangles = 0;
+};
+
+/// Configures a draw of num_vertices positions read from FCRAM at 0x1000, which the vertex shader
+/// passes through.
+void SetupVertexArray(Pica::PicaCore& pica, u32 num_vertices) {
+    using nihstro::DestRegister;
+    using nihstro::OpCode;
+    using nihstro::SourceRegister;
+    using Pica::PipelineRegs;
+
+    auto& regs = pica.regs.internal;
+    auto& attributes = regs.pipeline.vertex_attributes;
+    attributes.base_address.Assign(Memory::FCRAM_PADDR / 16);
+    attributes.format0.Assign(PipelineRegs::VertexAttributeFormat::FLOAT);
+    attributes.size0.Assign(3);
+    attributes.max_attribute_index.Assign(0);
+    attributes.attribute_loaders[0].data_offset.Assign(0x1000);
+    attributes.attribute_loaders[0].comp0.Assign(0);
+    attributes.attribute_loaders[0].byte_count.Assign(16);
+    attributes.attribute_loaders[0].component_count.Assign(1);
+    regs.pipeline.num_vertices = num_vertices;
+    regs.pipeline.vertex_offset = 0;
+    regs.vs.output_mask.Assign(1);
+
+    const auto vs = CompileShaderSetup({
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0)},
+        {OpCode::Id::END},
+    });
+    pica.vs_setup.program_code = vs->program_code;
+    pica.vs_setup.swizzle_data = vs->swizzle_data;
+    pica.vs_setup.MarkProgramCodeDirty();
+    pica.vs_setup.MarkSwizzleDataDirty();
+}
+
+/**
+ * Configures a FixedPrimitive geometry shader draw of num_vertices vertices read from FCRAM. The
+ * geometry shader emits a triangle from the three vertices buffered in the float uniforms
+ * starting at c8.
+ */
+void SetupFixedPrimitiveDraw(Pica::PicaCore& pica, u32 num_vertices) {
+    using nihstro::DestRegister;
+    using nihstro::OpCode;
+    using nihstro::SourceRegister;
+    using Pica::PipelineRegs;
+
+    SetupVertexArray(pica, num_vertices);
+
+    auto& regs = pica.regs.internal;
+    regs.pipeline.use_gs.Assign(PipelineRegs::UseGS::Yes);
+    regs.pipeline.vs_outmap_total_minus_1_a.Assign(0);
+    regs.pipeline.vs_outmap_total_minus_1_b.Assign(0);
+    regs.pipeline.gs_config.mode.Assign(PipelineRegs::GSMode::FixedPrimitive);
+    regs.pipeline.gs_config.fixed_vertex_num_minus_1.Assign(2);
+    regs.pipeline.gs_config.stride_minus_1.Assign(0);
+    regs.pipeline.gs_config.start_index.Assign(8);
+
+    regs.gs.output_mask.Assign(1);
+    regs.gs.input_to_uniform.Assign(1);
+    regs.gs.shader_mode.Assign(Pica::ShaderRegs::ShaderMode::GS);
+
+    const auto gs = CompileShaderSetup({
+        {OpCode::Id::NOP}, // setemit 0
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeFloat(8)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::NOP}, // setemit 1
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeFloat(9)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::NOP}, // setemit 2, prim
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeFloat(10)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::MOV, DestRegister::MakeTemporary(0), SourceRegister::MakeFloat(8)},
+        {OpCode::Id::END},
+    });
+    for (u32 vertex = 0; vertex < 3; ++vertex) {
+        InsertSetEmit(*gs, vertex * 3, vertex, vertex == 2);
+        InsertEmit(*gs, vertex * 3 + 2);
+    }
+
+    pica.gs_setup.program_code = gs->program_code;
+    pica.gs_setup.swizzle_data = gs->swizzle_data;
+    pica.gs_setup.MarkProgramCodeDirty();
+    pica.gs_setup.MarkSwizzleDataDirty();
+    pica.gs_setup.uniforms.b[15] = false;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PicaCore stores plain registers like WriteInternalReg", "[video_core][pica]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Pica::PicaCore direct{memory, nullptr};
+    // Attaching a debug context makes every write go through WriteInternalReg.
+    Pica::PicaCore dispatched{memory, Pica::DebugContext::Construct()};
+
+    for (u32 seed = 0; seed < 8; ++seed) {
+        const auto words = BuildCommandList(seed);
+        std::memcpy(memory.GetFCRAMPointer(0), words.data(), words.size() * sizeof(u32));
+
+        direct.dirty_regs.Reset();
+        dispatched.dirty_regs.Reset();
+        direct.ProcessCmdList(Memory::FCRAM_PADDR, static_cast<u32>(words.size() * 4), false);
+        dispatched.ProcessCmdList(Memory::FCRAM_PADDR, static_cast<u32>(words.size() * 4), false);
+
+        REQUIRE(direct.regs.reg_array == dispatched.regs.reg_array);
+        REQUIRE(direct.dirty_regs.qwords == dispatched.dirty_regs.qwords);
+        REQUIRE(direct.vs_setup.uniforms.f == dispatched.vs_setup.uniforms.f);
+    }
+}
+
+TEST_CASE("PicaCore lists every register WriteInternalReg handles", "[video_core][pica]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Pica::PicaCore direct{memory, nullptr};
+    // WriteInternalReg asserts that the registers of its switch have side effects, and the debug
+    // context makes every register go through it.
+    Pica::PicaCore dispatched{memory, Pica::DebugContext::Construct()};
+
+    CommandListBuilder builder;
+    for (u32 id = 0; id < Pica::RegsInternal::NUM_REGS; ++id) {
+        if (IsSafeReg(id)) {
+            builder.Write(id, {0});
+        }
+    }
+    std::memcpy(memory.GetFCRAMPointer(0), builder.words.data(),
+                builder.words.size() * sizeof(u32));
+    const u32 size = static_cast<u32>(builder.words.size() * sizeof(u32));
+    direct.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    dispatched.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    REQUIRE(direct.regs.reg_array == dispatched.regs.reg_array);
+}
+
+TEST_CASE("PicaCore command list replay", "[.][video_core][pica][benchmark]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Pica::PicaCore direct{memory, nullptr};
+    Pica::PicaCore dispatched{memory, Pica::DebugContext::Construct()};
+
+    const auto words = BuildCommandList(0);
+    std::memcpy(memory.GetFCRAMPointer(0), words.data(), words.size() * sizeof(u32));
+    const u32 size = static_cast<u32>(words.size() * sizeof(u32));
+
+    BENCHMARK("Direct stores") {
+        direct.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    };
+    BENCHMARK("Per register dispatch") {
+        dispatched.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    };
+}
+
+TEST_CASE("PicaCore leaves the geometry shader unit as the software pipeline does",
+          "[video_core][pica]") {
+    const bool use_hw_shader = Settings::values.use_hw_shader.GetValue();
+    Settings::values.use_hw_shader.SetValue(true);
+
+    Core::System system;
+    Memory::MemorySystem memory{system};
+
+    // Two invocations of three vertices each, with distinct positions.
+    constexpr u32 num_vertices = 6;
+    std::vector<float> vertices(num_vertices * 4);
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        vertices[i] = static_cast<float>(i) + 0.5f;
+    }
+    std::memcpy(memory.GetFCRAMPointer(0x1000), vertices.data(), vertices.size() * sizeof(float));
+
+    CommandListBuilder builder;
+    builder.Write(PICA_REG_INDEX(pipeline.trigger_draw), {1});
+    std::memcpy(memory.GetFCRAMPointer(0), builder.words.data(),
+                builder.words.size() * sizeof(u32));
+    const u32 size = static_cast<u32>(builder.words.size() * sizeof(u32));
+
+    FakeRasterizer software_rasterizer{false};
+    FakeRasterizer host_rasterizer{true};
+    Pica::PicaCore software{memory, nullptr};
+    Pica::PicaCore host{memory, nullptr};
+    software.BindRasterizer(&software_rasterizer);
+    host.BindRasterizer(&host_rasterizer);
+    SetupFixedPrimitiveDraw(software, num_vertices);
+    SetupFixedPrimitiveDraw(host, num_vertices);
+
+    software.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    host.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    Settings::values.use_hw_shader.SetValue(use_hw_shader);
+
+    REQUIRE(software.GetDrawStats().rejected == 1);
+    REQUIRE(host.GetDrawStats().accelerated == 1);
+    REQUIRE(software_rasterizer.triangles == 2);
+    REQUIRE(host_rasterizer.triangles == 0);
+
+    // The last invocation's vertices stay buffered in the uniforms, and b15 is raised.
+    REQUIRE(std::memcmp(software.gs_setup.uniforms.f.data(), host.gs_setup.uniforms.f.data(),
+                        sizeof(host.gs_setup.uniforms.f)) == 0);
+    REQUIRE(host.gs_setup.uniforms.f[8].x.ToFloat32() == vertices[3 * 4]);
+    REQUIRE(host.gs_setup.uniforms.b == software.gs_setup.uniforms.b);
+    REQUIRE(host.gs_setup.uniforms.b[15]);
+
+    // The registers are those of the last invocation.
+    REQUIRE(std::memcmp(software.gs_unit.temporary.data(), host.gs_unit.temporary.data(),
+                        sizeof(host.gs_unit.temporary)) == 0);
+    REQUIRE(std::memcmp(software.gs_unit.output.data(), host.gs_unit.output.data(),
+                        sizeof(host.gs_unit.output)) == 0);
+}
+
+TEST_CASE("PicaCore leaves registers written by some invocations as the software pipeline does",
+          "[video_core][pica]") {
+    using nihstro::DestRegister;
+    using nihstro::OpCode;
+    using nihstro::SourceRegister;
+
+    const bool use_hw_shader = Settings::values.use_hw_shader.GetValue();
+    Settings::values.use_hw_shader.SetValue(true);
+
+    Core::System system;
+    Memory::MemorySystem memory{system};
+
+    constexpr u32 num_vertices = 6;
+    std::vector<float> vertices(num_vertices * 4);
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        vertices[i] = static_cast<float>(i) + 0.5f;
+    }
+    std::memcpy(memory.GetFCRAMPointer(0x1000), vertices.data(), vertices.size() * sizeof(float));
+
+    CommandListBuilder builder;
+    builder.Write(PICA_REG_INDEX(pipeline.trigger_draw), {1});
+    std::memcpy(memory.GetFCRAMPointer(0), builder.words.data(),
+                builder.words.size() * sizeof(u32));
+    const u32 size = static_cast<u32>(builder.words.size() * sizeof(u32));
+
+    // Only the first invocation, whose first vertex has x below c0.x, writes r1.
+    const auto gs = CompileShaderSetup({
+        {OpCode::Id::MOV, DestRegister::MakeTemporary(2), SourceRegister::MakeFloat(0)},
+        {OpCode::Id::NOP}, // setemit 0
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeFloat(8)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::NOP}, // setemit 1
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeFloat(9)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::NOP}, // setemit 2, prim
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeFloat(10)},
+        {OpCode::Id::NOP}, // emit
+        {OpCode::Id::NOP}, // cmp c8, r2
+        {OpCode::Id::NOP}, // ifc 13, 0
+        {OpCode::Id::MOV, DestRegister::MakeTemporary(1), SourceRegister::MakeFloat(8)},
+        {OpCode::Id::END},
+    });
+    for (u32 vertex = 0; vertex < 3; ++vertex) {
+        InsertSetEmit(*gs, vertex * 3 + 1, vertex, vertex == 2);
+        InsertEmit(*gs, vertex * 3 + 3);
+    }
+    InsertCompare(*gs, 10, SourceRegister::MakeFloat(8), SourceRegister::MakeTemporary(2));
+    InsertFlowControl(*gs, 11, OpCode::Id::IFC, 13, 0);
+
+    FakeRasterizer software_rasterizer{false};
+    FakeRasterizer host_rasterizer{true};
+    Pica::PicaCore software{memory, nullptr};
+    Pica::PicaCore host{memory, nullptr};
+    software.BindRasterizer(&software_rasterizer);
+    host.BindRasterizer(&host_rasterizer);
+    host_rasterizer.gs_setup = &host.gs_setup;
+    for (auto* pica : {&software, &host}) {
+        SetupFixedPrimitiveDraw(*pica, num_vertices);
+        pica->gs_setup.program_code = gs->program_code;
+        pica->gs_setup.swizzle_data = gs->swizzle_data;
+        const auto threshold = Pica::f24::FromFloat32(vertices[2 * 4]);
+        pica->gs_setup.uniforms.f[0] = {threshold, threshold, threshold, threshold};
+    }
+
+    software.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    host.ProcessCmdList(Memory::FCRAM_PADDR, size, false);
+    Settings::values.use_hw_shader.SetValue(use_hw_shader);
+
+    // Replaying the last invocation would leave r1 unwritten, so the draw stays on the CPU.
+    REQUIRE(host.GetDrawStats().rejected == 1);
+    REQUIRE(software.gs_unit.temporary[1].x.ToFloat32() == vertices[0]);
+    REQUIRE(std::memcmp(software.gs_unit.temporary.data(), host.gs_unit.temporary.data(),
+                        sizeof(host.gs_unit.temporary)) == 0);
+    REQUIRE(std::memcmp(software.gs_unit.output.data(), host.gs_unit.output.data(),
+                        sizeof(host.gs_unit.output)) == 0);
+}
+
+TEST_CASE("PicaCore only carries strip vertices over to draws that continue the strip",
+          "[video_core][pica]") {
+    using Pica::PipelineRegs;
+
+    const bool use_hw_shader = Settings::values.use_hw_shader.GetValue();
+    Settings::values.use_hw_shader.SetValue(true);
+
+    Core::System system;
+    Memory::MemorySystem memory{system};
+
+    constexpr u32 num_vertices = 6;
+    std::vector<float> vertices(num_vertices * 4, 1.0f);
+    std::memcpy(memory.GetFCRAMPointer(0x1000), vertices.data(), vertices.size() * sizeof(float));
+
+    const auto draw_strips = [&](bool restart) {
+        CommandListBuilder builder;
+        builder.Write(PICA_REG_INDEX(pipeline.triangle_topology),
+                      {static_cast<u32>(PipelineRegs::TriangleTopology::Strip) << 8});
+        builder.Write(PICA_REG_INDEX(pipeline.trigger_draw), {1});
+        if (restart) {
+            builder.Write(PICA_REG_INDEX(pipeline.restart_primitive), {1});
+        }
+        builder.Write(PICA_REG_INDEX(pipeline.trigger_draw), {1});
+        builder.Write(PICA_REG_INDEX(pipeline.restart_primitive), {1});
+        std::memcpy(memory.GetFCRAMPointer(0), builder.words.data(),
+                    builder.words.size() * sizeof(u32));
+
+        FakeRasterizer rasterizer{true};
+        Pica::PicaCore pica{memory, nullptr};
+        pica.BindRasterizer(&rasterizer);
+        SetupVertexArray(pica, num_vertices);
+        pica.ProcessCmdList(Memory::FCRAM_PADDR,
+                            static_cast<u32>(builder.words.size() * sizeof(u32)), false);
+        return std::make_pair(pica.GetDrawStats(), rasterizer.triangles);
+    };
+
+    SECTION("restarted strips are drawn on the host alone") {
+        const auto [stats, triangles] = draw_strips(true);
+        REQUIRE(stats.accelerated == 2);
+        REQUIRE(stats.carried_over == 0);
+        REQUIRE(triangles == 0);
+    }
+
+    SECTION("a continued strip builds its first triangles from the previous draw") {
+        const auto [stats, triangles] = draw_strips(false);
+        REQUIRE(stats.accelerated == 2);
+        REQUIRE(stats.carried_over == 2);
+        REQUIRE(triangles == 2);
+    }
+
+    Settings::values.use_hw_shader.SetValue(use_hw_shader);
+}
@@ -0,0 +1,148 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "video_core/pica/primitive_assembly.h"
+
+using Pica::OutputVertex;
+using Pica::PrimitiveAssembler;
+using Topology = Pica::PipelineRegs::TriangleTopology;
+using Triangle = std::array<u32, 3>;
+
+namespace {
+
+OutputVertex MakeVertex(u32 id) {
+    OutputVertex vertex{};
+    vertex.pos.x = Pica::f24::FromFloat32(static_cast<float>(id));
+    return vertex;
+}
+
+u32 GetId(const OutputVertex& vertex) {
+    return static_cast<u32>(vertex.pos.x.ToFloat32());
+}
+
+struct TriangleRecorder {
+    std::vector<Triangle> triangles;
+
+    PrimitiveAssembler::TriangleHandler Handler() {
+        return [this](const OutputVertex& v0, const OutputVertex& v1, const OutputVertex& v2) {
+            triangles.push_back({GetId(v0), GetId(v1), GetId(v2)});
+        };
+    }
+};
+
+/// Appends the triangles the host draws for vertices [first, first + count) of the batch.
+void DrawHost(Topology topology, u32 first, u32 count, std::vector<Triangle>& triangles) {
+    for (u32 i = 0; i + 2 < count; ++i) {
+        const u32 v = first + i;
+        switch (topology) {
+        case Topology::List:
+            if (i % 3 == 0) {
+                triangles.push_back({v, v + 1, v + 2});
+            }
+            break;
+        case Topology::Strip:
+            if (i % 2 == 0) {
+                triangles.push_back({v, v + 1, v + 2});
+            } else {
+                triangles.push_back({v + 1, v, v + 2});
+            }
+            break;
+        case Topology::Fan:
+            triangles.push_back({first, v + 1, v + 2});
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+constexpr u32 PREVIOUS_ID = 100;
+constexpr u32 NEXT_ID = 200;
+
+} // Anonymous namespace
+
+TEST_CASE("PrimitiveAssembler splits batches like submitting every vertex",
+          "[video_core][primitive_assembly]") {
+    const auto topology = GENERATE(Topology::List, Topology::Strip, Topology::Fan);
+    const u32 num_previous = GENERATE(0u, 1u, 2u, 3u, 4u);
+    const u32 num_vertices = GENERATE(range(0u, 10u));
+
+    const auto noop = [](const OutputVertex&, const OutputVertex&, const OutputVertex&) {};
+
+    PrimitiveAssembler reference{topology};
+    PrimitiveAssembler split_assembler{topology};
+    for (u32 i = 0; i < num_previous; ++i) {
+        reference.SubmitVertex(MakeVertex(PREVIOUS_ID + i), noop);
+        split_assembler.SubmitVertex(MakeVertex(PREVIOUS_ID + i), noop);
+    }
+
+    TriangleRecorder expected;
+    for (u32 i = 0; i < num_vertices; ++i) {
+        reference.SubmitVertex(MakeVertex(i), expected.Handler());
+    }
+
+    TriangleRecorder result;
+    const auto split = split_assembler.SplitBatch(num_vertices);
+    if (split.count == 0) {
+        for (u32 i = 0; i < num_vertices; ++i) {
+            split_assembler.SubmitVertex(MakeVertex(i), result.Handler());
+        }
+    } else {
+        REQUIRE(split.first + split.count <= num_vertices);
+        REQUIRE(split.head <= split.tail);
+        for (u32 i = 0; i < split.head; ++i) {
+            split_assembler.SubmitVertex(MakeVertex(i), result.Handler());
+        }
+        DrawHost(topology, split.first, split.count, result.triangles);
+        split_assembler.SkipVertices(split.tail - split.head);
+        for (u32 i = split.tail; i < num_vertices; ++i) {
+            split_assembler.SubmitVertex(MakeVertex(i), noop);
+        }
+    }
+
+    // The vertices left buffered must build the same triangles with the next batch.
+    for (u32 i = 0; i < 3; ++i) {
+        reference.SubmitVertex(MakeVertex(NEXT_ID + i), expected.Handler());
+        split_assembler.SubmitVertex(MakeVertex(NEXT_ID + i), result.Handler());
+    }
+
+    REQUIRE(result.triangles == expected.triangles);
+}
+
+TEST_CASE("PrimitiveAssembler lets the host draw batches after buffered vertices",
+          "[video_core][primitive_assembly]") {
+    const auto noop = [](const OutputVertex&, const OutputVertex&, const OutputVertex&) {};
+
+    SECTION("List with a buffered vertex") {
+        PrimitiveAssembler assembler{Topology::List};
+        assembler.SubmitVertex(MakeVertex(PREVIOUS_ID), noop);
+        const auto split = assembler.SplitBatch(8);
+        REQUIRE(split.head == 2);
+        REQUIRE(split.first == 2);
+        REQUIRE(split.count == 6);
+        REQUIRE(split.tail == 8);
+    }
+
+    SECTION("Strip with an odd number of buffered vertices") {
+        PrimitiveAssembler assembler{Topology::Strip};
+        for (u32 i = 0; i < 3; ++i) {
+            assembler.SubmitVertex(MakeVertex(PREVIOUS_ID + i), noop);
+        }
+        const auto split = assembler.SplitBatch(10);
+        REQUIRE(split.head == 3);
+        REQUIRE(split.first == 1);
+        REQUIRE(split.count == 9);
+        REQUIRE(split.tail == 8);
+    }
+
+    SECTION("Fan around a buffered vertex") {
+        PrimitiveAssembler assembler{Topology::Fan};
+        assembler.SubmitVertex(MakeVertex(PREVIOUS_ID), noop);
+        REQUIRE(assembler.SplitBatch(10).count == 0);
+    }
+}
@@ -15,6 +15,7 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <fmt/format.h>
 #include <nihstro/inline_assembly.h>
+#include "tests/video_core/shader_test_utils.h"
 #include "video_core/pica/shader_setup.h"
 #include "video_core/pica/shader_unit.h"
 #include "video_core/shader/shader_interpreter.h"
@@ -58,20 +59,6 @@ struct StringMaker<Common::Vec4f> {
 };
 } // namespace Catch
 
-static std::unique_ptr<Pica::ShaderSetup> CompileShaderSetup(
-    std::initializer_list<nihstro::InlineAsm> code) {
-    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
-
-    auto shader = std::make_unique<Pica::ShaderSetup>();
-
-    std::transform(shbin.program.begin(), shbin.program.end(), shader->program_code.begin(),
-                   [](const auto& x) { return x.hex; });
-    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
-                   shader->swizzle_data.begin(), [](const auto& x) { return x.hex; });
-
-    return shader;
-}
-
 class ShaderTest {
 public:
     explicit ShaderTest(std::initializer_list<nihstro::InlineAsm> code)
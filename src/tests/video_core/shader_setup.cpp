@@ -0,0 +1,126 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "video_core/pica/regs_shader.h"
+#include "video_core/pica/shader_setup.h"
+
+using Pica::ShaderRegs;
+using Pica::ShaderSetup;
+using UniformFormat = decltype(ShaderRegs::uniform_setup)::Format;
+
+namespace {
+
+std::vector<u32> MakeWords(std::size_t count, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<u32> words(count);
+    for (auto& word : words) {
+        word = rng();
+    }
+    // Include the special float24 encodings of zero, infinity and NaN.
+    if (count >= 3) {
+        words[0] = 0x00000000;
+        words[1] = 0x7F000000;
+        words[2] = 0x80FFFFFF;
+    }
+    return words;
+}
+
+bool SameUniforms(const ShaderSetup& a, const ShaderSetup& b) {
+    return std::memcmp(a.uniforms.f.data(), b.uniforms.f.data(), sizeof(a.uniforms.f)) == 0;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ShaderSetup decodes runs of float uniforms like single writes",
+          "[video_core][shader_setup]") {
+    const bool is_float32 = GENERATE(false, true);
+    const u32 start_index = GENERATE(0u, 5u, 94u, 120u);
+    const std::size_t num_queued = GENERATE(0u, 1u, 2u);
+    const std::size_t num_words = GENERATE(0u, 1u, 7u, 12u, 64u);
+
+    ShaderRegs single_regs{};
+    ShaderRegs bulk_regs{};
+    for (auto* config : {&single_regs, &bulk_regs}) {
+        config->uniform_setup.index.Assign(start_index);
+        config->uniform_setup.format.Assign(is_float32 ? UniformFormat::Float32
+                                                       : UniformFormat::Float24);
+    }
+
+    ShaderSetup single;
+    ShaderSetup bulk;
+    for (auto* setup : {&single, &bulk}) {
+        std::memset(setup->uniforms.f.data(), 0, sizeof(setup->uniforms.f));
+        setup->ClearDirtyUniforms();
+    }
+
+    const auto words = MakeWords(num_queued + num_words, start_index + num_words);
+    for (std::size_t i = 0; i < num_queued; ++i) {
+        single.WriteUniformFloatReg(single_regs, words[i]);
+        bulk.WriteUniformFloatReg(bulk_regs, words[i]);
+    }
+
+    const auto initial = bulk.uniforms.f;
+
+    u32 written_begin = 96;
+    u32 written_end = 0;
+    for (std::size_t i = num_queued; i < words.size(); ++i) {
+        if (const auto index = single.WriteUniformFloatReg(single_regs, words[i])) {
+            written_begin = std::min(written_begin, *index);
+            written_end = std::max(written_end, *index + 1);
+        }
+    }
+    const auto range =
+        bulk.WriteUniformFloatRegs(bulk_regs, std::span{words}.subspan(num_queued));
+
+    REQUIRE(SameUniforms(single, bulk));
+    REQUIRE(single_regs.uniform_setup.index == bulk_regs.uniform_setup.index);
+    REQUIRE(single.uniform_queue.index == bulk.uniform_queue.index);
+    if (written_begin < written_end) {
+        REQUIRE(range.first == written_begin);
+        REQUIRE(range.second == written_end);
+    } else {
+        REQUIRE(range.first == range.second);
+    }
+
+    // Every changed uniform is inside the dirty range.
+    for (u32 i = 0; i < 96; ++i) {
+        if (std::memcmp(&initial[i], &bulk.uniforms.f[i], sizeof(initial[i])) != 0) {
+            REQUIRE(bulk.float_uniforms_dirty_begin <= i);
+            REQUIRE(i < bulk.float_uniforms_dirty_end);
+        }
+    }
+}
+
+TEST_CASE("ShaderSetup keeps the dirty range of float uniforms", "[video_core][shader_setup]") {
+    ShaderRegs config{};
+    config.uniform_setup.format.Assign(UniformFormat::Float32);
+    ShaderSetup setup;
+    std::memset(setup.uniforms.f.data(), 0, sizeof(setup.uniforms.f));
+    setup.ClearDirtyUniforms();
+    REQUIRE(!setup.HasDirtyFloatUniforms());
+
+    const auto write = [&](u32 index, float value) {
+        config.uniform_setup.index.Assign(index);
+        u32 word;
+        std::memcpy(&word, &value, sizeof(word));
+        const std::vector<u32> words{word, word, word, word};
+        setup.WriteUniformFloatRegs(config, words);
+    };
+
+    write(10, 1.0f);
+    write(4, 2.0f);
+    REQUIRE(setup.float_uniforms_dirty_begin == 4);
+    REQUIRE(setup.float_uniforms_dirty_end == 11);
+
+    // Rewriting the same value does not mark the uniform again.
+    setup.ClearDirtyUniforms();
+    write(10, 1.0f);
+    REQUIRE(!setup.HasDirtyFloatUniforms());
+    REQUIRE(!setup.uniforms_dirty);
+}
@@ -0,0 +1,67 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <nihstro/inline_assembly.h>
+#include "video_core/pica/shader_setup.h"
+
+inline std::unique_ptr<Pica::ShaderSetup> CompileShaderSetup(
+    std::initializer_list<nihstro::InlineAsm> code) {
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
+
+    auto shader = std::make_unique<Pica::ShaderSetup>();
+
+    std::transform(shbin.program.begin(), shbin.program.end(), shader->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   shader->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+
+    return shader;
+}
+
+// nihstro does not support the EMIT and SETEMIT instructions, compare instructions, or flow control
+// instructions with explicit offsets, so the instruction-binary must be manually inserted in place
+// of NOPs.
+
+inline void InsertSetEmit(Pica::ShaderSetup& setup, u32 offset, u32 vertex_id, bool prim_emit) {
+    nihstro::Instruction SETEMIT = {};
+    SETEMIT.opcode = nihstro::OpCode(nihstro::OpCode::Id::SETEMIT);
+    SETEMIT.setemit.vertex_id = vertex_id;
+    SETEMIT.setemit.prim_emit = prim_emit;
+    setup.program_code[offset] = SETEMIT.hex;
+}
+
+inline void InsertEmit(Pica::ShaderSetup& setup, u32 offset) {
+    nihstro::Instruction EMIT = {};
+    EMIT.opcode = nihstro::OpCode(nihstro::OpCode::Id::EMIT);
+    setup.program_code[offset] = EMIT.hex;
+}
+
+inline void InsertFlowControl(Pica::ShaderSetup& setup, u32 offset, nihstro::OpCode::Id opcode,
+                              u32 dest_offset, u32 num_instructions) {
+    nihstro::Instruction instr = {};
+    instr.opcode = nihstro::OpCode(opcode);
+    instr.flow_control.dest_offset = dest_offset;
+    instr.flow_control.num_instructions = num_instructions;
+    instr.flow_control.refx = 1;
+    instr.flow_control.op = nihstro::Instruction::FlowControlType::Op::JustX;
+    setup.program_code[offset] = instr.hex;
+}
+
+inline void InsertCompare(Pica::ShaderSetup& setup, u32 offset, nihstro::SourceRegister src1,
+                          nihstro::SourceRegister src2) {
+    using CompareOp = nihstro::Instruction::Common::CompareOpType::Op;
+    nihstro::Instruction CMP = {};
+    CMP.opcode = nihstro::OpCode(nihstro::OpCode::Id::CMP);
+    CMP.common.operand_desc_id = 0;
+    CMP.common.src1 = src1;
+    CMP.common.src2 = src2;
+    CMP.common.compare_op.x = CompareOp::LessThan;
+    CMP.common.compare_op.y = CompareOp::Equal;
+    setup.program_code[offset] = CMP.hex;
+}
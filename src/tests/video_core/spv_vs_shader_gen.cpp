@@ -0,0 +1,336 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <nihstro/inline_assembly.h>
+#include <spirv-tools/libspirv.hpp>
+#include "common/settings.h"
+#include "tests/video_core/shader_test_utils.h"
+#include "video_core/pica/regs_internal.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+#include "video_core/shader/generator/glsl_shader_gen.h"
+#include "video_core/shader/generator/shader_gen.h"
+#include "video_core/shader/generator/spv_vs_shader_gen.h"
+
+using Pica::Shader::Generator::AttribLoadFlags;
+using Pica::Shader::Generator::PicaVSConfig;
+using Pica::Shader::Generator::SPIRV::GenerateVertexShader;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+using Type = nihstro::InlineAsm::Type;
+using VSOutputAttributes = Pica::RasterizerRegs::VSOutputAttributes;
+
+/// Configures the vertex shader of a program writing the position to output register 0.
+static PicaVSConfig MakeConfig(Pica::ShaderSetup& setup, bool use_clip_planes,
+                               bool use_geometry_shader, bool accurate_mul) {
+    Pica::RegsInternal regs{};
+    regs.vs.output_mask.Assign(1);
+    regs.rasterizer.vs_output_total.Assign(1);
+    regs.rasterizer.vs_output_attributes[0].map_x.Assign(VSOutputAttributes::POSITION_X);
+    regs.rasterizer.vs_output_attributes[0].map_y.Assign(VSOutputAttributes::POSITION_Y);
+    regs.rasterizer.vs_output_attributes[0].map_z.Assign(VSOutputAttributes::POSITION_Z);
+    regs.rasterizer.vs_output_attributes[0].map_w.Assign(VSOutputAttributes::POSITION_W);
+
+    return PicaVSConfig{regs, setup, use_clip_planes, use_geometry_shader, accurate_mul};
+}
+
+static std::vector<u32> Generate(Pica::ShaderSetup& setup, bool use_clip_planes = false,
+                                 bool accurate_mul = false) {
+    return GenerateVertexShader(setup, MakeConfig(setup, use_clip_planes, false, accurate_mul));
+}
+
+static bool IsValid(const std::vector<u32>& code) {
+    const spvtools::SpirvTools tools{SPV_ENV_VULKAN_1_1};
+    return !code.empty() && tools.Validate(code);
+}
+
+// The SPIR-V opcodes and enumerants needed to read the interface of a module.
+namespace Spv {
+constexpr u32 OpTypeInt = 21;
+constexpr u32 OpTypeFloat = 22;
+constexpr u32 OpTypeVector = 23;
+constexpr u32 OpTypeArray = 28;
+constexpr u32 OpTypeStruct = 30;
+constexpr u32 OpTypePointer = 32;
+constexpr u32 OpConstant = 43;
+constexpr u32 OpVariable = 59;
+constexpr u32 OpDecorate = 71;
+constexpr u32 OpMemberDecorate = 72;
+
+constexpr u32 DecorationBuiltIn = 11;
+constexpr u32 DecorationLocation = 30;
+constexpr u32 DecorationBinding = 33;
+constexpr u32 DecorationDescriptorSet = 34;
+constexpr u32 DecorationOffset = 35;
+
+constexpr u32 StorageClassInput = 1;
+constexpr u32 StorageClassUniform = 2;
+constexpr u32 StorageClassOutput = 3;
+} // namespace Spv
+
+/**
+ * Describes the inputs, outputs, built-ins and uniform blocks of a module by location and type,
+ * so that the modules of the SPIR-V generator and of glslang can be compared. Built-ins are
+ * listed the same way whether they are variables of their own or members of gl_PerVertex.
+ */
+static std::map<std::string, std::string> ReadInterface(const std::vector<u32>& code) {
+    std::unordered_map<u32, std::string> types;
+    std::unordered_map<u32, u32> constants;
+    std::unordered_map<u32, u32> pointees;
+    std::unordered_map<u32, std::vector<u32>> struct_members;
+    std::unordered_map<u32, std::map<u32, u32>> decorations;
+    std::map<std::tuple<u32, u32, u32>, u32> member_decorations;
+    std::vector<std::tuple<u32, u32, u32>> variables;
+
+    for (std::size_t i = 5; i < code.size();) {
+        const u32* const words = code.data() + i;
+        const u32 word_count = words[0] >> 16;
+        if (word_count == 0 || i + word_count > code.size()) {
+            return {};
+        }
+        switch (words[0] & 0xFFFF) {
+        case Spv::OpTypeInt:
+            types[words[1]] = fmt::format("{}int{}", words[3] ? "" : "u", words[2]);
+            break;
+        case Spv::OpTypeFloat:
+            types[words[1]] = fmt::format("float{}", words[2]);
+            break;
+        case Spv::OpTypeVector:
+            types[words[1]] = fmt::format("{}x{}", types[words[2]], words[3]);
+            break;
+        case Spv::OpTypeArray:
+            types[words[1]] = fmt::format("{}[{}]", types[words[2]], constants[words[3]]);
+            break;
+        case Spv::OpTypeStruct:
+            struct_members[words[1]].assign(words + 2, words + word_count);
+            break;
+        case Spv::OpTypePointer:
+            pointees[words[1]] = words[3];
+            break;
+        case Spv::OpConstant:
+            constants[words[2]] = words[3];
+            break;
+        case Spv::OpVariable:
+            variables.emplace_back(words[2], words[3], pointees[words[1]]);
+            break;
+        case Spv::OpDecorate:
+            decorations[words[1]][words[2]] = word_count > 3 ? words[3] : 0;
+            break;
+        case Spv::OpMemberDecorate:
+            member_decorations[{words[1], words[2], words[3]}] = word_count > 4 ? words[4] : 0;
+            break;
+        default:
+            break;
+        }
+        i += word_count;
+    }
+
+    std::map<std::string, std::string> interface;
+    for (const auto& [id, storage_class, type] : variables) {
+        const auto& decoration = decorations[id];
+        if (storage_class == Spv::StorageClassUniform) {
+            std::string offsets;
+            for (u32 member = 0; member < struct_members[type].size(); ++member) {
+                offsets += fmt::format(
+                    "{} ", member_decorations[{type, member, Spv::DecorationOffset}]);
+            }
+            interface[fmt::format("uniform set {} binding {}",
+                                  decoration.at(Spv::DecorationDescriptorSet),
+                                  decoration.at(Spv::DecorationBinding))] = offsets;
+            continue;
+        }
+        if (storage_class != Spv::StorageClassInput && storage_class != Spv::StorageClassOutput) {
+            continue;
+        }
+
+        const std::string_view direction = storage_class == Spv::StorageClassInput ? "in" : "out";
+        if (decoration.contains(Spv::DecorationLocation)) {
+            interface[fmt::format("{} location {}", direction,
+                                  decoration.at(Spv::DecorationLocation))] = types[type];
+        } else if (decoration.contains(Spv::DecorationBuiltIn)) {
+            interface[fmt::format("{} built-in {}", direction,
+                                  decoration.at(Spv::DecorationBuiltIn))] = types[type];
+        } else {
+            const auto& members = struct_members[type];
+            for (u32 member = 0; member < members.size(); ++member) {
+                const auto it = member_decorations.find({type, member, Spv::DecorationBuiltIn});
+                if (it != member_decorations.end()) {
+                    interface[fmt::format("{} built-in {}", direction, it->second)] =
+                        types[members[member]];
+                }
+            }
+        }
+    }
+    return interface;
+}
+
+TEST_CASE("SPIR-V vertex shader with arithmetic", "[video_core][shader]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_temp = SourceRegister::MakeTemporary(0);
+    const auto sh_c0 = SourceRegister::MakeFloat(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::MUL, DestRegister::MakeTemporary(0), sh_input, sh_c0},
+        {OpCode::Id::ADD, DestRegister::MakeTemporary(0), sh_temp, sh_input},
+        {OpCode::Id::DP3, DestRegister::MakeTemporary(1), sh_temp, sh_input},
+        {OpCode::Id::DPH, DestRegister::MakeTemporary(1), sh_temp, sh_input},
+        {OpCode::Id::MAX, DestRegister::MakeTemporary(1), sh_temp, sh_input},
+        {OpCode::Id::RCP, DestRegister::MakeTemporary(1), sh_temp},
+        {OpCode::Id::RSQ, DestRegister::MakeTemporary(1), sh_temp},
+        {OpCode::Id::FLR, DestRegister::MakeTemporary(1), sh_temp},
+        {OpCode::Id::EX2, DestRegister::MakeTemporary(1), sh_temp},
+        {OpCode::Id::LG2, DestRegister::MakeTemporary(1), sh_temp},
+        {OpCode::Id::SGE, DestRegister::MakeTemporary(1), sh_temp, sh_input},
+        {OpCode::Id::NOP}, // mad r1, r0, v0, c0
+        {OpCode::Id::MOV, sh_output, SourceRegister::MakeTemporary(1)},
+        {OpCode::Id::END},
+    });
+    nihstro::Instruction MAD = {};
+    MAD.opcode = nihstro::OpCode(OpCode::Id::MAD);
+    MAD.mad.operand_desc_id = 0;
+    MAD.mad.src1 = sh_temp;
+    MAD.mad.src2 = sh_input;
+    MAD.mad.src3 = sh_c0;
+    MAD.mad.dest = DestRegister::MakeTemporary(1);
+    setup->program_code[11] = MAD.hex;
+
+    REQUIRE(IsValid(Generate(*setup, false, false)));
+    REQUIRE(IsValid(Generate(*setup, true, true)));
+}
+
+TEST_CASE("SPIR-V vertex shader with address registers", "[video_core][shader]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_c8 = SourceRegister::MakeFloat(8);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto setup = CompileShaderSetup({
+        // mova a0.x, sh_input.x
+        {OpCode::Id::MOVA, DestRegister{}, "x", sh_input, "x", SourceRegister{}, "",
+         nihstro::InlineAsm::RelativeAddress::A1},
+        // mov sh_output.xyzw, c8[a0.x].xyzw
+        {OpCode::Id::MOV, sh_output, "xyzw", sh_c8, "xyzw", SourceRegister{}, "",
+         nihstro::InlineAsm::RelativeAddress::A1},
+        {OpCode::Id::END},
+    });
+
+    REQUIRE(IsValid(Generate(*setup)));
+}
+
+TEST_CASE("SPIR-V vertex shader with calls and conditionals", "[video_core][shader]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_temp = SourceRegister::MakeTemporary(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::NOP}, // call 6, 1
+        {OpCode::Id::NOP}, // cmp v0, r0
+        {OpCode::Id::NOP}, // ifc 4, 1
+        {OpCode::Id::MOV, sh_output, sh_input},
+        {OpCode::Id::MOV, sh_output, sh_temp},
+        {OpCode::Id::NOP}, // callc 7, 1
+        {OpCode::Id::ADD, DestRegister::MakeTemporary(0), sh_temp, sh_input},
+        {OpCode::Id::END},
+    });
+    InsertFlowControl(*setup, 0, OpCode::Id::CALL, 6, 1);
+    InsertCompare(*setup, 1, sh_input, sh_temp);
+    InsertFlowControl(*setup, 2, OpCode::Id::IFC, 4, 1);
+    InsertFlowControl(*setup, 5, OpCode::Id::CALLC, 7, 1);
+
+    REQUIRE(IsValid(Generate(*setup)));
+}
+
+TEST_CASE("SPIR-V vertex shader with nested loops", "[video_core][shader]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_temp = SourceRegister::MakeTemporary(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto setup = CompileShaderSetup({
+        // clang-format off
+        {OpCode::Id::MOV, sh_temp, sh_input},
+        {OpCode::Id::LOOP, 0},
+            {OpCode::Id::LOOP, 1},
+                {OpCode::Id::ADD, sh_temp, sh_temp, sh_input},
+            {Type::EndLoop},
+        {Type::EndLoop},
+        {OpCode::Id::MOV, sh_output, sh_temp},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+
+    REQUIRE(IsValid(Generate(*setup)));
+}
+
+TEST_CASE("SPIR-V vertex shader with jumps", "[video_core][shader]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_temp = SourceRegister::MakeTemporary(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::NOP}, // cmp v0, r0
+        {OpCode::Id::NOP}, // jmpc 4
+        {OpCode::Id::ADD, DestRegister::MakeTemporary(0), sh_temp, sh_input},
+        {OpCode::Id::NOP}, // jmpu 1
+        {OpCode::Id::MOV, sh_output, sh_temp},
+        {OpCode::Id::END},
+    });
+    InsertCompare(*setup, 0, sh_input, sh_temp);
+    InsertFlowControl(*setup, 1, OpCode::Id::JMPC, 4, 0);
+    InsertFlowControl(*setup, 3, OpCode::Id::JMPU, 1, 0);
+
+    REQUIRE(IsValid(Generate(*setup)));
+}
+
+TEST_CASE("SPIR-V vertex shader without END", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::MOV, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0)},
+    });
+    std::fill(setup->program_code.begin() + 1, setup->program_code.end(),
+              setup->program_code[0]);
+
+    REQUIRE(Generate(*setup).empty());
+}
+
+TEST_CASE("SPIR-V vertex shader interface matches the GLSL vertex shader",
+          "[video_core][shader]") {
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::ADD, sh_output, SourceRegister::MakeInput(0), SourceRegister::MakeInput(3)},
+        {OpCode::Id::END},
+    });
+
+    // Keep the uniform blocks that the program does not use in the glslang module.
+    const bool disable_spirv_optimizer = Settings::values.disable_spirv_optimizer.GetValue();
+    Settings::values.disable_spirv_optimizer.SetValue(true);
+
+    for (const bool use_clip_planes : {false, true}) {
+        for (const bool use_geometry_shader : {false, true}) {
+            auto config = MakeConfig(*setup, use_clip_planes, use_geometry_shader, false);
+            config.state.load_flags[3] = AttribLoadFlags::Sint;
+
+            const auto glsl = Pica::Shader::Generator::GLSL::GenerateVertexShader(*setup, config,
+                                                                                 true);
+            const auto glsl_code =
+                Vulkan::CompileGLSLtoSPIRV(glsl, vk::ShaderStageFlagBits::eVertex);
+            const auto code = GenerateVertexShader(*setup, config);
+            REQUIRE(!glsl_code.empty());
+            REQUIRE(IsValid(code));
+
+            const auto interface = ReadInterface(code);
+            REQUIRE(interface.contains("in location 0"));
+            REQUIRE(interface.at("in location 3") == "int32x4");
+            REQUIRE(interface == ReadInterface(glsl_code));
+        }
+    }
+
+    Settings::values.disable_spirv_optimizer.SetValue(disable_spirv_optimizer);
+}
@@ -0,0 +1,109 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <catch2/catch_test_macros.hpp>
+#include "common/settings.h"
+#include "common/thread_worker.h"
+#include "tests/video_core/vk_test_utils.h"
+#include "video_core/pica/regs_internal.h"
+#include "video_core/renderer_vulkan/vk_descriptor_update_queue.h"
+#include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/renderer_vulkan/vk_render_manager.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+using Vulkan::PipelineLibraryType;
+
+constexpr std::string_view VERTEX_SHADER = R"(#version 450 core
+void main() {
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+}
+)";
+
+constexpr std::string_view FRAGMENT_SHADER = R"(#version 450 core
+layout(location = 0) out vec4 color;
+void main() {
+    color = vec4(1.0);
+}
+)";
+
+TEST_CASE("Vulkan pipeline built whole when one of its libraries fails", "[video_core][vulkan]") {
+    const auto instance = CreateSoftwareInstance();
+    if (!instance) {
+        SKIP("Test requires a software Vulkan device");
+    }
+    if (!instance->IsGraphicsPipelineLibrarySupported()) {
+        SKIP("Test requires VK_EXT_graphics_pipeline_library");
+    }
+
+    Common::ThreadWorker worker{1, "Pipeline test worker"};
+    Vulkan::Scheduler scheduler{*instance};
+    Vulkan::RenderManager renderpass_cache{*instance, scheduler};
+    const vk::Device device = instance->GetDevice();
+    const auto pipeline_cache = device.createPipelineCacheUnique({});
+    const auto pipeline_layout = device.createPipelineLayoutUnique({});
+
+    Vulkan::Shader vertex_shader{*instance, vk::ShaderStageFlagBits::eVertex,
+                                 std::string{VERTEX_SHADER}};
+    Vulkan::Shader fragment_shader{*instance, vk::ShaderStageFlagBits::eFragment,
+                                   std::string{FRAGMENT_SHADER}};
+    const std::array<Vulkan::Shader*, 3> stages{&vertex_shader, nullptr, &fragment_shader};
+
+    Vulkan::PipelineInfo info{};
+    info.attachments.color = VideoCore::PixelFormat::RGBA8;
+    info.attachments.depth = VideoCore::PixelFormat::Invalid;
+
+    std::array<std::unique_ptr<Vulkan::PipelineLibrary>, Vulkan::NUM_PIPELINE_LIBRARIES> owned;
+    Vulkan::PipelineLibraries libraries{};
+    for (u32 i = 0; i < Vulkan::NUM_PIPELINE_LIBRARIES; ++i) {
+        const auto type = static_cast<PipelineLibraryType>(i);
+        owned[i] = std::make_unique<Vulkan::PipelineLibrary>(
+            *instance, renderpass_cache, type, info, *pipeline_cache, *pipeline_layout, stages);
+        libraries[i] = owned[i].get();
+        if (type == PipelineLibraryType::FragmentShader) {
+            // Leave the library as Build does when the driver fails to create it.
+            owned[i]->MarkDone();
+        } else {
+            owned[i]->Build();
+        }
+    }
+    REQUIRE(!libraries[static_cast<u32>(PipelineLibraryType::FragmentShader)]->Handle());
+
+    Vulkan::GraphicsPipeline pipeline{*instance, renderpass_cache, info, *pipeline_cache,
+                                      *pipeline_layout, stages, &worker, libraries};
+    REQUIRE(pipeline.TryBuild(true));
+    pipeline.WaitDone();
+    REQUIRE(pipeline.Handle());
+}
+
+TEST_CASE("Vulkan pipeline cache stops its workers before destroying their shaders",
+          "[video_core][vulkan]") {
+    const auto instance = CreateSoftwareInstance();
+    if (!instance) {
+        SKIP("Test requires a software Vulkan device");
+    }
+
+    const bool use_disk_shader_cache = Settings::values.use_disk_shader_cache.GetValue();
+    Settings::values.use_disk_shader_cache.SetValue(false);
+
+    Vulkan::Scheduler scheduler{*instance};
+    Vulkan::RenderManager renderpass_cache{*instance, scheduler};
+    Vulkan::DescriptorUpdateQueue update_queue{*instance};
+
+    // The caches are destroyed with fragment shaders still compiling on the workers. The compiles
+    // write to shaders the cache owns, so joining the workers after destroying the shaders crashes
+    // here or is reported by AddressSanitizer.
+    for (u32 round = 0; round < 4; ++round) {
+        Vulkan::PipelineCache cache{*instance, scheduler, renderpass_cache, update_queue};
+        Pica::RegsInternal regs{};
+        for (u32 ops = 0; ops < 100; ++ops) {
+            regs.texturing.tev_stage0.ops_raw = (ops % 10) | ((ops / 10) << 16);
+            cache.UseFragmentShader(regs, {});
+        }
+    }
+
+    Settings::values.use_disk_shader_cache.SetValue(use_disk_shader_cache);
+}
@@ -0,0 +1,203 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <span>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <nihstro/inline_assembly.h>
+#include "common/scope_exit.h"
+#include "common/vector_math.h"
+#include "tests/video_core/shader_test_utils.h"
+#include "tests/video_core/vk_test_utils.h"
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+#include "video_core/shader/generator/glsl_shader_decompiler.h"
+
+using Pica::Shader::Generator::GLSL::DecompileProgram;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+
+/**
+ * Wraps a decompiled vertex program in a compute shader. The input registers v0 and v1 and the
+ * output register o0 are read from and written to a storage buffer at binding 0.
+ */
+constexpr std::string_view COMPUTE_SHADER = R"(#version 450 core
+layout (local_size_x = 1) in;
+
+layout (set = 0, binding = 0, std430) buffer shader_data {{
+    vec4 vs_in_reg0;
+    vec4 vs_in_reg1;
+    vec4 vs_out_attr0;
+}};
+
+struct pica_uniforms {{
+    uint b;
+    uvec4 i[4];
+    vec4 f[96];
+}};
+pica_uniforms uniforms;
+
+{}
+
+void main() {{
+    exec_shader();
+}}
+)";
+
+/// Runs a compute shader once over a host visible storage buffer initialized with data.
+static void RunComputeShader(const Vulkan::Instance& instance, std::string_view code,
+                             std::span<Common::Vec4f> data) {
+    const vk::Device device = instance.GetDevice();
+    const vk::DeviceSize size = data.size_bytes();
+
+    const vk::BufferCreateInfo buffer_info = {
+        .size = size,
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer,
+    };
+    const VmaAllocationCreateInfo alloc_create_info = {
+        .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+        .requiredFlags = 0,
+        .preferredFlags = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+    };
+    VkBuffer unsafe_buffer{};
+    VmaAllocation allocation{};
+    VmaAllocationInfo alloc_info{};
+    VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(buffer_info);
+    REQUIRE(vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info, &alloc_create_info,
+                            &unsafe_buffer, &allocation, &alloc_info) == VK_SUCCESS);
+    SCOPE_EXIT({ vmaDestroyBuffer(instance.GetAllocator(), unsafe_buffer, allocation); });
+    std::memcpy(alloc_info.pMappedData, data.data(), size);
+    vmaFlushAllocation(instance.GetAllocator(), allocation, 0, VK_WHOLE_SIZE);
+
+    const vk::ShaderModule module =
+        Vulkan::Compile(code, vk::ShaderStageFlagBits::eCompute, device);
+    REQUIRE(module);
+    SCOPE_EXIT({ device.destroyShaderModule(module); });
+
+    const vk::DescriptorSetLayoutBinding binding = {
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .descriptorCount = 1,
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+    };
+    const auto set_layout = device.createDescriptorSetLayoutUnique({
+        .bindingCount = 1,
+        .pBindings = &binding,
+    });
+    const auto pipeline_layout = device.createPipelineLayoutUnique({
+        .setLayoutCount = 1,
+        .pSetLayouts = &*set_layout,
+    });
+    const vk::ComputePipelineCreateInfo pipeline_info = {
+        .stage =
+            {
+                .stage = vk::ShaderStageFlagBits::eCompute,
+                .module = module,
+                .pName = "main",
+            },
+        .layout = *pipeline_layout,
+    };
+    auto pipeline = device.createComputePipelineUnique({}, pipeline_info);
+    REQUIRE(pipeline.result == vk::Result::eSuccess);
+
+    const vk::DescriptorPoolSize pool_size = {
+        .type = vk::DescriptorType::eStorageBuffer,
+        .descriptorCount = 1,
+    };
+    const auto descriptor_pool = device.createDescriptorPoolUnique({
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &pool_size,
+    });
+    const vk::DescriptorSet descriptor_set = device.allocateDescriptorSets({
+        .descriptorPool = *descriptor_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &*set_layout,
+    })[0];
+    const vk::DescriptorBufferInfo descriptor_buffer = {
+        .buffer = unsafe_buffer,
+        .offset = 0,
+        .range = size,
+    };
+    const vk::WriteDescriptorSet write = {
+        .dstSet = descriptor_set,
+        .dstBinding = 0,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .pBufferInfo = &descriptor_buffer,
+    };
+    device.updateDescriptorSets(write, {});
+
+    const auto command_pool = device.createCommandPoolUnique({
+        .queueFamilyIndex = instance.GetGraphicsQueueFamilyIndex(),
+    });
+    auto cmdbufs = device.allocateCommandBuffersUnique({
+        .commandPool = *command_pool,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = 1,
+    });
+    const vk::CommandBuffer cmdbuf = *cmdbufs[0];
+    const vk::MemoryBarrier barrier = {
+        .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+        .dstAccessMask = vk::AccessFlagBits::eHostRead,
+    };
+    cmdbuf.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline.value);
+    cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout, 0,
+                              descriptor_set, {});
+    cmdbuf.dispatch(1, 1, 1);
+    cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                           vk::PipelineStageFlagBits::eHost, {}, barrier, {}, {});
+    cmdbuf.end();
+
+    const auto fence = device.createFenceUnique({});
+    const vk::SubmitInfo submit_info = {
+        .commandBufferCount = 1,
+        .pCommandBuffers = &cmdbuf,
+    };
+    instance.GetGraphicsQueue().submit(submit_info, *fence);
+    REQUIRE(device.waitForFences(*fence, true, UINT64_MAX) == vk::Result::eSuccess);
+
+    vmaInvalidateAllocation(instance.GetAllocator(), allocation, 0, VK_WHOLE_SIZE);
+    std::memcpy(data.data(), alloc_info.pMappedData, size);
+}
+
+TEST_CASE("Decompiled DPH uses a w of 1 for its first operand on the device",
+          "[video_core][vulkan]") {
+    const auto instance = CreateSoftwareInstance();
+    if (!instance) {
+        SKIP("Test requires a software Vulkan device");
+    }
+
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::DPH, DestRegister::MakeOutput(0), SourceRegister::MakeInput(0),
+         SourceRegister::MakeInput(1)},
+        {OpCode::Id::END},
+    });
+    const auto get_input_reg = [](u32 reg) { return fmt::format("vs_in_reg{}", reg); };
+    const auto get_output_reg = [](u32 reg) -> std::string {
+        return reg == 0 ? "vs_out_attr0" : "";
+    };
+
+    for (const bool sanitize_mul : {false, true}) {
+        const auto program = DecompileProgram(setup->program_code, setup->swizzle_data, 0,
+                                              get_input_reg, get_output_reg, sanitize_mul);
+        REQUIRE(!program.empty());
+
+        // The w of v0 is not 1, so using it gives 1*5 + 2*6 + 3*7 + 4*8 = 70 instead of 46.
+        std::array<Common::Vec4f, 3> registers{
+            Common::Vec4f{1.f, 2.f, 3.f, 4.f},
+            Common::Vec4f{5.f, 6.f, 7.f, 8.f},
+            Common::Vec4f{},
+        };
+        RunComputeShader(*instance, fmt::format(COMPUTE_SHADER, program), registers);
+        REQUIRE(registers[2] == Common::Vec4f{46.f, 46.f, 46.f, 46.f});
+    }
+}
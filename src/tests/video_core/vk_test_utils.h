@@ -0,0 +1,39 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "core/frontend/emu_window.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+
+/// A window without a surface, so that the Vulkan instance only needs the headless extension.
+class HeadlessWindow final : public Frontend::EmuWindow {
+public:
+    void PollEvents() override {}
+};
+
+/**
+ * Creates a Vulkan instance on a software device such as lavapipe or SwiftShader, whose results do
+ * not depend on the GPU of the machine running the tests. Returns null when there is none.
+ */
+inline std::unique_ptr<Vulkan::Instance> CreateSoftwareInstance() {
+    try {
+        const Vulkan::Instance probe{};
+        const auto devices = probe.GetPhysicalDevices();
+        const auto it = std::find_if(devices.begin(), devices.end(), [](vk::PhysicalDevice device) {
+            return device.getProperties().deviceType == vk::PhysicalDeviceType::eCpu;
+        });
+        if (it == devices.end()) {
+            return nullptr;
+        }
+        HeadlessWindow window;
+        return std::make_unique<Vulkan::Instance>(window,
+                                                  static_cast<u32>(it - devices.begin()));
+    } catch (const std::runtime_error&) {
+        return nullptr;
+    }
+}
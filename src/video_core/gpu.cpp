@@ -32,10 +32,7 @@ GPU::GPU(Core::System& system, Frontend::EmuWindow& emu_window,
          Frontend::EmuWindow* secondary_window)
     : right_eye_disabler{std::make_unique<RightEyeDisabler>(*this)},
       impl{std::make_unique<Impl>(system, emu_window, secondary_window)} {
-    impl->vblank_event = impl->timing.RegisterEvent(
-        "GPU::VBlankCallback",
-        [this](uintptr_t user_data, s64 cycles_late) { VBlankCallback(user_data, cycles_late); });
-    impl->timing.ScheduleEvent(FRAME_TICKS, impl->vblank_event);
+    RebindTiming();
 
     // Bind the rasterizer to the PICA GPU
     impl->pica.BindRasterizer(impl->rasterizer);
@@ -85,6 +82,28 @@ void GPU::ClearAll(bool flush) {
     impl->rasterizer->ClearAll(flush);
 }
 
+void GPU::FlushAll() {
+    impl->rasterizer->FlushAll();
+}
+
+void GPU::PrepareStateLoad() {
+    impl->rasterizer->PrepareStateLoad();
+    impl->pica.PrepareStateLoad();
+}
+
+void GPU::RebindTiming() {
+    impl->timing = &impl->system.CoreTiming();
+    impl->vblank_event = impl->timing->RegisterEvent(
+        "GPU::VBlankCallback",
+        [this](uintptr_t user_data, s64 cycles_late) { VBlankCallback(user_data, cycles_late); });
+    impl->timing->ScheduleEvent(FRAME_TICKS, impl->vblank_event);
+}
+
+void GPU::FinishStateLoad() {
+    impl->rasterizer->FinishStateLoad();
+    impl->pica.FinishStateLoad();
+}
+
 void GPU::Execute(const Service::GSP::Command& command) {
     using Service::GSP::CommandId;
     auto& regs = impl->pica.regs;
@@ -216,7 +235,27 @@ void GPU::SetBufferSwap(u32 screen_id, const Service::GSP::FrameBufferInfo& info
         MicroProfileFlip();
         impl->system.perf_stats->EndGameFrame();
         right_eye_disabler->ReportEndFrame();
+        LogDrawStats();
+    }
+}
+
+void GPU::LogDrawStats() {
+    constexpr u32 DRAW_STATS_INTERVAL = 600;
+    if (++impl->frames_since_draw_stats < DRAW_STATS_INTERVAL) {
+        return;
     }
+
+    const auto stats = impl->pica.GetDrawStats();
+    const auto& last = impl->logged_draw_stats;
+    LOG_DEBUG(HW_GPU,
+              "Draws in the last {} frames: {} on the host ({} also assembled in software), "
+              "in software: {} with hardware shaders disabled, {} unsplittable, {} rejected",
+              DRAW_STATS_INTERVAL, stats.accelerated - last.accelerated,
+              stats.carried_over - last.carried_over,
+              stats.hw_shader_disabled - last.hw_shader_disabled,
+              stats.unsplittable - last.unsplittable, stats.rejected - last.rejected);
+    impl->logged_draw_stats = stats;
+    impl->frames_since_draw_stats = 0;
 }
 
 void GPU::SetColorFill(const Pica::ColorFill& fill) {
@@ -419,7 +458,7 @@ void GPU::VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
     impl->signal_interrupt(Service::GSP::InterruptId::PDC1);
 
     // Reschedule recurrent event
-    impl->timing.ScheduleEvent(FRAME_TICKS - cycles_late, impl->vblank_event);
+    impl->timing->ScheduleEvent(FRAME_TICKS - cycles_late, impl->vblank_event);
 }
 
 void GPU::RecreateRenderer(Frontend::EmuWindow& emu_window, Frontend::EmuWindow* secondary_window) {
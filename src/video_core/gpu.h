@@ -60,6 +60,18 @@ public:
     /// Flushes and invalidates all memory in the rasterizer cache and removes any leftover state.
     void ClearAll(bool flush);
 
+    /// Flushes all GPU modified memory in the rasterizer cache back to guest memory.
+    void FlushAll();
+
+    /// Records the guest memory backing the rasterizer cache before a savestate is loaded.
+    void PrepareStateLoad();
+
+    /// Attaches the GPU to the core timing of a system that was re-initialized for a load.
+    void RebindTiming();
+
+    /// Revalidates the rasterizer cache against the loaded guest memory and resyncs all state.
+    void FinishStateLoad();
+
     /// Executes the provided GSP command.
     void Execute(const Service::GSP::Command& command);
 
@@ -112,6 +124,9 @@ private:
 
     void VBlankCallback(uintptr_t user_data, s64 cycles_late);
 
+    /// Periodically logs how the draws were split between the host and the software pipeline.
+    void LogDrawStats();
+
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const u32 file_version);
@@ -24,7 +24,7 @@
 
 namespace VideoCore {
 struct GPU::Impl {
-    Core::Timing& timing;
+    Core::Timing* timing;
     Core::System& system;
     Memory::MemorySystem& memory;
     std::shared_ptr<Pica::DebugContext> debug_context;
@@ -35,10 +35,12 @@ struct GPU::Impl {
     std::unique_ptr<SwRenderer::SwBlitter> sw_blitter;
     Core::TimingEventType* vblank_event;
     Service::GSP::InterruptHandler signal_interrupt;
+    Pica::PicaCore::DrawStats logged_draw_stats{};
+    u32 frames_since_draw_stats = 0;
 
     explicit Impl(Core::System& system, Frontend::EmuWindow& emu_window,
                   Frontend::EmuWindow* secondary_window)
-        : timing{system.CoreTiming()}, system{system}, memory{system.Memory()},
+        : timing{&system.CoreTiming()}, system{system}, memory{system.Memory()},
           debug_context{Pica::g_debug_context}, pica{memory, debug_context},
           renderer{VideoCore::CreateRenderer(emu_window, secondary_window, pica, system)},
           rasterizer{renderer->Rasterizer()},
@@ -0,0 +1,109 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+#include <vector>
+#include "common/common_types.h"
+#include "core/perf_stats.h"
+
+namespace VideoCore {
+
+/**
+ * Bookkeeping for the timestamp queries a renderer writes during a single frame. Every
+ * GPUTimelineStage interval is delimited by a pair of timestamps, the backend only has to write
+ * them to the indices returned by Begin/End and hand back the resolved values. Nested intervals
+ * of the same stage are folded into the outermost one so no time is counted twice.
+ */
+class GPUTimelineFrame {
+public:
+    static constexpr u32 MaxQueries = 512;
+
+    GPUTimelineFrame() {
+        Reset(0);
+    }
+
+    /// Forgets all intervals so the frame can be recorded again.
+    void Reset(u64 frame_) {
+        frame = frame_;
+        num_queries = 0;
+        intervals.clear();
+        depth.fill(0);
+        open.fill(-1);
+    }
+
+    /// Returns the query index to write the start timestamp of the stage to, if one is needed.
+    [[nodiscard]] std::optional<u32> Begin(Core::GPUTimelineStage stage) {
+        const auto index = static_cast<std::size_t>(stage);
+        if (depth[index]++ > 0) {
+            return std::nullopt;
+        }
+        if (num_queries + 2 > MaxQueries) {
+            open[index] = -1;
+            return std::nullopt;
+        }
+        open[index] = static_cast<s32>(intervals.size());
+        intervals.push_back({stage, num_queries, 0, false});
+        return num_queries++;
+    }
+
+    /// Returns the query index to write the end timestamp of the stage to, if one is needed.
+    [[nodiscard]] std::optional<u32> End(Core::GPUTimelineStage stage) {
+        const auto index = static_cast<std::size_t>(stage);
+        if (depth[index] == 0 || --depth[index] > 0 || open[index] < 0) {
+            return std::nullopt;
+        }
+        Interval& interval = intervals[open[index]];
+        open[index] = -1;
+        interval.end = num_queries;
+        interval.closed = true;
+        return num_queries++;
+    }
+
+    /// Returns the number of queries written during the frame.
+    [[nodiscard]] u32 NumQueries() const noexcept {
+        return num_queries;
+    }
+
+    /// Returns the index of the presented frame the queries belong to.
+    [[nodiscard]] u64 Frame() const noexcept {
+        return frame;
+    }
+
+    /// Sums the stage intervals from the resolved timestamps, given in ticks of period_ns.
+    [[nodiscard]] Core::GPUStageTimes Resolve(std::span<const u64> timestamps,
+                                              double period_ns) const {
+        Core::GPUStageTimes gpu_ms{};
+        for (const Interval& interval : intervals) {
+            if (!interval.closed || timestamps[interval.end] < timestamps[interval.begin]) {
+                continue;
+            }
+            const u64 ticks = timestamps[interval.end] - timestamps[interval.begin];
+            gpu_ms[static_cast<std::size_t>(interval.stage)] +=
+                static_cast<double>(ticks) * period_ns / 1'000'000.0;
+        }
+        return gpu_ms;
+    }
+
+private:
+    struct Interval {
+        Core::GPUTimelineStage stage;
+        u32 begin;
+        u32 end;
+        bool closed;
+    };
+
+    static constexpr std::size_t NumStages = static_cast<std::size_t>(Core::GPUTimelineStage::Count);
+
+    u64 frame{};
+    u32 num_queries{};
+    std::vector<Interval> intervals;
+    std::array<u32, NumStages> depth{};
+    std::array<s32, NumStages> open{};
+};
+
+} // namespace VideoCore
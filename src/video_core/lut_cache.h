@@ -0,0 +1,64 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "common/hash.h"
+
+namespace VideoCore {
+
+/// Identifies the conversion applied to a LUT before it is written to the texture buffer.
+enum class LutType : u32 {
+    Lighting,
+    Fog,
+    ProcTexValue,
+    ProcTexColor,
+    ProcTexColorDiff,
+};
+
+/**
+ * Content addressed index of the LUTs resident in a texture stream buffer.
+ * Games tend to alternate between a handful of lighting and proctex tables, so a dirty LUT
+ * often has contents that were already converted and uploaded for an earlier draw. Those uploads
+ * stay valid until the stream buffer wraps around, at which point the cache must be cleared.
+ */
+class LutCache {
+public:
+    /// Computes the key of a guest LUT, taking the conversion applied to it into account.
+    template <typename T, std::size_t N>
+    [[nodiscard]] static u64 Hash(LutType type, const std::array<T, N>& lut) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>, "LUT entries must be trivially copyable");
+        return Common::HashCombine(static_cast<u64>(type),
+                                   Common::ComputeHash64(lut.data(), sizeof(T) * N));
+    }
+
+    /// Returns the texel offset of an uploaded LUT with the provided key, if there is one.
+    [[nodiscard]] std::optional<int> Find(u64 hash) const {
+        const auto it = entries.find(hash);
+        if (it == entries.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /// Records that a LUT with the provided key was uploaded at the texel offset.
+    void Insert(u64 hash, int offset) {
+        entries.insert_or_assign(hash, offset);
+    }
+
+    /// Forgets all uploaded LUTs, must be called when the backing stream buffer is invalidated.
+    void Clear() {
+        entries.clear();
+    }
+
+private:
+    std::unordered_map<u64, int, Common::IdentityHash<u64>> entries;
+};
+
+} // namespace VideoCore
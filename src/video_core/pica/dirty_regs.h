@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include "video_core/pica/regs_internal.h"
 
 namespace Pica {
@@ -16,6 +17,17 @@ union DirtyRegs {
         qwords[reg_id >> 6] |= 1ULL << (reg_id & 0x3f);
     }
 
+    void SetRange(u32 reg_id, u32 count) {
+        const u32 end = reg_id + count;
+        while (reg_id < end) {
+            const u32 bit = reg_id & 0x3f;
+            const u32 num_bits = std::min(64 - bit, end - reg_id);
+            const u64 bits = num_bits == 64 ? ~0ULL : (1ULL << num_bits) - 1;
+            qwords[reg_id >> 6] |= bits << bit;
+            reg_id += num_bits;
+        }
+    }
+
     void Reset() {
         qwords.fill(0ULL);
     }
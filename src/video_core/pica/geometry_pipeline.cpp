@@ -326,6 +326,11 @@ void GeometryPipeline::Setup(ShaderEngine* shader_engine) {
     shader_engine->SetupBatch(gs, regs.gs.main_offset);
 }
 
+void GeometryPipeline::Reset() {
+    backend = nullptr;
+    shader_engine = nullptr;
+}
+
 void GeometryPipeline::Reconfigure() {
     ASSERT(!backend || backend->IsEmpty());
 
@@ -35,6 +35,9 @@ public:
     /// Reconfigures the pipeline according to current register settings
     void Reconfigure();
 
+    /// Drops the pipeline configuration along with any partially submitted primitive
+    void Reset();
+
     /// Checks if the pipeline needs a direct input from index buffer
     bool NeedIndexInput() const;
 
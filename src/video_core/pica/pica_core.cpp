@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include "common/arch.h"
 #include "common/archives.h"
 #include "common/microprofile.h"
@@ -30,6 +32,73 @@ union CommandHeader {
 };
 static_assert(sizeof(CommandHeader) == sizeof(u32), "CommandHeader has incorrect size!");
 
+// Expand a 4-bit mask to 4-byte mask, e.g. 0b0101 -> 0x00FF00FF
+constexpr std::array<u32, 16> ExpandBitsToBytes = {
+    0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff,
+    0x00ffff00, 0x00ffffff, 0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ffff,
+    0xffff0000, 0xffff00ff, 0xffffff00, 0xffffffff,
+};
+
+/// Registers that WriteInternalReg handles with more than a masked store. This must list every
+/// register of its switch, which WriteInternalReg asserts.
+constexpr auto RegHasSideEffects = [] {
+    std::array<bool, RegsInternal::NUM_REGS> table{};
+    const auto mark = [&table](std::size_t first, std::size_t count = 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            table[first + i] = true;
+        }
+    };
+    mark(PICA_REG_INDEX(irq_request));
+    mark(PICA_REG_INDEX(pipeline.triangle_topology));
+    mark(PICA_REG_INDEX(pipeline.restart_primitive));
+    mark(PICA_REG_INDEX(pipeline.vs_default_attributes_setup.index));
+    mark(PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[0]), 3);
+    mark(PICA_REG_INDEX(pipeline.gpu_mode));
+    mark(PICA_REG_INDEX(pipeline.command_buffer.trigger[0]), 2);
+    mark(PICA_REG_INDEX(pipeline.trigger_draw));
+    mark(PICA_REG_INDEX(pipeline.trigger_draw_indexed));
+    mark(PICA_REG_INDEX(gs.bool_uniforms));
+    mark(PICA_REG_INDEX(gs.int_uniforms[0]), 4);
+    mark(PICA_REG_INDEX(gs.uniform_setup.set_value[0]), 8);
+    mark(PICA_REG_INDEX(gs.program.set_word[0]), 8);
+    mark(PICA_REG_INDEX(gs.swizzle_patterns.set_word[0]), 8);
+    mark(PICA_REG_INDEX(vs.output_mask));
+    mark(PICA_REG_INDEX(vs.bool_uniforms));
+    mark(PICA_REG_INDEX(vs.int_uniforms[0]), 4);
+    mark(PICA_REG_INDEX(vs.uniform_setup.set_value[0]), 8);
+    mark(PICA_REG_INDEX(vs.program.set_word[0]), 8);
+    mark(PICA_REG_INDEX(vs.swizzle_patterns.set_word[0]), 8);
+    mark(PICA_REG_INDEX(lighting.lut_data[0]), 8);
+    mark(PICA_REG_INDEX(texturing.fog_lut_data[0]), 8);
+    mark(PICA_REG_INDEX(texturing.proctex_lut_data[0]), 8);
+    return table;
+}();
+
+constexpr u32 UNIFORM_PORT_REGS = 8;
+constexpr u32 NO_UNIFORM_PORT = UNIFORM_PORT_REGS;
+
+/// Returns which float uniform data register of the vertex or geometry shader unit the register
+/// is, or NO_UNIFORM_PORT.
+constexpr u32 GetUniformPortIndex(u32 id) {
+    for (const u32 first : {PICA_REG_INDEX(gs.uniform_setup.set_value[0]),
+                            PICA_REG_INDEX(vs.uniform_setup.set_value[0])}) {
+        if (id >= first && id < first + UNIFORM_PORT_REGS) {
+            return id - first;
+        }
+    }
+    return NO_UNIFORM_PORT;
+}
+
+/// For each register, the first register from it onwards that has side effects, or NUM_REGS.
+constexpr auto NextSideEffectReg = [] {
+    std::array<u16, RegsInternal::NUM_REGS + 1> table{};
+    table[RegsInternal::NUM_REGS] = RegsInternal::NUM_REGS;
+    for (std::size_t i = RegsInternal::NUM_REGS; i-- > 0;) {
+        table[i] = RegHasSideEffects[i] ? static_cast<u16>(i) : table[i + 1];
+    }
+    return table;
+}();
+
 PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext> debug_context_)
     : memory{memory_}, debug_context{std::move(debug_context_)},
       geometry_pipeline{regs.internal, gs_unit, gs_setup},
@@ -39,7 +108,9 @@ PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext>
     const auto submit_vertex = [this](const AttributeBuffer& buffer) {
         const auto add_triangle = [this](const OutputVertex& v0, const OutputVertex& v1,
                                          const OutputVertex& v2) {
-            rasterizer->AddTriangle(v0, v1, v2);
+            if (!discard_triangles) {
+                rasterizer->AddTriangle(v0, v1, v2);
+            }
         };
         const auto vertex = OutputVertex(regs.internal.rasterizer, buffer);
         primitive_assembler.SubmitVertex(vertex, add_triangle);
@@ -53,6 +124,27 @@ PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext>
 
 PicaCore::~PicaCore() = default;
 
+void PicaCore::PrepareStateLoad() {
+    // The core outlives savestate loads. Reset everything between command lists the same way a
+    // newly created core would be, as not all of it is restored from the savestate.
+    primitive_assembler.Reconfigure(PipelineRegs::TriangleTopology::List);
+    geometry_pipeline.Reset();
+    cmd_list = {};
+    immediate.Reset();
+    discard_triangles = false;
+}
+
+void PicaCore::FinishStateLoad() {
+    // The loaded registers, tables and uniforms have to reach the renderer even where they match
+    // the values it last saw, as those belong to the emulation that was running before.
+    dirty_regs.qwords.fill(~0ULL);
+    lighting.lut_dirty = Lighting::LutAllDirty;
+    fog.lut_dirty = true;
+    proctex.table_dirty = ProcTex::TableAllDirty;
+    vs_setup.uniforms_dirty = true;
+    gs_setup.uniforms_dirty = true;
+}
+
 void PicaCore::InitializeRegs() {
     // Values initialized by GSP
     regs.internal.irq_autostop = 1;
@@ -104,6 +196,17 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size, bool ignore_list) {
     const u8* head = memory.GetPhysicalPointer(list);
     cmd_list.Reset(list, head, size);
 
+    // Registers without side effects are stored directly, unless every write has to be reported
+    // to the debugger.
+    const bool trace_writes = debug_context || DebugUtils::IsPicaTracing();
+    const auto store_reg = [this](u32 id, u32 value, u32 write_mask) {
+        u32& reg = regs.internal.reg_array[id];
+        reg = (reg & ~write_mask) | (value & write_mask);
+    };
+    const auto is_plain_reg = [trace_writes](u32 id) {
+        return !trace_writes && id < RegsInternal::NUM_REGS && !RegHasSideEffects[id];
+    };
+
     bool stop_requested = false;
     while (cmd_list.current_index < cmd_list.length) {
         if (stop_requested) [[unlikely]] {
@@ -116,19 +219,78 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size, bool ignore_list) {
 
         // Read the header and the value to write.
         const u32 value = cmd_list.head[cmd_list.current_index++];
+        cmd_list.header_index = cmd_list.current_index;
         const CommandHeader header{cmd_list.head[cmd_list.current_index++]};
+        const u32 write_mask = ExpandBitsToBytes[header.parameter_mask];
+        const u32 num_extra = header.extra_data_length;
+
+        if (!header.group_commands && is_plain_reg(header.cmd_id)) {
+            // Repeated writes to the same register only leave the last value behind.
+            const u32 last_value =
+                num_extra == 0 ? value : cmd_list.head[cmd_list.current_index + num_extra - 1];
+            cmd_list.current_index += num_extra;
+            store_reg(header.cmd_id, last_value, write_mask);
+            dirty_regs.Set(header.cmd_id);
+            continue;
+        }
 
         // Write to the requested PICA register.
-        WriteInternalReg(header.cmd_id, value, header.parameter_mask, stop_requested);
+        if (is_plain_reg(header.cmd_id)) {
+            store_reg(header.cmd_id, value, write_mask);
+            dirty_regs.Set(header.cmd_id);
+        } else {
+            WriteInternalReg(header.cmd_id, value, header.parameter_mask, stop_requested);
+        }
 
         // Write any extra paramters as well.
-        for (u32 i = 0; i < header.extra_data_length; ++i) {
+        u32 i = 0;
+        while (i < num_extra) {
             if (stop_requested) [[unlikely]] {
                 break;
             }
             const u32 cmd = header.cmd_id + (header.group_commands ? i + 1 : 0);
-            const u32 extra_value = cmd_list.head[cmd_list.current_index++];
-            WriteInternalReg(cmd, extra_value, header.parameter_mask, stop_requested);
+            const u32 port = GetUniformPortIndex(cmd);
+            if (!trace_writes && port != NO_UNIFORM_PORT) {
+                // Feed every following word that reaches the same uniform port in one go.
+                const u32 count = header.group_commands
+                                      ? std::min(num_extra - i, UNIFORM_PORT_REGS - port)
+                                      : num_extra - i;
+                const std::span values{cmd_list.head + cmd_list.current_index, count};
+                WriteUniformFloatRegs(cmd >= PICA_REG_INDEX(vs.uniform_setup.set_value[0]),
+                                      values);
+                if (header.group_commands) {
+                    for (u32 j = 0; j < count; ++j) {
+                        store_reg(cmd + j, values[j], write_mask);
+                    }
+                    dirty_regs.SetRange(cmd, count);
+                } else {
+                    store_reg(cmd, values.back(), write_mask);
+                    dirty_regs.Set(cmd);
+                }
+                cmd_list.current_index += count;
+                i += count;
+                continue;
+            }
+            if (!header.group_commands || !is_plain_reg(cmd)) {
+                const u32 extra_value = cmd_list.head[cmd_list.current_index++];
+                WriteInternalReg(cmd, extra_value, header.parameter_mask, stop_requested);
+                ++i;
+                continue;
+            }
+
+            // Store the whole run of grouped registers up to the next one with side effects.
+            const u32 count = std::min<u32>(NextSideEffectReg[cmd] - cmd, num_extra - i);
+            const u32* values = cmd_list.head + cmd_list.current_index;
+            if (write_mask == 0xFFFFFFFF) {
+                std::memcpy(&regs.internal.reg_array[cmd], values, count * sizeof(u32));
+            } else {
+                for (u32 j = 0; j < count; ++j) {
+                    store_reg(cmd + j, values[j], write_mask);
+                }
+            }
+            dirty_regs.SetRange(cmd, count);
+            cmd_list.current_index += count;
+            i += count;
         }
     }
 }
@@ -147,13 +309,6 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask, bool& stop_requeste
         return;
     }
 
-    // Expand a 4-bit mask to 4-byte mask, e.g. 0b0101 -> 0x00FF00FF
-    constexpr std::array<u32, 16> ExpandBitsToBytes = {
-        0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff,
-        0x00ffff00, 0x00ffffff, 0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ffff,
-        0xffff0000, 0xffff00ff, 0xffffff00, 0xffffffff,
-    };
-
     // TODO: Figure out how register masking acts on e.g. vs.uniform_setup.set_value
     const u32 old_value = regs.internal.reg_array[id];
     const u32 write_mask = ExpandBitsToBytes[mask];
@@ -167,6 +322,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask, bool& stop_requeste
         debug_context->OnEvent(DebugContext::Event::PicaCommandLoaded, &id);
     }
 
+    bool handled = true;
     switch (id) {
     // Trigger IRQ
     case PICA_REG_INDEX(irq_request):
@@ -320,10 +476,8 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask, bool& stop_requeste
     case PICA_REG_INDEX(vs.uniform_setup.set_value[5]):
     case PICA_REG_INDEX(vs.uniform_setup.set_value[6]):
     case PICA_REG_INDEX(vs.uniform_setup.set_value[7]): {
-        const auto index = vs_setup.WriteUniformFloatReg(regs.internal.vs, value);
-        if (!regs.internal.pipeline.gs_unit_exclusive_configuration &&
-            regs.internal.pipeline.use_gs == PipelineRegs::UseGS::No && index) {
-            gs_setup.uniforms.f[index.value()] = vs_setup.uniforms.f[index.value()];
+        if (const auto index = vs_setup.WriteUniformFloatReg(regs.internal.vs, value)) {
+            MirrorVSFloatUniforms(index.value(), index.value() + 1);
         }
         break;
     }
@@ -443,9 +597,14 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask, bool& stop_requeste
         break;
     }
     default:
+        handled = false;
         break;
     }
 
+    // ProcessCmdList stores the registers missing from the table without calling this.
+    ASSERT_MSG(!handled || RegHasSideEffects[id],
+               "Register 0x{:03X} is handled but missing from RegHasSideEffects", id);
+
     dirty_regs.Set(id);
 
     if (debug_context) {
@@ -453,6 +612,26 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask, bool& stop_requeste
     }
 }
 
+void PicaCore::WriteUniformFloatRegs(bool is_gs, std::span<const u32> values) {
+    if (is_gs) {
+        gs_setup.WriteUniformFloatRegs(regs.internal.gs, values);
+        return;
+    }
+    const auto [begin, end] = vs_setup.WriteUniformFloatRegs(regs.internal.vs, values);
+    MirrorVSFloatUniforms(begin, end);
+}
+
+void PicaCore::MirrorVSFloatUniforms(u32 begin, u32 end) {
+    // Without a geometry shader the shared configuration also goes to the geometry shader unit.
+    if (regs.internal.pipeline.gs_unit_exclusive_configuration ||
+        regs.internal.pipeline.use_gs != PipelineRegs::UseGS::No || begin >= end) {
+        return;
+    }
+    std::copy(vs_setup.uniforms.f.begin() + begin, vs_setup.uniforms.f.begin() + end,
+              gs_setup.uniforms.f.begin() + begin);
+    gs_setup.MarkFloatUniformsDirty(begin, end);
+}
+
 void PicaCore::SubmitImmediate(u32 value) {
     // Push to word to the queue. This returns true when a full attribute is formed.
     if (!immediate.queue.Push(value)) {
@@ -532,45 +711,166 @@ void PicaCore::DrawArrays(bool is_indexed) {
         debug_context->OnEvent(DebugContext::Event::IncomingPrimitiveBatch, nullptr);
     }
 
-    const bool accelerate_draw = [this] {
-        // Geometry shaders cannot be accelerated due to register preservation.
-        if (regs.internal.pipeline.use_gs == PipelineRegs::UseGS::Yes) {
-            return false;
+    const auto& pipeline = regs.internal.pipeline;
+    const u32 num_vertices = pipeline.num_vertices;
+
+    const auto draw_software = [&](u32 first) {
+        if (first < num_vertices) {
+            LoadVertices(is_indexed, first, num_vertices - first);
         }
+        rasterizer->DrawTriangles();
 
-        // TODO (wwylele): for Strip/Fan topology, if the primitive assember is not restarted
-        // after this draw call, the buffered vertex from this draw should "leak" to the next
-        // draw, in which case we should buffer the vertex into the software primitive assember,
-        // or disable accelerate draw completely. However, there is not game found yet that does
-        // this, so this is left unimplemented for now. Revisit this when an issue is found in
-        // games.
-
-        bool accelerate_draw = Settings::values.use_hw_shader && primitive_assembler.IsEmpty();
-        const auto topology = primitive_assembler.GetTopology();
-        if (topology == PipelineRegs::TriangleTopology::Shader ||
-            topology == PipelineRegs::TriangleTopology::List) {
-            accelerate_draw = accelerate_draw && (regs.internal.pipeline.num_vertices % 3) == 0;
+        if (debug_context) {
+            debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch, nullptr);
         }
-        return accelerate_draw;
-    }();
+    };
+
+    if (!Settings::values.use_hw_shader) {
+        draw_software(0);
+        ++draw_stats.hw_shader_disabled;
+        return;
+    }
 
-    // Attempt to use hardware vertex shaders if possible.
-    if (accelerate_draw && rasterizer->AccelerateDrawBatch(is_indexed)) {
+    if (pipeline.use_gs == PipelineRegs::UseGS::Yes) {
+        // Vertices emitted by the geometry shader cannot be carried over between the software
+        // assembler and the host. The rasterizer checks that the geometry shader does not carry
+        // registers between invocations, that it writes the same registers on every path, and
+        // that the vertices fill whole invocations.
+        if (!primitive_assembler.IsEmpty()) {
+            draw_software(0);
+            ++draw_stats.unsplittable;
+            return;
+        }
+        if (!AccelerateDrawRange(is_indexed, 0, num_vertices)) {
+            draw_software(0);
+            ++draw_stats.rejected;
+            return;
+        }
+        if (num_vertices != 0) {
+            // The host draw leaves the geometry shader unit untouched. Run the last invocation
+            // again with its triangles discarded, so that the unit is left as the software
+            // pipeline leaves it: the registers and b15 of the last invocation, which writes the
+            // same registers as every other one, and in FixedPrimitive mode its vertices buffered
+            // in the float uniforms.
+            const u32 invocation_vertices =
+                pipeline.gs_config.mode == PipelineRegs::GSMode::FixedPrimitive
+                    ? pipeline.gs_config.fixed_vertex_num_minus_1 + 1
+                    : (regs.internal.gs.max_input_attribute_index + 1) /
+                          (pipeline.vs_outmap_total_minus_1_a + 1);
+            discard_triangles = true;
+            LoadVertices(is_indexed, num_vertices - invocation_vertices, invocation_vertices);
+            discard_triangles = false;
+            gs_setup.uniforms_dirty = true;
+        }
+        ++draw_stats.accelerated;
         return;
     }
 
-    // We cannot accelerate the draw, so load and execute the vertex shader for each vertex.
-    LoadVertices(is_indexed);
+    // Vertices that form triangles with the vertices buffered by a previous draw, or that stay
+    // buffered for the next one, go through the software assembler, and the host draws the rest.
+    const auto split = primitive_assembler.SplitBatch(num_vertices);
+    if (split.count == 0) {
+        draw_software(0);
+        ++draw_stats.unsplittable;
+        return;
+    }
 
-    // Draw emitted triangles.
-    rasterizer->DrawTriangles();
+    if (split.head != 0) {
+        LoadVertices(is_indexed, 0, split.head);
+        rasterizer->DrawTriangles();
+    }
 
-    if (debug_context) {
-        debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch, nullptr);
+    if (!AccelerateDrawRange(is_indexed, split.first, split.count)) {
+        draw_software(split.head);
+        ++draw_stats.rejected;
+        return;
     }
+
+    // The triangles of the tail are part of the host range, its vertices only have to be shaded
+    // when the next draw continues the strip or fan.
+    const bool carry_tail = split.tail < num_vertices && !PrimitiveRestartsBeforeNextDraw();
+    if (carry_tail) {
+        primitive_assembler.SkipVertices(split.tail - split.head);
+        discard_triangles = true;
+        LoadVertices(is_indexed, split.tail, num_vertices - split.tail);
+        discard_triangles = false;
+    } else {
+        primitive_assembler.SkipVertices(num_vertices - split.head);
+    }
+
+    ++draw_stats.accelerated;
+    if (split.head != 0 || carry_tail) {
+        ++draw_stats.carried_over;
+    }
+}
+
+bool PicaCore::PrimitiveRestartsBeforeNextDraw() const {
+    // Draws triggered by a write with extra data may be followed by more draws of the same
+    // command, so only look past single writes.
+    const CommandHeader current{cmd_list.head[cmd_list.header_index]};
+    if (current.extra_data_length != 0) {
+        return false;
+    }
+
+    // Anything that may consume the buffered vertices before a reset, including the end of the
+    // command list, counts as a continuation.
+    u32 index = cmd_list.header_index + 1;
+    while (true) {
+        if (index % 2 != 0) {
+            index++;
+        }
+        if (index + 2 > cmd_list.length) {
+            return false;
+        }
+        const CommandHeader header{cmd_list.head[index + 1]};
+        const u32 num_regs = header.group_commands ? header.extra_data_length + 1 : 1;
+        for (u32 id = header.cmd_id; id < header.cmd_id + num_regs; ++id) {
+            switch (id) {
+            case PICA_REG_INDEX(pipeline.triangle_topology):
+            case PICA_REG_INDEX(pipeline.restart_primitive):
+                return true;
+            case PICA_REG_INDEX(irq_request):
+            case PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[0]):
+            case PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[1]):
+            case PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[2]):
+            case PICA_REG_INDEX(pipeline.command_buffer.trigger[0]):
+            case PICA_REG_INDEX(pipeline.command_buffer.trigger[1]):
+            case PICA_REG_INDEX(pipeline.trigger_draw):
+            case PICA_REG_INDEX(pipeline.trigger_draw_indexed):
+                return false;
+            default:
+                break;
+            }
+        }
+        index += 2 + header.extra_data_length;
+    }
+}
+
+bool PicaCore::AccelerateDrawRange(bool is_indexed, u32 first, u32 count) {
+    // The rasterizer draws the vertices described by the pipeline registers, so point them at the
+    // range for the duration of the draw.
+    auto& pipeline = regs.internal.pipeline;
+    const u32 num_vertices = pipeline.num_vertices;
+    const u32 vertex_offset = pipeline.vertex_offset;
+    const u32 index_offset = pipeline.index_array.offset;
+
+    pipeline.num_vertices = count;
+    if (is_indexed) {
+        const u32 index_size = pipeline.index_array.format != 0 ? 2 : 1;
+        pipeline.index_array.offset.Assign(index_offset + first * index_size);
+    } else {
+        pipeline.vertex_offset = vertex_offset + first;
+    }
+
+    const bool accelerated = rasterizer->AccelerateDrawBatch(is_indexed);
+
+    pipeline.num_vertices = num_vertices;
+    pipeline.vertex_offset = vertex_offset;
+    pipeline.index_array.offset.Assign(index_offset);
+    return accelerated;
 }
 
-void PicaCore::LoadVertices(bool is_indexed) {
+void PicaCore::LoadVertices(bool is_indexed, u32 first, u32 count) {
     // Read and validate vertex information from the loaders
     const auto& pipeline = regs.internal.pipeline;
     const PAddr base_address = pipeline.vertex_attributes.GetPhysicalBaseAddress();
@@ -600,7 +900,7 @@ void PicaCore::LoadVertices(bool is_indexed) {
     geometry_pipeline.Setup(shader_engine.get());
     ASSERT(!geometry_pipeline.NeedIndexInput() || is_indexed);
 
-    for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+    for (u32 index = first; index < first + count; ++index) {
         // Indexed rendering doesn't use the start offset
         const u32 vertex = is_indexed
                                ? (index_u16 ? index_address_16[index] : index_address_8[index])
@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <stdexcept>
+#include <vector>
+#include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
+#include "common/serialization/binary_archive.h"
 #include "core/hle/service/gsp/gsp_interrupt.h"
 #include "video_core/pica/dirty_regs.h"
 #include "video_core/pica/geometry_pipeline.h"
@@ -40,6 +44,26 @@ public:
 
     void ProcessCmdList(PAddr list, u32 size, bool ignore_list);
 
+    /// Resets the vertex processing state, so that a savestate is loaded onto a clean core.
+    void PrepareStateLoad();
+
+    /// Marks all registers, tables and uniforms dirty after a savestate was loaded.
+    void FinishStateLoad();
+
+    /// Number of draws that were accelerated, and of the reasons that made draws fall back to the
+    /// software vertex pipeline.
+    struct DrawStats {
+        u64 accelerated = 0;
+        u64 carried_over = 0; ///< Accelerated draws that also assembled vertices in software
+        u64 hw_shader_disabled = 0;
+        u64 unsplittable = 0; ///< The buffered vertices cannot be shared with the host
+        u64 rejected = 0;     ///< The rasterizer could not draw the batch
+    };
+
+    DrawStats GetDrawStats() const {
+        return draw_stats;
+    }
+
 private:
     void InitializeRegs();
 
@@ -51,7 +75,22 @@ private:
 
     void DrawArrays(bool is_indexed);
 
-    void LoadVertices(bool is_indexed);
+    /// Writes a run of words to the float uniform port of the vertex or geometry shader unit.
+    void WriteUniformFloatRegs(bool is_gs, std::span<const u32> values);
+
+    /// Copies float uniforms [begin, end) to the geometry shader unit when it shares the vertex
+    /// shader configuration.
+    void MirrorVSFloatUniforms(u32 begin, u32 end);
+
+    /// Draws vertices [first, first + count) of the batch with the rasterizer.
+    bool AccelerateDrawRange(bool is_indexed, u32 first, u32 count);
+
+    /// Returns whether the primitive assembler is reset before the command list draws again, so
+    /// that the vertices left buffered by the current draw are never used.
+    bool PrimitiveRestartsBeforeNextDraw() const;
+
+    /// Runs vertices [first, first + count) of the batch through the software vertex pipeline.
+    void LoadVertices(bool is_indexed, u32 first, u32 count);
 
 public:
     union Regs {
@@ -81,6 +120,7 @@ public:
         const u32* head;
         u32 current_index;
         u32 length;
+        u32 header_index; ///< Index of the header of the command being processed
 
         void Reset(PAddr addr, const u8* head, u32 size) {
             this->addr = addr;
@@ -272,6 +312,30 @@ private:
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const u32 file_version) {
+        // Apart from the geometry pipeline backend, the state is plain data. It is written through
+        // the binary archive as a single blob, which avoids the per-object overhead of Boost on
+        // the f24 vectors of the shader state.
+        std::vector<u8> state;
+        if constexpr (Archive::is_saving::value) {
+            // The blob is smaller than the core, reserving avoids regrowing it while writing.
+            state.reserve(sizeof(PicaCore));
+            Common::BinaryOArchive oa{state};
+            serialize_state(oa);
+        }
+        ar & state;
+        if constexpr (Archive::is_loading::value) {
+            Common::BinaryIArchive ia{state};
+            serialize_state(ia);
+            if (!ia.AtEnd()) {
+                throw std::runtime_error("PICA state has trailing data");
+            }
+        }
+        ar & geometry_pipeline;
+        ar & cmd_list;
+    }
+
+    template <class Archive>
+    void serialize_state(Archive& ar) {
         ar & regs_lcd;
         ar & regs.reg_array;
         ar & gs_unit;
@@ -282,9 +346,7 @@ private:
         ar & fog;
         ar & input_default_attributes;
         ar & immediate;
-        ar & geometry_pipeline;
         ar & primitive_assembler;
-        ar & cmd_list;
     }
 
 public:
@@ -306,6 +368,8 @@ private:
     PrimitiveAssembler primitive_assembler;
     CommandList cmd_list;
     std::unique_ptr<ShaderEngine> shader_engine;
+    DrawStats draw_stats{};
+    bool discard_triangles = false;
 };
 
 #define GPU_REG_INDEX(field_name) (offsetof(Pica::PicaCore::Regs, field_name) / sizeof(u32))
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/logging/log.h"
 #include "video_core/pica/primitive_assembly.h"
 
@@ -50,4 +51,70 @@ void PrimitiveAssembler::SubmitVertex(const OutputVertex& vtx,
     }
 }
 
+PrimitiveAssembler::BatchSplit PrimitiveAssembler::SplitBatch(u32 num_vertices) const {
+    switch (topology) {
+    case PipelineRegs::TriangleTopology::List:
+    case PipelineRegs::TriangleTopology::Shader: {
+        // The head completes the buffered triangle and the tail is left buffered.
+        const u32 first = static_cast<u32>(3 - buffer_index) % 3;
+        if (num_vertices < first) {
+            return {};
+        }
+        const u32 count = (num_vertices - first) / 3 * 3;
+        return {first, first, count, first + count};
+    }
+
+    case PipelineRegs::TriangleTopology::Strip: {
+        // Triangles are built from buffer[0], buffer[1] and the new vertex, which the host only
+        // matches when the vertex two positions back is in buffer[0]. So the host range starts
+        // at an odd vertex when buffer_index is odd.
+        const u32 first = static_cast<u32>(buffer_index);
+        if (num_vertices < first + 3) {
+            return {};
+        }
+        const u32 head = IsEmpty() ? 0 : first + 2;
+        return {head, first, num_vertices - first, std::max(head, num_vertices - 2)};
+    }
+
+    case PipelineRegs::TriangleTopology::Fan:
+        // A fan centered on a buffered vertex cannot be drawn by the host.
+        if (buffer_index != 0 || num_vertices < 3) {
+            return {};
+        }
+        return {1, 0, num_vertices, num_vertices - 1};
+
+    default:
+        return {};
+    }
+}
+
+void PrimitiveAssembler::SkipVertices(u32 count) {
+    if (count == 0) {
+        return;
+    }
+
+    switch (topology) {
+    case PipelineRegs::TriangleTopology::List:
+    case PipelineRegs::TriangleTopology::Shader:
+        if (buffer_index + count >= 3) {
+            winding = false;
+        }
+        buffer_index = static_cast<int>((buffer_index + count) % 3);
+        break;
+
+    case PipelineRegs::TriangleTopology::Strip:
+        strip_ready |= count >= 2 || buffer_index == 1;
+        buffer_index ^= static_cast<int>(count & 1);
+        break;
+
+    case PipelineRegs::TriangleTopology::Fan:
+        strip_ready |= count >= 2 || buffer_index == 1;
+        buffer_index = 1;
+        break;
+
+    default:
+        break;
+    }
+}
+
 } // namespace Pica
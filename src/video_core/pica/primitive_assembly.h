@@ -21,6 +21,17 @@ struct PrimitiveAssembler {
     using TriangleHandler =
         std::function<void(const OutputVertex&, const OutputVertex&, const OutputVertex&)>;
 
+    /**
+     * Describes how a batch of vertices is shared between the software assembler and the host
+     * GPU, which draws a range of the batch with its own primitive topology.
+     */
+    struct BatchSplit {
+        u32 head;  ///< Vertices [0, head) are submitted first to build their triangles
+        u32 first; ///< First vertex of the range drawn by the host
+        u32 count; ///< Number of vertices drawn by the host, 0 if the batch cannot be split
+        u32 tail;  ///< Vertices [tail, num_vertices) are submitted last to refill the buffer
+    };
+
     explicit PrimitiveAssembler(
         PipelineRegs::TriangleTopology topology = PipelineRegs::TriangleTopology::List);
 
@@ -32,6 +43,21 @@ struct PrimitiveAssembler {
      */
     void SubmitVertex(const OutputVertex& vtx, const TriangleHandler& triangle_handler);
 
+    /**
+     * Splits a batch of vertices so that the host draws all triangles that are built from
+     * vertices of the batch alone. The triangles using vertices buffered before the batch are
+     * built from the head vertices, and the tail vertices leave the buffer as if the whole batch
+     * had been submitted, once the vertices in between have been skipped with SkipVertices.
+     */
+    BatchSplit SplitBatch(u32 num_vertices) const;
+
+    /**
+     * Advances the internal state as if the given number of vertices had been submitted, without
+     * building any triangle. The skipped vertices are not buffered, so the vertices that should
+     * stay in the buffer must still be submitted afterwards.
+     */
+    void SkipVertices(u32 count);
+
     /**
      * Invert the vertex order of the next triangle. Called by geometry shader emitter.
      * This only takes effect for TriangleTopology::Shader.
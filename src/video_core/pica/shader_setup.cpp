@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bit>
+#include <cstring>
+#include "common/arch.h"
 #include "common/assert.h"
 #include "common/bit_set.h"
 #include "common/hash.h"
@@ -9,8 +12,82 @@
 #include "video_core/pica/regs_shader.h"
 #include "video_core/pica/shader_setup.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace Pica {
 
+namespace {
+
+static_assert(sizeof(Common::Vec4<f24>) == 4 * sizeof(u32));
+
+/// Decodes uniforms written as three words holding four float24 values each.
+void DecodeFloat24Uniforms(const u32* words, Common::Vec4<f24>* uniforms, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i, words += 3) {
+        // Same layout as PackedAttribute::AsFloat24
+        alignas(16) const std::array<u32, 4> raw = {
+            words[2] & 0xFFFFFF,
+            ((words[1] & 0xFFFF) << 8) | (words[2] >> 24),
+            ((words[0] & 0xFF) << 16) | (words[1] >> 16),
+            words[0] >> 8,
+        };
+#if CITRA_ARCH(x86_64)
+        // Vectorized f24::FromRaw
+        const __m128i value = _mm_load_si128(reinterpret_cast<const __m128i*>(raw.data()));
+        const __m128i sign = _mm_slli_epi32(_mm_srli_epi32(value, 23), 31);
+        const __m128i exponent = _mm_and_si128(_mm_srli_epi32(value, 16), _mm_set1_epi32(0x7F));
+        const __m128i mantissa = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0xFFFF)), 7);
+        const __m128i is_inf_nan = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x7F));
+        const __m128i biased = _mm_or_si128(_mm_add_epi32(exponent, _mm_set1_epi32(64)),
+                                            _mm_and_si128(is_inf_nan, _mm_set1_epi32(0xFF)));
+        const __m128i is_zero = _mm_cmpeq_epi32(
+            _mm_and_si128(value, _mm_set1_epi32(0x7FFFFF)), _mm_setzero_si128());
+        const __m128i result = _mm_or_si128(
+            sign, _mm_andnot_si128(is_zero, _mm_or_si128(mantissa, _mm_slli_epi32(biased, 23))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&uniforms[i]), result);
+#elif CITRA_ARCH(arm64)
+        // Vectorized f24::FromRaw
+        const uint32x4_t value = vld1q_u32(raw.data());
+        const uint32x4_t sign = vshlq_n_u32(vshrq_n_u32(value, 23), 31);
+        const uint32x4_t exponent = vandq_u32(vshrq_n_u32(value, 16), vdupq_n_u32(0x7F));
+        const uint32x4_t mantissa = vshlq_n_u32(vandq_u32(value, vdupq_n_u32(0xFFFF)), 7);
+        const uint32x4_t is_inf_nan = vceqq_u32(exponent, vdupq_n_u32(0x7F));
+        const uint32x4_t biased = vorrq_u32(vaddq_u32(exponent, vdupq_n_u32(64)),
+                                            vandq_u32(is_inf_nan, vdupq_n_u32(0xFF)));
+        const uint32x4_t is_nonzero = vtstq_u32(value, vdupq_n_u32(0x7FFFFF));
+        const uint32x4_t result = vorrq_u32(
+            sign, vandq_u32(is_nonzero, vorrq_u32(mantissa, vshlq_n_u32(biased, 23))));
+        vst1q_u32(reinterpret_cast<u32*>(&uniforms[i]), result);
+#else
+        uniforms[i] = Common::Vec4<f24>{f24::FromRaw(raw[0]), f24::FromRaw(raw[1]),
+                                        f24::FromRaw(raw[2]), f24::FromRaw(raw[3])};
+#endif
+    }
+}
+
+/// Decodes uniforms written as four float32 words each, from w to x.
+void DecodeFloat32Uniforms(const u32* words, Common::Vec4<f24>* uniforms, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i, words += 4) {
+#if CITRA_ARCH(x86_64)
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&uniforms[i]),
+                         _mm_shuffle_epi32(value, _MM_SHUFFLE(0, 1, 2, 3)));
+#elif CITRA_ARCH(arm64)
+        const uint32x4_t value = vrev64q_u32(vld1q_u32(words));
+        vst1q_u32(reinterpret_cast<u32*>(&uniforms[i]), vextq_u32(value, value, 2));
+#else
+        for (u32 j = 0; j < 4; ++j) {
+            uniforms[i][3 - j] = f24::FromFloat32(std::bit_cast<f32>(words[j]));
+        }
+#endif
+    }
+}
+
+} // Anonymous namespace
+
 ShaderSetup::ShaderSetup() = default;
 
 ShaderSetup::~ShaderSetup() = default;
@@ -44,11 +121,77 @@ std::optional<u32> ShaderSetup::WriteUniformFloatReg(ShaderRegs& config, u32 val
 
     const u32 index = uniform_setup.index.Value();
     const auto prev = std::exchange(uniforms.f[index], uniform);
-    uniforms_dirty |= prev != uniform;
+    if (prev != uniform) {
+        MarkFloatUniformsDirty(index, index + 1);
+    }
     uniform_setup.index.Assign(index + 1);
     return index;
 }
 
+std::pair<u32, u32> ShaderSetup::WriteUniformFloatRegs(ShaderRegs& config,
+                                                       std::span<const u32> values) {
+    auto& uniform_setup = config.uniform_setup;
+    u32 written_begin = static_cast<u32>(uniforms.f.size());
+    u32 written_end = 0;
+    const auto write_word = [&](u32 value) {
+        if (const auto index = WriteUniformFloatReg(config, value)) {
+            written_begin = std::min(written_begin, *index);
+            written_end = std::max(written_end, *index + 1);
+        }
+    };
+
+    // Complete the uniform a previous write left in the queue.
+    std::size_t pos = 0;
+    while (uniform_queue.index != 0 && pos < values.size()) {
+        write_word(values[pos++]);
+    }
+
+    // Decode whole uniforms that land inside the uniform array directly.
+    const bool is_float32 = uniform_setup.IsFloat32();
+    const std::size_t words_per_uniform = is_float32 ? 4 : 3;
+    const u32 index = uniform_setup.index.Value();
+    const std::size_t count =
+        index < uniforms.f.size()
+            ? std::min((values.size() - pos) / words_per_uniform, uniforms.f.size() - index)
+            : 0;
+    if (count != 0) {
+        decltype(uniforms.f) decoded;
+        if (is_float32) {
+            DecodeFloat32Uniforms(values.data() + pos, decoded.data(), count);
+        } else {
+            DecodeFloat24Uniforms(values.data() + pos, decoded.data(), count);
+        }
+
+        u32 changed_begin = static_cast<u32>(uniforms.f.size());
+        u32 changed_end = 0;
+        for (u32 i = 0; i < count; ++i) {
+            if (std::memcmp(&uniforms.f[index + i], &decoded[i], sizeof(decoded[i])) != 0) {
+                uniforms.f[index + i] = decoded[i];
+                changed_begin = std::min(changed_begin, index + i);
+                changed_end = index + i + 1;
+            }
+        }
+        if (changed_begin < changed_end) {
+            MarkFloatUniformsDirty(changed_begin, changed_end);
+        }
+
+        uniform_setup.index.Assign(index + static_cast<u32>(count));
+        written_begin = std::min(written_begin, index);
+        written_end = std::max(written_end, index + static_cast<u32>(count));
+        pos += count * words_per_uniform;
+    }
+
+    // The remaining words either start a uniform or point outside the uniform array.
+    while (pos < values.size()) {
+        write_word(values[pos++]);
+    }
+
+    if (written_begin >= written_end) {
+        return {0, 0};
+    }
+    return {written_begin, written_end};
+}
+
 u64 ShaderSetup::GetProgramCodeHash() {
     if (program_code_hash_dirty) {
         program_code_hash = Common::ComputeHash64(&program_code, sizeof(program_code));
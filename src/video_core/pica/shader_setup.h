@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <optional>
+#include <span>
+#include <utility>
 #include "common/vector_math.h"
 #include "video_core/pica/packed_attribute.h"
 #include "video_core/pica_types.h"
@@ -61,6 +64,12 @@ public:
 
     std::optional<u32> WriteUniformFloatReg(ShaderRegs& config, u32 value);
 
+    /**
+     * Writes a run of words to the float uniform port, decoding whole uniforms at once.
+     * @returns the range of float uniforms that were written.
+     */
+    std::pair<u32, u32> WriteUniformFloatRegs(ShaderRegs& config, std::span<const u32> values);
+
     u64 GetProgramCodeHash();
 
     u64 GetSwizzleDataHash();
@@ -73,6 +82,22 @@ public:
         swizzle_data_hash_dirty = true;
     }
 
+    /// Marks the float uniforms [begin, end) as changed.
+    void MarkFloatUniformsDirty(u32 begin, u32 end) {
+        float_uniforms_dirty_begin = std::min(float_uniforms_dirty_begin, begin);
+        float_uniforms_dirty_end = std::max(float_uniforms_dirty_end, end);
+    }
+
+    bool HasDirtyFloatUniforms() const {
+        return float_uniforms_dirty_begin < float_uniforms_dirty_end;
+    }
+
+    void ClearDirtyUniforms() {
+        uniforms_dirty = false;
+        float_uniforms_dirty_begin = static_cast<u32>(uniforms.f.size());
+        float_uniforms_dirty_end = 0;
+    }
+
 public:
     Uniforms uniforms;
     PackedAttribute uniform_queue;
@@ -80,7 +105,11 @@ public:
     SwizzleData swizzle_data{};
     u32 entry_point{};
     const void* cached_shader{};
+    /// Set when the boolean or integer uniforms change, or when every uniform has to be synced.
     bool uniforms_dirty = true;
+    /// Range of float uniforms changed since the last ClearDirtyUniforms
+    u32 float_uniforms_dirty_begin = 0;
+    u32 float_uniforms_dirty_end = 0;
 
 private:
     bool program_code_hash_dirty{true};
@@ -55,7 +55,12 @@ RasterizerAccelerated::HardwareVertex::HardwareVertex(const Pica::OutputVertex&
 }
 
 RasterizerAccelerated::RasterizerAccelerated(Memory::MemorySystem& memory_, Pica::PicaCore& pica_)
-    : memory{memory_}, pica{pica_}, regs{pica.regs.internal} {}
+    : memory{memory_}, pica{pica_}, regs{pica.regs.internal} {
+    // The rasterizer can be created long after the uniforms were written, for example when the
+    // renderer is recreated, so start from the current values and force a full upload.
+    vs_pica_data.SetFromRegs(pica.vs_setup);
+    pica.vs_setup.uniforms_dirty = true;
+}
 
 /**
  * This is a helper function to resolve an issue when interpolating opposite quaternions. See below
@@ -136,6 +141,28 @@ RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray
     return {vertex_min, vertex_max, vs_input_size};
 }
 
+bool RasterizerAccelerated::SyncVSPicaUniforms() {
+    auto& setup = pica.vs_setup;
+    if (setup.uniforms_dirty) {
+        vs_pica_data.SetFromRegs(setup);
+        setup.ClearDirtyUniforms();
+        return vs_pica_data_uploaded.Differs(vs_pica_data);
+    }
+    if (!setup.HasDirtyFloatUniforms()) {
+        return false;
+    }
+
+    // Only the float uniforms written by the command lists changed.
+    const u32 begin = setup.float_uniforms_dirty_begin;
+    const u32 end = setup.float_uniforms_dirty_end;
+    vs_pica_data.SetFloatUniformsFromRegs(setup, begin, end);
+    setup.ClearDirtyUniforms();
+    return vs_pica_data_uploaded.Differs(
+        vs_pica_data, offsetof(Pica::Shader::Generator::VSPicaUniformData, f) +
+                          begin * sizeof(Common::Vec4f),
+        (end - begin) * sizeof(Common::Vec4f));
+}
+
 void RasterizerAccelerated::SyncDrawUniforms() {
     auto& dirty = pica.dirty_regs;
 
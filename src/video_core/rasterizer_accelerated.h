@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstring>
 #include "common/vector_math.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/shader/generator/pica_fs_config.h"
@@ -31,6 +32,10 @@ protected:
     /// Sync vertex and framgent uniforms from PICA registers
     void SyncDrawUniforms();
 
+    /// Converts the vertex shader uniforms changed since the last sync and returns whether the
+    /// block now differs from the bound one.
+    bool SyncVSPicaUniforms();
+
 protected:
     /// Structure that the hardware rendered vertices are composed of
     struct HardwareVertex {
@@ -56,6 +61,33 @@ protected:
     /// Retrieve the range and the size of the input vertex
     VertexArrayInfo AnalyzeVertexArray(bool is_indexed, u32 stride_alignment = 1);
 
+    /**
+     * Copy of a uniform block as it was last uploaded to the GPU. The dirty flags are raised on
+     * every register write, so comparing against this avoids re-uploading identical blocks.
+     */
+    template <typename T>
+    class UploadedUniform {
+    public:
+        [[nodiscard]] bool Differs(const T& data) const {
+            return !valid || std::memcmp(&copy, &data, sizeof(T)) != 0;
+        }
+
+        /// Compares the given byte range, when the rest of the data is known to be unchanged.
+        [[nodiscard]] bool Differs(const T& data, std::size_t offset, std::size_t size) const {
+            return !valid || std::memcmp(reinterpret_cast<const u8*>(&copy) + offset,
+                                         reinterpret_cast<const u8*>(&data) + offset, size) != 0;
+        }
+
+        void Set(const T& data) {
+            std::memcpy(&copy, &data, sizeof(T));
+            valid = true;
+        }
+
+    private:
+        T copy{};
+        bool valid = false;
+    };
+
 protected:
     Memory::MemorySystem& memory;
     Pica::PicaCore& pica;
@@ -64,6 +96,10 @@ protected:
     Pica::Shader::UserConfig user_config{};
     Pica::Shader::Generator::VSUniformData vs_data{};
     Pica::Shader::Generator::FSUniformData fs_data{};
+    Pica::Shader::Generator::VSPicaUniformData vs_pica_data{};
+    UploadedUniform<Pica::Shader::Generator::VSUniformData> vs_data_uploaded;
+    UploadedUniform<Pica::Shader::Generator::FSUniformData> fs_data_uploaded;
+    UploadedUniform<Pica::Shader::Generator::VSPicaUniformData> vs_pica_data_uploaded;
     bool vs_data_dirty = true;
     bool fs_data_dirty = true;
 };
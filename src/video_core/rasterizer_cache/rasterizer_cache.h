@@ -8,6 +8,7 @@
 #include <boost/container/small_vector.hpp>
 #include <boost/range/iterator_range.hpp>
 #include "common/alignment.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -1235,6 +1236,65 @@ void RasterizerCache<T>::ClearAll(bool flush) {
     page_table.clear();
 }
 
+template <class T>
+void RasterizerCache<T>::PrepareStateLoad() {
+    // GPU modified regions never made it to guest memory, so they cannot survive the load.
+    load_dirty_regions.clear();
+    for (const auto& [region, surface_id] : dirty_regions) {
+        load_dirty_regions += region;
+    }
+
+    load_page_hashes.clear();
+    for (const auto& [interval, count] : cached_pages) {
+        for (u32 page = boost::icl::first(interval); page < boost::icl::last_next(interval);
+             page++) {
+            const u8* ptr = memory.GetPhysicalPointer(page << Memory::CITRA_PAGE_BITS);
+            const u64 hash = ptr ? Common::ComputeHash64(ptr, Memory::CITRA_PAGE_SIZE) : 0;
+            load_page_hashes.emplace_back(page, hash);
+        }
+    }
+}
+
+template <class T>
+void RasterizerCache<T>::FinishStateLoad() {
+    // The restored page tables know nothing about the cache, so mark its pages again.
+    for (const auto& [interval, count] : cached_pages) {
+        const PAddr start_addr = boost::icl::first(interval) << Memory::CITRA_PAGE_BITS;
+        const PAddr end_addr = boost::icl::last_next(interval) << Memory::CITRA_PAGE_BITS;
+        memory.RasterizerMarkRegionCached(start_addr, end_addr - start_addr, true);
+    }
+
+    for (const auto& region : load_dirty_regions) {
+        InvalidateRegion(region.lower(), region.upper() - region.lower());
+    }
+
+    // Only surfaces backed by pages that differ from the restored memory are invalidated.
+    // Consecutive changed pages are merged to keep the number of invalidations low.
+    u32 run_start = 0;
+    u32 run_end = 0;
+    const auto invalidate_run = [&] {
+        if (run_end != run_start) {
+            InvalidateRegion(run_start << Memory::CITRA_PAGE_BITS,
+                             (run_end - run_start) << Memory::CITRA_PAGE_BITS);
+        }
+    };
+    for (const auto& [page, hash] : load_page_hashes) {
+        const u8* ptr = memory.GetPhysicalPointer(page << Memory::CITRA_PAGE_BITS);
+        if (ptr && hash == Common::ComputeHash64(ptr, Memory::CITRA_PAGE_SIZE)) {
+            continue;
+        }
+        if (page != run_end) {
+            invalidate_run();
+            run_start = page;
+        }
+        run_end = page + 1;
+    }
+    invalidate_run();
+
+    load_page_hashes.clear();
+    load_dirty_regions.clear();
+}
+
 template <class T>
 void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, SurfaceId flush_surface_id) {
     if (size == 0) [[unlikely]] {
@@ -15,6 +15,7 @@
 
 #include "video_core/rasterizer_cache/framebuffer_base.h"
 #include "video_core/rasterizer_cache/sampler_params.h"
+#include "video_core/rasterizer_cache/surface_base.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/texture_cube.h"
 
@@ -136,6 +137,12 @@ public:
     /// Clear all cached resources tracked by this cache manager
     void ClearAll(bool flush);
 
+    /// Records the guest memory backing the cache before it is replaced by a savestate load
+    void PrepareStateLoad();
+
+    /// Invalidates the cached resources whose guest memory was changed by a savestate load
+    void FinishStateLoad();
+
 private:
     /// Iterate over all page indices in a range
     template <typename Func>
@@ -224,6 +231,8 @@ private:
     Common::SlotVector<Framebuffer> slot_framebuffers;
     SurfaceMap dirty_regions;
     PageMap cached_pages;
+    std::vector<std::pair<u32, u64>> load_page_hashes;
+    SurfaceRegions load_dirty_regions;
     u32 resolution_scale_factor;
     u64 frame_tick{};
     FramebufferParams fb_params;
@@ -55,6 +55,12 @@ public:
     /// Removes as much state as possible from the rasterizer in preparation for a save/load state
     virtual void ClearAll(bool flush) = 0;
 
+    /// Records the guest memory backing cached resources before a savestate is loaded
+    virtual void PrepareStateLoad() {}
+
+    /// Invalidates the cached resources whose guest memory was changed by a savestate load
+    virtual void FinishStateLoad() {}
+
     /// Attempt to use a faster method to perform a display transfer with is_texture_copy = 0
     virtual bool AccelerateDisplayTransfer(const Pica::DisplayTransferConfig&) {
         return false;
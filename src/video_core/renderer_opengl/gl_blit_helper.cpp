@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include "common/hash.h"
+#include "common/literals.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
@@ -25,9 +28,13 @@ namespace OpenGL {
 
 using Settings::TextureFilter;
 using VideoCore::SurfaceType;
+using namespace Common::Literals;
 
 namespace {
 
+/// Maximum size of the filtered textures kept around for reuse
+constexpr std::size_t FILTER_CACHE_BUDGET = 64_MiB;
+
 struct TempTexture {
     OGLTexture tex;
     OGLFramebuffer fbo;
@@ -156,7 +163,8 @@ bool BlitHelper::ConvertRGBA4ToRGB5A1(Surface& source, Surface& dest,
     return true;
 }
 
-bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
+bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit,
+                        std::span<const u8> source_data) {
     const auto filter = Settings::values.texture_filter.GetValue();
     const bool is_depth =
         surface.type == SurfaceType::Depth || surface.type == SurfaceType::DepthStencil;
@@ -167,6 +175,29 @@ bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
         return true;
     }
 
+    // Only whole surfaces are cached, filters sample past the edges of partial rectangles.
+    const bool cacheable = !source_data.empty() && blit.src_rect.GetWidth() == surface.width &&
+                           blit.src_rect.GetHeight() == surface.height;
+    const FilterParams params{
+        .filter = filter,
+        .pixel_format = surface.pixel_format,
+        .res_scale = surface.res_scale,
+        .width = surface.width,
+        .height = surface.height,
+    };
+    u64 cache_key = 0;
+    if (cacheable) {
+        const u64 content_hash = Common::ComputeHash64(source_data.data(), source_data.size());
+        cache_key = Common::HashCombine(
+            content_hash, static_cast<u64>(filter) | static_cast<u64>(surface.pixel_format) << 8 |
+                              static_cast<u64>(surface.res_scale) << 16 |
+                              static_cast<u64>(surface.width) << 32 |
+                              static_cast<u64>(surface.height) << 48);
+        if (LoadFiltered(cache_key, params, source_data, surface, blit)) {
+            return true;
+        }
+    }
+
     switch (filter) {
     case TextureFilter::Anime4K:
         FilterAnime4K(surface, blit);
@@ -187,9 +218,82 @@ bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
         LOG_ERROR(Render_OpenGL, "Unknown texture filter {}", filter);
     }
 
+    if (cacheable) {
+        StoreFiltered(cache_key, params, source_data, surface, blit);
+    }
+
     return true;
 }
 
+bool BlitHelper::LoadFiltered(u64 key, const FilterParams& params,
+                              std::span<const u8> source_data, Surface& surface,
+                              const VideoCore::TextureBlit& blit) {
+    const auto it = filter_cache.find(key);
+    if (it == filter_cache.end()) {
+        return false;
+    }
+
+    // The key is only a hash, so compare everything the result depends on.
+    FilteredTexture& entry = it->second;
+    if (entry.params != params || !std::ranges::equal(entry.source_data, source_data)) {
+        return false;
+    }
+    filter_lru.splice(filter_lru.end(), filter_lru, entry.lru_it);
+    glCopyImageSubData(entry.texture.handle, GL_TEXTURE_2D, 0, 0, 0, 0, surface.Handle(),
+                       GL_TEXTURE_2D, blit.dst_level, blit.dst_rect.left, blit.dst_rect.bottom, 0,
+                       blit.dst_rect.GetWidth(), blit.dst_rect.GetHeight(), 1);
+    return true;
+}
+
+void BlitHelper::StoreFiltered(u64 key, const FilterParams& params,
+                               std::span<const u8> source_data, Surface& surface,
+                               const VideoCore::TextureBlit& blit) {
+    const u32 width = blit.dst_rect.GetWidth();
+    const u32 height = blit.dst_rect.GetHeight();
+    const std::size_t size =
+        static_cast<std::size_t>(width) * height * surface.GetInternalBytesPerPixel() +
+        source_data.size();
+    if (size > FILTER_CACHE_BUDGET) {
+        return;
+    }
+    // A result with a colliding key is replaced.
+    if (const auto it = filter_cache.find(key); it != filter_cache.end()) {
+        EraseFiltered(it);
+    }
+    while (filter_cache_size + size > FILTER_CACHE_BUDGET) {
+        EraseFiltered(filter_cache.find(filter_lru.front()));
+    }
+
+    GLint prev_active_texture;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &prev_active_texture);
+    OGLTexture texture;
+    texture.Create();
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, texture.handle);
+    glTexStorage2D(GL_TEXTURE_2D, 1, surface.Tuple().internal_format, width, height);
+    glBindTexture(GL_TEXTURE_2D, OpenGLState::GetCurState().texture_units[1].texture_2d);
+    glActiveTexture(prev_active_texture);
+    glCopyImageSubData(surface.Handle(), GL_TEXTURE_2D, blit.dst_level, blit.dst_rect.left,
+                       blit.dst_rect.bottom, 0, texture.handle, GL_TEXTURE_2D, 0, 0, 0, 0, width,
+                       height, 1);
+
+    filter_lru.push_back(key);
+    filter_cache.emplace(key, FilteredTexture{
+                                  .texture = std::move(texture),
+                                  .params = params,
+                                  .source_data{source_data.begin(), source_data.end()},
+                                  .size = size,
+                                  .lru_it = std::prev(filter_lru.end()),
+                              });
+    filter_cache_size += size;
+}
+
+void BlitHelper::EraseFiltered(FilterCache::iterator it) {
+    filter_cache_size -= it->second.size;
+    filter_lru.erase(it->second.lru_it);
+    filter_cache.erase(it);
+}
+
 void BlitHelper::FilterAnime4K(Surface& surface, const VideoCore::TextureBlit& blit) {
     static constexpr u8 internal_scale_factor = 2;
 
@@ -4,7 +4,12 @@
 
 #pragma once
 
+#include <list>
+#include <span>
+#include <unordered_map>
+#include <vector>
 #include "common/math_util.h"
+#include "common/settings.h"
 #include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
@@ -25,7 +30,13 @@ public:
     explicit BlitHelper(const Driver& driver);
     ~BlitHelper();
 
-    bool Filter(Surface& surface, const VideoCore::TextureBlit& blit);
+    /**
+     * Upscales the blit source rectangle of the surface with the configured texture filter.
+     * When the decoded source texels are provided, the filtered result is cached by their
+     * contents so textures uploaded again after invalidation do not have to be filtered again.
+     */
+    bool Filter(Surface& surface, const VideoCore::TextureBlit& blit,
+                std::span<const u8> source_data = {});
 
     bool ConvertDS24S8ToRGBA8(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
@@ -38,12 +49,42 @@ private:
     void FilterXbrz(Surface& surface, const VideoCore::TextureBlit& blit);
     void FilterMMPX(Surface& surface, const VideoCore::TextureBlit& blit);
 
+    /// Everything a filtered result depends on besides the source texels.
+    struct FilterParams {
+        Settings::TextureFilter filter;
+        VideoCore::PixelFormat pixel_format;
+        u32 res_scale;
+        u32 width;
+        u32 height;
+
+        bool operator==(const FilterParams&) const = default;
+    };
+
+    /// Copies the cached result of the same filtering to the blit destination, if there is one.
+    bool LoadFiltered(u64 key, const FilterParams& params, std::span<const u8> source_data,
+                      Surface& surface, const VideoCore::TextureBlit& blit);
+
+    /// Stores the filtered blit destination in the cache, evicting the oldest results if needed.
+    void StoreFiltered(u64 key, const FilterParams& params, std::span<const u8> source_data,
+                       Surface& surface, const VideoCore::TextureBlit& blit);
+
     void SetParams(OGLProgram& program, const VideoCore::Extent& src_extent,
                    Common::Rectangle<u32> src_rect);
     void Draw(OGLProgram& program, GLuint dst_tex, GLuint dst_fbo, u32 dst_level,
               Common::Rectangle<u32> dst_rect);
 
 private:
+    struct FilteredTexture {
+        OGLTexture texture;
+        FilterParams params;
+        std::vector<u8> source_data;
+        std::size_t size;
+        std::list<u64>::iterator lru_it;
+    };
+    using FilterCache = std::unordered_map<u64, FilteredTexture>;
+
+    void EraseFiltered(FilterCache::iterator it);
+
     const Driver& driver;
     OGLVertexArray vao;
     OpenGLState state;
@@ -64,6 +105,10 @@ private:
     OGLTexture temp_tex;
     VideoCore::Extent temp_extent{};
     bool use_texture_view{true};
+
+    FilterCache filter_cache;
+    std::list<u64> filter_lru;
+    std::size_t filter_cache_size{};
 };
 
 } // namespace OpenGL
@@ -0,0 +1,118 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/settings.h"
+#include "core/perf_stats.h"
+#include "video_core/renderer_opengl/gl_driver.h"
+#include "video_core/renderer_opengl/gl_gpu_timeline.h"
+
+namespace OpenGL {
+
+using VideoCore::GPUTimelineFrame;
+
+// Timestamp queries are core since OpenGL 3.3, OpenGL ES only has them through an extension.
+GPUTimeline::GPUTimeline(const Driver& driver)
+    : supported{!driver.IsOpenGLES()} {
+    if (!supported) {
+        return;
+    }
+    for (FrameQueries& queries : frames) {
+        glGenQueries(static_cast<GLsizei>(queries.queries.size()), queries.queries.data());
+    }
+}
+
+GPUTimeline::~GPUTimeline() {
+    if (!supported) {
+        return;
+    }
+    for (FrameQueries& queries : frames) {
+        glDeleteQueries(static_cast<GLsizei>(queries.queries.size()), queries.queries.data());
+    }
+}
+
+void GPUTimeline::Begin(Core::GPUTimelineStage stage) {
+    if (!enabled) {
+        return;
+    }
+    EndRenderPass();
+    FrameQueries& queries = frames[current_frame];
+    if (const auto index = queries.frame.Begin(stage)) {
+        glQueryCounter(queries.queries[*index], GL_TIMESTAMP);
+    }
+}
+
+void GPUTimeline::End(Core::GPUTimelineStage stage) {
+    if (!enabled) {
+        return;
+    }
+    FrameQueries& queries = frames[current_frame];
+    if (const auto index = queries.frame.End(stage)) {
+        glQueryCounter(queries.queries[*index], GL_TIMESTAMP);
+    }
+}
+
+void GPUTimeline::MarkDraw() {
+    if (!enabled || render_pass_open) {
+        return;
+    }
+    Begin(Core::GPUTimelineStage::RenderPass);
+    render_pass_open = true;
+}
+
+void GPUTimeline::EndRenderPass() {
+    if (!render_pass_open) {
+        return;
+    }
+    render_pass_open = false;
+    End(Core::GPUTimelineStage::RenderPass);
+}
+
+void GPUTimeline::EndFrame(Core::PerfStats& perf_stats) {
+    EndRenderPass();
+    FrameQueries& current = frames[current_frame];
+    current.pending = current.frame.NumQueries() > 0;
+
+    // Report every frame whose queries are available, most frames never have to wait here.
+    for (FrameQueries& queries : frames) {
+        if (queries.pending) {
+            Resolve(queries, perf_stats, false);
+        }
+    }
+
+    current_frame = (current_frame + 1) % NUM_FRAMES;
+    FrameQueries& next = frames[current_frame];
+    if (next.pending) {
+        Resolve(next, perf_stats, true);
+    }
+    next.frame.Reset(perf_stats.GetTimelineFrame() + 1);
+
+    // Only toggle between frames so intervals are never left half written.
+    enabled = supported && Settings::values.record_frame_times;
+}
+
+bool GPUTimeline::Resolve(FrameQueries& queries, Core::PerfStats& perf_stats, bool wait) {
+    const u32 num_queries = queries.frame.NumQueries();
+    if (!wait) {
+        // Queries complete in order, so the last one being available implies all of them are.
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(queries.queries[num_queries - 1], GL_QUERY_RESULT_AVAILABLE,
+                            &available);
+        if (available == GL_FALSE) {
+            return false;
+        }
+    }
+    queries.pending = false;
+
+    std::array<u64, GPUTimelineFrame::MaxQueries> timestamps{};
+    for (u32 i = 0; i < num_queries; i++) {
+        GLuint64 timestamp{};
+        glGetQueryObjectui64v(queries.queries[i], GL_QUERY_RESULT, &timestamp);
+        timestamps[i] = timestamp;
+    }
+    perf_stats.AddGPUTimeline(queries.frame.Frame(),
+                              queries.frame.Resolve({timestamps.data(), num_queries}, 1.0));
+    return true;
+}
+
+} // namespace OpenGL
@@ -0,0 +1,79 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <glad/glad.h>
+#include "video_core/gpu_timeline.h"
+
+namespace Core {
+class PerfStats;
+}
+
+namespace OpenGL {
+
+class Driver;
+
+/**
+ * Measures the host GPU time of each GPUTimelineStage with GL_TIMESTAMP queries. OpenGL has no
+ * notion of render passes, so consecutive draws are grouped into one RenderPass interval that
+ * stays open until any other stage begins or the frame ends.
+ */
+class GPUTimeline {
+    static constexpr std::size_t NUM_FRAMES = 4;
+
+public:
+    explicit GPUTimeline(const Driver& driver);
+    ~GPUTimeline();
+
+    /// Writes the start timestamp of the stage, closing any open render pass.
+    void Begin(Core::GPUTimelineStage stage);
+
+    /// Writes the end timestamp of the stage.
+    void End(Core::GPUTimelineStage stage);
+
+    /// Opens a render pass interval for the upcoming draw, unless one is already open.
+    void MarkDraw();
+
+    /// Closes the current frame and reports the timings of completed frames to perf_stats.
+    /// Must be called before PerfStats::EndSwap so the frame indices line up.
+    void EndFrame(Core::PerfStats& perf_stats);
+
+private:
+    struct FrameQueries {
+        std::array<GLuint, VideoCore::GPUTimelineFrame::MaxQueries> queries{};
+        VideoCore::GPUTimelineFrame frame{};
+        bool pending{};
+    };
+
+    void EndRenderPass();
+    bool Resolve(FrameQueries& queries, Core::PerfStats& perf_stats, bool wait);
+
+private:
+    std::array<FrameQueries, NUM_FRAMES> frames{};
+    std::size_t current_frame{};
+    bool supported{};
+    bool enabled{};
+    bool render_pass_open{};
+};
+
+/// Measures the GPU time of the commands issued during its lifetime as the provided stage.
+class GPUTimelineScope {
+public:
+    explicit GPUTimelineScope(GPUTimeline& timeline_, Core::GPUTimelineStage stage_)
+        : timeline{timeline_}, stage{stage_} {
+        timeline.Begin(stage);
+    }
+
+    ~GPUTimelineScope() {
+        timeline.End(stage);
+    }
+
+private:
+    GPUTimeline& timeline;
+    Core::GPUTimelineStage stage;
+};
+
+} // namespace OpenGL
@@ -50,6 +50,47 @@ GLenum MakePrimitiveMode(Pica::PipelineRegs::TriangleTopology topology) {
     return GL_TRIANGLES;
 }
 
+/// Returns the number of vertices a PICA geometry shader invocation receives, or 0 if unknown.
+u32 GetGeometryShaderVertexNum(const Pica::RegsInternal& regs) {
+    const u32 vs_output_num = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+    switch (regs.pipeline.gs_config.mode) {
+    case Pica::PipelineRegs::GSMode::Point: {
+        const u32 gs_input_num = regs.gs.max_input_attribute_index + 1;
+        if (regs.gs.input_to_uniform != 0 || gs_input_num % vs_output_num != 0) {
+            return 0;
+        }
+        return gs_input_num / vs_output_num;
+    }
+    case Pica::PipelineRegs::GSMode::FixedPrimitive:
+        if (regs.gs.input_to_uniform == 0 ||
+            vs_output_num != regs.pipeline.gs_config.stride_minus_1 + 1) {
+            return 0;
+        }
+        return regs.pipeline.gs_config.fixed_vertex_num_minus_1 + 1;
+    default:
+        // The number of vertices of the variable primitive mode is read from the index buffer
+        return 0;
+    }
+}
+
+/// Returns the GL primitive that holds the vertices of one geometry shader invocation.
+GLenum MakeGeometryShaderPrimitiveMode(u32 vertex_num) {
+    switch (vertex_num) {
+    case 1:
+        return GL_POINTS;
+    case 2:
+        return GL_LINES;
+    case 3:
+        return GL_TRIANGLES;
+    case 4:
+        return GL_LINES_ADJACENCY;
+    case 6:
+        return GL_TRIANGLES_ADJACENCY;
+    default:
+        return GL_NONE;
+    }
+}
+
 GLenum MakeAttributeType(Pica::PipelineRegs::VertexAttributeFormat format) {
     switch (format) {
     case Pica::PipelineRegs::VertexAttributeFormat::BYTE:
@@ -107,6 +148,8 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory, Pica::PicaCore&
         Common::AlignUp<std::size_t>(sizeof(VSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs =
         Common::AlignUp<std::size_t>(sizeof(FSUniformData), uniform_buffer_alignment);
+    uniform_size_aligned_gs_pica =
+        Common::AlignUp<std::size_t>(sizeof(GSPicaUniformData), uniform_buffer_alignment);
 
     // Set vertex attributes for software shader path
     state.draw.vertex_array = sw_vao.handle;
@@ -449,8 +492,8 @@ bool RasterizerOpenGL::SetupGeometryShader() {
     MICROPROFILE_SCOPE(OpenGL_GS);
 
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        LOG_ERROR(Render_OpenGL, "Accelerate draw doesn't support geometry shader");
-        return false;
+        return curr_shader_manager->UseProgrammableGeometryShader(regs, pica.gs_setup,
+                                                                  accurate_mul);
     }
 
     // Enable the quaternion fix-up geometry-shader only if we are actually doing per-fragment
@@ -467,10 +510,13 @@ bool RasterizerOpenGL::SetupGeometryShader() {
 
 bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        if (regs.pipeline.gs_config.mode != Pica::PipelineRegs::GSMode::Point) {
+        if (regs.pipeline.triangle_topology != Pica::PipelineRegs::TriangleTopology::Shader) {
             return false;
         }
-        if (regs.pipeline.triangle_topology != Pica::PipelineRegs::TriangleTopology::Shader) {
+        // Each GL primitive must hold exactly the vertices of one geometry shader invocation
+        const u32 vertex_num = GetGeometryShaderVertexNum(regs);
+        if (MakeGeometryShaderPrimitiveMode(vertex_num) == GL_NONE ||
+            regs.pipeline.num_vertices % vertex_num != 0) {
             return false;
         }
     }
@@ -487,7 +533,10 @@ bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
 }
 
 bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
-    const GLenum primitive_mode = MakePrimitiveMode(regs.pipeline.triangle_topology);
+    const GLenum primitive_mode =
+        regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No
+            ? MakeGeometryShaderPrimitiveMode(GetGeometryShaderVertexNum(regs))
+            : MakePrimitiveMode(regs.pipeline.triangle_topology);
     auto [vs_input_index_min, vs_input_index_max, vs_input_size] = AnalyzeVertexArray(is_indexed);
 
     if (vs_input_size > VERTEX_BUFFER_SIZE) {
@@ -617,6 +666,7 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     UploadUniforms(accelerate);
 
     // Draw the vertex batch
+    runtime.Timeline().MarkDraw();
     bool succeeded = true;
     if (accelerate) {
         succeeded = AccelerateDrawBatchInternal(is_indexed);
@@ -812,6 +862,14 @@ void RasterizerOpenGL::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
 
+void RasterizerOpenGL::PrepareStateLoad() {
+    res_cache.PrepareStateLoad();
+}
+
+void RasterizerOpenGL::FinishStateLoad() {
+    res_cache.FinishStateLoad();
+}
+
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) {
     return res_cache.AccelerateDisplayTransfer(config);
 }
@@ -877,42 +935,85 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
         return;
     }
 
+    const auto set_lut_offset = [this](int& lut_offset, int new_offset) {
+        if (std::exchange(lut_offset, new_offset) != new_offset) {
+            fs_data_dirty = true;
+        }
+    };
+
+    // Bind the LUTs whose contents are still resident in the texture buffer
+    u32 lighting_misses = 0;
+    for (u32 dirty = pica.lighting.lut_dirty; dirty != 0; dirty &= dirty - 1) {
+        const u32 index = std::countr_zero(dirty);
+        const u64 hash = VideoCore::LutCache::Hash(VideoCore::LutType::Lighting,
+                                                   pica.lighting.luts[index]);
+        if (const auto cached = lf_lut_cache.Find(hash)) {
+            set_lut_offset(fs_data.lighting_lut_offset[index / 4][index % 4], *cached);
+        } else {
+            lighting_misses |= 1U << index;
+        }
+    }
+    bool fog_miss = false;
+    if (pica.fog.lut_dirty) {
+        const u64 hash = VideoCore::LutCache::Hash(VideoCore::LutType::Fog, pica.fog.lut);
+        if (const auto cached = lf_lut_cache.Find(hash)) {
+            set_lut_offset(fs_data.fog_lut_offset, *cached);
+        } else {
+            fog_miss = true;
+        }
+    }
+
+    pica.lighting.lut_dirty = 0;
+    pica.fog.lut_dirty = false;
+    if (!lighting_misses && !fog_miss) {
+        return;
+    }
+
     std::size_t bytes_used = 0;
     glBindBuffer(GL_TEXTURE_BUFFER, texture_lf_buffer.GetHandle());
     const auto [buffer, offset, invalidate] =
         texture_lf_buffer.Map(max_size, sizeof(Common::Vec4f));
 
     if (invalidate) {
-        pica.lighting.lut_dirty = pica.lighting.LutAllDirty;
-        pica.fog.lut_dirty = true;
+        lf_lut_cache.Clear();
+        lighting_misses = pica.lighting.LutAllDirty;
+        fog_miss = true;
     }
 
     // Sync the lighting luts
-    while (pica.lighting.lut_dirty) {
-        const u32 index = std::countr_zero(pica.lighting.lut_dirty);
-        pica.lighting.lut_dirty &= ~(1 << index);
+    while (lighting_misses) {
+        const u32 index = std::countr_zero(lighting_misses);
+        lighting_misses &= ~(1 << index);
 
-        Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
         const auto& source_lut = pica.lighting.luts[index];
+        const u64 hash = VideoCore::LutCache::Hash(VideoCore::LutType::Lighting, source_lut);
+        int& lut_offset = fs_data.lighting_lut_offset[index / 4][index % 4];
+        if (const auto cached = lf_lut_cache.Find(hash)) {
+            set_lut_offset(lut_offset, *cached);
+            continue;
+        }
+
+        Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
         for (u32 i = 0; i < source_lut.size(); i++) {
             new_data[i] = {source_lut[i].ToFloat(), source_lut[i].DiffToFloat()};
         }
-        fs_data.lighting_lut_offset[index / 4][index % 4] =
-            static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-        fs_data_dirty = true;
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        lf_lut_cache.Insert(hash, new_offset);
+        set_lut_offset(lut_offset, new_offset);
         bytes_used += source_lut.size() * sizeof(Common::Vec2f);
     }
 
     // Sync the fog lut
-    if (pica.fog.lut_dirty) {
+    if (fog_miss) {
         Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
         for (u32 i = 0; i < pica.fog.lut.size(); i++) {
             new_data[i] = {pica.fog.lut[i].ToFloat(), pica.fog.lut[i].DiffToFloat()};
         }
-        fs_data.fog_lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-        fs_data_dirty = true;
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        lf_lut_cache.Insert(VideoCore::LutCache::Hash(VideoCore::LutType::Fog, pica.fog.lut),
+                            new_offset);
+        set_lut_offset(fs_data.fog_lut_offset, new_offset);
         bytes_used += pica.fog.lut.size() * sizeof(Common::Vec2f);
-        pica.fog.lut_dirty = false;
     }
 
     texture_lf_buffer.Unmap(bytes_used);
@@ -928,66 +1029,114 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
         return;
     }
 
+    const auto& proctex = pica.proctex;
+
+    const auto set_lut_offset = [this](int& lut_offset, int new_offset) {
+        if (std::exchange(lut_offset, new_offset) != new_offset) {
+            fs_data_dirty = true;
+        }
+    };
+
+    // Returns true if the table has to be uploaded, binding the resident copy otherwise
+    const auto needs_upload = [&](VideoCore::LutType type, const auto& lut, int& lut_offset) {
+        if (const auto cached = lut_cache.Find(VideoCore::LutCache::Hash(type, lut))) {
+            set_lut_offset(lut_offset, *cached);
+            return false;
+        }
+        return true;
+    };
+
+    using VideoCore::LutType;
+    bool noise_miss = pica.proctex.noise_lut_dirty &&
+                      needs_upload(LutType::ProcTexValue, proctex.noise_table,
+                                   fs_data.proctex_noise_lut_offset);
+    bool color_map_miss = pica.proctex.color_map_dirty &&
+                          needs_upload(LutType::ProcTexValue, proctex.color_map_table,
+                                       fs_data.proctex_color_map_offset);
+    bool alpha_map_miss = pica.proctex.alpha_map_dirty &&
+                          needs_upload(LutType::ProcTexValue, proctex.alpha_map_table,
+                                       fs_data.proctex_alpha_map_offset);
+    bool lut_miss = pica.proctex.lut_dirty && needs_upload(LutType::ProcTexColor,
+                                                           proctex.color_table,
+                                                           fs_data.proctex_lut_offset);
+    bool diff_lut_miss =
+        pica.proctex.diff_lut_dirty &&
+        needs_upload(LutType::ProcTexColorDiff, proctex.color_diff_table,
+                     fs_data.proctex_diff_lut_offset);
+
+    pica.proctex.table_dirty = 0;
+    if (!noise_miss && !color_map_miss && !alpha_map_miss && !lut_miss && !diff_lut_miss) {
+        return;
+    }
+
     std::size_t bytes_used = 0;
     glBindBuffer(GL_TEXTURE_BUFFER, texture_buffer.GetHandle());
     const auto [buffer, offset, invalidate] = texture_buffer.Map(max_size, sizeof(Common::Vec4f));
 
     if (invalidate) {
-        pica.proctex.table_dirty = pica.proctex.TableAllDirty;
+        lut_cache.Clear();
+        noise_miss = color_map_miss = alpha_map_miss = lut_miss = diff_lut_miss = true;
     }
 
     // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
     const auto sync_proc_tex_value_lut = [&](const auto& lut, GLint& lut_offset) {
+        const u64 hash = VideoCore::LutCache::Hash(LutType::ProcTexValue, lut);
+        if (const auto cached = lut_cache.Find(hash)) {
+            set_lut_offset(lut_offset, *cached);
+            return;
+        }
         Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
         for (u32 i = 0; i < lut.size(); i++) {
             new_data[i] = {lut[i].ToFloat(), lut[i].DiffToFloat()};
         }
-        lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-        fs_data_dirty = true;
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        lut_cache.Insert(hash, new_offset);
+        set_lut_offset(lut_offset, new_offset);
         bytes_used += lut.size() * sizeof(Common::Vec2f);
     };
 
     // Sync the proctex noise lut
-    if (pica.proctex.noise_lut_dirty) {
-        sync_proc_tex_value_lut(pica.proctex.noise_table, fs_data.proctex_noise_lut_offset);
+    if (noise_miss) {
+        sync_proc_tex_value_lut(proctex.noise_table, fs_data.proctex_noise_lut_offset);
     }
 
     // Sync the proctex color map
-    if (pica.proctex.color_map_dirty) {
-        sync_proc_tex_value_lut(pica.proctex.color_map_table, fs_data.proctex_color_map_offset);
+    if (color_map_miss) {
+        sync_proc_tex_value_lut(proctex.color_map_table, fs_data.proctex_color_map_offset);
     }
 
     // Sync the proctex alpha map
-    if (pica.proctex.alpha_map_dirty) {
-        sync_proc_tex_value_lut(pica.proctex.alpha_map_table, fs_data.proctex_alpha_map_offset);
+    if (alpha_map_miss) {
+        sync_proc_tex_value_lut(proctex.alpha_map_table, fs_data.proctex_alpha_map_offset);
     }
 
     // Sync the proctex lut
-    if (pica.proctex.lut_dirty) {
+    if (lut_miss) {
         Common::Vec4f* new_data = reinterpret_cast<Common::Vec4f*>(buffer + bytes_used);
-        for (u32 i = 0; i < pica.proctex.color_table.size(); i++) {
-            new_data[i] = pica.proctex.color_table[i].ToVector() / 255.0f;
+        for (u32 i = 0; i < proctex.color_table.size(); i++) {
+            new_data[i] = proctex.color_table[i].ToVector() / 255.0f;
         }
-        fs_data.proctex_lut_offset =
-            static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
-        fs_data_dirty = true;
-        bytes_used += pica.proctex.color_table.size() * sizeof(Common::Vec4f);
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
+        lut_cache.Insert(VideoCore::LutCache::Hash(LutType::ProcTexColor, proctex.color_table),
+                         new_offset);
+        set_lut_offset(fs_data.proctex_lut_offset, new_offset);
+        bytes_used += proctex.color_table.size() * sizeof(Common::Vec4f);
     }
 
     // Sync the proctex difference lut
-    if (pica.proctex.diff_lut_dirty) {
+    if (diff_lut_miss) {
         Common::Vec4f* new_data = reinterpret_cast<Common::Vec4f*>(buffer + bytes_used);
-        for (u32 i = 0; i < pica.proctex.color_diff_table.size(); i++) {
-            new_data[i] = pica.proctex.color_diff_table[i].ToVector() / 255.0f;
+        for (u32 i = 0; i < proctex.color_diff_table.size(); i++) {
+            new_data[i] = proctex.color_diff_table[i].ToVector() / 255.0f;
         }
-        fs_data.proctex_diff_lut_offset =
-            static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
-        fs_data_dirty = true;
-        bytes_used += pica.proctex.color_diff_table.size() * sizeof(Common::Vec4f);
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
+        lut_cache.Insert(
+            VideoCore::LutCache::Hash(LutType::ProcTexColorDiff, proctex.color_diff_table),
+            new_offset);
+        set_lut_offset(fs_data.proctex_diff_lut_offset, new_offset);
+        bytes_used += proctex.color_diff_table.size() * sizeof(Common::Vec4f);
     }
 
-    pica.proctex.table_dirty = 0;
-
     texture_buffer.Unmap(bytes_used);
 }
 
@@ -996,44 +1145,70 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
     state.draw.uniform_buffer = uniform_buffer.GetHandle();
     state.Apply();
 
-    const bool sync_vs_pica = accelerate_draw && pica.vs_setup.uniforms_dirty;
-    if (!sync_vs_pica && !vs_data_dirty && !fs_data_dirty) {
+    const bool sync_vs_pica = accelerate_draw && (pica.vs_setup.uniforms_dirty ||
+                                                  pica.vs_setup.HasDirtyFloatUniforms());
+    // The geometry shader block also holds the registers of the geometry shader unit, which change
+    // without raising a dirty flag, so it is compared against the bound copy on every draw.
+    const bool sync_gs_pica =
+        accelerate_draw && regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No;
+    if (!sync_vs_pica && !sync_gs_pica && !vs_data_dirty && !fs_data_dirty) {
+        return;
+    }
+
+    if (sync_gs_pica) {
+        gs_pica_data.SetFromRegs(pica.gs_setup, pica.gs_unit);
+    }
+
+    // Skip blocks that were flagged dirty but are identical to the bound ones
+    const bool upload_vs = vs_data_dirty && vs_data_uploaded.Differs(vs_data);
+    const bool upload_fs = fs_data_dirty && fs_data_uploaded.Differs(fs_data);
+    const bool upload_vs_pica = sync_vs_pica && SyncVSPicaUniforms();
+    const bool upload_gs_pica = sync_gs_pica && gs_pica_data_uploaded.Differs(gs_pica_data);
+    vs_data_dirty = false;
+    fs_data_dirty = false;
+    if (!upload_vs && !upload_fs && !upload_vs_pica && !upload_gs_pica) {
         return;
     }
 
-    std::size_t uniform_size =
-        uniform_size_aligned_vs_pica + uniform_size_aligned_vs + uniform_size_aligned_fs;
+    std::size_t uniform_size = uniform_size_aligned_vs_pica + uniform_size_aligned_vs +
+                               uniform_size_aligned_fs + uniform_size_aligned_gs_pica;
     std::size_t used_bytes = 0;
 
     const auto [uniforms, offset, invalidate] =
         uniform_buffer.Map(uniform_size, uniform_buffer_alignment);
 
-    if (vs_data_dirty || invalidate) {
+    if (upload_vs || invalidate) {
         std::memcpy(uniforms + used_bytes, &vs_data, sizeof(vs_data));
         glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::VSData, uniform_buffer.GetHandle(),
                           offset + used_bytes, sizeof(vs_data));
-        vs_data_dirty = false;
+        vs_data_uploaded.Set(vs_data);
         used_bytes += uniform_size_aligned_vs;
     }
 
-    if (fs_data_dirty || invalidate) {
+    if (upload_fs || invalidate) {
         std::memcpy(uniforms + used_bytes, &fs_data, sizeof(fs_data));
         glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::FSData, uniform_buffer.GetHandle(),
                           offset + used_bytes, sizeof(fs_data));
-        fs_data_dirty = false;
+        fs_data_uploaded.Set(fs_data);
         used_bytes += uniform_size_aligned_fs;
     }
 
-    if (sync_vs_pica || invalidate) {
-        VSPicaUniformData vs_uniforms;
-        vs_uniforms.SetFromRegs(pica.vs_setup);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+    if (upload_vs_pica || invalidate) {
+        std::memcpy(uniforms + used_bytes, &vs_pica_data, sizeof(vs_pica_data));
         glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::VSPicaData,
-                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(vs_uniforms));
-        pica.vs_setup.uniforms_dirty = false;
+                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(vs_pica_data));
+        vs_pica_data_uploaded.Set(vs_pica_data);
         used_bytes += uniform_size_aligned_vs_pica;
     }
 
+    if (upload_gs_pica || invalidate) {
+        std::memcpy(uniforms + used_bytes, &gs_pica_data, sizeof(gs_pica_data));
+        glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::GSPicaData,
+                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(gs_pica_data));
+        gs_pica_data_uploaded.Set(gs_pica_data);
+        used_bytes += uniform_size_aligned_gs_pica;
+    }
+
     uniform_buffer.Unmap(used_bytes);
 }
 
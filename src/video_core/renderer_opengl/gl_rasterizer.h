@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "video_core/lut_cache.h"
 #include "video_core/rasterizer_accelerated.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
@@ -50,6 +51,8 @@ public:
     void InvalidateRegion(PAddr addr, u32 size) override;
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
     void ClearAll(bool flush) override;
+    void PrepareStateLoad() override;
+    void FinishStateLoad() override;
     bool AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) override;
     bool AccelerateTextureCopy(const Pica::DisplayTransferConfig& config) override;
     bool AccelerateFill(const Pica::MemoryFillConfig& config) override;
@@ -57,6 +60,11 @@ public:
                            u32 pixel_stride, ScreenInfo& screen_info);
     bool AccelerateDrawBatch(bool is_indexed) override;
 
+    /// Returns the timeline measuring the GPU time of issued work
+    GPUTimeline& Timeline() noexcept {
+        return runtime.Timeline();
+    }
+
 private:
     /// Syncs pipeline state from PICA registers
     void SyncDrawState();
@@ -120,10 +128,16 @@ private:
     OGLStreamBuffer index_buffer;
     OGLStreamBuffer texture_buffer;
     OGLStreamBuffer texture_lf_buffer;
+    VideoCore::LutCache lut_cache;    ///< LUTs resident in the texture buffer
+    VideoCore::LutCache lf_lut_cache; ///< LUTs resident in the light-fog buffer
     GLint uniform_buffer_alignment;
     std::size_t uniform_size_aligned_vs_pica;
     std::size_t uniform_size_aligned_vs;
     std::size_t uniform_size_aligned_fs;
+    std::size_t uniform_size_aligned_gs_pica;
+
+    Pica::Shader::Generator::GSPicaUniformData gs_pica_data{};
+    UploadedUniform<Pica::Shader::Generator::GSPicaUniformData> gs_pica_data_uploaded;
 
     OGLTexture texture_buffer_lut_lf;
     OGLTexture texture_buffer_lut_rg;
@@ -93,10 +93,13 @@ static std::tuple<PicaVSConfig, Pica::ShaderSetup> BuildVSConfigFromRaw(
     setup.swizzle_data = swizzle_data;
 
     // Enable the geometry-shader only if we are actually doing per-fragment lighting
-    // and care about proper quaternions. Otherwise just use standard vertex+fragment shaders
-    const bool use_geometry_shader = !raw.GetRawShaderConfig().lighting.disable;
-    return {PicaVSConfig{raw.GetRawShaderConfig(), setup, driver.HasClipCullDistance(),
-                         use_geometry_shader, accurate_mul},
+    // and care about proper quaternions, or the PICA pipeline has a geometry shader. Otherwise just
+    // use standard vertex+fragment shaders
+    const auto& regs = raw.GetRawShaderConfig();
+    const bool use_geometry_shader =
+        !regs.lighting.disable || regs.pipeline.use_gs == Pica::PipelineRegs::UseGS::Yes;
+    return {PicaVSConfig{regs, setup, driver.HasClipCullDistance(), use_geometry_shader,
+                         accurate_mul},
             setup};
 }
 
@@ -252,6 +255,9 @@ private:
 using ProgrammableVertexShaders =
     ShaderDoubleCache<PicaVSConfig, &GLSL::GenerateVertexShader, GL_VERTEX_SHADER>;
 
+using ProgrammableGeometryShaders =
+    ShaderDoubleCache<PicaProgrammableGSConfig, &GLSL::GenerateGeometryShader, GL_GEOMETRY_SHADER>;
+
 using FixedGeometryShaders =
     ShaderCache<PicaFixedGSConfig, &GLSL::GenerateFixedGeometryShader, GL_GEOMETRY_SHADER>;
 
@@ -261,7 +267,8 @@ class ShaderProgramManager::Impl {
 public:
     explicit Impl(const Driver& driver, u64 title_id, bool separable)
         : separable(separable), programmable_vertex_shaders(separable),
-          trivial_vertex_shader(driver, separable), fixed_geometry_shaders(separable),
+          trivial_vertex_shader(driver, separable), programmable_geometry_shaders(separable),
+          fixed_geometry_shaders(separable),
           fragment_shaders(separable), disk_cache(title_id, separable) {
         if (separable) {
             pipeline.Create();
@@ -320,6 +327,7 @@ public:
     ProgrammableVertexShaders programmable_vertex_shaders;
     TrivialVertexShader trivial_vertex_shader;
 
+    ProgrammableGeometryShaders programmable_geometry_shaders;
     FixedGeometryShaders fixed_geometry_shaders;
 
     FragmentShaders fragment_shaders;
@@ -340,8 +348,10 @@ bool ShaderProgramManager::UseProgrammableVertexShader(const Pica::RegsInternal&
                                                        Pica::ShaderSetup& setup,
                                                        bool accurate_mul) {
     // Enable the geometry-shader only if we are actually doing per-fragment lighting
-    // and care about proper quaternions. Otherwise just use standard vertex+fragment shaders
-    const bool use_geometry_shader = !regs.lighting.disable;
+    // and care about proper quaternions, or the PICA pipeline has a geometry shader. Otherwise just
+    // use standard vertex+fragment shaders
+    const bool use_geometry_shader =
+        !regs.lighting.disable || regs.pipeline.use_gs == Pica::PipelineRegs::UseGS::Yes;
 
     PicaVSConfig config{regs, setup, driver.HasClipCullDistance(), use_geometry_shader,
                         accurate_mul};
@@ -371,6 +381,18 @@ void ShaderProgramManager::UseTrivialVertexShader() {
     impl->current.vs_hash = 0;
 }
 
+bool ShaderProgramManager::UseProgrammableGeometryShader(const Pica::RegsInternal& regs,
+                                                         Pica::ShaderSetup& setup,
+                                                         bool accurate_mul) {
+    PicaProgrammableGSConfig gs_config{regs, setup, driver.HasClipCullDistance(), accurate_mul};
+    auto [handle, _] = impl->programmable_geometry_shaders.Get(gs_config, setup);
+    if (handle == 0)
+        return false;
+    impl->current.gs = handle;
+    impl->current.gs_hash = gs_config.Hash();
+    return true;
+}
+
 void ShaderProgramManager::UseFixedGeometryShader(const Pica::RegsInternal& regs) {
     PicaFixedGSConfig gs_config(regs, driver.HasClipCullDistance());
     auto [handle, _] = impl->fixed_geometry_shaders.Get(gs_config, impl->separable);
@@ -114,7 +114,7 @@ static constexpr std::array<FormatTuple, 8> CUSTOM_TUPLES = {{
 } // Anonymous namespace
 
 TextureRuntime::TextureRuntime(const Driver& driver_, VideoCore::RendererBase& renderer)
-    : driver{driver_}, blit_helper{driver} {
+    : driver{driver_}, blit_helper{driver}, timeline{driver} {
     for (std::size_t i = 0; i < draw_fbos.size(); ++i) {
         draw_fbos[i].Create();
         read_fbos[i].Create();
@@ -261,6 +261,7 @@ void TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClea
 
 bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                   std::span<const VideoCore::TextureCopy> copies) {
+    const GPUTimelineScope timeline_scope{timeline, Core::GPUTimelineStage::Blit};
     const GLenum src_textarget = source.texture_type == VideoCore::TextureType::CubeMap
                                      ? GL_TEXTURE_CUBE_MAP
                                      : GL_TEXTURE_2D;
@@ -278,6 +279,7 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
 
 bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureBlit& blit) {
+    const GPUTimelineScope timeline_scope{timeline, Core::GPUTimelineStage::Blit};
     OpenGLState state = OpenGLState::GetCurState();
     state.scissor.enabled = false;
     state.draw.read_framebuffer = read_fbos[FboIndex(source.type)].handle;
@@ -387,6 +389,8 @@ GLuint Surface::CopyHandle() noexcept {
 
 void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
                      const VideoCore::StagingData& staging) {
+    const GPUTimelineScope timeline_scope{runtime->Timeline(),
+                                          Core::GPUTimelineStage::TextureUpload};
     ASSERT(stride * GetFormatBytesPerPixel(pixel_format) % 4 == 0);
 
     const u32 unscaled_width = upload.texture_rect.GetWidth();
@@ -408,7 +412,8 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
         .src_rect = upload.texture_rect,
         .dst_rect = upload.texture_rect * res_scale,
     };
-    if (res_scale != 1 && !runtime->blit_helper.Filter(*this, blit)) {
+    if (res_scale != 1 &&
+        !runtime->blit_helper.Filter(*this, blit, staging.mapped.first(staging.size))) {
         BlitScale(blit, true);
     }
 }
@@ -456,6 +461,8 @@ void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
 
 void Surface::Download(const VideoCore::BufferTextureCopy& download,
                        const VideoCore::StagingData& staging) {
+    const GPUTimelineScope timeline_scope{runtime->Timeline(),
+                                          Core::GPUTimelineStage::TextureUpload};
     ASSERT(stride * GetFormatBytesPerPixel(pixel_format) % 4 == 0);
 
     const u32 unscaled_width = download.texture_rect.GetWidth();
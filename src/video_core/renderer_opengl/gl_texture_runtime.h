@@ -8,6 +8,7 @@
 #include "video_core/rasterizer_cache/rasterizer_cache_base.h"
 #include "video_core/rasterizer_cache/surface_base.h"
 #include "video_core/renderer_opengl/gl_blit_helper.h"
+#include "video_core/renderer_opengl/gl_gpu_timeline.h"
 
 namespace VideoCore {
 struct Material;
@@ -78,6 +79,11 @@ public:
     /// Generates mipmaps for all the available levels of the texture
     void GenerateMipmaps(Surface& surface);
 
+    /// Returns the timeline measuring the GPU time of issued work
+    GPUTimeline& Timeline() noexcept {
+        return timeline;
+    }
+
 private:
     /// Returns the OpenGL driver class
     const Driver& GetDriver() const {
@@ -90,6 +96,7 @@ private:
 private:
     const Driver& driver;
     BlitHelper blit_helper;
+    GPUTimeline timeline;
     std::vector<u8> staging_buffer;
     std::array<OGLFramebuffer, 3> draw_fbos;
     std::array<OGLFramebuffer, 3> read_fbos;
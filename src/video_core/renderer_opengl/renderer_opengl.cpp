@@ -131,6 +131,7 @@ void RendererOpenGL::SwapBuffers() {
     }
 #endif
 
+    rasterizer.Timeline().EndFrame(*system.perf_stats);
     system.perf_stats->EndSwap();
     EndFrame();
     prev_state.Apply();
@@ -654,6 +655,8 @@ void RendererOpenGL::DrawSingleScreenStereo(const ScreenInfo& screen_info_l,
  * Draws the emulated screens to the emulator window.
  */
 void RendererOpenGL::DrawScreens(const Layout::FramebufferLayout& layout, bool flipped) {
+    const GPUTimelineScope timeline_scope{rasterizer.Timeline(), Core::GPUTimelineStage::Present};
+
     if (settings.bg_color_update_requested.exchange(false)) {
         // Update background color before drawing
         glClearColor(Settings::values.bg_red.GetValue(), Settings::values.bg_green.GetValue(),
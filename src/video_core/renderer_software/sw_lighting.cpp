@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include "video_core/renderer_software/sw_lighting.h"
 
 namespace SwRenderer {
@@ -10,174 +12,284 @@ namespace SwRenderer {
 using Pica::f16;
 using Pica::LightingRegs;
 
-static float LookupLightingLut(const Pica::PicaCore::Lighting& lighting, std::size_t lut_index,
-                               u8 index, float delta) {
-    ASSERT_MSG(lut_index < lighting.luts.size(), "Out of range lut");
-    ASSERT_MSG(index < lighting.luts[lut_index].size(), "Out of range index");
+namespace {
 
-    const auto& lut = lighting.luts[lut_index][index];
+constexpr std::size_t N = LIGHTING_BATCH_SIZE;
 
-    const float lut_value = lut.ToFloat();
-    const float lut_diff = lut.DiffToFloat();
+/// One value per fragment of the batch. The loops over it have a fixed trip count so that the
+/// compiler can turn them into vector instructions.
+using Lanes = std::array<f32, N>;
 
-    return lut_value + lut_diff * delta;
+struct LanesVec3 {
+    Lanes x;
+    Lanes y;
+    Lanes z;
+};
+
+Lanes Splat(f32 value) {
+    Lanes result;
+    result.fill(value);
+    return result;
 }
 
-std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::PicaCore::Lighting& lighting_state,
-    const Common::Quaternion<f32>& normquat, const Common::Vec3f& view,
-    std::span<const Common::Vec4<u8>, 4> texture_color) {
+LanesVec3 Splat(const Common::Vec3f& value) {
+    return {Splat(value.x), Splat(value.y), Splat(value.z)};
+}
 
-    Common::Vec4f shadow;
-    if (lighting.config0.enable_shadow) {
-        shadow = texture_color[lighting.config0.shadow_selector].Cast<float>() / 255.0f;
-        if (lighting.config0.shadow_invert) {
-            shadow = Common::MakeVec(1.0f, 1.0f, 1.0f, 1.0f) - shadow;
-        }
-    } else {
-        shadow = Common::MakeVec(1.0f, 1.0f, 1.0f, 1.0f);
+Lanes Dot(const LanesVec3& a, const LanesVec3& b) {
+    Lanes result;
+    for (std::size_t i = 0; i < N; i++) {
+        result[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
     }
+    return result;
+}
 
-    Common::Vec3f surface_normal{};
-    Common::Vec3f surface_tangent{};
-
-    if (lighting.config0.bump_mode != LightingRegs::LightingBumpMode::None) {
-        Common::Vec3f perturbation =
-            texture_color[lighting.config0.bump_selector].xyz().Cast<float>() / 127.5f -
-            Common::MakeVec(1.0f, 1.0f, 1.0f);
-        if (lighting.config0.bump_mode == LightingRegs::LightingBumpMode::NormalMap) {
-            if (!lighting.config0.disable_bump_renorm) {
-                const f32 z_square = 1 - perturbation.xy().Length2();
-                perturbation.z = std::sqrt(std::max(z_square, 0.0f));
-            }
-            surface_normal = perturbation;
-            surface_tangent = Common::MakeVec(1.0f, 0.0f, 0.0f);
-        } else if (lighting.config0.bump_mode == LightingRegs::LightingBumpMode::TangentMap) {
-            surface_normal = Common::MakeVec(0.0f, 0.0f, 1.0f);
-            surface_tangent = perturbation;
-        } else {
-            LOG_ERROR(HW_GPU, "Unknown bump mode {}",
-                      static_cast<u32>(lighting.config0.bump_mode.Value()));
-        }
-    } else {
-        surface_normal = Common::MakeVec(0.0f, 0.0f, 1.0f);
-        surface_tangent = Common::MakeVec(1.0f, 0.0f, 0.0f);
+Lanes Length2(const LanesVec3& a) {
+    return Dot(a, a);
+}
+
+/// Normalizes the vectors in place and returns their original lengths.
+Lanes Normalize(LanesVec3& a) {
+    Lanes length;
+    for (std::size_t i = 0; i < N; i++) {
+        length[i] = std::sqrt(a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i]);
+        a.x[i] /= length[i];
+        a.y[i] /= length[i];
+        a.z[i] /= length[i];
     }
+    return length;
+}
 
-    // Use the normalized the quaternion when performing the rotation
-    auto normal = Common::QuaternionRotate(normquat, surface_normal);
-    auto tangent = Common::QuaternionRotate(normquat, surface_tangent);
+LanesVec3 Normalized(const LanesVec3& a) {
+    LanesVec3 result = a;
+    Normalize(result);
+    return result;
+}
 
-    Common::Vec4f diffuse_sum = {0.0f, 0.0f, 0.0f, 1.0f};
-    Common::Vec4f specular_sum = {0.0f, 0.0f, 0.0f, 1.0f};
+void StoreLane(LanesVec3& lanes, std::size_t i, const Common::Vec3f& value) {
+    lanes.x[i] = value.x;
+    lanes.y[i] = value.y;
+    lanes.z[i] = value.z;
+}
 
-    for (u32 light_index = 0; light_index <= lighting.max_light_index; ++light_index) {
-        u32 num = lighting.light_enable.GetNum(light_index);
-        const auto& light_config = lighting.light[num];
+/// Samples a LUT with the given inputs, which are in [0, 1] when abs is set and [-1, 1] otherwise.
+Lanes LookupLightingLut(const LightingCache& cache, std::size_t lut_index, const Lanes& input,
+                        bool abs, bool two_sided_diffuse, f32 scale) {
+    ASSERT_MSG(lut_index < cache.luts.size(), "Out of range lut");
+    const auto& lut = cache.luts[lut_index];
+
+    Lanes result;
+    for (std::size_t i = 0; i < N; i++) {
+        u8 index;
+        f32 delta;
+        if (abs) {
+            const f32 value = two_sided_diffuse ? std::abs(input[i]) : std::max(input[i], 0.0f);
+            const f32 flr = std::floor(value * 256.0f);
+            index = static_cast<u8>(std::clamp(flr, 0.0f, 255.0f));
+            delta = value * 256 - index;
+        } else {
+            const f32 flr = std::floor(input[i] * 128.0f);
+            const s8 signed_index = static_cast<s8>(std::clamp(flr, -128.0f, 127.0f));
+            delta = input[i] * 128.0f - signed_index;
+            index = static_cast<u8>(signed_index);
+        }
+        const auto& entry = lut[index];
+        result[i] = scale * (entry.value + entry.difference * delta);
+    }
+    return result;
+}
 
-        const Common::Vec3f position = {f16::FromRaw(light_config.x).ToFloat32(),
-                                        f16::FromRaw(light_config.y).ToFloat32(),
-                                        f16::FromRaw(light_config.z).ToFloat32()};
-        Common::Vec3f refl_value{};
-        Common::Vec3f light_vector{};
+} // Anonymous namespace
+
+void LightingCache::Update(const Pica::LightingRegs& regs,
+                           Pica::PicaCore::Lighting& lighting_state) {
+    // Only one renderer is active at a time, so the dirty bits are ours to consume.
+    u32 dirty = luts_valid ? lighting_state.lut_dirty : Pica::PicaCore::Lighting::LutAllDirty;
+    for (; dirty != 0; dirty &= dirty - 1) {
+        const std::size_t index = std::countr_zero(dirty);
+        for (std::size_t i = 0; i < luts[index].size(); i++) {
+            const auto& entry = lighting_state.luts[index][i];
+            luts[index][i] = {entry.ToFloat(), entry.DiffToFloat()};
+        }
+    }
+    lighting_state.lut_dirty = 0;
+    luts_valid = true;
+
+    for (std::size_t i = 0; i < lights.size(); i++) {
+        const auto& light_config = regs.light[i];
+        const Common::Vec3<s32> spot_dir{light_config.spot_x.Value(), light_config.spot_y.Value(),
+                                         light_config.spot_z.Value()};
+        lights[i] = {
+            .position = {f16::FromRaw(light_config.x).ToFloat32(),
+                         f16::FromRaw(light_config.y).ToFloat32(),
+                         f16::FromRaw(light_config.z).ToFloat32()},
+            .spot_direction = spot_dir.Cast<float>() / 2047.0f,
+            .specular_0 = light_config.specular_0.ToVec3f(),
+            .specular_1 = light_config.specular_1.ToVec3f(),
+            .diffuse = light_config.diffuse.ToVec3f(),
+            .ambient = light_config.ambient.ToVec3f(),
+            .dist_atten_scale = Pica::f20::FromRaw(light_config.dist_atten_scale).ToFloat32(),
+            .dist_atten_bias = Pica::f20::FromRaw(light_config.dist_atten_bias).ToFloat32(),
+        };
+    }
+}
 
-        if (light_config.config.directional) {
-            light_vector = position;
+void ComputeFragmentsColors(
+    const Pica::LightingRegs& lighting, const LightingCache& cache,
+    std::span<const LightingFragment> fragments,
+    std::span<std::pair<Common::Vec4<u8>, Common::Vec4<u8>>, LIGHTING_BATCH_SIZE> colors) {
+    ASSERT(fragments.size() <= N);
+
+    // Unused lanes repeat the first fragment, so they hold values that are safe to compute with.
+    const auto fragment = [&](std::size_t i) -> const LightingFragment& {
+        return fragments[i < fragments.size() ? i : 0];
+    };
+
+    std::array<Common::Vec4f, N> shadow;
+    LanesVec3 normal;
+    LanesVec3 tangent;
+    LanesVec3 view;
+    for (std::size_t i = 0; i < N; i++) {
+        const auto& texture_color = fragment(i).texture_color;
+        if (lighting.config0.enable_shadow) {
+            shadow[i] = texture_color[lighting.config0.shadow_selector].Cast<float>() / 255.0f;
+            if (lighting.config0.shadow_invert) {
+                shadow[i] = Common::MakeVec(1.0f, 1.0f, 1.0f, 1.0f) - shadow[i];
+            }
         } else {
-            light_vector = position + view;
+            shadow[i] = Common::MakeVec(1.0f, 1.0f, 1.0f, 1.0f);
         }
 
-        [[maybe_unused]] const f32 length = light_vector.Normalize();
+        Common::Vec3f surface_normal{};
+        Common::Vec3f surface_tangent{};
+
+        if (lighting.config0.bump_mode != LightingRegs::LightingBumpMode::None) {
+            Common::Vec3f perturbation =
+                texture_color[lighting.config0.bump_selector].xyz().Cast<float>() / 127.5f -
+                Common::MakeVec(1.0f, 1.0f, 1.0f);
+            if (lighting.config0.bump_mode == LightingRegs::LightingBumpMode::NormalMap) {
+                if (!lighting.config0.disable_bump_renorm) {
+                    const f32 z_square = 1 - perturbation.xy().Length2();
+                    perturbation.z = std::sqrt(std::max(z_square, 0.0f));
+                }
+                surface_normal = perturbation;
+                surface_tangent = Common::MakeVec(1.0f, 0.0f, 0.0f);
+            } else if (lighting.config0.bump_mode == LightingRegs::LightingBumpMode::TangentMap) {
+                surface_normal = Common::MakeVec(0.0f, 0.0f, 1.0f);
+                surface_tangent = perturbation;
+            } else {
+                LOG_ERROR(HW_GPU, "Unknown bump mode {}",
+                          static_cast<u32>(lighting.config0.bump_mode.Value()));
+            }
+        } else {
+            surface_normal = Common::MakeVec(0.0f, 0.0f, 1.0f);
+            surface_tangent = Common::MakeVec(1.0f, 0.0f, 0.0f);
+        }
 
-        Common::Vec3f norm_view = view.Normalized();
-        Common::Vec3f half_vector = norm_view + light_vector;
+        // Use the normalized the quaternion when performing the rotation
+        StoreLane(normal, i, Common::QuaternionRotate(fragment(i).normquat, surface_normal));
+        StoreLane(tangent, i, Common::QuaternionRotate(fragment(i).normquat, surface_tangent));
+        StoreLane(view, i, fragment(i).view);
+    }
 
-        f32 dist_atten = 1.0f;
-        if (!lighting.IsDistAttenDisabled(num)) {
-            const f32 scale = Pica::f20::FromRaw(light_config.dist_atten_scale).ToFloat32();
-            const f32 bias = Pica::f20::FromRaw(light_config.dist_atten_bias).ToFloat32();
-            const std::size_t lut =
-                static_cast<std::size_t>(LightingRegs::LightingSampler::DistanceAttenuation) + num;
+    const LanesVec3 norm_view = Normalized(view);
 
-            const f32 sample_loc = std::clamp(scale * length + bias, 0.0f, 1.0f);
+    LanesVec3 diffuse_sum{Splat(0.0f), Splat(0.0f), Splat(0.0f)};
+    LanesVec3 specular_sum{Splat(0.0f), Splat(0.0f), Splat(0.0f)};
+    Lanes diffuse_alpha = Splat(1.0f);
+    Lanes specular_alpha = Splat(1.0f);
+
+    const auto config = lighting.config0.config.Value();
+    const auto is_supported = [config](LightingRegs::LightingSampler sampler) {
+        return LightingRegs::IsLightingSamplerSupported(config, sampler);
+    };
+
+    for (u32 light_index = 0; light_index <= lighting.max_light_index; ++light_index) {
+        const u32 num = lighting.light_enable.GetNum(light_index);
+        const auto& light_config = lighting.light[num];
+        const auto& light = cache.lights[num];
+        const bool two_sided = light_config.config.two_sided_diffuse;
+
+        LanesVec3 light_vector = Splat(light.position);
+        if (!light_config.config.directional) {
+            for (std::size_t i = 0; i < N; i++) {
+                light_vector.x[i] += view.x[i];
+                light_vector.y[i] += view.y[i];
+                light_vector.z[i] += view.z[i];
+            }
+        }
+        const Lanes length = Normalize(light_vector);
 
-            const u8 lutindex =
-                static_cast<u8>(std::clamp(std::floor(sample_loc * 256.0f), 0.0f, 255.0f));
-            const f32 delta = sample_loc * 256 - lutindex;
+        LanesVec3 half_vector;
+        for (std::size_t i = 0; i < N; i++) {
+            half_vector.x[i] = norm_view.x[i] + light_vector.x[i];
+            half_vector.y[i] = norm_view.y[i] + light_vector.y[i];
+            half_vector.z[i] = norm_view.z[i] + light_vector.z[i];
+        }
+        const LanesVec3 norm_half_vector = Normalized(half_vector);
 
-            dist_atten = LookupLightingLut(lighting_state, lut, lutindex, delta);
+        Lanes dist_atten = Splat(1.0f);
+        if (!lighting.IsDistAttenDisabled(num)) {
+            const auto& lut = cache.luts[static_cast<std::size_t>(
+                                             LightingRegs::LightingSampler::DistanceAttenuation) +
+                                         num];
+            for (std::size_t i = 0; i < N; i++) {
+                const f32 sample_loc = std::clamp(
+                    light.dist_atten_scale * length[i] + light.dist_atten_bias, 0.0f, 1.0f);
+                const u8 lutindex =
+                    static_cast<u8>(std::clamp(std::floor(sample_loc * 256.0f), 0.0f, 255.0f));
+                const f32 delta = sample_loc * 256 - lutindex;
+                dist_atten[i] = lut[lutindex].value + lut[lutindex].difference * delta;
+            }
         }
 
         auto get_lut_value = [&](LightingRegs::LightingLutInput input, bool abs,
                                  LightingRegs::LightingScale scale_enum,
                                  LightingRegs::LightingSampler sampler) {
-            f32 result = 0.0f;
+            Lanes result = Splat(0.0f);
 
             switch (input) {
             case LightingRegs::LightingLutInput::NH:
-                result = Common::Dot(normal, half_vector.Normalized());
+                result = Dot(normal, norm_half_vector);
                 break;
             case LightingRegs::LightingLutInput::VH:
-                result = Common::Dot(norm_view, half_vector.Normalized());
+                result = Dot(norm_view, norm_half_vector);
                 break;
             case LightingRegs::LightingLutInput::NV:
-                result = Common::Dot(normal, norm_view);
+                result = Dot(normal, norm_view);
                 break;
             case LightingRegs::LightingLutInput::LN:
-                result = Common::Dot(light_vector, normal);
+                result = Dot(light_vector, normal);
                 break;
-            case LightingRegs::LightingLutInput::SP: {
-                Common::Vec3<s32> spot_dir{light_config.spot_x.Value(), light_config.spot_y.Value(),
-                                           light_config.spot_z.Value()};
-                result = Common::Dot(light_vector, spot_dir.Cast<float>() / 2047.0f);
+            case LightingRegs::LightingLutInput::SP:
+                result = Dot(light_vector, Splat(light.spot_direction));
                 break;
-            }
             case LightingRegs::LightingLutInput::CP:
-                if (lighting.config0.config == LightingRegs::LightingConfig::Config7) {
-                    const Common::Vec3f norm_half_vector = half_vector.Normalized();
-                    const Common::Vec3f half_vector_proj =
-                        norm_half_vector - normal * Common::Dot(normal, norm_half_vector);
-                    result = Common::Dot(half_vector_proj, tangent);
-                } else {
-                    result = 0.0f;
+                if (config == LightingRegs::LightingConfig::Config7) {
+                    const Lanes n_dot_h = Dot(normal, norm_half_vector);
+                    LanesVec3 half_vector_proj;
+                    for (std::size_t i = 0; i < N; i++) {
+                        half_vector_proj.x[i] = norm_half_vector.x[i] - normal.x[i] * n_dot_h[i];
+                        half_vector_proj.y[i] = norm_half_vector.y[i] - normal.y[i] * n_dot_h[i];
+                        half_vector_proj.z[i] = norm_half_vector.z[i] - normal.z[i] * n_dot_h[i];
+                    }
+                    result = Dot(half_vector_proj, tangent);
                 }
                 break;
             default:
                 LOG_CRITICAL(HW_GPU, "Unknown lighting LUT input {}", input);
                 UNIMPLEMENTED();
-                result = 0.0f;
-            }
-
-            u8 index;
-            f32 delta;
-
-            if (abs) {
-                if (light_config.config.two_sided_diffuse) {
-                    result = std::abs(result);
-                } else {
-                    result = std::max(result, 0.0f);
-                }
-
-                const f32 flr = std::floor(result * 256.0f);
-                index = static_cast<u8>(std::clamp(flr, 0.0f, 255.0f));
-                delta = result * 256 - index;
-            } else {
-                const f32 flr = std::floor(result * 128.0f);
-                const s8 signed_index = static_cast<s8>(std::clamp(flr, -128.0f, 127.0f));
-                delta = result * 128.0f - signed_index;
-                index = static_cast<u8>(signed_index);
             }
 
             const f32 scale = lighting.lut_scale.GetScale(scale_enum);
-            return scale * LookupLightingLut(lighting_state, static_cast<std::size_t>(sampler),
-                                             index, delta);
+            return LookupLightingLut(cache, static_cast<std::size_t>(sampler), result, abs,
+                                     two_sided, scale);
         };
 
         // If enabled, compute spot light attenuation value
-        f32 spot_atten = 1.0f;
+        Lanes spot_atten = Splat(1.0f);
         if (!lighting.IsSpotAttenDisabled(num) &&
-            LightingRegs::IsLightingSamplerSupported(
-                lighting.config0.config, LightingRegs::LightingSampler::SpotlightAttenuation)) {
+            is_supported(LightingRegs::LightingSampler::SpotlightAttenuation)) {
             auto lut = LightingRegs::SpotlightAttenuationSampler(num);
             spot_atten =
                 get_lut_value(lighting.lut_input.sp, lighting.abs_lut_input.disable_sp == 0,
@@ -185,151 +297,154 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
         }
 
         // Specular 0 component
-        f32 d0_lut_value = 1.0f;
+        Lanes d0_lut_value = Splat(1.0f);
         if (lighting.config1.disable_lut_d0 == 0 &&
-            LightingRegs::IsLightingSamplerSupported(
-                lighting.config0.config, LightingRegs::LightingSampler::Distribution0)) {
+            is_supported(LightingRegs::LightingSampler::Distribution0)) {
             d0_lut_value =
                 get_lut_value(lighting.lut_input.d0, lighting.abs_lut_input.disable_d0 == 0,
                               lighting.lut_scale.d0, LightingRegs::LightingSampler::Distribution0);
         }
 
-        Common::Vec3f specular_0 = d0_lut_value * light_config.specular_0.ToVec3f();
-
         // If enabled, lookup ReflectRed value, otherwise, 1.0 is used
+        Lanes refl_r = Splat(1.0f);
         if (lighting.config1.disable_lut_rr == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::ReflectRed)) {
-            refl_value.x =
+            is_supported(LightingRegs::LightingSampler::ReflectRed)) {
+            refl_r =
                 get_lut_value(lighting.lut_input.rr, lighting.abs_lut_input.disable_rr == 0,
                               lighting.lut_scale.rr, LightingRegs::LightingSampler::ReflectRed);
-        } else {
-            refl_value.x = 1.0f;
         }
 
         // If enabled, lookup ReflectGreen value, otherwise, ReflectRed value is used
+        Lanes refl_g = refl_r;
         if (lighting.config1.disable_lut_rg == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::ReflectGreen)) {
-            refl_value.y =
+            is_supported(LightingRegs::LightingSampler::ReflectGreen)) {
+            refl_g =
                 get_lut_value(lighting.lut_input.rg, lighting.abs_lut_input.disable_rg == 0,
                               lighting.lut_scale.rg, LightingRegs::LightingSampler::ReflectGreen);
-        } else {
-            refl_value.y = refl_value.x;
         }
 
         // If enabled, lookup ReflectBlue value, otherwise, ReflectRed value is used
+        Lanes refl_b = refl_r;
         if (lighting.config1.disable_lut_rb == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::ReflectBlue)) {
-            refl_value.z =
+            is_supported(LightingRegs::LightingSampler::ReflectBlue)) {
+            refl_b =
                 get_lut_value(lighting.lut_input.rb, lighting.abs_lut_input.disable_rb == 0,
                               lighting.lut_scale.rb, LightingRegs::LightingSampler::ReflectBlue);
-        } else {
-            refl_value.z = refl_value.x;
         }
 
         // Specular 1 component
-        f32 d1_lut_value = 1.0f;
+        Lanes d1_lut_value = Splat(1.0f);
         if (lighting.config1.disable_lut_d1 == 0 &&
-            LightingRegs::IsLightingSamplerSupported(
-                lighting.config0.config, LightingRegs::LightingSampler::Distribution1)) {
+            is_supported(LightingRegs::LightingSampler::Distribution1)) {
             d1_lut_value =
                 get_lut_value(lighting.lut_input.d1, lighting.abs_lut_input.disable_d1 == 0,
                               lighting.lut_scale.d1, LightingRegs::LightingSampler::Distribution1);
         }
 
-        Common::Vec3f specular_1 = d1_lut_value * refl_value * light_config.specular_1.ToVec3f();
-
         // Fresnel
         // Note: only the last entry in the light slots applies the Fresnel factor
         if (light_index == lighting.max_light_index && lighting.config1.disable_lut_fr == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::Fresnel)) {
+            is_supported(LightingRegs::LightingSampler::Fresnel)) {
 
-            const f32 lut_value =
+            const Lanes lut_value =
                 get_lut_value(lighting.lut_input.fr, lighting.abs_lut_input.disable_fr == 0,
                               lighting.lut_scale.fr, LightingRegs::LightingSampler::Fresnel);
 
             // Enabled for diffuse lighting alpha component
             if (lighting.config0.enable_primary_alpha) {
-                diffuse_sum.a() = lut_value;
+                diffuse_alpha = lut_value;
             }
 
             // Enabled for the specular lighting alpha component
             if (lighting.config0.enable_secondary_alpha) {
-                specular_sum.a() = lut_value;
+                specular_alpha = lut_value;
             }
         }
 
-        auto dot_product = Common::Dot(light_vector, normal);
-        if (light_config.config.two_sided_diffuse) {
-            dot_product = std::abs(dot_product);
-        } else {
-            dot_product = std::max(dot_product, 0.0f);
+        Lanes dot_product = Dot(light_vector, normal);
+        Lanes geo_factor = Splat(1.0f);
+        const bool geo_factor_0 = light_config.config.geometric_factor_0;
+        const bool geo_factor_1 = light_config.config.geometric_factor_1;
+        if (geo_factor_0 || geo_factor_1) {
+            geo_factor = Length2(half_vector);
         }
 
-        f32 clamp_highlights = 1.0f;
-        if (lighting.config0.clamp_highlights) {
-            clamp_highlights = dot_product == 0.0f ? 0.0f : 1.0f;
-        }
+        const bool shadow_primary =
+            lighting.config0.shadow_primary && !lighting.IsShadowDisabled(num);
+        const bool shadow_secondary =
+            lighting.config0.shadow_secondary && !lighting.IsShadowDisabled(num);
+
+        for (std::size_t i = 0; i < N; i++) {
+            dot_product[i] =
+                two_sided ? std::abs(dot_product[i]) : std::max(dot_product[i], 0.0f);
 
-        if (light_config.config.geometric_factor_0 || light_config.config.geometric_factor_1) {
-            f32 geo_factor = half_vector.Length2();
-            geo_factor = geo_factor == 0.0f ? 0.0f : std::min(dot_product / geo_factor, 1.0f);
-            if (light_config.config.geometric_factor_0) {
-                specular_0 *= geo_factor;
+            f32 clamp_highlights = 1.0f;
+            if (lighting.config0.clamp_highlights) {
+                clamp_highlights = dot_product[i] == 0.0f ? 0.0f : 1.0f;
             }
-            if (light_config.config.geometric_factor_1) {
-                specular_1 *= geo_factor;
+
+            Common::Vec3f specular_0 = d0_lut_value[i] * light.specular_0;
+            Common::Vec3f specular_1 = d1_lut_value[i] *
+                                       Common::MakeVec(refl_r[i], refl_g[i], refl_b[i]) *
+                                       light.specular_1;
+            if (geo_factor_0 || geo_factor_1) {
+                const f32 factor = geo_factor[i] == 0.0f
+                                       ? 0.0f
+                                       : std::min(dot_product[i] / geo_factor[i], 1.0f);
+                if (geo_factor_0) {
+                    specular_0 *= factor;
+                }
+                if (geo_factor_1) {
+                    specular_1 *= factor;
+                }
             }
-        }
 
-        const bool shadow_primary_enable =
-            lighting.config0.shadow_primary && !lighting.IsShadowDisabled(num);
-        const bool shadow_secondary_enable =
-            lighting.config0.shadow_secondary && !lighting.IsShadowDisabled(num);
-        const auto shadow_primary =
-            shadow_primary_enable ? shadow.xyz() : Common::MakeVec(1.f, 1.f, 1.f);
-        const auto shadow_secondary =
-            shadow_secondary_enable ? shadow.xyz() : Common::MakeVec(1.f, 1.f, 1.f);
-
-        const auto diffuse = (light_config.diffuse.ToVec3f() * dot_product * shadow_primary +
-                              light_config.ambient.ToVec3f()) *
-                             dist_atten * spot_atten;
-        const auto specular = (specular_0 + specular_1) * clamp_highlights * dist_atten *
-                              spot_atten * shadow_secondary;
-
-        diffuse_sum += Common::MakeVec(diffuse, 0.0f);
-        specular_sum += Common::MakeVec(specular, 0.0f);
+            const auto shadow_primary_value =
+                shadow_primary ? shadow[i].xyz() : Common::MakeVec(1.f, 1.f, 1.f);
+            const auto shadow_secondary_value =
+                shadow_secondary ? shadow[i].xyz() : Common::MakeVec(1.f, 1.f, 1.f);
+
+            const auto diffuse =
+                (light.diffuse * dot_product[i] * shadow_primary_value + light.ambient) *
+                dist_atten[i] * spot_atten[i];
+            const auto specular = (specular_0 + specular_1) * clamp_highlights * dist_atten[i] *
+                                  spot_atten[i] * shadow_secondary_value;
+
+            diffuse_sum.x[i] += diffuse.x;
+            diffuse_sum.y[i] += diffuse.y;
+            diffuse_sum.z[i] += diffuse.z;
+            specular_sum.x[i] += specular.x;
+            specular_sum.y[i] += specular.y;
+            specular_sum.z[i] += specular.z;
+        }
     }
 
-    if (lighting.config0.shadow_alpha) {
-        // Alpha shadow also uses the Fresnel selecotr to determine which alpha to apply
-        // Enabled for diffuse lighting alpha component
-        if (lighting.config0.enable_primary_alpha) {
-            diffuse_sum.a() *= shadow.w;
-        }
+    const Common::Vec3f global_ambient = lighting.global_ambient.ToVec3f();
+    const auto to_color = [](f32 x, f32 y, f32 z, f32 w) {
+        return Common::MakeVec(std::clamp(x, 0.0f, 1.0f) * 255, std::clamp(y, 0.0f, 1.0f) * 255,
+                               std::clamp(z, 0.0f, 1.0f) * 255, std::clamp(w, 0.0f, 1.0f) * 255)
+            .Cast<u8>();
+    };
 
-        // Enabled for the specular lighting alpha component
-        if (lighting.config0.enable_secondary_alpha) {
-            specular_sum.a() *= shadow.w;
+    for (std::size_t i = 0; i < fragments.size(); i++) {
+        if (lighting.config0.shadow_alpha) {
+            // Alpha shadow also uses the Fresnel selecotr to determine which alpha to apply
+            // Enabled for diffuse lighting alpha component
+            if (lighting.config0.enable_primary_alpha) {
+                diffuse_alpha[i] *= shadow[i].w;
+            }
+
+            // Enabled for the specular lighting alpha component
+            if (lighting.config0.enable_secondary_alpha) {
+                specular_alpha[i] *= shadow[i].w;
+            }
         }
-    }
 
-    diffuse_sum += Common::MakeVec(lighting.global_ambient.ToVec3f(), 0.0f);
-
-    const auto diffuse = Common::MakeVec(std::clamp(diffuse_sum.x, 0.0f, 1.0f) * 255,
-                                         std::clamp(diffuse_sum.y, 0.0f, 1.0f) * 255,
-                                         std::clamp(diffuse_sum.z, 0.0f, 1.0f) * 255,
-                                         std::clamp(diffuse_sum.w, 0.0f, 1.0f) * 255)
-                             .Cast<u8>();
-    const auto specular = Common::MakeVec(std::clamp(specular_sum.x, 0.0f, 1.0f) * 255,
-                                          std::clamp(specular_sum.y, 0.0f, 1.0f) * 255,
-                                          std::clamp(specular_sum.z, 0.0f, 1.0f) * 255,
-                                          std::clamp(specular_sum.w, 0.0f, 1.0f) * 255)
-                              .Cast<u8>();
-    return std::make_pair(diffuse, specular);
+        colors[i] = std::make_pair(
+            to_color(diffuse_sum.x[i] + global_ambient.x, diffuse_sum.y[i] + global_ambient.y,
+                     diffuse_sum.z[i] + global_ambient.z, diffuse_alpha[i]),
+            to_color(specular_sum.x[i], specular_sum.y[i], specular_sum.z[i], specular_alpha[i]));
+    }
 }
 
 } // namespace SwRenderer
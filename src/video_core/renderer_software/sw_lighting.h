@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <span>
 #include <utility>
 
@@ -13,9 +14,52 @@
 
 namespace SwRenderer {
 
-std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::PicaCore::Lighting& lighting_state,
-    const Common::Quaternion<f32>& normquat, const Common::Vec3f& view,
-    std::span<const Common::Vec4<u8>, 4> texture_color);
+/// Number of fragments lit together by ComputeFragmentsColors.
+constexpr std::size_t LIGHTING_BATCH_SIZE = 4;
+
+/**
+ * Lighting state converted to floating point for the software renderer. The LUTs are only
+ * converted again when they are written, the light parameters are refreshed on every draw.
+ */
+struct LightingCache {
+    struct LutEntry {
+        f32 value;
+        f32 difference;
+    };
+
+    struct Light {
+        Common::Vec3f position;
+        Common::Vec3f spot_direction;
+        Common::Vec3f specular_0;
+        Common::Vec3f specular_1;
+        Common::Vec3f diffuse;
+        Common::Vec3f ambient;
+        f32 dist_atten_scale;
+        f32 dist_atten_bias;
+    };
+
+    std::array<std::array<LutEntry, 256>, 24> luts{};
+    std::array<Light, 8> lights{};
+    bool luts_valid = false;
+
+    /// Converts the LUTs written since the last update and the parameters of the enabled lights.
+    void Update(const Pica::LightingRegs& regs, Pica::PicaCore::Lighting& lighting_state);
+};
+
+struct LightingFragment {
+    Common::Quaternion<f32> normquat;
+    Common::Vec3f view;
+    std::array<Common::Vec4<u8>, 4> texture_color;
+};
+
+/**
+ * Computes the primary and secondary lighting colors of up to LIGHTING_BATCH_SIZE fragments.
+ * The fragments are processed together, with the per light work laid out so that it vectorizes
+ * across them.
+ */
+void ComputeFragmentsColors(
+    const Pica::LightingRegs& lighting, const LightingCache& cache,
+    std::span<const LightingFragment> fragments,
+    std::span<std::pair<Common::Vec4<u8>, Common::Vec4<u8>>, LIGHTING_BATCH_SIZE> colors);
 
 } // namespace SwRenderer
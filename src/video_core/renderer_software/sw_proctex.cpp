@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
 #include "video_core/renderer_software/sw_proctex.h"
 
@@ -15,26 +17,32 @@ using ProcTexCombiner = Pica::TexturingRegs::ProcTexCombiner;
 using ProcTexFilter = Pica::TexturingRegs::ProcTexFilter;
 using Pica::f16;
 
-float LookupLUT(const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& lut, float coord) {
+/// Number of coordinates processed together. The loops over them have a fixed trip count so that
+/// the compiler can turn them into vector instructions.
+constexpr std::size_t N = 4;
+
+using Lanes = std::array<float, N>;
+
+float LookupLUT(const std::array<ProcTexCache::ValueEntry, 128>& lut, float coord) {
     // For NoiseLUT/ColorMap/AlphaMap, coord=0.0 is lut[0], coord=127.0/128.0 is lut[127] and
     // coord=1.0 is lut[127]+lut_diff[127]. For other indices, the result is interpolated using
     // value entries and difference entries.
     coord *= 128;
     const int index_int = std::min(static_cast<int>(coord), 127);
     const float frac = coord - index_int;
-    return lut[index_int].ToFloat() + frac * lut[index_int].DiffToFloat();
+    return lut[index_int].value + frac * lut[index_int].difference;
 }
 
 // These function are used to generate random noise for procedural texture. Their results are
 // verified against real hardware, but it's not known if the algorithm is the same as hardware.
-unsigned int NoiseRand1D(unsigned int v) {
-    static constexpr std::array<unsigned int, 16> table{
+constexpr unsigned int NoiseRand1D(unsigned int v) {
+    constexpr std::array<unsigned int, 16> table{
         {0, 4, 10, 8, 4, 9, 7, 12, 5, 15, 13, 14, 11, 15, 2, 11}};
     return ((v % 9 + 2) * 3 & 0xF) ^ table[(v / 9) & 0xF];
 }
 
-float NoiseRand2D(unsigned int x, unsigned int y) {
-    static constexpr std::array<unsigned int, 16> table{
+constexpr unsigned int NoiseRand2DIndex(unsigned int x, unsigned int y) {
+    constexpr std::array<unsigned int, 16> table{
         {10, 2, 15, 8, 0, 7, 4, 5, 5, 13, 2, 6, 13, 9, 3, 14}};
     unsigned int u2 = NoiseRand1D(x);
     unsigned int v2 = NoiseRand1D(y);
@@ -43,17 +51,30 @@ float NoiseRand2D(unsigned int x, unsigned int y) {
     v2 += 10 + u2;
     v2 &= 0xF;
     v2 ^= table[u2];
+    return v2;
+}
+
+// NoiseRand1D only depends on v % 9 and (v / 9) % 16, so the noise repeats every 144 units.
+constexpr unsigned int NOISE_PERIOD = 9 * 16;
+
+constexpr auto NOISE_TABLE = [] {
+    std::array<std::array<u8, NOISE_PERIOD>, NOISE_PERIOD> table{};
+    for (unsigned int x = 0; x < NOISE_PERIOD; x++) {
+        for (unsigned int y = 0; y < NOISE_PERIOD; y++) {
+            table[x][y] = static_cast<u8>(NoiseRand2DIndex(x, y));
+        }
+    }
+    return table;
+}();
+
+float NoiseRand2D(unsigned int x, unsigned int y) {
+    const unsigned int v2 = NOISE_TABLE[x % NOISE_PERIOD][y % NOISE_PERIOD];
     return -1.0f + v2 * 2.0f / 15.0f;
 }
 
-float NoiseCoef(float u, float v, const Pica::TexturingRegs& regs,
-                const Pica::PicaCore::ProcTex& state) {
-    const float freq_u = f16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32();
-    const float freq_v = f16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32();
-    const float phase_u = f16::FromRaw(regs.proctex_noise_u.phase).ToFloat32();
-    const float phase_v = f16::FromRaw(regs.proctex_noise_v.phase).ToFloat32();
-    const float x = 9 * freq_u * std::abs(u + phase_u);
-    const float y = 9 * freq_v * std::abs(v + phase_v);
+float NoiseCoef(float u, float v, const ProcTexCache& cache) {
+    const float x = 9 * cache.noise_frequency.x * std::abs(u + cache.noise_phase.x);
+    const float y = 9 * cache.noise_frequency.y * std::abs(v + cache.noise_phase.y);
     const int x_int = static_cast<int>(x);
     const int y_int = static_cast<int>(y);
     const float x_frac = x - x_int;
@@ -63,162 +84,266 @@ float NoiseCoef(float u, float v, const Pica::TexturingRegs& regs,
     const float g1 = NoiseRand2D(x_int + 1, y_int) * (x_frac + y_frac - 1);
     const float g2 = NoiseRand2D(x_int, y_int + 1) * (x_frac + y_frac - 1);
     const float g3 = NoiseRand2D(x_int + 1, y_int + 1) * (x_frac + y_frac - 2);
-    const float x_noise = LookupLUT(state.noise_table, x_frac);
-    const float y_noise = LookupLUT(state.noise_table, y_frac);
+    const float x_noise = LookupLUT(cache.noise_table, x_frac);
+    const float y_noise = LookupLUT(cache.noise_table, y_frac);
     return Common::BilinearInterp(g0, g1, g2, g3, x_noise, y_noise);
 }
 
-float GetShiftOffset(float v, ProcTexShift mode, ProcTexClamp clamp_mode) {
+Lanes GetShiftOffset(const Lanes& v, ProcTexShift mode, ProcTexClamp clamp_mode) {
     const float offset = (clamp_mode == ProcTexClamp::MirroredRepeat) ? 1 : 0.5f;
+    Lanes result{};
     switch (mode) {
     case ProcTexShift::None:
-        return 0;
+        break;
     case ProcTexShift::Odd:
-        return offset * (((int)v / 2) % 2);
+        for (std::size_t i = 0; i < N; i++) {
+            result[i] = offset * (((int)v[i] / 2) % 2);
+        }
+        break;
     case ProcTexShift::Even:
-        return offset * ((((int)v + 1) / 2) % 2);
+        for (std::size_t i = 0; i < N; i++) {
+            result[i] = offset * ((((int)v[i] + 1) / 2) % 2);
+        }
+        break;
     default:
         LOG_CRITICAL(HW_GPU, "Unknown shift mode {}", mode);
-        return 0;
+        break;
     }
-};
+    return result;
+}
 
-void ClampCoord(float& coord, ProcTexClamp mode) {
+void ClampCoord(Lanes& coord, ProcTexClamp mode) {
     switch (mode) {
     case ProcTexClamp::ToZero:
-        if (coord > 1.0f)
-            coord = 0.0f;
+        for (auto& c : coord) {
+            c = c > 1.0f ? 0.0f : c;
+        }
         break;
     case ProcTexClamp::ToEdge:
-        coord = std::min(coord, 1.0f);
+        for (auto& c : coord) {
+            c = std::min(c, 1.0f);
+        }
         break;
     case ProcTexClamp::SymmetricalRepeat:
-        coord = coord - std::floor(coord);
+        for (auto& c : coord) {
+            c = c - std::floor(c);
+        }
         break;
-    case ProcTexClamp::MirroredRepeat: {
-        int integer = static_cast<int>(coord);
-        float frac = coord - integer;
-        coord = (integer % 2) == 0 ? frac : (1.0f - frac);
+    case ProcTexClamp::MirroredRepeat:
+        for (auto& c : coord) {
+            const int integer = static_cast<int>(c);
+            const float frac = c - integer;
+            c = (integer % 2) == 0 ? frac : (1.0f - frac);
+        }
         break;
-    }
     case ProcTexClamp::Pulse:
-        if (coord <= 0.5f)
-            coord = 0.0f;
-        else
-            coord = 1.0f;
+        for (auto& c : coord) {
+            c = c <= 0.5f ? 0.0f : 1.0f;
+        }
         break;
     default:
         LOG_CRITICAL(HW_GPU, "Unknown clamp mode {}", mode);
-        coord = std::min(coord, 1.0f);
+        for (auto& c : coord) {
+            c = std::min(c, 1.0f);
+        }
         break;
     }
 }
 
-float CombineAndMap(float u, float v, ProcTexCombiner combiner,
-                    const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& map_table) {
-    float f;
+Lanes CombineAndMap(const Lanes& u, const Lanes& v, ProcTexCombiner combiner,
+                    const std::array<ProcTexCache::ValueEntry, 128>& map_table) {
+    Lanes f{};
     switch (combiner) {
     case ProcTexCombiner::U:
         f = u;
         break;
     case ProcTexCombiner::U2:
-        f = u * u;
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = u[i] * u[i];
+        }
         break;
     case ProcTexCombiner::V:
         f = v;
         break;
     case ProcTexCombiner::V2:
-        f = v * v;
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = v[i] * v[i];
+        }
         break;
     case ProcTexCombiner::Add:
-        f = (u + v) * 0.5f;
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = (u[i] + v[i]) * 0.5f;
+        }
         break;
     case ProcTexCombiner::Add2:
-        f = (u * u + v * v) * 0.5f;
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = (u[i] * u[i] + v[i] * v[i]) * 0.5f;
+        }
         break;
     case ProcTexCombiner::SqrtAdd2:
-        f = std::min(std::sqrt(u * u + v * v), 1.0f);
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = std::min(std::sqrt(u[i] * u[i] + v[i] * v[i]), 1.0f);
+        }
         break;
     case ProcTexCombiner::Min:
-        f = std::min(u, v);
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = std::min(u[i], v[i]);
+        }
         break;
     case ProcTexCombiner::Max:
-        f = std::max(u, v);
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = std::max(u[i], v[i]);
+        }
         break;
     case ProcTexCombiner::RMax:
-        f = std::min(((u + v) * 0.5f + std::sqrt(u * u + v * v)) * 0.5f, 1.0f);
+        for (std::size_t i = 0; i < N; i++) {
+            f[i] = std::min(((u[i] + v[i]) * 0.5f + std::sqrt(u[i] * u[i] + v[i] * v[i])) * 0.5f,
+                            1.0f);
+        }
         break;
     default:
         LOG_CRITICAL(HW_GPU, "Unknown combiner {}", combiner);
-        f = 0.0f;
         break;
     }
-    return LookupLUT(map_table, f);
+
+    Lanes result;
+    for (std::size_t i = 0; i < N; i++) {
+        result[i] = LookupLUT(map_table, f[i]);
+    }
+    return result;
 }
-} // Anonymous namespace
 
-Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
-                         const Pica::PicaCore::ProcTex& state) {
-    u = std::abs(u);
-    v = std::abs(v);
+void ProcTexLanes(Lanes u, Lanes v, std::span<Common::Vec4<u8>> colors,
+                  const Pica::TexturingRegs& regs, const ProcTexCache& cache) {
+    for (std::size_t i = 0; i < N; i++) {
+        u[i] = std::abs(u[i]);
+        v[i] = std::abs(v[i]);
+    }
 
     // Get shift offset before noise generation
-    const float u_shift = GetShiftOffset(v, regs.proctex.u_shift, regs.proctex.u_clamp);
-    const float v_shift = GetShiftOffset(u, regs.proctex.v_shift, regs.proctex.v_clamp);
+    const Lanes u_shift = GetShiftOffset(v, regs.proctex.u_shift, regs.proctex.u_clamp);
+    const Lanes v_shift = GetShiftOffset(u, regs.proctex.v_shift, regs.proctex.v_clamp);
 
     // Generate noise
     if (regs.proctex.noise_enable) {
-        float noise = NoiseCoef(u, v, regs, state);
-        u += noise * regs.proctex_noise_u.amplitude / 4095.0f;
-        v += noise * regs.proctex_noise_v.amplitude / 4095.0f;
-        u = std::abs(u);
-        v = std::abs(v);
+        for (std::size_t i = 0; i < N; i++) {
+            const float noise = NoiseCoef(u[i], v[i], cache);
+            u[i] = std::abs(u[i] + noise * cache.noise_amplitude.x / 4095.0f);
+            v[i] = std::abs(v[i] + noise * cache.noise_amplitude.y / 4095.0f);
+        }
     }
 
     // Shift
-    u += u_shift;
-    v += v_shift;
+    for (std::size_t i = 0; i < N; i++) {
+        u[i] += u_shift[i];
+        v[i] += v_shift[i];
+    }
 
     // Clamp
     ClampCoord(u, regs.proctex.u_clamp);
     ClampCoord(v, regs.proctex.v_clamp);
 
     // Combine and map
-    const float lut_coord = CombineAndMap(u, v, regs.proctex.color_combiner, state.color_map_table);
+    const Lanes lut_coord =
+        CombineAndMap(u, v, regs.proctex.color_combiner, cache.color_map_table);
 
     // Look up the color
     // For the color lut, coord=0.0 is lut[offset] and coord=1.0 is lut[offset+width-1]
     const u32 offset = regs.proctex_lut_offset.level0;
     const u32 width = regs.proctex_lut.width;
-    const float index = offset + (lut_coord * (width - 1));
-    Common::Vec4<u8> final_color;
     // TODO(wwylele): implement mipmap
     switch (regs.proctex_lut.filter) {
     case ProcTexFilter::Linear:
     case ProcTexFilter::LinearMipmapLinear:
-    case ProcTexFilter::LinearMipmapNearest: {
-        const int index_int = static_cast<int>(index);
-        const float frac = index - index_int;
-        const auto color_value = state.color_table[index_int].ToVector().Cast<float>();
-        const auto color_diff = state.color_diff_table[index_int].ToVector().Cast<float>();
-        final_color = (color_value + frac * color_diff).Cast<u8>();
+    case ProcTexFilter::LinearMipmapNearest:
+        for (std::size_t i = 0; i < colors.size(); i++) {
+            const float index = offset + (lut_coord[i] * (width - 1));
+            const int index_int = static_cast<int>(index);
+            const float frac = index - index_int;
+            colors[i] =
+                (cache.color_table[index_int] + frac * cache.color_diff_table[index_int])
+                    .Cast<u8>();
+        }
         break;
-    }
     case ProcTexFilter::Nearest:
     case ProcTexFilter::NearestMipmapLinear:
     case ProcTexFilter::NearestMipmapNearest:
-        final_color = state.color_table[static_cast<int>(std::round(index))].ToVector();
+        for (std::size_t i = 0; i < colors.size(); i++) {
+            const float index = offset + (lut_coord[i] * (width - 1));
+            colors[i] = cache.color_table[static_cast<int>(std::round(index))].Cast<u8>();
+        }
         break;
     }
 
     if (regs.proctex.separate_alpha) {
         // Note: in separate alpha mode, the alpha channel skips the color LUT look up stage. It
         // uses the output of CombineAndMap directly instead.
-        const float final_alpha =
-            CombineAndMap(u, v, regs.proctex.alpha_combiner, state.alpha_map_table);
-        return Common::MakeVec<u8>(final_color.rgb(), static_cast<u8>(final_alpha * 255));
-    } else {
-        return final_color;
+        const Lanes final_alpha =
+            CombineAndMap(u, v, regs.proctex.alpha_combiner, cache.alpha_map_table);
+        for (std::size_t i = 0; i < colors.size(); i++) {
+            colors[i].a() = static_cast<u8>(final_alpha[i] * 255);
+        }
+    }
+}
+
+void ConvertValueTable(std::array<ProcTexCache::ValueEntry, 128>& out,
+                       const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& table) {
+    for (std::size_t i = 0; i < table.size(); i++) {
+        out[i] = {table[i].ToFloat(), table[i].DiffToFloat()};
+    }
+}
+} // Anonymous namespace
+
+void ProcTexCache::Update(const Pica::TexturingRegs& regs, Pica::PicaCore::ProcTex& state) {
+    // Only one renderer is active at a time, so the dirty bits are ours to consume.
+    if (!tables_valid) {
+        state.table_dirty = Pica::PicaCore::ProcTex::TableAllDirty;
+    }
+    if (state.noise_lut_dirty) {
+        ConvertValueTable(noise_table, state.noise_table);
+    }
+    if (state.color_map_dirty) {
+        ConvertValueTable(color_map_table, state.color_map_table);
+    }
+    if (state.alpha_map_dirty) {
+        ConvertValueTable(alpha_map_table, state.alpha_map_table);
+    }
+    if (state.lut_dirty) {
+        for (std::size_t i = 0; i < color_table.size(); i++) {
+            color_table[i] = state.color_table[i].ToVector().Cast<float>();
+        }
+    }
+    if (state.diff_lut_dirty) {
+        for (std::size_t i = 0; i < color_diff_table.size(); i++) {
+            color_diff_table[i] = state.color_diff_table[i].ToVector().Cast<float>();
+        }
+    }
+    state.table_dirty = 0;
+    tables_valid = true;
+
+    noise_frequency = {f16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32(),
+                       f16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32()};
+    noise_phase = {f16::FromRaw(regs.proctex_noise_u.phase).ToFloat32(),
+                   f16::FromRaw(regs.proctex_noise_v.phase).ToFloat32()};
+    noise_amplitude = {static_cast<float>(regs.proctex_noise_u.amplitude),
+                       static_cast<float>(regs.proctex_noise_v.amplitude)};
+}
+
+void ProcTex(std::span<const Common::Vec2f> uv, std::span<Common::Vec4<u8>> colors,
+             const Pica::TexturingRegs& regs, const ProcTexCache& cache) {
+    ASSERT(uv.size() == colors.size());
+    for (std::size_t first = 0; first < uv.size(); first += N) {
+        const std::size_t count = std::min(N, uv.size() - first);
+        // Unused lanes repeat the first coordinate, so they hold values that are safe to compute
+        // with.
+        Lanes u;
+        Lanes v;
+        for (std::size_t i = 0; i < N; i++) {
+            const auto& coord = uv[first + (i < count ? i : 0)];
+            u[i] = coord.x;
+            v[i] = coord.y;
+        }
+        ProcTexLanes(u, v, colors.subspan(first, count), regs, cache);
     }
 }
 
@@ -4,14 +4,40 @@
 
 #pragma once
 
+#include <array>
+#include <span>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica/pica_core.h"
 
 namespace SwRenderer {
 
-/// Generates procedural texture color for the given coordinates
-Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
-                         const Pica::PicaCore::ProcTex& state);
+/**
+ * Procedural texture state converted to floating point for the software renderer. The tables are
+ * only converted again when they are written, the noise parameters are refreshed on every draw.
+ */
+struct ProcTexCache {
+    struct ValueEntry {
+        f32 value;
+        f32 difference;
+    };
+
+    std::array<ValueEntry, 128> noise_table{};
+    std::array<ValueEntry, 128> color_map_table{};
+    std::array<ValueEntry, 128> alpha_map_table{};
+    std::array<Common::Vec4f, 256> color_table{};
+    std::array<Common::Vec4f, 256> color_diff_table{};
+    Common::Vec2f noise_frequency{};
+    Common::Vec2f noise_phase{};
+    Common::Vec2f noise_amplitude{};
+    bool tables_valid = false;
+
+    /// Converts the tables written since the last update and the noise parameters.
+    void Update(const Pica::TexturingRegs& regs, Pica::PicaCore::ProcTex& state);
+};
+
+/// Generates procedural texture colors for a batch of coordinates
+void ProcTex(std::span<const Common::Vec2f> uv, std::span<Common::Vec4<u8>> colors,
+             const Pica::TexturingRegs& regs, const ProcTexCache& cache);
 
 } // namespace SwRenderer
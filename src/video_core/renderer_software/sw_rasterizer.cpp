@@ -2,6 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <span>
 #include <boost/container/static_vector.hpp>
 #include "common/logging/log.h"
 #include "common/microprofile.h"
@@ -98,6 +102,89 @@ private:
     Common::Vec4<f24> bias;
 };
 
+/// Number of triangles classified together, sized so the loops below vectorize well.
+constexpr std::size_t TRIANGLE_GROUP_SIZE = 8;
+
+/// Maximum number of triangles queued before they are flushed.
+constexpr std::size_t MAX_QUEUED_TRIANGLES = 1024;
+
+enum class TriangleClass : u8 {
+    Accept, ///< Entirely inside the view volume
+    Reject, ///< Entirely outside one of the clipping edges
+    Clip,   ///< Must go through the clipper
+};
+
+/**
+ * Classifies a group of triangles against the clipping edges used by the clipper. Positions are
+ * processed in structure of arrays form, evaluating the edge equations with the same operations
+ * as ClippingEdge::IsInside. Vertices with non-finite components are left to the clipper, as the
+ * PICA multiplication rules for infinities would make the plain float results differ.
+ */
+void ClassifyTriangles(std::span<const Pica::OutputVertex> vertices,
+                       const RasterizerRegs& rasterizer_regs, std::span<TriangleClass> classes) {
+    static constexpr std::size_t MAX_VERTICES = TRIANGLE_GROUP_SIZE * 3;
+    static constexpr f32 MIN_DISTANCE = -EPSILON_Z;
+    static constexpr f32 EPSILON_W = f24::FromFloat32(0.00001f).ToFloat32();
+    static constexpr u32 NON_FINITE = 1u << 31;
+
+    std::array<f32, MAX_VERTICES> x{};
+    std::array<f32, MAX_VERTICES> y{};
+    std::array<f32, MAX_VERTICES> z{};
+    std::array<f32, MAX_VERTICES> w{};
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        x[i] = vertices[i].pos.x.ToFloat32();
+        y[i] = vertices[i].pos.y.ToFloat32();
+        z[i] = vertices[i].pos.z.ToFloat32();
+        w[i] = vertices[i].pos.w.ToFloat32();
+    }
+
+    // Bit n of the outcode is set when the vertex lies outside of clipping edge n.
+    std::array<u32, MAX_VERTICES> outcodes{};
+    for (std::size_t i = 0; i < MAX_VERTICES; i++) {
+        const f32 max_abs = std::max({std::abs(x[i]), std::abs(y[i]), std::abs(z[i]),
+                                      std::abs(w[i])});
+        u32 code = max_abs <= std::numeric_limits<f32>::max() ? 0 : NON_FINITE;
+        code |= !(w[i] - x[i] >= MIN_DISTANCE) ? 1u << 0 : 0;
+        code |= !(x[i] + w[i] >= MIN_DISTANCE) ? 1u << 1 : 0;
+        code |= !(w[i] - y[i] >= MIN_DISTANCE) ? 1u << 2 : 0;
+        code |= !(y[i] + w[i] >= MIN_DISTANCE) ? 1u << 3 : 0;
+        code |= !(-z[i] >= MIN_DISTANCE) ? 1u << 4 : 0;
+        code |= !(z[i] + w[i] >= MIN_DISTANCE) ? 1u << 5 : 0;
+        code |= !(w[i] + EPSILON_W >= MIN_DISTANCE) ? 1u << 6 : 0;
+        outcodes[i] = code;
+    }
+
+    if (rasterizer_regs.clip_enable) {
+        const auto coef = rasterizer_regs.GetClipCoef();
+        const f32 cx = coef.x.ToFloat32();
+        const f32 cy = coef.y.ToFloat32();
+        const f32 cz = coef.z.ToFloat32();
+        const f32 cw = coef.w.ToFloat32();
+        const f32 max_abs = std::max({std::abs(cx), std::abs(cy), std::abs(cz), std::abs(cw)});
+        const u32 coef_code = max_abs <= std::numeric_limits<f32>::max() ? 0 : NON_FINITE;
+        for (std::size_t i = 0; i < MAX_VERTICES; i++) {
+            const f32 distance = x[i] * cx + y[i] * cy + z[i] * cz + w[i] * cw;
+            outcodes[i] |= coef_code | (!(distance >= MIN_DISTANCE) ? 1u << 7 : 0);
+        }
+    }
+
+    for (std::size_t i = 0; i < vertices.size() / 3; i++) {
+        const u32 code0 = outcodes[i * 3];
+        const u32 code1 = outcodes[i * 3 + 1];
+        const u32 code2 = outcodes[i * 3 + 2];
+        const u32 any_outside = code0 | code1 | code2;
+        if (any_outside & NON_FINITE) {
+            classes[i] = TriangleClass::Clip;
+        } else if ((code0 & code1 & code2) != 0) {
+            classes[i] = TriangleClass::Reject;
+        } else if (any_outside == 0) {
+            classes[i] = TriangleClass::Accept;
+        } else {
+            classes[i] = TriangleClass::Clip;
+        }
+    }
+}
+
 } // Anonymous namespace
 
 RasterizerSoftware::RasterizerSoftware(Memory::MemorySystem& memory_, Pica::PicaCore& pica_)
@@ -107,6 +194,103 @@ RasterizerSoftware::RasterizerSoftware(Memory::MemorySystem& memory_, Pica::Pica
 
 void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                                      const Pica::OutputVertex& v2) {
+    pending_vertices.push_back(v0);
+    pending_vertices.push_back(v1);
+    pending_vertices.push_back(v2);
+    if (pending_vertices.size() >= MAX_QUEUED_TRIANGLES * 3) {
+        FlushTriangles();
+    }
+}
+
+void RasterizerSoftware::DrawTriangles() {
+    FlushTriangles();
+}
+
+void RasterizerSoftware::FlushTriangles() {
+    if (pending_vertices.empty()) {
+        return;
+    }
+
+    if (regs.texturing.main_config.texture3_enable) {
+        proctex_cache.Update(regs.texturing, pica.proctex);
+    }
+    if (!regs.lighting.disable) {
+        lighting_cache.Update(regs.lighting, pica.lighting);
+    }
+
+    const Viewport viewport = GetViewport();
+    const std::size_t num_triangles = pending_vertices.size() / 3;
+    std::array<TriangleClass, TRIANGLE_GROUP_SIZE> classes;
+    for (std::size_t first = 0; first < num_triangles; first += TRIANGLE_GROUP_SIZE) {
+        const std::size_t count = std::min(TRIANGLE_GROUP_SIZE, num_triangles - first);
+        const auto group = std::span{pending_vertices}.subspan(first * 3, count * 3);
+        ClassifyTriangles(group, regs.rasterizer, classes);
+
+        for (std::size_t i = 0; i < count; i++) {
+            const Pica::OutputVertex* triangle = &group[i * 3];
+            switch (classes[i]) {
+            case TriangleClass::Accept:
+                DrawUnclippedTriangle(triangle[0], triangle[1], triangle[2], viewport);
+                break;
+            case TriangleClass::Reject:
+                break;
+            case TriangleClass::Clip:
+                ClipTriangle(triangle[0], triangle[1], triangle[2], viewport);
+                break;
+            }
+        }
+    }
+
+    pending_vertices.clear();
+}
+
+void RasterizerSoftware::DrawUnclippedTriangle(const Pica::OutputVertex& v0,
+                                               const Pica::OutputVertex& v1,
+                                               const Pica::OutputVertex& v2,
+                                               const Viewport& viewport) {
+    // Culled triangles are dropped before paying for the perspective divide of every attribute.
+    if (IsCulled(v0, v1, v2, viewport)) {
+        return;
+    }
+
+    Vertex vtx0{v0};
+    Vertex vtx1{v1};
+    Vertex vtx2{v2};
+    FlipQuaternionIfOpposite(vtx1.quat, vtx0.quat);
+    FlipQuaternionIfOpposite(vtx2.quat, vtx0.quat);
+
+    MakeScreenCoords(vtx0, viewport);
+    MakeScreenCoords(vtx1, viewport);
+    MakeScreenCoords(vtx2, viewport);
+    ProcessTriangle(vtx0, vtx1, vtx2);
+}
+
+bool RasterizerSoftware::IsCulled(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                                  const Pica::OutputVertex& v2, const Viewport& viewport) const {
+    const auto cull_mode = regs.rasterizer.cull_mode.Value();
+    if (cull_mode == RasterizerRegs::CullMode::KeepAll) {
+        return false;
+    }
+
+    // Matches the screen position computed by MakeScreenCoords and the winding test of
+    // ProcessTriangle.
+    const auto screen_xy = [&viewport](const Pica::OutputVertex& vtx) {
+        const f24 inv_w = f24::One() / vtx.pos.w;
+        const f24 x = (vtx.pos.x * inv_w + f24::One()) * viewport.halfsize_x + viewport.offset_x;
+        const f24 y = (vtx.pos.y * inv_w + f24::One()) * viewport.halfsize_y + viewport.offset_y;
+        return Common::Vec2<Fix12P4>{Fix12P4::FromFloat24(x), Fix12P4::FromFloat24(y)};
+    };
+    const auto pos0 = screen_xy(v0);
+    const auto pos1 = screen_xy(v1);
+    const auto pos2 = screen_xy(v2);
+    if (cull_mode == RasterizerRegs::CullMode::KeepClockWise) {
+        return SignedArea(pos0, pos2, pos1) <= 0;
+    }
+    return SignedArea(pos0, pos1, pos2) <= 0;
+}
+
+void RasterizerSoftware::ClipTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                                      const Pica::OutputVertex& v2, const Viewport& viewport) {
     /**
      * Clipping a planar n-gon against a plane will remove at least 1 vertex and introduces 2 at
      * the new edge (or less in degenerate cases). As such, we can say that each clipping plane
@@ -176,15 +360,15 @@ void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::O
         }
     }
 
-    MakeScreenCoords((*output_list)[0]);
-    MakeScreenCoords((*output_list)[1]);
+    MakeScreenCoords((*output_list)[0], viewport);
+    MakeScreenCoords((*output_list)[1], viewport);
 
     for (std::size_t i = 0; i < output_list->size() - 2; i++) {
         Vertex& vtx0 = (*output_list)[0];
         Vertex& vtx1 = (*output_list)[i + 1];
         Vertex& vtx2 = (*output_list)[i + 2];
 
-        MakeScreenCoords(vtx2);
+        MakeScreenCoords(vtx2, viewport);
 
         LOG_TRACE(
             Render_Software,
@@ -205,13 +389,16 @@ void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::O
     }
 }
 
-void RasterizerSoftware::MakeScreenCoords(Vertex& vtx) {
+Viewport RasterizerSoftware::GetViewport() const {
     Viewport viewport{};
     viewport.halfsize_x = f24::FromRaw(regs.rasterizer.viewport_size_x);
     viewport.halfsize_y = f24::FromRaw(regs.rasterizer.viewport_size_y);
     viewport.offset_x = f24::FromFloat32(static_cast<f32>(regs.rasterizer.viewport_corner.x));
     viewport.offset_y = f24::FromFloat32(static_cast<f32>(regs.rasterizer.viewport_corner.y));
+    return viewport;
+}
 
+void RasterizerSoftware::MakeScreenCoords(Vertex& vtx, const Viewport& viewport) {
     f24 inv_w = f24::One() / vtx.pos.w;
     vtx.pos.w = inv_w;
     vtx.quat *= inv_w;
@@ -300,10 +487,81 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
 
     fb.Bind();
 
+    const auto write_fragment = [&](u16 x, u16 y, float depth, Common::Vec4<u8> primary_color,
+                                    std::span<const Common::Vec4<u8>, 4> texture_color,
+                                    Common::Vec4<u8> primary_fragment_color,
+                                    Common::Vec4<u8> secondary_fragment_color) {
+        // Write the TEV stages.
+        auto combiner_output = WriteTevConfig(texture_color, tev_stages, primary_color,
+                                              primary_fragment_color, secondary_fragment_color);
+
+        const auto& output_merger = regs.framebuffer.output_merger;
+        if (output_merger.fragment_operation_mode ==
+            FramebufferRegs::FragmentOperationMode::Shadow) {
+            const u32 depth_int = static_cast<u32>(depth * 0xFFFFFF);
+            // Use green color as the shadow intensity
+            const u8 stencil = combiner_output.y;
+            fb.DrawShadowMapPixel(x >> 4, y >> 4, depth_int, stencil);
+            // Skip the normal output merger pipeline if it is in shadow mode
+            return;
+        }
+
+        // Does alpha testing happen before or after stencil?
+        if (!DoAlphaTest(combiner_output.a())) {
+            return;
+        }
+        WriteFog(depth, combiner_output);
+        if (!DoDepthStencilTest(x, y, depth)) {
+            return;
+        }
+        const auto result = PixelColor(x, y, combiner_output);
+        if (regs.framebuffer.framebuffer.allow_color_write != 0) {
+            fb.DrawPixel(x >> 4, y >> 4, result);
+        }
+    };
+
     // Enter rasterization loop, starting at the center of the topleft bounding box corner.
     // TODO: Not sure if looping through x first might be faster
     for (u16 y = min_y + 8; y < max_y; y += 0x10) {
         const auto process_scanline = [&, y] {
+            // Covered fragments are gathered so that their procedural texture and lighting are
+            // computed together. They are written in order once the batch is full or the
+            // scanline ends.
+            struct PendingFragment {
+                u16 x;
+                float depth;
+                Common::Vec4<u8> primary_color;
+            };
+            std::array<PendingFragment, LIGHTING_BATCH_SIZE> pending;
+            std::array<LightingFragment, LIGHTING_BATCH_SIZE> fragments;
+            std::array<Common::Vec2f, LIGHTING_BATCH_SIZE> proctex_uv;
+            std::size_t num_pending = 0;
+
+            const auto flush_pending = [&] {
+                if (regs.texturing.main_config.texture3_enable) {
+                    std::array<Common::Vec4<u8>, LIGHTING_BATCH_SIZE> proctex_color;
+                    ProcTex(std::span{proctex_uv}.first(num_pending),
+                            std::span{proctex_color}.first(num_pending), regs.texturing,
+                            proctex_cache);
+                    for (std::size_t i = 0; i < num_pending; i++) {
+                        fragments[i].texture_color[3] = proctex_color[i];
+                    }
+                }
+
+                std::array<std::pair<Common::Vec4<u8>, Common::Vec4<u8>>, LIGHTING_BATCH_SIZE>
+                    colors{};
+                if (!regs.lighting.disable) {
+                    ComputeFragmentsColors(regs.lighting, lighting_cache,
+                                           std::span{fragments}.first(num_pending), colors);
+                }
+
+                for (std::size_t i = 0; i < num_pending; i++) {
+                    write_fragment(pending[i].x, y, pending[i].depth, pending[i].primary_color,
+                                   fragments[i].texture_color, colors[i].first, colors[i].second);
+                }
+                num_pending = 0;
+            };
+
             for (u16 x = min_x + 8; x < max_x; x += 0x10) {
                 // Do not process the pixel if it's inside the scissor box and the scissor mode is
                 // set to Exclude.
@@ -408,13 +666,16 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
 
                 // Sample bound texture units.
                 const f24 tc0_w = get_interpolated_attribute(v0.tc0_w, v1.tc0_w, v2.tc0_w);
-                const auto texture_color = TextureColor(uv, textures, tc0_w);
+                auto& fragment = fragments[num_pending];
+                fragment.texture_color = TextureColor(uv, textures, tc0_w);
 
-                Common::Vec4<u8> primary_fragment_color = {0, 0, 0, 0};
-                Common::Vec4<u8> secondary_fragment_color = {0, 0, 0, 0};
+                if (regs.texturing.main_config.texture3_enable) {
+                    const auto& coord = uv[regs.texturing.main_config.texture3_coordinates];
+                    proctex_uv[num_pending] = {coord.u().ToFloat32(), coord.v().ToFloat32()};
+                }
 
                 if (!regs.lighting.disable) {
-                    const auto normquat =
+                    fragment.normquat =
                         Common::Quaternion<f32>{
                             {get_interpolated_attribute(v0.quat.x, v1.quat.x, v2.quat.x)
                                  .ToFloat32(),
@@ -426,45 +687,21 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
                         }
                             .Normalized();
 
-                    const Common::Vec3f view{
+                    fragment.view = {
                         get_interpolated_attribute(v0.view.x, v1.view.x, v2.view.x).ToFloat32(),
                         get_interpolated_attribute(v0.view.y, v1.view.y, v2.view.y).ToFloat32(),
                         get_interpolated_attribute(v0.view.z, v1.view.z, v2.view.z).ToFloat32(),
                     };
-                    std::tie(primary_fragment_color, secondary_fragment_color) =
-                        ComputeFragmentsColors(regs.lighting, pica.lighting, normquat, view,
-                                               texture_color);
                 }
 
-                // Write the TEV stages.
-                auto combiner_output =
-                    WriteTevConfig(texture_color, tev_stages, primary_color, primary_fragment_color,
-                                   secondary_fragment_color);
-
-                const auto& output_merger = regs.framebuffer.output_merger;
-                if (output_merger.fragment_operation_mode ==
-                    FramebufferRegs::FragmentOperationMode::Shadow) {
-                    const u32 depth_int = static_cast<u32>(depth * 0xFFFFFF);
-                    // Use green color as the shadow intensity
-                    const u8 stencil = combiner_output.y;
-                    fb.DrawShadowMapPixel(x >> 4, y >> 4, depth_int, stencil);
-                    // Skip the normal output merger pipeline if it is in shadow mode
-                    continue;
-                }
-
-                // Does alpha testing happen before or after stencil?
-                if (!DoAlphaTest(combiner_output.a())) {
-                    continue;
-                }
-                WriteFog(depth, combiner_output);
-                if (!DoDepthStencilTest(x, y, depth)) {
-                    continue;
-                }
-                const auto result = PixelColor(x, y, combiner_output);
-                if (regs.framebuffer.framebuffer.allow_color_write != 0) {
-                    fb.DrawPixel(x >> 4, y >> 4, result);
+                pending[num_pending] = {x, depth, primary_color};
+                if (++num_pending == LIGHTING_BATCH_SIZE) {
+                    flush_pending();
                 }
             }
+            if (num_pending != 0) {
+                flush_pending();
+            }
         };
         sw_workers.QueueWork(std::move(process_scanline));
     }
@@ -581,13 +818,6 @@ std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
         }
     }
 
-    // Sample procedural texture
-    if (regs.texturing.main_config.texture3_enable) {
-        const auto& proctex_uv = uv[regs.texturing.main_config.texture3_coordinates];
-        texture_color[3] = ProcTex(proctex_uv.u().ToFloat32(), proctex_uv.v().ToFloat32(),
-                                   regs.texturing, pica.proctex);
-    }
-
     return texture_color;
 }
 
@@ -5,11 +5,15 @@
 #pragma once
 
 #include <span>
+#include <vector>
 #include "common/thread_worker.h"
+#include "video_core/pica/output_vertex.h"
 #include "video_core/pica/regs_texturing.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_software/sw_clipper.h"
 #include "video_core/renderer_software/sw_framebuffer.h"
+#include "video_core/renderer_software/sw_lighting.h"
+#include "video_core/renderer_software/sw_proctex.h"
 
 namespace Pica {
 struct RegsInternal;
@@ -26,7 +30,7 @@ public:
 
     void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                      const Pica::OutputVertex& v2) override;
-    void DrawTriangles() override {}
+    void DrawTriangles() override;
     void FlushAll() override {}
     void FlushRegion(PAddr addr, u32 size) override {}
     void InvalidateRegion(PAddr addr, u32 size) override {}
@@ -34,14 +38,33 @@ public:
     void ClearAll(bool flush) override {}
 
 private:
+    /// Clips, culls and rasterizes the queued triangles.
+    void FlushTriangles();
+
+    /// Clips the triangle against the view volume and rasterizes the resulting polygon.
+    void ClipTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                      const Pica::OutputVertex& v2, const Viewport& viewport);
+
+    /// Rasterizes a triangle that lies entirely inside the view volume.
+    void DrawUnclippedTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                               const Pica::OutputVertex& v2, const Viewport& viewport);
+
+    /// Returns true if the unclipped triangle would be discarded by face culling.
+    bool IsCulled(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                  const Pica::OutputVertex& v2, const Viewport& viewport) const;
+
+    /// Returns the viewport transform configured in the rasterizer registers.
+    Viewport GetViewport() const;
+
     /// Computes the screen coordinates of the provided vertex.
-    void MakeScreenCoords(Vertex& vtx);
+    void MakeScreenCoords(Vertex& vtx, const Viewport& viewport);
 
     /// Processes the triangle defined by the provided vertices.
     void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2,
                          bool reversed = false);
 
-    /// Returns the texture color of the currently processed pixel.
+    /// Returns the texture color of the currently processed pixel. The procedural texture is
+    /// sampled separately for a batch of pixels.
     std::array<Common::Vec4<u8>, 4> TextureColor(
         std::span<const Common::Vec2<f24>, 3> uv,
         std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w) const;
@@ -72,6 +95,9 @@ private:
     std::size_t num_sw_threads;
     Common::ThreadWorker sw_workers;
     Framebuffer fb;
+    LightingCache lighting_cache;
+    ProcTexCache proctex_cache;
+    std::vector<Pica::OutputVertex> pending_vertices;
 };
 
 } // namespace SwRenderer
@@ -0,0 +1,222 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/dumping/backend.h"
+#include "video_core/renderer_vulkan/frame_dumper_vulkan.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+#include <vk_mem_alloc.h>
+
+namespace Vulkan {
+
+FrameDumperVulkan::FrameDumperVulkan(Core::System& system_, const Instance& instance_,
+                                     Scheduler& scheduler_, PresentWindow& present_window_)
+    : system{system_}, instance{instance_}, scheduler{scheduler_},
+      present_window{present_window_} {}
+
+FrameDumperVulkan::~FrameDumperVulkan() {
+    ReleaseResources();
+}
+
+bool FrameDumperVulkan::IsDumping() const {
+    auto video_dumper = system.GetVideoDumper();
+    return active && video_dumper && video_dumper->IsDumping();
+}
+
+Layout::FramebufferLayout FrameDumperVulkan::GetLayout() const {
+    auto video_dumper = system.GetVideoDumper();
+    return video_dumper ? video_dumper->GetLayout() : Layout::FramebufferLayout{};
+}
+
+void FrameDumperVulkan::StartDumping() {
+    active = true;
+}
+
+void FrameDumperVulkan::StopDumping() {
+    // The dumper may not receive frames after this returns, so hand it the readbacks still in
+    // flight, oldest first. They were all submitted by Readback, so they can be waited on from
+    // this thread.
+    std::scoped_lock lock{slot_mutex};
+    for (std::size_t i = 0; i < NUM_SLOTS; i++) {
+        SendToDumper(slots[(current_slot + i) % NUM_SLOTS]);
+    }
+    active = false;
+}
+
+Frame* FrameDumperVulkan::GetRenderFrame() {
+    std::scoped_lock lock{slot_mutex};
+    const auto layout = GetLayout();
+    if (layout.width != width || layout.height != height) {
+        scheduler.Finish();
+        DestroySlots();
+        CreateSlots(layout.width, layout.height);
+    }
+
+    Slot& slot = slots[current_slot];
+    SendToDumper(slot);
+    return &slot.frame;
+}
+
+void FrameDumperVulkan::Readback(Frame* frame) {
+    std::scoped_lock lock{slot_mutex};
+    Slot& slot = slots[current_slot];
+    ASSERT(frame == &slot.frame);
+
+    scheduler.Record([width = width, height = height, source_image = frame->image,
+                      buffer = slot.buffer](vk::CommandBuffer cmdbuf) {
+        const vk::ImageMemoryBarrier read_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = source_image,
+            .subresourceRange{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel = 0,
+                .levelCount = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            },
+        };
+        const vk::BufferMemoryBarrier host_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eHostRead,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        };
+        const vk::BufferImageCopy image_copy = {
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource =
+                {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {width, height, 1},
+        };
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
+        cmdbuf.copyImageToBuffer(source_image, vk::ImageLayout::eTransferSrcOptimal, buffer,
+                                 image_copy);
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                               vk::PipelineStageFlagBits::eHost, vk::DependencyFlagBits::eByRegion,
+                               {}, host_barrier, {});
+    });
+
+    slot.tick = scheduler.CurrentTick();
+    slot.pending = true;
+    current_slot = (current_slot + 1) % NUM_SLOTS;
+
+    // Submit the copy right away so that StopDumping can wait for it from another thread.
+    scheduler.Flush();
+}
+
+void FrameDumperVulkan::ReleaseResources() {
+    std::scoped_lock lock{slot_mutex};
+    if (width == 0 && height == 0) {
+        return;
+    }
+    scheduler.Finish();
+    DestroySlots();
+}
+
+void FrameDumperVulkan::CreateSlots(u32 width_, u32 height_) {
+    width = width_;
+    height = height_;
+    format = present_window.FrameFormat();
+
+    const vk::BufferCreateInfo buffer_info = {
+        .size = width * height * 4,
+        .usage = vk::BufferUsageFlagBits::eTransferDst,
+    };
+    const VmaAllocationCreateInfo alloc_create_info = {
+        .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+        .requiredFlags = 0,
+        .preferredFlags = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+    };
+
+    for (Slot& slot : slots) {
+        present_window.RecreateFrame(&slot.frame, width, height);
+
+        VkBuffer unsafe_buffer{};
+        VmaAllocationInfo alloc_info{};
+        VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(buffer_info);
+        const VkResult result =
+            vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info, &alloc_create_info,
+                            &unsafe_buffer, &slot.allocation, &alloc_info);
+        if (result != VK_SUCCESS) [[unlikely]] {
+            LOG_CRITICAL(Render_Vulkan, "Failed allocating frame dump buffer with error {}",
+                         result);
+            UNREACHABLE();
+        }
+        slot.buffer = vk::Buffer{unsafe_buffer};
+        slot.mapped = static_cast<u8*>(alloc_info.pMappedData);
+        slot.pending = false;
+    }
+    current_slot = 0;
+}
+
+void FrameDumperVulkan::DestroySlots() {
+    const vk::Device device = instance.GetDevice();
+    for (Slot& slot : slots) {
+        Frame& frame = slot.frame;
+        if (frame.image) {
+            device.destroyFramebuffer(frame.framebuffer);
+            device.destroyImageView(frame.image_view);
+            vmaDestroyImage(instance.GetAllocator(), frame.image, frame.allocation);
+        }
+        if (slot.buffer) {
+            vmaDestroyBuffer(instance.GetAllocator(), slot.buffer, slot.allocation);
+        }
+        slot = Slot{};
+    }
+    width = 0;
+    height = 0;
+}
+
+void FrameDumperVulkan::SendToDumper(Slot& slot) {
+    if (!slot.pending) {
+        return;
+    }
+    slot.pending = false;
+
+    auto video_dumper = system.GetVideoDumper();
+    if (!active || !video_dumper) {
+        return;
+    }
+
+    // The copy was recorded NUM_SLOTS frames ago, so this rarely has to wait.
+    scheduler.GetMasterSemaphore()->Wait(slot.tick);
+    vmaInvalidateAllocation(instance.GetAllocator(), slot.allocation, 0, VK_WHOLE_SIZE);
+
+    // The dumpers expect BGRA pixels, like the OpenGL readback produces.
+    VideoDumper::VideoFrame frame{width, height, slot.mapped};
+    if (format == vk::Format::eR8G8B8A8Unorm) {
+        for (std::size_t i = 0; i < frame.data.size(); i += 4) {
+            std::swap(frame.data[i], frame.data[i + 2]);
+        }
+    }
+    video_dumper->AddVideoFrame(std::move(frame));
+}
+
+} // namespace Vulkan
@@ -0,0 +1,84 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include "core/frontend/framebuffer_layout.h"
+#ifdef HAVE_LIBRETRO
+#include "citra_libretro/libretro_vk.h"
+#else
+#include "video_core/renderer_vulkan/vk_present_window.h"
+#endif
+
+namespace Core {
+class System;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Renders frames for the video dumper into dedicated images and reads them back through host
+ * visible buffers. Readbacks are pipelined over a few slots so the render thread never waits
+ * on the copy of the frame it just recorded, a slot is handed to the video dumper when it comes
+ * around for reuse.
+ */
+class FrameDumperVulkan {
+    static constexpr std::size_t NUM_SLOTS = 3;
+
+public:
+    explicit FrameDumperVulkan(Core::System& system, const Instance& instance,
+                               Scheduler& scheduler, PresentWindow& present_window);
+    ~FrameDumperVulkan();
+
+    bool IsDumping() const;
+    Layout::FramebufferLayout GetLayout() const;
+    void StartDumping();
+
+    /// Hands the pending readbacks to the dumper, no frames are sent after this returns.
+    void StopDumping();
+
+    /// Returns the frame to draw the dumped layout to, sending the readback it held to the dumper.
+    Frame* GetRenderFrame();
+
+    /// Records the copy of the frame returned by GetRenderFrame to its readback buffer.
+    void Readback(Frame* frame);
+
+    /// Releases the readback resources once dumping has stopped.
+    void ReleaseResources();
+
+private:
+    struct Slot {
+        Frame frame{};
+        vk::Buffer buffer{};
+        VmaAllocation allocation{};
+        u8* mapped{};
+        u64 tick{};
+        bool pending{};
+    };
+
+    void CreateSlots(u32 width, u32 height);
+    void DestroySlots();
+    void SendToDumper(Slot& slot);
+
+private:
+    Core::System& system;
+    const Instance& instance;
+    Scheduler& scheduler;
+    PresentWindow& present_window;
+    std::array<Slot, NUM_SLOTS> slots{};
+    std::size_t current_slot{};
+    u32 width{};
+    u32 height{};
+    vk::Format format{};
+    std::mutex slot_mutex;
+    std::atomic_bool active{false};
+};
+
+} // namespace Vulkan
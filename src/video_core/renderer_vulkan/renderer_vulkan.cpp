@@ -118,6 +118,7 @@ RendererVulkan::RendererVulkan(Core::System& system, Pica::PicaCore& pica_,
                                          renderpass_cache,
                                          update_queue,
                                          main_present_window.ImageCount()},
+      frame_dumper{system, instance, scheduler, main_present_window},
       present_heap{instance, scheduler.GetMasterSemaphore(), PRESENT_BINDINGS, 32} {
     CompileShaders();
     BuildLayouts();
@@ -860,6 +861,9 @@ void RendererVulkan::DrawScreens(Frame* frame, const Layout::FramebufferLayout&
         ReloadPipeline();
     }
 
+    renderpass_cache.EndRendering();
+    const GPUTimelineScope timeline_scope{renderpass_cache.Timeline(),
+                                          Core::GPUTimelineStage::Present};
     PrepareDraw(frame, layout);
 
     const auto& top_screen = layout.top_screen;
@@ -895,6 +899,7 @@ void RendererVulkan::SwapBuffers() {
     PrepareRendertarget();
     RenderScreenshot();
     RenderToWindow(main_present_window, layout, false);
+    RenderToDumper();
 #ifndef ANDROID
     if (Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
         ASSERT(secondary_window);
@@ -920,11 +925,32 @@ void RendererVulkan::SwapBuffers() {
     }
 #endif
 
+    renderpass_cache.Timeline().EndFrame(*system.perf_stats);
     system.perf_stats->EndSwap();
     rasterizer.TickFrame();
     EndFrame();
 }
 
+void RendererVulkan::RenderToDumper() {
+    if (!frame_dumper.IsDumping()) {
+        frame_dumper.ReleaseResources();
+        return;
+    }
+
+    const Layout::FramebufferLayout layout = frame_dumper.GetLayout();
+    Frame* frame = frame_dumper.GetRenderFrame();
+    DrawScreens(frame, layout, false);
+    frame_dumper.Readback(frame);
+}
+
+void RendererVulkan::PrepareVideoDumping() {
+    frame_dumper.StartDumping();
+}
+
+void RendererVulkan::CleanupVideoDumping() {
+    frame_dumper.StopDumping();
+}
+
 void RendererVulkan::RenderScreenshot() {
     if (!settings.screenshot_requested.exchange(false)) {
         return;
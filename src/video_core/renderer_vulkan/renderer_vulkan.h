@@ -13,6 +13,7 @@
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_present_window.h"
 #endif
+#include "video_core/renderer_vulkan/frame_dumper_vulkan.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_render_manager.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
@@ -82,6 +83,8 @@ public:
 
     void SwapBuffers() override;
     void TryPresent(int timeout_ms, bool is_secondary) override {}
+    void PrepareVideoDumping() override;
+    void CleanupVideoDumping() override;
 
 private:
     void ReloadPipeline();
@@ -98,6 +101,7 @@ private:
     void PrepareDraw(Frame* frame, const Layout::FramebufferLayout& layout);
     void RenderToWindow(PresentWindow& window, const Layout::FramebufferLayout& layout,
                         bool flipped);
+    void RenderToDumper();
 
     void DrawScreens(Frame* frame, const Layout::FramebufferLayout& layout, bool flipped);
     void DrawBottomScreen(const Layout::FramebufferLayout& layout,
@@ -128,6 +132,7 @@ private:
     DescriptorUpdateQueue update_queue;
     RasterizerVulkan rasterizer;
     std::unique_ptr<PresentWindow> secondary_present_window_ptr;
+    FrameDumperVulkan frame_dumper;
 
     DescriptorHeap present_heap;
     vk::UniquePipelineLayout present_pipeline_layout;
@@ -0,0 +1,116 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/settings.h"
+#include "core/perf_stats.h"
+#include "video_core/renderer_vulkan/vk_gpu_timeline.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+namespace Vulkan {
+
+using VideoCore::GPUTimelineFrame;
+
+GPUTimeline::GPUTimeline(const Instance& instance_, Scheduler& scheduler_)
+    : instance{instance_}, scheduler{scheduler_},
+      supported{instance.IsTimestampQuerySupported()} {
+    if (!supported) {
+        return;
+    }
+
+    const vk::QueryPoolCreateInfo pool_info = {
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = GPUTimelineFrame::MaxQueries,
+    };
+    for (FrameQueries& queries : frames) {
+        queries.pool = instance.GetDevice().createQueryPool(pool_info);
+    }
+}
+
+GPUTimeline::~GPUTimeline() {
+    for (FrameQueries& queries : frames) {
+        if (queries.pool) {
+            instance.GetDevice().destroyQueryPool(queries.pool);
+        }
+    }
+}
+
+void GPUTimeline::Begin(Core::GPUTimelineStage stage) {
+    if (!enabled) {
+        return;
+    }
+    FrameQueries& queries = frames[current_frame];
+    if (!queries.reset) {
+        scheduler.Record([pool = queries.pool](vk::CommandBuffer cmdbuf) {
+            cmdbuf.resetQueryPool(pool, 0, GPUTimelineFrame::MaxQueries);
+        });
+        queries.reset = true;
+    }
+    if (const auto index = queries.frame.Begin(stage)) {
+        WriteTimestamp(queries, *index, vk::PipelineStageFlagBits::eTopOfPipe);
+    }
+}
+
+void GPUTimeline::End(Core::GPUTimelineStage stage) {
+    if (!enabled) {
+        return;
+    }
+    FrameQueries& queries = frames[current_frame];
+    if (const auto index = queries.frame.End(stage)) {
+        WriteTimestamp(queries, *index, vk::PipelineStageFlagBits::eBottomOfPipe);
+    }
+}
+
+void GPUTimeline::EndFrame(Core::PerfStats& perf_stats) {
+    FrameQueries& current = frames[current_frame];
+    if (current.frame.NumQueries() > 0) {
+        current.tick = scheduler.CurrentTick();
+        current.pending = true;
+    }
+
+    // Report every frame that has completed since, most frames never have to wait here.
+    for (FrameQueries& queries : frames) {
+        if (queries.pending && scheduler.IsFree(queries.tick)) {
+            Resolve(queries, perf_stats);
+        }
+    }
+
+    current_frame = (current_frame + 1) % NUM_FRAMES;
+    FrameQueries& next = frames[current_frame];
+    if (next.pending) {
+        scheduler.Wait(next.tick);
+        Resolve(next, perf_stats);
+    }
+    next.frame.Reset(perf_stats.GetTimelineFrame() + 1);
+    next.reset = false;
+
+    // Only toggle between frames so intervals are never left half written.
+    enabled = supported && Settings::values.record_frame_times;
+}
+
+void GPUTimeline::Resolve(FrameQueries& queries, Core::PerfStats& perf_stats) {
+    queries.pending = false;
+
+    const u32 num_queries = queries.frame.NumQueries();
+    std::array<u64, GPUTimelineFrame::MaxQueries> timestamps{};
+    const vk::Result result = instance.GetDevice().getQueryPoolResults(
+        queries.pool, 0, num_queries, num_queries * sizeof(u64), timestamps.data(), sizeof(u64),
+        vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) {
+        return;
+    }
+
+    const double period_ns = static_cast<double>(instance.GetTimestampPeriod());
+    perf_stats.AddGPUTimeline(queries.frame.Frame(),
+                              queries.frame.Resolve({timestamps.data(), num_queries}, period_ns));
+}
+
+void GPUTimeline::WriteTimestamp(FrameQueries& queries, u32 index,
+                                 vk::PipelineStageFlagBits stage) {
+    scheduler.Record([pool = queries.pool, index, stage](vk::CommandBuffer cmdbuf) {
+        cmdbuf.writeTimestamp(stage, pool, index);
+    });
+}
+
+} // namespace Vulkan
@@ -0,0 +1,80 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include "video_core/gpu_timeline.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Core {
+class PerfStats;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Measures the host GPU time of each GPUTimelineStage with timestamp queries. Every frame writes
+ * to its own query pool, which is read back without waiting once the frame has completed on the
+ * GPU. Recording only happens while frame times are being recorded.
+ */
+class GPUTimeline {
+    static constexpr std::size_t NUM_FRAMES = 4;
+
+public:
+    explicit GPUTimeline(const Instance& instance, Scheduler& scheduler);
+    ~GPUTimeline();
+
+    /// Writes the start timestamp of the stage. Must be called outside of a renderpass.
+    void Begin(Core::GPUTimelineStage stage);
+
+    /// Writes the end timestamp of the stage.
+    void End(Core::GPUTimelineStage stage);
+
+    /// Closes the current frame and reports the timings of completed frames to perf_stats.
+    /// Must be called before PerfStats::EndSwap so the frame indices line up.
+    void EndFrame(Core::PerfStats& perf_stats);
+
+private:
+    struct FrameQueries {
+        vk::QueryPool pool{};
+        VideoCore::GPUTimelineFrame frame{};
+        u64 tick{};
+        bool pending{};
+        bool reset{};
+    };
+
+    void Resolve(FrameQueries& queries, Core::PerfStats& perf_stats);
+    void WriteTimestamp(FrameQueries& queries, u32 index, vk::PipelineStageFlagBits stage);
+
+private:
+    const Instance& instance;
+    Scheduler& scheduler;
+    std::array<FrameQueries, NUM_FRAMES> frames{};
+    std::size_t current_frame{};
+    bool supported{};
+    bool enabled{};
+};
+
+/// Measures the GPU time of the commands recorded during its lifetime as the provided stage.
+class GPUTimelineScope {
+public:
+    explicit GPUTimelineScope(GPUTimeline& timeline_, Core::GPUTimelineStage stage_)
+        : timeline{timeline_}, stage{stage_} {
+        timeline.Begin(stage);
+    }
+
+    ~GPUTimelineScope() {
+        timeline.End(stage);
+    }
+
+private:
+    GPUTimeline& timeline;
+    Core::GPUTimelineStage stage;
+};
+
+} // namespace Vulkan
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <span>
 #include <boost/container/static_vector.hpp>
 
 #include "common/hash.h"
@@ -50,6 +51,42 @@ u64 PipelineInfo::Hash(const Instance& instance) const {
     return info_hash;
 }
 
+u64 PipelineInfo::LibraryHash(const Instance& instance, PipelineLibraryType type) const {
+    u64 info_hash = 0;
+    const auto append_hash = [&info_hash](const auto& data) {
+        const u64 data_hash = Common::ComputeStructHash64(data);
+        info_hash = Common::HashCombine(info_hash, data_hash);
+    };
+
+    const bool is_dynamic = instance.IsExtendedDynamicStateSupported();
+    switch (type) {
+    case PipelineLibraryType::VertexInput:
+        append_hash(vertex_layout);
+        if (!is_dynamic) {
+            append_hash(rasterization);
+        }
+        break;
+    case PipelineLibraryType::PreRasterization:
+        append_hash(attachments);
+        if (!is_dynamic) {
+            append_hash(rasterization);
+        }
+        break;
+    case PipelineLibraryType::FragmentShader:
+        append_hash(attachments);
+        if (!is_dynamic) {
+            append_hash(depth_stencil);
+        }
+        break;
+    case PipelineLibraryType::FragmentOutput:
+        append_hash(attachments);
+        append_hash(blending);
+        break;
+    }
+
+    return info_hash;
+}
+
 Shader::Shader(const Instance& instance) : device{instance.GetDevice()} {}
 
 Shader::Shader(const Instance& instance, vk::ShaderStageFlagBits stage, std::string code)
@@ -64,42 +101,17 @@ Shader::~Shader() {
     }
 }
 
-GraphicsPipeline::GraphicsPipeline(const Instance& instance_, RenderManager& renderpass_cache_,
-                                   const PipelineInfo& info_, vk::PipelineCache pipeline_cache_,
-                                   vk::PipelineLayout layout_, std::array<Shader*, 3> stages_,
-                                   Common::ThreadWorker* worker_)
-    : instance{instance_}, renderpass_cache{renderpass_cache_}, worker{worker_},
-      pipeline_layout{layout_}, pipeline_cache{pipeline_cache_}, info{info_}, stages{stages_} {}
-
-GraphicsPipeline::~GraphicsPipeline() = default;
-
-bool GraphicsPipeline::TryBuild(bool wait_built) {
-    // The pipeline is currently being compiled. We can either wait for it
-    // or skip the draw.
-    if (is_pending) {
-        return wait_built;
-    }
-
-    // If the shaders haven't been compiled yet, we cannot proceed.
-    const bool shaders_pending = std::any_of(
-        stages.begin(), stages.end(), [](Shader* shader) { return shader && !shader->IsDone(); });
-    if (!wait_built && shaders_pending) {
-        return false;
-    }
-
-    // Ask the driver if it can give us the pipeline quickly.
-    if (!shaders_pending && instance.IsPipelineCreationCacheControlSupported() && Build(true)) {
-        return true;
-    }
-
-    // Fallback to (a)synchronous compilation
-    worker->QueueWork([this] { Build(); });
-    is_pending = true;
-    return wait_built;
-}
-
-bool GraphicsPipeline::Build(bool fail_on_compile_required) {
-    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+namespace {
+
+/**
+ * Creates a graphics pipeline. When library_flags is set, only the state of the selected
+ * pipeline library parts is used and the result is a library for linking.
+ */
+vk::ResultValue<vk::UniquePipeline> CreatePipeline(
+    const Instance& instance, RenderManager& renderpass_cache, const PipelineInfo& info,
+    std::span<Shader* const> stages, vk::PipelineCache pipeline_cache,
+    vk::PipelineLayout pipeline_layout, vk::GraphicsPipelineLibraryFlagsEXT library_flags,
+    vk::PipelineCreateFlags create_flags) {
     std::array<vk::VertexInputBindingDescription, MAX_VERTEX_BINDINGS> bindings;
     for (u32 i = 0; i < info.vertex_layout.binding_count; i++) {
         const auto& binding = info.vertex_layout.bindings[i];
@@ -235,6 +247,19 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .back = stencil_op_state,
     };
 
+    const bool is_library = static_cast<bool>(library_flags);
+    const auto has_part = [&](vk::GraphicsPipelineLibraryFlagBitsEXT part) {
+        return !is_library || static_cast<bool>(library_flags & part);
+    };
+    const bool has_vertex_input =
+        has_part(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface);
+    const bool has_pre_rasterization =
+        has_part(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders);
+    const bool has_fragment_shader =
+        has_part(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader);
+    const bool has_fragment_output =
+        has_part(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface);
+
     u32 shader_count = 0;
     std::array<vk::PipelineShaderStageCreateInfo, MAX_SHADER_STAGES> shader_stages;
     for (std::size_t i = 0; i < stages.size(); i++) {
@@ -242,38 +267,152 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         if (!shader) {
             continue;
         }
+        const vk::ShaderStageFlagBits stage = MakeShaderStage(i);
+        if (stage == vk::ShaderStageFlagBits::eFragment ? !has_fragment_shader
+                                                         : !has_pre_rasterization) {
+            continue;
+        }
 
         shader->WaitDone();
         shader_stages[shader_count++] = vk::PipelineShaderStageCreateInfo{
-            .stage = MakeShaderStage(i),
+            .stage = stage,
             .module = shader->Handle(),
             .pName = "main",
         };
     }
 
-    vk::GraphicsPipelineCreateInfo pipeline_info = {
+    const bool needs_renderpass =
+        has_pre_rasterization || has_fragment_shader || has_fragment_output;
+    const vk::GraphicsPipelineLibraryCreateInfoEXT library_info = {
+        .flags = library_flags,
+    };
+
+    const vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .pNext = is_library ? &library_info : nullptr,
+        .flags = is_library ? create_flags | vk::PipelineCreateFlagBits::eLibraryKHR |
+                                  vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT
+                            : create_flags,
         .stageCount = shader_count,
         .pStages = shader_stages.data(),
-        .pVertexInputState = &vertex_input_info,
-        .pInputAssemblyState = &input_assembly,
-        .pViewportState = &viewport_info,
-        .pRasterizationState = &raster_state,
-        .pMultisampleState = &multisampling,
-        .pDepthStencilState = &depth_info,
-        .pColorBlendState = &color_blending,
+        .pVertexInputState = has_vertex_input ? &vertex_input_info : nullptr,
+        .pInputAssemblyState = has_vertex_input ? &input_assembly : nullptr,
+        .pViewportState = has_pre_rasterization ? &viewport_info : nullptr,
+        .pRasterizationState = has_pre_rasterization ? &raster_state : nullptr,
+        .pMultisampleState = has_fragment_shader || has_fragment_output ? &multisampling : nullptr,
+        .pDepthStencilState = has_fragment_shader ? &depth_info : nullptr,
+        .pColorBlendState = has_fragment_output ? &color_blending : nullptr,
         .pDynamicState = &dynamic_info,
-        .layout = pipeline_layout,
-        .renderPass =
-            renderpass_cache.GetRenderpass(info.attachments.color, info.attachments.depth, false),
+        .layout = has_pre_rasterization || has_fragment_shader ? pipeline_layout
+                                                               : vk::PipelineLayout{},
+        .renderPass = needs_renderpass ? renderpass_cache.GetRenderpass(info.attachments.color,
+                                                                        info.attachments.depth,
+                                                                        false)
+                                       : vk::RenderPass{},
+    };
+
+    return instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+}
+
+} // Anonymous namespace
+
+PipelineLibrary::PipelineLibrary(const Instance& instance_, RenderManager& renderpass_cache_,
+                                 PipelineLibraryType type_, const PipelineInfo& info_,
+                                 vk::PipelineCache pipeline_cache_, vk::PipelineLayout layout_,
+                                 std::array<Shader*, 3> stages_)
+    : instance{instance_}, renderpass_cache{renderpass_cache_}, type{type_},
+      pipeline_layout{layout_}, pipeline_cache{pipeline_cache_}, info{info_}, stages{stages_} {}
+
+PipelineLibrary::~PipelineLibrary() = default;
+
+void PipelineLibrary::Build() {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+    static constexpr std::array LIBRARY_FLAGS = {
+        vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface,
+        vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders,
+        vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader,
+        vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface,
     };
 
-    if (fail_on_compile_required) {
-        pipeline_info.flags |= vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequiredEXT;
+    // A library that failed to build is left empty, and the pipelines using it are built whole.
+    auto result =
+        CreatePipeline(instance, renderpass_cache, info, stages, pipeline_cache, pipeline_layout,
+                       LIBRARY_FLAGS[static_cast<u32>(type)], {});
+    if (result.result == vk::Result::eSuccess) {
+        pipeline = std::move(result.value);
+    } else {
+        LOG_ERROR(Render_Vulkan, "Graphics pipeline library creation failed with {}",
+                  vk::to_string(result.result));
     }
+    MarkDone();
+}
 
-    auto result = instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+GraphicsPipeline::GraphicsPipeline(const Instance& instance_, RenderManager& renderpass_cache_,
+                                   const PipelineInfo& info_, vk::PipelineCache pipeline_cache_,
+                                   vk::PipelineLayout layout_, std::array<Shader*, 3> stages_,
+                                   Common::ThreadWorker* worker_, PipelineLibraries libraries_)
+    : instance{instance_}, renderpass_cache{renderpass_cache_}, worker{worker_},
+      pipeline_layout{layout_}, pipeline_cache{pipeline_cache_}, info{info_}, stages{stages_},
+      libraries{libraries_} {}
+
+GraphicsPipeline::~GraphicsPipeline() = default;
+
+bool GraphicsPipeline::TryBuild(bool wait_built) {
+    // The pipeline is currently being compiled. We can either wait for it
+    // or skip the draw.
+    if (is_pending) {
+        return wait_built;
+    }
+
+    // Linking libraries is fast enough to do at draw time, once their shaders are compiled.
+    if (libraries[0]) {
+        const bool libraries_pending =
+            std::any_of(libraries.begin(), libraries.end(),
+                        [](PipelineLibrary* library) { return !library->IsDone(); });
+        if (!wait_built && libraries_pending) {
+            return false;
+        }
+        for (PipelineLibrary* library : libraries) {
+            library->WaitDone();
+        }
+        const bool libraries_built = std::all_of(
+            libraries.begin(), libraries.end(),
+            [](PipelineLibrary* library) { return static_cast<bool>(library->Handle()); });
+        if (libraries_built && Link(false)) {
+            // Swap in an optimized pipeline once the driver is done with it
+            worker->QueueWork([this] { Link(true); });
+            return true;
+        }
+    }
+
+    // If the shaders haven't been compiled yet, we cannot proceed.
+    const bool shaders_pending = std::any_of(
+        stages.begin(), stages.end(), [](Shader* shader) { return shader && !shader->IsDone(); });
+    if (!wait_built && shaders_pending) {
+        return false;
+    }
+
+    // Ask the driver if it can give us the pipeline quickly.
+    if (!shaders_pending && instance.IsPipelineCreationCacheControlSupported() && Build(true)) {
+        return true;
+    }
+
+    // Fallback to (a)synchronous compilation
+    worker->QueueWork([this] { Build(); });
+    is_pending = true;
+    return wait_built;
+}
+
+bool GraphicsPipeline::Build(bool fail_on_compile_required) {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+    const vk::PipelineCreateFlags create_flags =
+        fail_on_compile_required ? vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequiredEXT
+                                 : vk::PipelineCreateFlags{};
+
+    auto result = CreatePipeline(instance, renderpass_cache, info, stages, pipeline_cache,
+                                 pipeline_layout, {}, create_flags);
     if (result.result == vk::Result::eSuccess) {
         pipeline = std::move(result.value);
+        handle.store(static_cast<VkPipeline>(*pipeline), std::memory_order::release);
     } else if (result.result == vk::Result::eErrorPipelineCompileRequiredEXT) {
         return false;
     } else {
@@ -284,4 +423,42 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
     return true;
 }
 
+bool GraphicsPipeline::Link(bool optimize) {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+    std::array<vk::Pipeline, NUM_PIPELINE_LIBRARIES> library_handles;
+    std::transform(libraries.begin(), libraries.end(), library_handles.begin(),
+                   [](PipelineLibrary* library) { return library->Handle(); });
+
+    const vk::PipelineLibraryCreateInfoKHR library_info = {
+        .libraryCount = NUM_PIPELINE_LIBRARIES,
+        .pLibraries = library_handles.data(),
+    };
+
+    const vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .pNext = &library_info,
+        .flags = optimize ? vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT
+                          : vk::PipelineCreateFlags{},
+        .layout = pipeline_layout,
+    };
+
+    auto result = instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+    if (result.result != vk::Result::eSuccess) {
+        LOG_ERROR(Render_Vulkan, "Graphics pipeline linking failed with {}",
+                  vk::to_string(result.result));
+        return false;
+    }
+
+    // The linked pipeline is kept alive as command buffers in flight may still use it
+    if (optimize) {
+        optimized_pipeline = std::move(result.value);
+        handle.store(static_cast<VkPipeline>(*optimized_pipeline), std::memory_order::release);
+        handle_updated.store(true, std::memory_order::relaxed);
+    } else {
+        pipeline = std::move(result.value);
+        handle.store(static_cast<VkPipeline>(*pipeline), std::memory_order::release);
+        MarkDone();
+    }
+    return true;
+}
+
 } // namespace Vulkan
@@ -45,6 +45,15 @@ class RenderManager;
 constexpr u32 MAX_SHADER_STAGES = 3;
 constexpr u32 MAX_VERTEX_ATTRIBUTES = 16;
 constexpr u32 MAX_VERTEX_BINDINGS = 13;
+constexpr u32 NUM_PIPELINE_LIBRARIES = 4;
+
+/// The parts a pipeline is split into with VK_EXT_graphics_pipeline_library
+enum class PipelineLibraryType : u32 {
+    VertexInput,
+    PreRasterization,
+    FragmentShader,
+    FragmentOutput,
+};
 
 /**
  * The pipeline state is tightly packed with bitfields to reduce
@@ -139,6 +148,9 @@ struct PipelineInfo {
 
     [[nodiscard]] u64 Hash(const Instance& instance) const;
 
+    /// Hashes the state used by a pipeline library, excluding the shaders
+    [[nodiscard]] u64 LibraryHash(const Instance& instance, PipelineLibraryType type) const;
+
     [[nodiscard]] bool IsDepthWriteEnabled() const noexcept {
         const bool has_stencil = attachments.depth == VideoCore::PixelFormat::D24S8;
         const bool depth_write =
@@ -164,12 +176,51 @@ struct Shader : public Common::AsyncHandle {
     std::string program;
 };
 
+/**
+ * A part of a graphics pipeline that is compiled once and linked into every pipeline sharing
+ * its state, so that new state combinations do not recompile the shaders.
+ */
+class PipelineLibrary : public Common::AsyncHandle {
+public:
+    explicit PipelineLibrary(const Instance& instance, RenderManager& renderpass_cache,
+                             PipelineLibraryType type, const PipelineInfo& info,
+                             vk::PipelineCache pipeline_cache, vk::PipelineLayout layout,
+                             std::array<Shader*, 3> stages);
+    ~PipelineLibrary();
+
+    /// Returns true when the library compiles shaders and should be built on a worker thread
+    [[nodiscard]] bool HasShaders() const noexcept {
+        return type == PipelineLibraryType::PreRasterization ||
+               type == PipelineLibraryType::FragmentShader;
+    }
+
+    void Build();
+
+    [[nodiscard]] vk::Pipeline Handle() const noexcept {
+        return *pipeline;
+    }
+
+private:
+    const Instance& instance;
+    RenderManager& renderpass_cache;
+    PipelineLibraryType type;
+
+    vk::UniquePipeline pipeline;
+    vk::PipelineLayout pipeline_layout;
+    vk::PipelineCache pipeline_cache;
+
+    PipelineInfo info;
+    std::array<Shader*, 3> stages;
+};
+
+using PipelineLibraries = std::array<PipelineLibrary*, NUM_PIPELINE_LIBRARIES>;
+
 class GraphicsPipeline : public Common::AsyncHandle {
 public:
     explicit GraphicsPipeline(const Instance& instance, RenderManager& renderpass_cache,
                               const PipelineInfo& info, vk::PipelineCache pipeline_cache,
                               vk::PipelineLayout layout, std::array<Shader*, 3> stages,
-                              Common::ThreadWorker* worker);
+                              Common::ThreadWorker* worker, PipelineLibraries libraries = {});
     ~GraphicsPipeline();
 
     bool TryBuild(bool wait_built);
@@ -177,20 +228,33 @@ public:
     bool Build(bool fail_on_compile_required = false);
 
     [[nodiscard]] vk::Pipeline Handle() const noexcept {
-        return *pipeline;
+        return vk::Pipeline{handle.load(std::memory_order::acquire)};
     }
 
+    /// Returns true once after the linked pipeline was replaced by an optimized one
+    [[nodiscard]] bool TakeHandleUpdate() noexcept {
+        return handle_updated.exchange(false, std::memory_order::relaxed);
+    }
+
+private:
+    /// Links the pipeline from its libraries, with link time optimization when optimize is set
+    bool Link(bool optimize);
+
 private:
     const Instance& instance;
     RenderManager& renderpass_cache;
     Common::ThreadWorker* worker;
 
     vk::UniquePipeline pipeline;
+    vk::UniquePipeline optimized_pipeline;
+    std::atomic<VkPipeline> handle{};
+    std::atomic_bool handle_updated{};
     vk::PipelineLayout pipeline_layout;
     vk::PipelineCache pipeline_cache;
 
     PipelineInfo info;
     std::array<Shader*, 3> stages;
+    PipelineLibraries libraries;
     bool is_pending{};
 };
 
@@ -404,12 +404,14 @@ bool Instance::CreateDevice(bool libretro) {
         vk::PhysicalDeviceCustomBorderColorFeaturesEXT, vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT,
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT,
-        vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR>();
+        vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR,
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
     const vk::StructureChain properties_chain =
         physical_device
             .getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDriverProperties,
                             vk::PhysicalDevicePortabilitySubsetPropertiesKHR,
-                            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>();
+                            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT,
+                            vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
     const vk::PhysicalDeviceDriverProperties driver =
         properties_chain.get<vk::PhysicalDeviceDriverProperties>();
 
@@ -422,7 +424,7 @@ bool Instance::CreateDevice(bool libretro) {
         return false;
     }
 
-    boost::container::static_vector<const char*, 13> enabled_extensions;
+    boost::container::static_vector<const char*, 15> enabled_extensions;
     const auto add_extension = [&](std::string_view extension, bool blacklist = false,
                                    std::string_view reason = "") -> bool {
         const auto result =
@@ -476,6 +478,9 @@ bool Instance::CreateDevice(bool libretro) {
     const bool has_fragment_shader_barycentric =
         add_extension(VK_KHR_FRAGMENT_SHADER_BARYCENTRIC_EXTENSION_NAME, is_moltenvk,
                       "the PerVertexKHR attribute is not supported by MoltenVK");
+    const bool has_pipeline_library = add_extension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+    const bool has_graphics_pipeline_library =
+        has_pipeline_library && add_extension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
 
     const auto family_properties = physical_device.getQueueFamilyProperties();
     if (family_properties.empty()) {
@@ -532,6 +537,7 @@ bool Instance::CreateDevice(bool libretro) {
         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT{},
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT{},
         vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR{},
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT{},
     };
 
 #define PROP_GET(structName, prop, property) property = properties_chain.get<structName>().prop;
@@ -611,6 +617,15 @@ bool Instance::CreateDevice(bool libretro) {
         device_chain.unlink<vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR>();
     }
 
+    if (has_graphics_pipeline_library) {
+        FEAT_SET(vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, graphicsPipelineLibrary,
+                 graphics_pipeline_library)
+        PROP_GET(vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+                 graphicsPipelineLibraryFastLinking, graphics_pipeline_library_fast_linking)
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+    }
+
 #undef PROP_GET
 #undef FEAT_SET
 
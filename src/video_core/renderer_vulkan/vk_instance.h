@@ -175,6 +175,12 @@ public:
         return fragment_shader_barycentric;
     }
 
+    /// Returns true when VK_EXT_graphics_pipeline_library is supported and linking libraries
+    /// into a pipeline is fast enough to be done at draw time
+    bool IsGraphicsPipelineLibrarySupported() const {
+        return graphics_pipeline_library && graphics_pipeline_library_fast_linking;
+    }
+
     /// Returns the vendor ID of the physical device
     u32 GetVendorID() const {
         return properties.vendorID;
@@ -235,6 +241,16 @@ public:
         return properties.limits.maxTexelBufferElements;
     }
 
+    /// Returns true if timestamps can be written on the graphics queue
+    bool IsTimestampQuerySupported() const {
+        return properties.limits.timestampComputeAndGraphics;
+    }
+
+    /// Returns the number of nanoseconds it takes for a timestamp value to be incremented by 1
+    float GetTimestampPeriod() const {
+        return properties.limits.timestampPeriod;
+    }
+
     /// Returns true if shaders can declare the ClipDistance attribute
     bool IsShaderClipDistanceSupported() const {
         return features.shaderClipDistance;
@@ -326,6 +342,8 @@ protected:
     bool image_format_list{};
     bool pipeline_creation_cache_control{};
     bool fragment_shader_barycentric{};
+    bool graphics_pipeline_library{};
+    bool graphics_pipeline_library_fast_linking{};
     bool shader_stencil_export{};
     bool external_memory_host{};
     u64 min_imported_host_pointer_alignment{};
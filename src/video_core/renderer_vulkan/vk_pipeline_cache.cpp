@@ -6,6 +6,7 @@
 
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -23,6 +24,7 @@
 #include "video_core/shader/generator/glsl_fs_shader_gen.h"
 #include "video_core/shader/generator/glsl_shader_gen.h"
 #include "video_core/shader/generator/spv_fs_shader_gen.h"
+#include "video_core/shader/generator/spv_vs_shader_gen.h"
 
 using namespace Pica::Shader::Generator;
 using Pica::Shader::FSConfig;
@@ -85,14 +87,14 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
     : instance{instance_}, scheduler{scheduler_}, renderpass_cache{renderpass_cache_},
       update_queue{update_queue_},
       num_worker_threads{std::max(std::thread::hardware_concurrency(), 2U) >> 1},
-      workers{num_worker_threads, "Pipeline workers"},
       descriptor_heaps{
           DescriptorHeap{instance, scheduler.GetMasterSemaphore(), BUFFER_BINDINGS, 32},
           DescriptorHeap{instance, scheduler.GetMasterSemaphore(), TEXTURE_BINDINGS<1>},
           DescriptorHeap{instance, scheduler.GetMasterSemaphore(), UTILITY_BINDINGS, 32}},
       trivial_vertex_shader{
           instance, vk::ShaderStageFlagBits::eVertex,
-          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)} {
+          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)},
+      workers{num_worker_threads, "Pipeline workers"} {
     scheduler.RegisterOnDispatch([this] { update_queue.Flush(); });
     profile = Pica::Shader::Profile{
         .has_separable_shaders = true,
@@ -252,9 +254,15 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
 
     auto [it, new_pipeline] = graphics_pipelines.try_emplace(pipeline_hash);
     if (new_pipeline) {
-        it.value() =
-            std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info, *pipeline_cache,
-                                               *pipeline_layout, current_shaders, &workers);
+        PipelineLibraries libraries{};
+        if (instance.IsGraphicsPipelineLibrarySupported()) {
+            for (u32 i = 0; i < NUM_PIPELINE_LIBRARIES; i++) {
+                libraries[i] = GetPipelineLibrary(static_cast<PipelineLibraryType>(i), info);
+            }
+        }
+        it.value() = std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info,
+                                                        *pipeline_cache, *pipeline_layout,
+                                                        current_shaders, &workers, libraries);
     }
 
     GraphicsPipeline* const pipeline{it->second.get()};
@@ -263,7 +271,8 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     }
 
     const bool is_dirty = scheduler.IsStateDirty(StateFlags::Pipeline);
-    const bool pipeline_dirty = (current_pipeline != pipeline) || is_dirty;
+    const bool handle_updated = pipeline->TakeHandleUpdate();
+    const bool pipeline_dirty = (current_pipeline != pipeline) || is_dirty || handle_updated;
     scheduler.Record([this, is_dirty, pipeline_dirty, pipeline,
                       current_dynamic = current_info.dynamic, dynamic = info.dynamic,
                       descriptor_sets = bound_descriptor_sets, offsets = offsets,
@@ -383,6 +392,34 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     return true;
 }
 
+PipelineLibrary* PipelineCache::GetPipelineLibrary(PipelineLibraryType type,
+                                                  const PipelineInfo& info) {
+    u64 library_hash =
+        Common::HashCombine(static_cast<u64>(type), info.LibraryHash(instance, type));
+    if (type == PipelineLibraryType::PreRasterization) {
+        library_hash = Common::HashCombine(library_hash, shader_hashes[ProgramType::VS]);
+        library_hash = Common::HashCombine(library_hash, shader_hashes[ProgramType::GS]);
+    } else if (type == PipelineLibraryType::FragmentShader) {
+        library_hash = Common::HashCombine(library_hash, shader_hashes[ProgramType::FS]);
+    }
+
+    auto [it, new_library] = pipeline_libraries.try_emplace(library_hash);
+    if (new_library) {
+        it.value() = std::make_unique<PipelineLibrary>(instance, renderpass_cache, type, info,
+                                                       *pipeline_cache, *pipeline_layout,
+                                                       current_shaders);
+        PipelineLibrary* const library{it->second.get()};
+        // Libraries without shaders are cheap enough to build right away
+        if (library->HasShaders()) {
+            workers.QueueWork([library] { library->Build(); });
+        } else {
+            library->Build();
+        }
+    }
+
+    return it->second.get();
+}
+
 bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
                                                 Pica::ShaderSetup& setup,
                                                 const VertexLayout& layout, bool accurate_mul) {
@@ -409,7 +446,29 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
     }
 
     const auto [it, new_config] = programmable_vertex_map.try_emplace(config);
-    if (new_config) {
+    if (new_config && Settings::values.spirv_shader_gen.GetValue()) {
+        auto code = SPIRV::GenerateVertexShader(setup, config);
+        if (code.empty()) {
+            LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable vertex shader");
+            programmable_vertex_map[config] = nullptr;
+            return false;
+        }
+
+        // Configs that only differ in unused state produce the same module
+        auto [iter, new_program] =
+            programmable_vertex_spv_cache.try_emplace(std::move(code), instance);
+        auto& shader = iter->second;
+
+        if (new_program) {
+            const vk::Device device = instance.GetDevice();
+            workers.QueueWork([device, &code = iter->first, &shader] {
+                shader.module = CompileSPV(code, device);
+                shader.MarkDone();
+            });
+        }
+
+        it->second = &shader;
+    } else if (new_config) {
         auto program = GLSL::GenerateVertexShader(setup, config, true);
         if (program.empty()) {
             LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable vertex shader");
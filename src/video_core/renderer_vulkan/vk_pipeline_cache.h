@@ -102,6 +102,9 @@ private:
     /// Builds the rasterizer pipeline layout
     void BuildLayout();
 
+    /// Returns the pipeline library of the given type for the current shaders and state
+    PipelineLibrary* GetPipelineLibrary(PipelineLibraryType type, const PipelineInfo& info);
+
     /// Returns true when the disk data can be used by the current driver
     bool IsCacheValid(std::span<const u8> cache_data) const;
 
@@ -117,13 +120,20 @@ private:
     RenderManager& renderpass_cache;
     DescriptorUpdateQueue& update_queue;
 
+    struct SpirvCodeHash {
+        std::size_t operator()(const std::vector<u32>& code) const noexcept {
+            return Common::ComputeHash64(code.data(), code.size() * sizeof(u32));
+        }
+    };
+
     Pica::Shader::Profile profile{};
     vk::UniquePipelineCache pipeline_cache;
     vk::UniquePipelineLayout pipeline_layout;
     std::size_t num_worker_threads;
-    Common::ThreadWorker workers;
     PipelineInfo current_info{};
     GraphicsPipeline* current_pipeline{};
+    tsl::robin_map<u64, std::unique_ptr<PipelineLibrary>, Common::IdentityHash<u64>>
+        pipeline_libraries;
     tsl::robin_map<u64, std::unique_ptr<GraphicsPipeline>, Common::IdentityHash<u64>>
         graphics_pipelines;
     std::array<DescriptorHeap, NumDescriptorHeaps> descriptor_heaps;
@@ -134,11 +144,16 @@ private:
     std::array<Shader*, MAX_SHADER_STAGES> current_shaders;
     std::unordered_map<Pica::Shader::Generator::PicaVSConfig, Shader*> programmable_vertex_map;
     std::unordered_map<std::string, Shader> programmable_vertex_cache;
+    std::unordered_map<std::vector<u32>, Shader, SpirvCodeHash> programmable_vertex_spv_cache;
     std::unordered_map<Pica::Shader::Generator::PicaFixedGSConfig, Shader> fixed_geometry_shaders;
     std::unordered_map<Pica::Shader::FSConfig, Shader> fragment_shaders;
     Shader trivial_vertex_shader;
 
     u64 current_program_id{0};
+
+    // Queued jobs refer to the libraries, pipelines and shaders above, so the workers are stopped
+    // before those are destroyed.
+    Common::ThreadWorker workers;
 };
 
 } // namespace Vulkan
@@ -130,6 +130,19 @@ vk::SurfaceKHR CreateSurface(vk::Instance instance, const Frontend::EmuWindow& e
     vk::SurfaceKHR surface{};
     vk::Result res;
 
+    if (window_info.type == Frontend::WindowSystemType::Headless) {
+        // Offscreen presentation, used to run the renderer on machines without a display.
+        const vk::HeadlessSurfaceCreateInfoEXT headless_ci = {};
+
+        if ((res = instance.createHeadlessSurfaceEXT(&headless_ci, nullptr, &surface)) !=
+            vk::Result::eSuccess) {
+            LOG_CRITICAL(Render_Vulkan, "Failed to initialize headless surface: {}",
+                         vk::to_string(res));
+            UNREACHABLE();
+        }
+        return surface;
+    }
+
 #if defined(VK_USE_PLATFORM_WIN32_KHR)
     if (window_info.type == Frontend::WindowSystemType::Windows) {
         const vk::Win32SurfaceCreateInfoKHR win32_ci = {
@@ -225,6 +238,7 @@ std::vector<const char*> GetInstanceExtensions(Frontend::WindowSystemType window
 
     switch (window_type) {
     case Frontend::WindowSystemType::Headless:
+        extensions.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
         break;
 #if defined(VK_USE_PLATFORM_WIN32_KHR)
     case Frontend::WindowSystemType::Windows:
@@ -251,9 +265,7 @@ std::vector<const char*> GetInstanceExtensions(Frontend::WindowSystemType window
         break;
     }
 
-    if (window_type != Frontend::WindowSystemType::Headless) {
-        extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
-    }
+    extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
 
     if (enable_debug_utils) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
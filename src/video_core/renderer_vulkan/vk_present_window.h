@@ -63,6 +63,11 @@ public:
         return swapchain.GetImageCount();
     }
 
+    /// Returns the format of the images created by RecreateFrame.
+    [[nodiscard]] vk::Format FrameFormat() const noexcept {
+        return swapchain.GetSurfaceFormat().format;
+    }
+
 private:
     void PresentThread(std::stop_token token);
 
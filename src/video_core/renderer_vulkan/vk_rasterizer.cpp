@@ -423,12 +423,8 @@ bool RasterizerVulkan::SetupGeometryShader() {
 
 bool RasterizerVulkan::AccelerateDrawBatch(bool is_indexed) {
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        if (regs.pipeline.gs_config.mode != Pica::PipelineRegs::GSMode::Point) {
-            return false;
-        }
-        if (regs.pipeline.triangle_topology != Pica::PipelineRegs::TriangleTopology::Shader) {
-            return false;
-        }
+        // PICA geometry shaders are only translated to GLSL geometry shaders for OpenGL
+        return false;
     }
 
     pipeline_info.rasterization.topology.Assign(regs.pipeline.triangle_topology);
@@ -747,6 +743,14 @@ void RasterizerVulkan::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
 
+void RasterizerVulkan::PrepareStateLoad() {
+    res_cache.PrepareStateLoad();
+}
+
+void RasterizerVulkan::FinishStateLoad() {
+    res_cache.FinishStateLoad();
+}
+
 bool RasterizerVulkan::AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) {
     return res_cache.AccelerateDisplayTransfer(config);
 }
@@ -831,40 +835,83 @@ void RasterizerVulkan::SyncAndUploadLUTsLF() {
         return;
     }
 
+    const auto set_lut_offset = [this](int& lut_offset, int new_offset) {
+        if (std::exchange(lut_offset, new_offset) != new_offset) {
+            fs_data_dirty = true;
+        }
+    };
+
+    // Bind the LUTs whose contents are still resident in the texture buffer
+    u32 lighting_misses = 0;
+    for (u32 dirty = pica.lighting.lut_dirty; dirty != 0; dirty &= dirty - 1) {
+        const u32 index = std::countr_zero(dirty);
+        const u64 hash = VideoCore::LutCache::Hash(VideoCore::LutType::Lighting,
+                                                   pica.lighting.luts[index]);
+        if (const auto cached = lf_lut_cache.Find(hash)) {
+            set_lut_offset(fs_data.lighting_lut_offset[index / 4][index % 4], *cached);
+        } else {
+            lighting_misses |= 1U << index;
+        }
+    }
+    bool fog_miss = false;
+    if (pica.fog.lut_dirty) {
+        const u64 hash = VideoCore::LutCache::Hash(VideoCore::LutType::Fog, pica.fog.lut);
+        if (const auto cached = lf_lut_cache.Find(hash)) {
+            set_lut_offset(fs_data.fog_lut_offset, *cached);
+        } else {
+            fog_miss = true;
+        }
+    }
+
+    pica.lighting.lut_dirty = 0;
+    pica.fog.lut_dirty = false;
+    if (!lighting_misses && !fog_miss) {
+        return;
+    }
+
     std::size_t bytes_used = 0;
     auto [buffer, offset, invalidate] = texture_lf_buffer.Map(max_size, sizeof(Common::Vec4f));
 
     if (invalidate) {
-        pica.lighting.lut_dirty = pica.lighting.LutAllDirty;
-        pica.fog.lut_dirty = true;
+        lf_lut_cache.Clear();
+        lighting_misses = pica.lighting.LutAllDirty;
+        fog_miss = true;
     }
 
     // Sync the lighting luts
-    while (pica.lighting.lut_dirty) {
-        u32 index = std::countr_zero(pica.lighting.lut_dirty);
-        pica.lighting.lut_dirty &= ~(1 << index);
+    while (lighting_misses) {
+        const u32 index = std::countr_zero(lighting_misses);
+        lighting_misses &= ~(1 << index);
 
-        Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
         const auto& source_lut = pica.lighting.luts[index];
+        const u64 hash = VideoCore::LutCache::Hash(VideoCore::LutType::Lighting, source_lut);
+        int& lut_offset = fs_data.lighting_lut_offset[index / 4][index % 4];
+        if (const auto cached = lf_lut_cache.Find(hash)) {
+            set_lut_offset(lut_offset, *cached);
+            continue;
+        }
+
+        Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
         for (u32 i = 0; i < source_lut.size(); i++) {
             new_data[i] = {source_lut[i].ToFloat(), source_lut[i].DiffToFloat()};
         }
-        fs_data.lighting_lut_offset[index / 4][index % 4] =
-            static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-        fs_data_dirty = true;
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        lf_lut_cache.Insert(hash, new_offset);
+        set_lut_offset(lut_offset, new_offset);
         bytes_used += source_lut.size() * sizeof(Common::Vec2f);
     }
 
     // Sync the fog lut
-    if (pica.fog.lut_dirty) {
+    if (fog_miss) {
         Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
         for (u32 i = 0; i < pica.fog.lut.size(); i++) {
             new_data[i] = {pica.fog.lut[i].ToFloat(), pica.fog.lut[i].DiffToFloat()};
         }
-        fs_data.fog_lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-        fs_data_dirty = true;
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        lf_lut_cache.Insert(VideoCore::LutCache::Hash(VideoCore::LutType::Fog, pica.fog.lut),
+                            new_offset);
+        set_lut_offset(fs_data.fog_lut_offset, new_offset);
         bytes_used += pica.fog.lut.size() * sizeof(Common::Vec2f);
-        pica.fog.lut_dirty = false;
     }
 
     texture_lf_buffer.Commit(static_cast<u32>(bytes_used));
@@ -877,7 +924,45 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
         sizeof(Common::Vec4f) * 256 +     // proctex
         sizeof(Common::Vec4f) * 256;      // proctex diff
 
-    if (!pica.proctex.lut_dirty) {
+    if (!pica.proctex.table_dirty) {
+        return;
+    }
+
+    const auto set_lut_offset = [this](int& lut_offset, int new_offset) {
+        if (std::exchange(lut_offset, new_offset) != new_offset) {
+            fs_data_dirty = true;
+        }
+    };
+
+    // Returns true if the table has to be uploaded, binding the resident copy otherwise
+    const auto needs_upload = [&](VideoCore::LutType type, const auto& lut, int& lut_offset) {
+        if (const auto cached = lut_cache.Find(VideoCore::LutCache::Hash(type, lut))) {
+            set_lut_offset(lut_offset, *cached);
+            return false;
+        }
+        return true;
+    };
+
+    using VideoCore::LutType;
+    bool noise_miss = pica.proctex.noise_lut_dirty &&
+                      needs_upload(LutType::ProcTexValue, proctex.noise_table,
+                                   fs_data.proctex_noise_lut_offset);
+    bool color_map_miss = pica.proctex.color_map_dirty &&
+                          needs_upload(LutType::ProcTexValue, proctex.color_map_table,
+                                       fs_data.proctex_color_map_offset);
+    bool alpha_map_miss = pica.proctex.alpha_map_dirty &&
+                          needs_upload(LutType::ProcTexValue, proctex.alpha_map_table,
+                                       fs_data.proctex_alpha_map_offset);
+    bool lut_miss = pica.proctex.lut_dirty && needs_upload(LutType::ProcTexColor,
+                                                           proctex.color_table,
+                                                           fs_data.proctex_lut_offset);
+    bool diff_lut_miss =
+        pica.proctex.diff_lut_dirty &&
+        needs_upload(LutType::ProcTexColorDiff, proctex.color_diff_table,
+                     fs_data.proctex_diff_lut_offset);
+
+    pica.proctex.table_dirty = 0;
+    if (!noise_miss && !color_map_miss && !alpha_map_miss && !lut_miss && !diff_lut_miss) {
         return;
     }
 
@@ -885,71 +970,90 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
     auto [buffer, offset, invalidate] = texture_buffer.Map(max_size, sizeof(Common::Vec4f));
 
     if (invalidate) {
-        pica.proctex.table_dirty = pica.proctex.TableAllDirty;
+        lut_cache.Clear();
+        noise_miss = color_map_miss = alpha_map_miss = lut_miss = diff_lut_miss = true;
     }
 
     // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
     const auto sync_proctex_value_lut =
         [&](const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& lut, int& lut_offset) {
+            const u64 hash = VideoCore::LutCache::Hash(LutType::ProcTexValue, lut);
+            if (const auto cached = lut_cache.Find(hash)) {
+                set_lut_offset(lut_offset, *cached);
+                return;
+            }
             Common::Vec2f* new_data = reinterpret_cast<Common::Vec2f*>(buffer + bytes_used);
             for (u32 i = 0; i < lut.size(); i++) {
                 new_data[i] = {lut[i].ToFloat(), lut[i].DiffToFloat()};
             }
-            lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-            fs_data_dirty = true;
+            const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+            lut_cache.Insert(hash, new_offset);
+            set_lut_offset(lut_offset, new_offset);
             bytes_used += lut.size() * sizeof(Common::Vec2f);
         };
 
     // Sync the proctex noise lut
-    if (pica.proctex.noise_lut_dirty) {
+    if (noise_miss) {
         sync_proctex_value_lut(proctex.noise_table, fs_data.proctex_noise_lut_offset);
     }
 
     // Sync the proctex color map
-    if (pica.proctex.color_map_dirty) {
+    if (color_map_miss) {
         sync_proctex_value_lut(proctex.color_map_table, fs_data.proctex_color_map_offset);
     }
 
     // Sync the proctex alpha map
-    if (pica.proctex.alpha_map_dirty) {
+    if (alpha_map_miss) {
         sync_proctex_value_lut(proctex.alpha_map_table, fs_data.proctex_alpha_map_offset);
     }
 
     // Sync the proctex lut
-    if (pica.proctex.lut_dirty) {
+    if (lut_miss) {
         Common::Vec4f* new_data = reinterpret_cast<Common::Vec4f*>(buffer + bytes_used);
         for (u32 i = 0; i < proctex.color_table.size(); i++) {
             new_data[i] = proctex.color_table[i].ToVector() / 255.0f;
         }
-        fs_data.proctex_lut_offset =
-            static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
-        fs_data_dirty = true;
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
+        lut_cache.Insert(VideoCore::LutCache::Hash(LutType::ProcTexColor, proctex.color_table),
+                         new_offset);
+        set_lut_offset(fs_data.proctex_lut_offset, new_offset);
         bytes_used += proctex.color_table.size() * sizeof(Common::Vec4f);
     }
 
     // Sync the proctex difference lut
-    if (pica.proctex.diff_lut_dirty) {
+    if (diff_lut_miss) {
         Common::Vec4f* new_data = reinterpret_cast<Common::Vec4f*>(buffer + bytes_used);
         for (u32 i = 0; i < proctex.color_diff_table.size(); i++) {
             new_data[i] = proctex.color_diff_table[i].ToVector() / 255.0f;
         }
-        fs_data.proctex_diff_lut_offset =
-            static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
-        fs_data_dirty = true;
+        const int new_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
+        lut_cache.Insert(
+            VideoCore::LutCache::Hash(LutType::ProcTexColorDiff, proctex.color_diff_table),
+            new_offset);
+        set_lut_offset(fs_data.proctex_diff_lut_offset, new_offset);
         bytes_used += proctex.color_diff_table.size() * sizeof(Common::Vec4f);
     }
 
-    pica.proctex.table_dirty = 0;
-
     texture_buffer.Commit(static_cast<u32>(bytes_used));
 }
 
 void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
-    const bool sync_vs_pica = accelerate_draw && pica.vs_setup.uniforms_dirty;
+    const bool sync_vs_pica = accelerate_draw && (pica.vs_setup.uniforms_dirty ||
+                                                  pica.vs_setup.HasDirtyFloatUniforms());
     if (!sync_vs_pica && !vs_data_dirty && !fs_data_dirty) {
         return;
     }
 
+    // Skip blocks that were flagged dirty but are identical to the bound ones
+    const bool upload_vs = vs_data_dirty && vs_data_uploaded.Differs(vs_data);
+    const bool upload_fs = fs_data_dirty && fs_data_uploaded.Differs(fs_data);
+    const bool upload_vs_pica = sync_vs_pica && SyncVSPicaUniforms();
+    vs_data_dirty = false;
+    fs_data_dirty = false;
+    if (!upload_vs && !upload_fs && !upload_vs_pica) {
+        return;
+    }
+
     const u32 uniform_size =
         uniform_size_aligned_vs_pica + uniform_size_aligned_vs + uniform_size_aligned_fs;
     auto [uniforms, offset, invalidate] =
@@ -957,26 +1061,24 @@ void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
 
     u32 used_bytes = 0;
 
-    if (vs_data_dirty || invalidate) {
+    if (upload_vs || invalidate) {
         std::memcpy(uniforms + used_bytes, &vs_data, sizeof(vs_data));
         pipeline_cache.UpdateRange(1, offset + used_bytes);
-        vs_data_dirty = false;
+        vs_data_uploaded.Set(vs_data);
         used_bytes += uniform_size_aligned_vs;
     }
 
-    if (fs_data_dirty || invalidate) {
+    if (upload_fs || invalidate) {
         std::memcpy(uniforms + used_bytes, &fs_data, sizeof(fs_data));
         pipeline_cache.UpdateRange(2, offset + used_bytes);
-        fs_data_dirty = false;
+        fs_data_uploaded.Set(fs_data);
         used_bytes += uniform_size_aligned_fs;
     }
 
-    if (sync_vs_pica || invalidate) {
-        VSPicaUniformData vs_uniforms;
-        vs_uniforms.SetFromRegs(pica.vs_setup);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+    if (upload_vs_pica || invalidate) {
+        std::memcpy(uniforms + used_bytes, &vs_pica_data, sizeof(vs_pica_data));
         pipeline_cache.UpdateRange(0, offset + used_bytes);
-        pica.vs_setup.uniforms_dirty = false;
+        vs_pica_data_uploaded.Set(vs_pica_data);
         used_bytes += uniform_size_aligned_vs_pica;
     }
 
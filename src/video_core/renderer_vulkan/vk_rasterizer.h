@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "video_core/lut_cache.h"
 #include "video_core/rasterizer_accelerated.h"
 #include "video_core/renderer_vulkan/vk_descriptor_update_queue.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
@@ -54,6 +55,8 @@ public:
     void InvalidateRegion(PAddr addr, u32 size) override;
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
     void ClearAll(bool flush) override;
+    void PrepareStateLoad() override;
+    void FinishStateLoad() override;
     bool AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) override;
     bool AccelerateTextureCopy(const Pica::DisplayTransferConfig& config) override;
     bool AccelerateFill(const Pica::MemoryFillConfig& config) override;
@@ -136,6 +139,8 @@ private:
     vk::UniqueBufferView texture_lf_view;
     vk::UniqueBufferView texture_rg_view;
     vk::UniqueBufferView texture_rgba_view;
+    VideoCore::LutCache lut_cache;    ///< LUTs resident in the texture buffer
+    VideoCore::LutCache lf_lut_cache; ///< LUTs resident in the light-fog buffer
     vk::DeviceSize uniform_buffer_alignment;
     u32 uniform_size_aligned_vs_pica;
     u32 uniform_size_aligned_vs;
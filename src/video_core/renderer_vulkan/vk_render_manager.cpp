@@ -17,7 +17,7 @@ using VideoCore::PixelFormat;
 using VideoCore::SurfaceType;
 
 RenderManager::RenderManager(const Instance& instance, Scheduler& scheduler)
-    : instance{instance}, scheduler{scheduler} {}
+    : instance{instance}, scheduler{scheduler}, timeline{instance, scheduler} {}
 
 RenderManager::~RenderManager() = default;
 
@@ -52,6 +52,7 @@ void RenderManager::BeginRendering(const RenderPass& new_pass) {
     }
 
     EndRendering();
+    timeline.Begin(Core::GPUTimelineStage::RenderPass);
     scheduler.Record([info = new_pass](vk::CommandBuffer cmdbuf) {
         const vk::RenderPassBeginInfo renderpass_begin_info = {
             .renderPass = info.render_pass,
@@ -116,6 +117,8 @@ void RenderManager::EndRendering() {
                                num_barriers, barriers.data());
     });
 
+    timeline.End(Core::GPUTimelineStage::RenderPass);
+
     // Reset state.
     pass.render_pass = VK_NULL_HANDLE;
     images = {};
@@ -8,6 +8,7 @@
 
 #include "common/math_util.h"
 #include "video_core/renderer_vulkan/vk_common.h"
+#include "video_core/renderer_vulkan/vk_gpu_timeline.h"
 
 namespace VideoCore {
 enum class PixelFormat : u32;
@@ -51,6 +52,11 @@ public:
     /// Exits from any currently active renderpass instance
     void EndRendering();
 
+    /// Returns the timeline measuring the GPU time of recorded work
+    GPUTimeline& Timeline() noexcept {
+        return timeline;
+    }
+
     /// Returns the renderpass associated with the color-depth format pair
     vk::RenderPass GetRenderpass(VideoCore::PixelFormat color, VideoCore::PixelFormat depth,
                                  bool is_clear);
@@ -63,6 +69,7 @@ private:
 private:
     const Instance& instance;
     Scheduler& scheduler;
+    GPUTimeline timeline;
     vk::UniqueRenderPass cached_renderpasses[NumColorFormats + 1][NumDepthFormats + 1][2];
     std::mutex cache_mutex;
     std::array<vk::Image, 2> images;
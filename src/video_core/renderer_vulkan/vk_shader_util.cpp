@@ -160,8 +160,8 @@ bool InitializeCompiler() {
 }
 } // Anonymous namespace
 
-vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
-                         std::string_view premable) {
+std::vector<u32> CompileGLSLtoSPIRV(std::string_view code, vk::ShaderStageFlagBits stage,
+                                    std::string_view premable) {
     if (!InitializeCompiler()) {
         return {};
     }
@@ -217,6 +217,15 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
         LOG_INFO(Render_Vulkan, "SPIR-V conversion messages: {}", spv_messages);
     }
 
+    return out_code;
+}
+
+vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
+                         std::string_view premable) {
+    const std::vector<u32> out_code = CompileGLSLtoSPIRV(code, stage, premable);
+    if (out_code.empty()) {
+        return {};
+    }
     return CompileSPV(out_code, device);
 }
 
@@ -5,11 +5,21 @@
 #pragma once
 
 #include <span>
+#include <vector>
 
 #include "video_core/renderer_vulkan/vk_common.h"
 
 namespace Vulkan {
 
+/**
+ * @brief Converts GLSL code to SPIR-V using glslang.
+ * @param code The string containing GLSL code.
+ * @param stage The pipeline stage the shader will be used in.
+ * @returns The SPIR-V bytecode, or an empty vector when the code fails to compile.
+ */
+std::vector<u32> CompileGLSLtoSPIRV(std::string_view code, vk::ShaderStageFlagBits stage,
+                                    std::string_view premable = "");
+
 /**
  * @brief Creates a vulkan shader module from GLSL by converting it to SPIR-V using glslang.
  * @param code The string containing GLSL code.
@@ -456,6 +456,8 @@ void TextureRuntime::ClearTextureWithRenderpass(Surface& surface,
 bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                   std::span<const VideoCore::TextureCopy> copies) {
     renderpass_cache.EndRendering();
+    const GPUTimelineScope timeline_scope{renderpass_cache.Timeline(),
+                                          Core::GPUTimelineStage::Blit};
 
     const RecordParams params = {
         .aspect = source.Aspect(),
@@ -564,6 +566,8 @@ bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
     }
 
     renderpass_cache.EndRendering();
+    const GPUTimelineScope timeline_scope{renderpass_cache.Timeline(),
+                                          Core::GPUTimelineStage::Blit};
 
     const RecordParams params = {
         .aspect = source.Aspect(),
@@ -807,6 +811,8 @@ Surface::~Surface() {
 void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
                      const VideoCore::StagingData& staging) {
     runtime->renderpass_cache.EndRendering();
+    const GPUTimelineScope timeline_scope{runtime->renderpass_cache.Timeline(),
+                                          Core::GPUTimelineStage::TextureUpload};
 
     const RecordParams params = {
         .aspect = Aspect(),
@@ -975,6 +981,8 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download,
     });
 
     runtime->renderpass_cache.EndRendering();
+    const GPUTimelineScope timeline_scope{runtime->renderpass_cache.Timeline(),
+                                          Core::GPUTimelineStage::TextureUpload};
 
     if (pixel_format == PixelFormat::D24S8) {
         runtime->blit_helper.DepthToBuffer(*this, runtime->download_buffer.Handle(), download);
@@ -2,16 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <bitset>
 #include <map>
+#include <optional>
 #include <set>
 #include <string>
-#include <tuple>
 #include <utility>
 #include <fmt/format.h>
 #include <nihstro/shader_bytecode.h>
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "video_core/shader/generator/glsl_shader_decompiler.h"
+#include "video_core/shader/generator/shader_control_flow.h"
 
 namespace Pica::Shader::Generator::GLSL {
 
@@ -22,180 +25,9 @@ using nihstro::RegisterType;
 using nihstro::SourceRegister;
 using nihstro::SwizzlePattern;
 
-constexpr u32 PROGRAM_END = MAX_PROGRAM_CODE_LENGTH;
-
-class DecompileFail : public std::runtime_error {
-public:
-    using std::runtime_error::runtime_error;
-};
-
-/// Describes the behaviour of code path of a given entry point and a return point.
-enum class ExitMethod {
-    Undetermined, ///< Internal value. Only occur when analyzing JMP loop.
-    AlwaysReturn, ///< All code paths reach the return point.
-    Conditional,  ///< Code path reaches the return point or an END instruction conditionally.
-    AlwaysEnd,    ///< All code paths reach a END instruction.
-};
-
-/// A subroutine is a range of code refereced by a CALL, IF or LOOP instruction.
-struct Subroutine {
-    /// Generates a name suitable for GLSL source code.
-    std::string GetName() const {
-        return "sub_" + std::to_string(begin) + "_" + std::to_string(end);
-    }
-
-    u32 begin;              ///< Entry point of the subroutine.
-    u32 end;                ///< Return point of the subroutine.
-    ExitMethod exit_method; ///< Exit method of the subroutine.
-    std::set<u32> labels;   ///< Addresses refereced by JMP instructions.
-
-    bool operator<(const Subroutine& rhs) const {
-        return std::tie(begin, end) < std::tie(rhs.begin, rhs.end);
-    }
-};
-
-/// Analyzes shader code and produces a set of subroutines.
-class ControlFlowAnalyzer {
-public:
-    ControlFlowAnalyzer(const ProgramCode& program_code, u32 main_offset)
-        : program_code(program_code) {
-
-        // Recursively finds all subroutines.
-        const Subroutine& program_main = AddSubroutine(main_offset, PROGRAM_END);
-        if (program_main.exit_method != ExitMethod::AlwaysEnd)
-            throw DecompileFail("Program does not always end");
-    }
-
-    std::set<Subroutine> MoveSubroutines() {
-        return std::move(subroutines);
-    }
-
-private:
-    const ProgramCode& program_code;
-    std::set<Subroutine> subroutines;
-    std::map<std::pair<u32, u32>, ExitMethod> exit_method_map;
-
-    /// Adds and analyzes a new subroutine if it is not added yet.
-    const Subroutine& AddSubroutine(u32 begin, u32 end) {
-        auto iter = subroutines.find(Subroutine{begin, end});
-        if (iter != subroutines.end())
-            return *iter;
-
-        Subroutine subroutine{begin, end};
-        subroutine.exit_method = Scan(begin, end, subroutine.labels);
-        if (subroutine.exit_method == ExitMethod::Undetermined)
-            throw DecompileFail("Recursive function detected");
-        return *subroutines.insert(std::move(subroutine)).first;
-    }
-
-    /// Merges exit method of two parallel branches.
-    static ExitMethod ParallelExit(ExitMethod a, ExitMethod b) {
-        if (a == ExitMethod::Undetermined) {
-            return b;
-        }
-        if (b == ExitMethod::Undetermined) {
-            return a;
-        }
-        if (a == b) {
-            return a;
-        }
-        return ExitMethod::Conditional;
-    }
-
-    /// Cascades exit method of two blocks of code.
-    static ExitMethod SeriesExit(ExitMethod a, ExitMethod b) {
-        // This should be handled before evaluating b.
-        DEBUG_ASSERT(a != ExitMethod::AlwaysEnd);
-
-        if (a == ExitMethod::Undetermined) {
-            return ExitMethod::Undetermined;
-        }
-
-        if (a == ExitMethod::AlwaysReturn) {
-            return b;
-        }
-
-        if (b == ExitMethod::Undetermined || b == ExitMethod::AlwaysEnd) {
-            return ExitMethod::AlwaysEnd;
-        }
-
-        return ExitMethod::Conditional;
-    }
-
-    /// Scans a range of code for labels and determines the exit method.
-    ExitMethod Scan(u32 begin, u32 end, std::set<u32>& labels) {
-        auto [iter, inserted] =
-            exit_method_map.emplace(std::make_pair(begin, end), ExitMethod::Undetermined);
-        ExitMethod& exit_method = iter->second;
-        if (!inserted)
-            return exit_method;
-
-        for (u32 offset = begin; offset != end && offset != PROGRAM_END; ++offset) {
-            const Instruction instr = {program_code[offset]};
-            switch (instr.opcode.Value()) {
-            case OpCode::Id::END: {
-                return exit_method = ExitMethod::AlwaysEnd;
-            }
-            case OpCode::Id::JMPC:
-            case OpCode::Id::JMPU: {
-                labels.insert(instr.flow_control.dest_offset);
-                ExitMethod no_jmp = Scan(offset + 1, end, labels);
-                ExitMethod jmp = Scan(instr.flow_control.dest_offset, end, labels);
-                return exit_method = ParallelExit(no_jmp, jmp);
-            }
-            case OpCode::Id::CALL: {
-                auto& call = AddSubroutine(instr.flow_control.dest_offset,
-                                           instr.flow_control.dest_offset +
-                                               instr.flow_control.num_instructions);
-                if (call.exit_method == ExitMethod::AlwaysEnd)
-                    return exit_method = ExitMethod::AlwaysEnd;
-                ExitMethod after_call = Scan(offset + 1, end, labels);
-                return exit_method = SeriesExit(call.exit_method, after_call);
-            }
-            case OpCode::Id::LOOP: {
-                auto& loop = AddSubroutine(offset + 1, instr.flow_control.dest_offset + 1);
-                if (loop.exit_method == ExitMethod::AlwaysEnd)
-                    return exit_method = ExitMethod::AlwaysEnd;
-                ExitMethod after_loop = Scan(instr.flow_control.dest_offset + 1, end, labels);
-                return exit_method = SeriesExit(loop.exit_method, after_loop);
-            }
-            case OpCode::Id::CALLC:
-            case OpCode::Id::CALLU: {
-                auto& call = AddSubroutine(instr.flow_control.dest_offset,
-                                           instr.flow_control.dest_offset +
-                                               instr.flow_control.num_instructions);
-                ExitMethod after_call = Scan(offset + 1, end, labels);
-                return exit_method = SeriesExit(
-                           ParallelExit(call.exit_method, ExitMethod::AlwaysReturn), after_call);
-            }
-            case OpCode::Id::IFU:
-            case OpCode::Id::IFC: {
-                auto& if_sub = AddSubroutine(offset + 1, instr.flow_control.dest_offset);
-                ExitMethod else_method;
-                if (instr.flow_control.num_instructions != 0) {
-                    auto& else_sub = AddSubroutine(instr.flow_control.dest_offset,
-                                                   instr.flow_control.dest_offset +
-                                                       instr.flow_control.num_instructions);
-                    else_method = else_sub.exit_method;
-                } else {
-                    else_method = ExitMethod::AlwaysReturn;
-                }
-
-                ExitMethod both = ParallelExit(if_sub.exit_method, else_method);
-                if (both == ExitMethod::AlwaysEnd)
-                    return exit_method = ExitMethod::AlwaysEnd;
-                ExitMethod after_call =
-                    Scan(instr.flow_control.dest_offset + instr.flow_control.num_instructions, end,
-                         labels);
-                return exit_method = SeriesExit(both, after_call);
-            }
-            default:
-                break;
-            }
-        }
-        return exit_method = ExitMethod::AlwaysReturn;
-    }
-};
+/// Most vertices a GLSL geometry shader invocation can emit. Each vertex writes 24 components,
+/// and only 1024 output components per invocation are guaranteed to be available.
+constexpr u32 MAX_GS_OUTPUT_VERTICES = 42;
 
 class ShaderWriter {
 public:
@@ -262,15 +94,440 @@ constexpr auto GetSelectorSrc1 = GetSelectorSrc<&SwizzlePattern::GetSelectorSrc1
 constexpr auto GetSelectorSrc2 = GetSelectorSrc<&SwizzlePattern::GetSelectorSrc2>;
 constexpr auto GetSelectorSrc3 = GetSelectorSrc<&SwizzlePattern::GetSelectorSrc3>;
 
+/**
+ * Checks whether a geometry shader program can run as independent invocations. The PICA shader
+ * unit keeps its registers and emitter state between invocations, so a register read before being
+ * written picks up what the previous invocation left there. This can only be reproduced when no
+ * invocation writes the register at all, which makes the value the same for the whole draw.
+ *
+ * After a host draw, the unit state is recreated by running only the last invocation on the CPU.
+ * That leaves the unit as the whole draw would only if every path writes the same temporary and
+ * output registers, so programs writing them conditionally are rejected as well.
+ */
+class GSStateAnalyzer {
+public:
+    GSStateAnalyzer(const ProgramCode& program_code, const SwizzleData& swizzle_data,
+                    u32 main_offset, const RegGetter& outputreg_getter)
+        : program_code(program_code), swizzle_data(swizzle_data) {
+        for (u32 reg = 0; reg < 16; ++reg) {
+            emitted_outputs[reg] = !outputreg_getter(reg).empty();
+        }
+
+        if (const auto state = Walk(main_offset, PROGRAM_END, State{})) {
+            MergeEnd(*state);
+        }
+
+        if ((read_before_write & written).any()) {
+            throw DecompileFail("Geometry shader carries registers between invocations");
+        }
+        for (std::size_t slot = TEMPORARY; slot < CONDITIONAL_CODE; ++slot) {
+            if (written[slot] && !always_written[slot]) {
+                throw DecompileFail("Geometry shader writes registers conditionally");
+            }
+        }
+        for (std::size_t slot = EMIT_BUFFER; slot < EMIT_BUFFER + 3; ++slot) {
+            if (read_before_write[slot]) {
+                throw DecompileFail("Geometry shader emits vertices of other invocations");
+            }
+        }
+        if (max_prims * 3 > MAX_GS_OUTPUT_VERTICES) {
+            throw DecompileFail("Geometry shader emits too many primitives");
+        }
+    }
+
+    u32 GetMaxVertices() const {
+        return std::max(max_prims, 1U) * 3;
+    }
+
+private:
+    /// Register components and emitter state tracked by the analysis.
+    enum Slot : std::size_t {
+        TEMPORARY = 0,          ///< 16 temporary registers, 4 components each.
+        OUTPUT = 64,            ///< 16 output registers, 4 components each.
+        CONDITIONAL_CODE = 128, ///< The x and y conditional codes.
+        ADDRESS_REGISTER = 130, ///< a0.x, a0.y and aL.
+        EMIT_CONFIG = 133,      ///< Vertex id, primitive and winding flags set by SETEMIT.
+        EMIT_BUFFER = 134,      ///< The three vertex slots of the emitter.
+        NUM_SLOTS = 137,
+    };
+
+    struct State {
+        std::bitset<NUM_SLOTS> written; ///< Slots written on every path reaching this point.
+        s32 vertex_id = -1;             ///< Emitter vertex id, -1 if unknown.
+        s32 prim_emit = -1;             ///< Emitter primitive flag, -1 if unknown.
+        u32 prims = 0;                  ///< Most primitives emitted on a path reaching this point.
+
+        /// Merges the state of a parallel code path.
+        void Merge(const State& other) {
+            written &= other.written;
+            if (vertex_id != other.vertex_id) {
+                vertex_id = -1;
+            }
+            if (prim_emit != other.prim_emit) {
+                prim_emit = -1;
+            }
+            prims = std::max(prims, other.prims);
+        }
+    };
+
+    static std::optional<State> Merge(std::optional<State> a, const std::optional<State>& b) {
+        if (!a) {
+            return b;
+        }
+        if (b) {
+            a->Merge(*b);
+        }
+        return a;
+    }
+
+    /// Merges the state of a path ending the program.
+    void MergeEnd(const State& state) {
+        always_written = ended ? always_written & state.written : state.written;
+        ended = true;
+    }
+
+    void Read(const State& state, std::size_t slot) {
+        if (!state.written[slot]) {
+            read_before_write.set(slot);
+        }
+    }
+
+    void Write(State& state, std::size_t slot) {
+        state.written.set(slot);
+        written.set(slot);
+    }
+
+    void ReadCondition(const State& state, Instruction::FlowControlType flow_control) {
+        using Op = Instruction::FlowControlType::Op;
+        if (flow_control.op.Value() != Op::JustY) {
+            Read(state, CONDITIONAL_CODE);
+        }
+        if (flow_control.op.Value() != Op::JustX) {
+            Read(state, CONDITIONAL_CODE + 1);
+        }
+    }
+
+    /// Marks the components of a source register read by the given lanes.
+    void ReadSource(const State& state, const SourceRegister& source_reg, std::string_view selector,
+                    u32 lanes, u32 address_register_index) {
+        const u32 index = static_cast<u32>(source_reg.GetIndex());
+        switch (source_reg.GetRegisterType()) {
+        case RegisterType::Temporary:
+            for (u32 lane = 0; lane < 4; ++lane) {
+                if (lanes & (1U << lane)) {
+                    const auto component = std::string_view("xyzw").find(selector[lane]);
+                    Read(state, TEMPORARY + index * 4 + component);
+                }
+            }
+            break;
+        case RegisterType::FloatUniform:
+            if (address_register_index != 0) {
+                Read(state, ADDRESS_REGISTER + address_register_index - 1);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void WriteDest(State& state, const DestRegister& dest_reg, u32 lanes) {
+        const u32 index = static_cast<u32>(dest_reg.GetIndex());
+        std::size_t base;
+        switch (dest_reg.GetRegisterType()) {
+        case RegisterType::Output:
+            base = OUTPUT + index * 4;
+            break;
+        case RegisterType::Temporary:
+            base = TEMPORARY + index * 4;
+            break;
+        default:
+            return;
+        }
+        for (u32 lane = 0; lane < 4; ++lane) {
+            if (lanes & (1U << lane)) {
+                Write(state, base + lane);
+            }
+        }
+    }
+
+    void AnalyzeInstr(const Instruction instr, State& state) {
+        const bool is_mad = instr.opcode.Value().GetInfo().type == OpCode::Type::MultiplyAdd;
+        const SwizzlePattern swizzle = {
+            swizzle_data[is_mad ? instr.mad.operand_desc_id : instr.common.operand_desc_id]};
+        u32 dest_lanes = 0;
+        for (u32 lane = 0; lane < 4; ++lane) {
+            dest_lanes |= static_cast<u32>(swizzle.DestComponentEnabled(static_cast<int>(lane)))
+                          << lane;
+        }
+
+        switch (instr.opcode.Value().GetInfo().type) {
+        case OpCode::Type::Arithmetic: {
+            const bool is_inverted =
+                (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+            u32 src1_lanes = dest_lanes;
+            u32 src2_lanes = dest_lanes;
+
+            switch (instr.opcode.Value().EffectiveOpCode()) {
+            case OpCode::Id::ADD:
+            case OpCode::Id::MUL:
+            case OpCode::Id::MAX:
+            case OpCode::Id::MIN:
+            case OpCode::Id::SGE:
+            case OpCode::Id::SGEI:
+            case OpCode::Id::SLT:
+            case OpCode::Id::SLTI:
+                break;
+            case OpCode::Id::DP3:
+                src1_lanes = src2_lanes = 0b0111;
+                break;
+            case OpCode::Id::DP4:
+                src1_lanes = src2_lanes = 0b1111;
+                break;
+            case OpCode::Id::DPH:
+            case OpCode::Id::DPHI:
+                src1_lanes = 0b0111;
+                src2_lanes = 0b1111;
+                break;
+            case OpCode::Id::FLR:
+            case OpCode::Id::MOV:
+                src2_lanes = 0;
+                break;
+            case OpCode::Id::MOVA:
+                src1_lanes = dest_lanes & 0b0011;
+                src2_lanes = 0;
+                break;
+            case OpCode::Id::EX2:
+            case OpCode::Id::LG2:
+            case OpCode::Id::RCP:
+            case OpCode::Id::RSQ:
+                src1_lanes = 0b0001;
+                src2_lanes = 0;
+                break;
+            case OpCode::Id::CMP:
+                src1_lanes = src2_lanes = 0b0011;
+                break;
+            default:
+                throw DecompileFail("Unhandled instruction");
+            }
+
+            ReadSource(state, instr.common.GetSrc1(is_inverted), GetSelectorSrc1(swizzle),
+                       src1_lanes, !is_inverted * instr.common.address_register_index);
+            ReadSource(state, instr.common.GetSrc2(is_inverted), GetSelectorSrc2(swizzle),
+                       src2_lanes, is_inverted * instr.common.address_register_index);
+
+            if (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::CMP) {
+                Write(state, CONDITIONAL_CODE);
+                Write(state, CONDITIONAL_CODE + 1);
+            } else if (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MOVA) {
+                for (u32 lane = 0; lane < 2; ++lane) {
+                    if (dest_lanes & (1U << lane)) {
+                        Write(state, ADDRESS_REGISTER + lane);
+                    }
+                }
+            } else {
+                WriteDest(state, instr.common.dest.Value(), dest_lanes);
+            }
+            break;
+        }
+
+        case OpCode::Type::MultiplyAdd: {
+            if ((instr.opcode.Value().EffectiveOpCode() != OpCode::Id::MAD) &&
+                (instr.opcode.Value().EffectiveOpCode() != OpCode::Id::MADI)) {
+                throw DecompileFail("Unhandled instruction");
+            }
+            const bool is_inverted = (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI);
+            ReadSource(state, instr.mad.GetSrc1(is_inverted), GetSelectorSrc1(swizzle), dest_lanes,
+                       0);
+            ReadSource(state, instr.mad.GetSrc2(is_inverted), GetSelectorSrc2(swizzle), dest_lanes,
+                       !is_inverted * instr.mad.address_register_index);
+            ReadSource(state, instr.mad.GetSrc3(is_inverted), GetSelectorSrc3(swizzle), dest_lanes,
+                       is_inverted * instr.mad.address_register_index);
+            WriteDest(state, instr.mad.dest.Value(), dest_lanes);
+            break;
+        }
+
+        default: {
+            switch (instr.opcode.Value()) {
+            case OpCode::Id::NOP:
+                break;
+
+            case OpCode::Id::SETEMIT:
+                Write(state, EMIT_CONFIG);
+                state.vertex_id = instr.setemit.vertex_id;
+                state.prim_emit = instr.setemit.prim_emit != 0;
+                break;
+
+            case OpCode::Id::EMIT: {
+                Read(state, EMIT_CONFIG);
+                for (u32 reg = 0; reg < 16; ++reg) {
+                    for (u32 comp = 0; emitted_outputs[reg] && comp < 4; ++comp) {
+                        Read(state, OUTPUT + reg * 4 + comp);
+                    }
+                }
+
+                if (state.vertex_id >= 3) {
+                    throw DecompileFail("Geometry shader emits to an invalid vertex slot");
+                } else if (state.vertex_id >= 0) {
+                    Write(state, EMIT_BUFFER + state.vertex_id);
+                } else {
+                    for (u32 i = 0; i < 3; ++i) {
+                        written.set(EMIT_BUFFER + i);
+                    }
+                }
+
+                if (state.prim_emit != 0) {
+                    if (loop_depth != 0) {
+                        throw DecompileFail("Geometry shader emits primitives in a loop");
+                    }
+                    for (u32 i = 0; i < 3; ++i) {
+                        Read(state, EMIT_BUFFER + i);
+                    }
+                    max_prims = std::max(max_prims, ++state.prims);
+                }
+                break;
+            }
+
+            default:
+                throw DecompileFail("Unhandled instruction");
+            }
+            break;
+        }
+        }
+    }
+
+    /**
+     * Follows all code paths from begin to end.
+     * @return the merged state of the paths reaching end, or nothing if all paths run into END.
+     */
+    std::optional<State> Walk(u32 begin, u32 end, std::optional<State> state) {
+        // States of the forward jumps that have not been reached yet
+        std::map<u32, State> jumps;
+
+        u32 offset;
+        for (offset = begin; offset != end && offset != PROGRAM_END; ++offset) {
+            if (const auto it = jumps.find(offset); it != jumps.end()) {
+                state = Merge(std::move(state), it->second);
+                jumps.erase(it);
+            }
+
+            const Instruction instr = {program_code[offset]};
+            switch (instr.opcode.Value()) {
+            case OpCode::Id::END:
+                if (state) {
+                    MergeEnd(*state);
+                }
+                state.reset();
+                break;
+
+            case OpCode::Id::JMPC:
+            case OpCode::Id::JMPU: {
+                const u32 dest = instr.flow_control.dest_offset;
+                if (dest <= offset || dest > end) {
+                    throw DecompileFail("Geometry shader jumps backwards or out of its block");
+                }
+                if (state) {
+                    if (instr.opcode.Value() == OpCode::Id::JMPC) {
+                        ReadCondition(*state, instr.flow_control);
+                    }
+                    auto [it, inserted] = jumps.emplace(dest, *state);
+                    if (!inserted) {
+                        it->second.Merge(*state);
+                    }
+                }
+                break;
+            }
+
+            case OpCode::Id::CALL:
+            case OpCode::Id::CALLC:
+            case OpCode::Id::CALLU: {
+                if (!state) {
+                    break;
+                }
+                if (instr.opcode.Value() == OpCode::Id::CALLC) {
+                    ReadCondition(*state, instr.flow_control);
+                }
+                auto called = Walk(instr.flow_control.dest_offset,
+                                   instr.flow_control.dest_offset +
+                                       instr.flow_control.num_instructions,
+                                   state);
+                if (instr.opcode.Value() == OpCode::Id::CALL) {
+                    state = std::move(called);
+                } else {
+                    state = Merge(std::move(state), called);
+                }
+                break;
+            }
+
+            case OpCode::Id::IFC:
+            case OpCode::Id::IFU: {
+                const u32 else_offset = instr.flow_control.dest_offset;
+                const u32 endif_offset = else_offset + instr.flow_control.num_instructions;
+                if (state) {
+                    if (instr.opcode.Value() == OpCode::Id::IFC) {
+                        ReadCondition(*state, instr.flow_control);
+                    }
+                    auto if_state = Walk(offset + 1, else_offset, state);
+                    auto else_state = instr.flow_control.num_instructions != 0
+                                          ? Walk(else_offset, endif_offset, state)
+                                          : state;
+                    state = Merge(std::move(if_state), else_state);
+                }
+                offset = endif_offset - 1;
+                break;
+            }
+
+            case OpCode::Id::LOOP: {
+                if (state) {
+                    // The loop body always runs at least once
+                    Write(*state, ADDRESS_REGISTER + 2);
+                    ++loop_depth;
+                    state = Walk(offset + 1, instr.flow_control.dest_offset + 1, state);
+                    --loop_depth;
+                }
+                offset = instr.flow_control.dest_offset;
+                break;
+            }
+
+            default:
+                if (state) {
+                    AnalyzeInstr(instr, *state);
+                }
+                break;
+            }
+        }
+
+        if (const auto it = jumps.find(offset); it != jumps.end()) {
+            state = Merge(std::move(state), it->second);
+            jumps.erase(it);
+        }
+        if (!jumps.empty()) {
+            throw DecompileFail("Geometry shader jumps into a nested block");
+        }
+        return state;
+    }
+
+    const ProgramCode& program_code;
+    const SwizzleData& swizzle_data;
+    std::array<bool, 16> emitted_outputs{};
+
+    std::bitset<NUM_SLOTS> written;           ///< Slots written anywhere in the program.
+    std::bitset<NUM_SLOTS> read_before_write; ///< Slots possibly read before being written.
+    std::bitset<NUM_SLOTS> always_written;    ///< Slots written on every path ending the program.
+    bool ended = false;                       ///< Whether any path ends the program.
+    u32 loop_depth = 0;
+    u32 max_prims = 0;
+};
+
 class GLSLGenerator {
 public:
     GLSLGenerator(const std::set<Subroutine>& subroutines, const ProgramCode& program_code,
                   const SwizzleData& swizzle_data, u32 main_offset,
                   const RegGetter& inputreg_getter, const RegGetter& outputreg_getter,
-                  bool sanitize_mul)
+                  const RegGetter& uniformreg_getter, bool sanitize_mul, bool is_gs)
         : subroutines(subroutines), program_code(program_code), swizzle_data(swizzle_data),
           main_offset(main_offset), inputreg_getter(inputreg_getter),
-          outputreg_getter(outputreg_getter), sanitize_mul(sanitize_mul) {
+          outputreg_getter(outputreg_getter), uniformreg_getter(uniformreg_getter),
+          sanitize_mul(sanitize_mul), is_gs(is_gs) {
 
         Generate();
     }
@@ -332,9 +589,18 @@ private:
             return fmt::format("reg_tmp{}", index);
         case RegisterType::FloatUniform:
             if (address_register_index != 0) {
+                if (uniformreg_getter) {
+                    throw DecompileFail("Relative addressing of remapped uniforms");
+                }
                 return fmt::format("get_offset_register({}, address_registers.{})", index,
                                    "xyz"[address_register_index - 1]);
             }
+            if (uniformreg_getter) {
+                std::string uniform = uniformreg_getter(index);
+                if (!uniform.empty()) {
+                    return uniform;
+                }
+            }
             return fmt::format("uniforms.f[{}]", index);
         default:
             UNREACHABLE();
@@ -359,6 +625,13 @@ private:
 
     /// Generates code representing a bool uniform
     std::string GetUniformBool(u32 index, bool invert_test = false) const {
+        if (is_gs && index == 15) {
+            // b15 is set after every geometry shader invocation, so it only holds the uploaded
+            // value in the first invocation of a draw.
+            return fmt::format("(gl_PrimitiveIDIn {} 0 {} (uniforms.b & {}u) {} 0u)",
+                               invert_test ? "==" : "!=", invert_test ? "&&" : "||", 1 << index,
+                               invert_test ? "==" : "!=");
+        }
         return fmt::format("(uniforms.b & {}u) {} 0u", 1 << index, invert_test ? "==" : "!=");
     }
 
@@ -506,15 +779,14 @@ private:
                         dot = fmt::format("dot(vec3({}), vec3({}))", src1, src2);
                     }
                 } else {
+                    const std::string src1_ =
+                        (opcode == OpCode::Id::DPH || opcode == OpCode::Id::DPHI)
+                            ? fmt::format("vec4({}.xyz, 1.0)", src1)
+                            : std::move(src1);
                     if (sanitize_mul) {
-                        const std::string src1_ =
-                            (opcode == OpCode::Id::DPH || opcode == OpCode::Id::DPHI)
-                                ? fmt::format("vec4({}.xyz, 1.0)", src1)
-                                : std::move(src1);
-
                         dot = fmt::format("dot(sanitize_mul({}, {}), vec4(1.0))", src1_, src2);
                     } else {
-                        dot = fmt::format("dot({}, {})", src1, src2);
+                        dot = fmt::format("dot({}, {})", src1_, src2);
                     }
                 }
 
@@ -789,10 +1061,24 @@ private:
                 break;
             }
 
-            case OpCode::Id::EMIT:
-            case OpCode::Id::SETEMIT:
-                LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+            case OpCode::Id::EMIT: {
+                if (!is_gs) {
+                    LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                    break;
+                }
+                shader.AddLine("emit();");
                 break;
+            }
+
+            case OpCode::Id::SETEMIT: {
+                if (!is_gs) {
+                    LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                    break;
+                }
+                shader.AddLine("setemit({}u, {}, {});", instr.setemit.vertex_id.Value(),
+                               instr.setemit.prim_emit != 0, instr.setemit.winding != 0);
+                break;
+            }
 
             default: {
                 LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
@@ -859,6 +1145,14 @@ private:
         // Add the main entry point
         shader.AddLine("bool exec_shader() {{");
         ++shader.scope;
+        if (is_gs) {
+            // Registers hold what the shader unit was left with, see GSStateAnalyzer
+            shader.AddLine("conditional_code = bvec2(uniforms.state.xy);");
+            shader.AddLine("address_registers = uniforms.address_registers.xyz;");
+            for (int i = 0; i < 16; ++i) {
+                shader.AddLine("reg_tmp{0} = uniforms.tmp_regs[{0}];", i);
+            }
+        }
         CallSubroutine(GetSubroutine(main_offset, PROGRAM_END));
         --shader.scope;
         shader.AddLine("}}\n");
@@ -923,7 +1217,9 @@ private:
     const u32 main_offset;
     const RegGetter& inputreg_getter;
     const RegGetter& outputreg_getter;
+    const RegGetter& uniformreg_getter;
     const bool sanitize_mul;
+    const bool is_gs;
 
     ShaderWriter shader;
 };
@@ -933,9 +1229,11 @@ std::string DecompileProgram(const ProgramCode& program_code, const SwizzleData&
                              const RegGetter& outputreg_getter, bool sanitize_mul) {
 
     try {
-        auto subroutines = ControlFlowAnalyzer(program_code, main_offset).MoveSubroutines();
+        auto subroutines = AnalyzeControlFlow(program_code, main_offset);
+        const RegGetter default_uniformreg_getter;
         GLSLGenerator generator(subroutines, program_code, swizzle_data, main_offset,
-                                inputreg_getter, outputreg_getter, sanitize_mul);
+                                inputreg_getter, outputreg_getter, default_uniformreg_getter,
+                                sanitize_mul, false);
         return generator.MoveShaderCode();
     } catch (const DecompileFail& exception) {
         LOG_INFO(HW_GPU, "Shader decompilation failed: {}", exception.what());
@@ -943,4 +1241,23 @@ std::string DecompileProgram(const ProgramCode& program_code, const SwizzleData&
     }
 }
 
+GSDecompileResult DecompileGeometryProgram(const ProgramCode& program_code,
+                                           const SwizzleData& swizzle_data, u32 main_offset,
+                                           const RegGetter& inputreg_getter,
+                                           const RegGetter& outputreg_getter,
+                                           const RegGetter& uniformreg_getter, bool sanitize_mul) {
+
+    try {
+        auto subroutines = AnalyzeControlFlow(program_code, main_offset);
+        const GSStateAnalyzer analyzer(program_code, swizzle_data, main_offset, outputreg_getter);
+        GLSLGenerator generator(subroutines, program_code, swizzle_data, main_offset,
+                                inputreg_getter, outputreg_getter, uniformreg_getter, sanitize_mul,
+                                true);
+        return {generator.MoveShaderCode(), analyzer.GetMaxVertices()};
+    } catch (const DecompileFail& exception) {
+        LOG_INFO(HW_GPU, "Geometry shader decompilation failed: {}", exception.what());
+        return {"", 0};
+    }
+}
+
 } // namespace Pica::Shader::Generator::GLSL
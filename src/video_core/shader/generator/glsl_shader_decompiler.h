@@ -17,4 +17,25 @@ std::string DecompileProgram(const Pica::ProgramCode& program_code,
                              const RegGetter& inputreg_getter, const RegGetter& outputreg_getter,
                              bool sanitize_mul);
 
+/// Result of decompiling a geometry shader program
+struct GSDecompileResult {
+    std::string code; ///< GLSL source of the program, empty on failure
+    u32 max_vertices; ///< Most vertices a single invocation can emit
+};
+
+/**
+ * Decompiles a PICA geometry shader program so that each invocation can run as an independent GLSL
+ * geometry shader invocation. EMIT and SETEMIT become calls to emit() and setemit(vertex_id, prim,
+ * winding), which the caller must define. Registers start from the values in the uniform block,
+ * which hold the state the PICA shader unit was left in. Programs that read a register which an
+ * earlier invocation may have written are rejected, since invocations do not run in order.
+ * @param uniformreg_getter returns the GLSL expression of a float uniform, or an empty string to
+ * read it from the uniform block
+ */
+GSDecompileResult DecompileGeometryProgram(const Pica::ProgramCode& program_code,
+                                           const Pica::SwizzleData& swizzle_data, u32 main_offset,
+                                           const RegGetter& inputreg_getter,
+                                           const RegGetter& outputreg_getter,
+                                           const RegGetter& uniformreg_getter, bool sanitize_mul);
+
 } // namespace Pica::Shader::Generator::GLSL
@@ -26,6 +26,19 @@ layout (binding = 0, std140) uniform vs_pica_data {
 } uniforms;
 )";
 
+constexpr std::string_view GSPicaUniformBlockDef = R"(
+layout (binding = 3, std140) uniform gs_pica_data {
+    uint b;
+    uvec4 i[4];
+    vec4 f[96];
+    vec4 in_regs[16];
+    vec4 tmp_regs[16];
+    vec4 out_regs[16];
+    ivec4 address_registers;
+    uvec4 state;
+} uniforms;
+)";
+
 constexpr std::string_view VSUniformBlockDef = R"(
 #ifdef VULKAN
 layout (set = 0, binding = 1, std140) uniform vs_data {
@@ -388,6 +401,147 @@ void EmitPrim(Vertex vtx0, Vertex vtx1, Vertex vtx2) {
     return out;
 };
 
+std::string GenerateGeometryShader(const ShaderSetup& setup, const PicaProgrammableGSConfig& config,
+                                   bool separable_shader) {
+    const auto& state = config.state;
+    const u32 vs_output_num = state.gs_state.vs_output_attributes;
+
+    std::string_view input_primitive;
+    switch (state.vertices_per_invocation) {
+    case 1:
+        input_primitive = "points";
+        break;
+    case 2:
+        input_primitive = "lines";
+        break;
+    case 3:
+        input_primitive = "triangles";
+        break;
+    case 4:
+        input_primitive = "lines_adjacency";
+        break;
+    case 6:
+        input_primitive = "triangles_adjacency";
+        break;
+    default:
+        return "";
+    }
+    if (state.num_outputs == 0) {
+        return "";
+    }
+
+    // Each GL invocation receives the vertices of one PICA invocation, in input register or
+    // uniform order.
+    const auto get_vertex_attribute = [vs_output_num](u32 attr) {
+        return fmt::format("vs_out_attr{}[{}]", attr % vs_output_num, attr / vs_output_num);
+    };
+
+    const auto get_input_reg = [&](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        if (state.input_map[reg] < 16) {
+            return get_vertex_attribute(state.input_map[reg]);
+        }
+        return fmt::format("uniforms.in_regs[{}]", reg);
+    };
+
+    const auto get_output_reg = [&](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        if (state.output_map[reg] < state.num_outputs) {
+            return fmt::format("gs_out_reg{}", reg);
+        }
+        return "";
+    };
+
+    RegGetter get_uniform_reg;
+    if (state.uniform_input) {
+        get_uniform_reg = [&](u32 index) -> std::string {
+            const u32 num_uniforms = vs_output_num * state.vertices_per_invocation;
+            if (index < state.uniform_input_start ||
+                index - state.uniform_input_start >= num_uniforms) {
+                return "";
+            }
+            return get_vertex_attribute(index - state.uniform_input_start);
+        };
+    }
+
+    const auto program = DecompileGeometryProgram(setup.program_code, setup.swizzle_data,
+                                                  state.main_offset, get_input_reg, get_output_reg,
+                                                  get_uniform_reg, state.sanitize_mul);
+    if (program.code.empty()) {
+        return "";
+    }
+
+    std::string out;
+    if (separable_shader) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+
+    out += fmt::format("layout({}) in;\n", input_primitive);
+    out += fmt::format("layout(triangle_strip, max_vertices = {}) out;\n", program.max_vertices);
+    out += GSPicaUniformBlockDef;
+    out += GetGSCommonSource(state.gs_state, separable_shader);
+
+    out += '\n';
+    for (u32 reg = 0; reg < 16; ++reg) {
+        if (state.output_map[reg] < state.num_outputs) {
+            out += fmt::format("vec4 gs_out_reg{};\n", reg);
+        }
+    }
+
+    out += R"(
+uint emit_vertex_id;
+bool emit_prim;
+bool emit_winding;
+Vertex emit_buffer[3];
+
+void setemit(uint vertex_id, bool prim, bool winding) {
+    emit_vertex_id = vertex_id;
+    emit_prim = prim;
+    emit_winding = winding;
+}
+
+void emit() {
+    if (emit_vertex_id < 3u) {
+)";
+    out += fmt::format("        emit_buffer[emit_vertex_id].attributes = vec4[{}](",
+                       state.num_outputs);
+    for (u32 reg = 0, i = 0; reg < 16; ++reg) {
+        if (state.output_map[reg] < state.num_outputs) {
+            out += fmt::format("{}gs_out_reg{}", i++ == 0 ? "" : ", ", reg);
+        }
+    }
+    out += ");\n";
+    out += R"(    }
+    if (emit_prim) {
+        if (emit_winding) {
+            EmitPrim(emit_buffer[1], emit_buffer[0], emit_buffer[2]);
+        } else {
+            EmitPrim(emit_buffer[0], emit_buffer[1], emit_buffer[2]);
+        }
+    }
+}
+
+)";
+
+    out += program.code;
+
+    out += R"(
+void main() {
+    emit_vertex_id = uniforms.state.z;
+    emit_prim = (uniforms.state.w & 1u) != 0u;
+    emit_winding = (uniforms.state.w & 2u) != 0u;
+)";
+    for (u32 reg = 0; reg < 16; ++reg) {
+        if (state.output_map[reg] < state.num_outputs) {
+            out += fmt::format("    gs_out_reg{0} = uniforms.out_regs[{0}];\n", reg);
+        }
+    }
+    out += "    exec_shader();\n";
+    out += "}\n";
+
+    return out;
+}
+
 std::string GenerateFixedGeometryShader(const PicaFixedGSConfig& config, bool separable_shader) {
     std::string out;
     if (separable_shader) {
@@ -27,6 +27,7 @@ struct ShaderSetup;
 
 namespace Pica::Shader::Generator {
 struct PicaVSConfig;
+struct PicaProgrammableGSConfig;
 struct PicaFixedGSConfig;
 } // namespace Pica::Shader::Generator
 
@@ -46,6 +47,13 @@ std::string GenerateTrivialVertexShader(bool use_clip_planes, bool separable_sha
 std::string GenerateVertexShader(const Pica::ShaderSetup& setup, const PicaVSConfig& config,
                                  bool separable_shader);
 
+/**
+ * Generates the GLSL geometry shader program source code for the given GS program
+ * @returns String of the shader source code; empty on failure
+ */
+std::string GenerateGeometryShader(const Pica::ShaderSetup& setup,
+                                   const PicaProgrammableGSConfig& config, bool separable_shader);
+
 /**
  * Generates the GLSL fixed geometry shader program source code for non-GS PICA pipeline
  * @returns String of the shader source code
@@ -59,11 +59,50 @@ void PicaVSConfigState::Init(const Pica::RegsInternal& regs, Pica::ShaderSetup&
     }
 }
 
+void PicaProgrammableGSConfigState::Init(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup,
+                                         bool use_clip_planes_, bool accurate_mul_) {
+    program_hash = setup.GetProgramCodeHash();
+    swizzle_hash = setup.GetSwizzleDataHash();
+    main_offset = regs.gs.main_offset;
+    sanitize_mul = accurate_mul_;
+
+    const u32 vs_output_num = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+    input_map.fill(16);
+    uniform_input = regs.pipeline.gs_config.mode == PipelineRegs::GSMode::FixedPrimitive;
+    if (uniform_input) {
+        vertices_per_invocation = regs.pipeline.gs_config.fixed_vertex_num_minus_1 + 1;
+        uniform_input_start = regs.pipeline.gs_config.start_index;
+    } else {
+        const u32 gs_input_num = regs.gs.max_input_attribute_index + 1;
+        vertices_per_invocation = gs_input_num / vs_output_num;
+        uniform_input_start = 0;
+        for (u32 attr = 0; attr < gs_input_num; ++attr) {
+            input_map[regs.gs.GetRegisterForAttribute(attr)] = attr;
+        }
+    }
+
+    num_outputs = 0;
+    output_map.fill(16);
+    for (u32 reg : Common::BitSet<u32>(regs.gs.output_mask)) {
+        output_map[reg] = num_outputs++;
+    }
+
+    gs_state.Init(regs, use_clip_planes_);
+    gs_state.vs_output_attributes = vs_output_num;
+    gs_state.gs_output_attributes = num_outputs;
+}
+
 PicaVSConfig::PicaVSConfig(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup,
                            bool use_clip_planes_, bool use_geometry_shader_, bool accurate_mul_) {
     state.Init(regs, setup, use_clip_planes_, use_geometry_shader_, accurate_mul_);
 }
 
+PicaProgrammableGSConfig::PicaProgrammableGSConfig(const Pica::RegsInternal& regs,
+                                                   Pica::ShaderSetup& setup,
+                                                   bool use_clip_planes_, bool accurate_mul_) {
+    state.Init(regs, setup, use_clip_planes_, accurate_mul_);
+}
+
 PicaFixedGSConfig::PicaFixedGSConfig(const Pica::RegsInternal& regs, bool use_clip_planes_) {
     state.Init(regs, use_clip_planes_);
 }
@@ -86,6 +86,35 @@ struct PicaVSConfigState {
     PicaGSConfigState gs_state;
 };
 
+/**
+ * This struct contains information to identify a GLSL geometry shader translated from a PICA
+ * geometry shader program.
+ */
+struct PicaProgrammableGSConfigState {
+    void Init(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup, bool use_clip_planes_,
+              bool accurate_mul_);
+
+    u64 program_hash;
+    u64 swizzle_hash;
+    u32 main_offset;
+    bool sanitize_mul;
+
+    // Whether vertices are received in float uniforms (FixedPrimitive mode) instead of input
+    // registers (Point mode)
+    bool uniform_input;
+    u32 vertices_per_invocation;
+    u32 uniform_input_start;
+
+    // input_map[input register index] -> input attribute index, 16 if it is not loaded
+    std::array<u32, 16> input_map;
+
+    u32 num_outputs;
+    // output_map[output register index] -> output attribute index
+    std::array<u32, 16> output_map;
+
+    PicaGSConfigState gs_state;
+};
+
 /**
  * This struct contains information to identify a GL vertex shader generated from PICA vertex
  * shader.
@@ -95,6 +124,15 @@ struct PicaVSConfig : Common::HashableStruct<PicaVSConfigState> {
                           bool use_clip_planes_, bool use_geometry_shader_, bool accurate_mul_);
 };
 
+/**
+ * This struct contains information to identify a GL geometry shader generated from PICA geometry
+ * shader.
+ */
+struct PicaProgrammableGSConfig : Common::HashableStruct<PicaProgrammableGSConfigState> {
+    explicit PicaProgrammableGSConfig(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup,
+                                      bool use_clip_planes_, bool accurate_mul_);
+};
+
 /**
  * This struct contains information to identify a GL geometry shader generated from PICA no-geometry
  * shader pipeline
@@ -113,6 +151,14 @@ struct hash<Pica::Shader::Generator::PicaVSConfig> {
     }
 };
 
+template <>
+struct hash<Pica::Shader::Generator::PicaProgrammableGSConfig> {
+    std::size_t operator()(
+        const Pica::Shader::Generator::PicaProgrammableGSConfig& k) const noexcept {
+        return k.Hash();
+    }
+};
+
 template <>
 struct hash<Pica::Shader::Generator::PicaFixedGSConfig> {
     std::size_t operator()(const Pica::Shader::Generator::PicaFixedGSConfig& k) const noexcept {
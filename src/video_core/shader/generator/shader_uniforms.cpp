@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include "video_core/pica/shader_setup.h"
+#include "video_core/pica/shader_unit.h"
 #include "video_core/shader/generator/shader_uniforms.h"
 
 namespace Pica::Shader::Generator {
@@ -23,4 +25,42 @@ void VSPicaUniformData::SetFromRegs(const Pica::ShaderSetup& setup) {
     }
 }
 
+void VSPicaUniformData::SetFloatUniformsFromRegs(const Pica::ShaderSetup& setup, u32 begin,
+                                                 u32 end) {
+    // f24 values are kept as 32-bit floats, so they can be copied as they are.
+    static_assert(sizeof(Common::Vec4<Pica::f24>) == sizeof(Common::Vec4f));
+    std::memcpy(&f[begin], &setup.uniforms.f[begin], (end - begin) * sizeof(Common::Vec4f));
+}
+
+void GSPicaUniformData::SetFromRegs(const Pica::ShaderSetup& setup,
+                                    const Pica::GeometryShaderUnit& unit) {
+    const auto to_float = [](const Common::Vec4<f24>& value) {
+        return Common::MakeVec<f32>(value.x.ToFloat32(), value.y.ToFloat32(), value.z.ToFloat32(),
+                                    value.w.ToFloat32());
+    };
+
+    b = 0;
+    for (u32 j = 0; j < setup.uniforms.b.size(); j++) {
+        b |= setup.uniforms.b[j] << j;
+    }
+    for (u32 j = 0; j < setup.uniforms.i.size(); j++) {
+        const auto& value = setup.uniforms.i[j];
+        i[j] = Common::MakeVec<u32>(value.x, value.y, value.z, value.w);
+    }
+    for (u32 j = 0; j < setup.uniforms.f.size(); j++) {
+        f[j] = to_float(setup.uniforms.f[j]);
+    }
+    for (u32 j = 0; j < 16; j++) {
+        in_regs[j] = to_float(unit.input[j]);
+        tmp_regs[j] = to_float(unit.temporary[j]);
+        out_regs[j] = to_float(unit.output[j]);
+    }
+    address_registers = Common::MakeVec<s32>(unit.address_registers[0],
+                                             unit.address_registers[1],
+                                             unit.address_registers[2], 0);
+    state = Common::MakeVec<u32>(unit.conditional_code[0], unit.conditional_code[1],
+                                 unit.emitter.vertex_id,
+                                 unit.emitter.prim_emit | (unit.emitter.winding << 1));
+}
+
 } // namespace Pica::Shader::Generator
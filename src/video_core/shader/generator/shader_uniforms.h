@@ -8,6 +8,7 @@
 #include "video_core/pica/regs_lighting.h"
 
 namespace Pica {
+struct GeometryShaderUnit;
 struct ShaderSetup;
 } // namespace Pica
 
@@ -85,6 +86,9 @@ static_assert(sizeof(VSUniformData) < 16384,
 struct VSPicaUniformData {
     void SetFromRegs(const ShaderSetup& setup);
 
+    /// Only updates the float uniforms [begin, end).
+    void SetFloatUniformsFromRegs(const ShaderSetup& setup, u32 begin, u32 end);
+
     u32 b;
     alignas(16) std::array<Common::Vec4u, 4> i;
     alignas(16) std::array<Common::Vec4f, 96> f;
@@ -94,4 +98,26 @@ static_assert(sizeof(VSPicaUniformData) == 1616,
 static_assert(sizeof(VSPicaUniformData) < 16384,
               "VSPicaUniformData structure must be less than 16kb as per the OpenGL spec");
 
+/**
+ * Uniform struct for the Uniform Buffer Object that contains PICA geometry shader uniforms, along
+ * with the registers the geometry shader unit keeps between invocations.
+ * NOTE: the same rule from UniformData also applies here.
+ */
+struct GSPicaUniformData {
+    void SetFromRegs(const ShaderSetup& setup, const GeometryShaderUnit& unit);
+
+    u32 b;
+    alignas(16) std::array<Common::Vec4u, 4> i;
+    alignas(16) std::array<Common::Vec4f, 96> f;
+    alignas(16) std::array<Common::Vec4f, 16> in_regs;
+    alignas(16) std::array<Common::Vec4f, 16> tmp_regs;
+    alignas(16) std::array<Common::Vec4f, 16> out_regs;
+    alignas(16) Common::Vec4i address_registers;
+    alignas(16) Common::Vec4u state; // Conditional codes, emit vertex id, emit prim | winding << 1
+};
+static_assert(sizeof(GSPicaUniformData) == 2416,
+              "The size of the GSPicaUniformData does not match the structure in the shader");
+static_assert(sizeof(GSPicaUniformData) < 16384,
+              "GSPicaUniformData structure must be less than 16kb as per the OpenGL spec");
+
 } // namespace Pica::Shader::Generator
@@ -0,0 +1,1280 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <iterator>
+#include <map>
+#include <set>
+#include <vector>
+#include <fmt/format.h>
+#include <nihstro/shader_bytecode.h>
+#include <sirit/sirit.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "video_core/pica/regs_rasterizer.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/shader_control_flow.h"
+#include "video_core/shader/generator/shader_gen.h"
+#include "video_core/shader/generator/spv_fs_shader_gen.h"
+#include "video_core/shader/generator/spv_vs_shader_gen.h"
+
+namespace Pica::Shader::Generator::SPIRV {
+
+using nihstro::DestRegister;
+using nihstro::Instruction;
+using nihstro::OpCode;
+using nihstro::RegisterType;
+using nihstro::SourceRegister;
+using nihstro::SwizzlePattern;
+using Sirit::Id;
+using VSOutputAttributes = Pica::RasterizerRegs::VSOutputAttributes;
+
+constexpr u32 SPIRV_VERSION_1_3 = 0x00010300;
+
+namespace {
+
+/// Returns the register component read by each lane of a source operand.
+template <SwizzlePattern::Selector (SwizzlePattern::*getter)(int) const>
+std::array<u32, 4> GetSelector(const SwizzlePattern& pattern) {
+    std::array<u32, 4> out;
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<u32>((pattern.*getter)(i));
+    }
+    return out;
+}
+
+constexpr auto GetSelectorSrc1 = GetSelector<&SwizzlePattern::GetSelectorSrc1>;
+constexpr auto GetSelectorSrc2 = GetSelector<&SwizzlePattern::GetSelectorSrc2>;
+constexpr auto GetSelectorSrc3 = GetSelector<&SwizzlePattern::GetSelectorSrc3>;
+
+/**
+ * Translates a PICA vertex shader program to SPIR-V. The program is structured the same way as in
+ * the GLSL decompiler: each subroutine becomes a function returning whether the program ended, and
+ * subroutines containing jumps dispatch their code blocks from a loop over a switch.
+ */
+class VertexModule : public Sirit::Module {
+    static constexpr u32 NUM_REGS = 16;
+
+public:
+    explicit VertexModule(const std::set<Subroutine>& subroutines, const ShaderSetup& setup,
+                          const PicaVSConfig& config)
+        : Sirit::Module{SPIRV_VERSION_1_3}, subroutines{subroutines},
+          program_code{setup.program_code}, swizzle_data{setup.swizzle_data},
+          state{config.state} {
+        DefineArithmeticTypes();
+        DefineUniformStructs();
+        DefineInterface();
+    }
+
+    /// Emits SPIR-V bytecode corresponding to the PICA vertex shader program
+    void Generate() {
+        const Subroutine& program_main = GetSubroutine(state.main_offset, PROGRAM_END);
+        DefineSubroutines(program_main);
+        DefineEntryPoint(subroutine_funcs.at(&program_main));
+    }
+
+private:
+    /// Gets the Subroutine object corresponding to the specified address.
+    const Subroutine& GetSubroutine(u32 begin, u32 end) const {
+        const auto iter = subroutines.find(Subroutine{begin, end});
+        ASSERT(iter != subroutines.end());
+        return *iter;
+    }
+
+    /**
+     * Returns the offset of the instruction compiled after the one at offset. Usually it is the
+     * current offset + 1. If the instruction is IF or LOOP, the next instruction is after the IF
+     * or LOOP block. If the instruction always terminates the program, returns PROGRAM_END.
+     */
+    u32 NextOffset(u32 offset) const {
+        const Instruction instr = {program_code[offset]};
+        switch (instr.opcode.Value()) {
+        case OpCode::Id::END:
+            return PROGRAM_END;
+
+        case OpCode::Id::CALL: {
+            const Subroutine& call_sub = GetSubroutine(
+                instr.flow_control.dest_offset,
+                instr.flow_control.dest_offset + instr.flow_control.num_instructions);
+            return call_sub.exit_method == ExitMethod::AlwaysEnd ? PROGRAM_END : offset + 1;
+        }
+
+        case OpCode::Id::IFC:
+        case OpCode::Id::IFU: {
+            const u32 else_offset = instr.flow_control.dest_offset;
+            const u32 endif_offset = else_offset + instr.flow_control.num_instructions;
+            if (instr.flow_control.num_instructions == 0) {
+                return else_offset;
+            }
+            const Subroutine& if_sub = GetSubroutine(offset + 1, else_offset);
+            const Subroutine& else_sub = GetSubroutine(else_offset, endif_offset);
+            if (if_sub.exit_method == ExitMethod::AlwaysEnd &&
+                else_sub.exit_method == ExitMethod::AlwaysEnd) {
+                return PROGRAM_END;
+            }
+            return endif_offset;
+        }
+
+        case OpCode::Id::LOOP: {
+            const Subroutine& loop_sub =
+                GetSubroutine(offset + 1, instr.flow_control.dest_offset + 1);
+            return loop_sub.exit_method == ExitMethod::AlwaysEnd
+                       ? PROGRAM_END
+                       : instr.flow_control.dest_offset + 1;
+        }
+
+        default:
+            return offset + 1;
+        }
+    }
+
+    /// Returns the offset after the last instruction compiled from the given range.
+    u32 SkipRange(u32 begin, u32 end) const {
+        u32 program_counter;
+        for (program_counter = begin; program_counter < (begin > end ? PROGRAM_END : end);) {
+            program_counter = NextOffset(program_counter);
+        }
+        return program_counter;
+    }
+
+    /**
+     * Returns the offsets at which the code of a subroutine is split into blocks. Besides the jump
+     * targets, a block starts after every IF or LOOP that contains a jump target.
+     */
+    std::set<u32> GetBlockLabels(const Subroutine& subroutine) const {
+        std::set<u32> labels = subroutine.labels;
+        labels.insert(subroutine.begin);
+        for (auto it = labels.begin(); it != labels.end(); ++it) {
+            const auto next_it = std::next(it);
+            const u32 next_label = next_it == labels.end() ? subroutine.end : *next_it;
+            const u32 block_end = SkipRange(*it, next_label);
+            if (block_end > next_label && block_end != PROGRAM_END) {
+                labels.insert(block_end);
+            }
+        }
+        return labels;
+    }
+
+    /// Returns the subroutines called by the code compiled for a subroutine.
+    std::vector<const Subroutine*> GetCallees(const Subroutine& subroutine) const {
+        std::vector<const Subroutine*> callees;
+        const std::set<u32> labels = GetBlockLabels(subroutine);
+        for (auto it = labels.begin(); it != labels.end(); ++it) {
+            const auto next_it = std::next(it);
+            const u32 next_label = next_it == labels.end() ? subroutine.end : *next_it;
+            for (u32 offset = *it; offset < (*it > next_label ? PROGRAM_END : next_label);
+                 offset = NextOffset(offset)) {
+                const Instruction instr = {program_code[offset]};
+                const u32 dest_offset = instr.flow_control.dest_offset;
+                const u32 num_instructions = instr.flow_control.num_instructions;
+                switch (instr.opcode.Value()) {
+                case OpCode::Id::CALL:
+                case OpCode::Id::CALLC:
+                case OpCode::Id::CALLU:
+                    callees.push_back(&GetSubroutine(dest_offset, dest_offset + num_instructions));
+                    break;
+                case OpCode::Id::IFC:
+                case OpCode::Id::IFU:
+                    callees.push_back(&GetSubroutine(offset + 1, dest_offset));
+                    if (num_instructions != 0) {
+                        callees.push_back(
+                            &GetSubroutine(dest_offset, dest_offset + num_instructions));
+                    }
+                    break;
+                case OpCode::Id::LOOP:
+                    callees.push_back(&GetSubroutine(offset + 1, dest_offset + 1));
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+        return callees;
+    }
+
+    /// Defines the functions of a subroutine and all subroutines it calls, callees first.
+    void DefineSubroutines(const Subroutine& subroutine) {
+        const auto [it, inserted] = subroutine_funcs.try_emplace(&subroutine);
+        if (!inserted) {
+            if (!Sirit::ValidId(it->second)) {
+                throw DecompileFail("Recursive function detected");
+            }
+            return;
+        }
+        for (const Subroutine* callee : GetCallees(subroutine)) {
+            DefineSubroutines(*callee);
+        }
+        subroutine_funcs[&subroutine] = DefineSubroutine(subroutine);
+    }
+
+    /// Defines the function of a single subroutine.
+    Id DefineSubroutine(const Subroutine& subroutine) {
+        const Id func{
+            OpFunction(bool_id, spv::FunctionControlMask::MaskNone, TypeFunction(bool_id))};
+        Name(func, subroutine.GetName());
+        AddLabel(OpLabel());
+
+        if (subroutine.labels.empty()) {
+            jmp_to_id = Id{};
+            if (CompileRange(subroutine.begin, subroutine.end) != PROGRAM_END) {
+                OpReturnValue(false_id);
+            }
+            OpFunctionEnd();
+            return func;
+        }
+
+        jmp_to_id = DefineVar<false>(u32_id, spv::StorageClass::Function);
+        OpStore(jmp_to_id, ConstU32(subroutine.begin));
+
+        const std::set<u32> labels = GetBlockLabels(subroutine);
+        std::vector<Sirit::Literal> literals;
+        std::vector<Id> block_labels;
+        for (const u32 label : labels) {
+            literals.push_back(label);
+            block_labels.push_back(OpLabel());
+        }
+
+        const Id loop_header{OpLabel()};
+        const Id dispatch_label{OpLabel()};
+        const Id default_label{OpLabel()};
+        const Id continue_label{OpLabel()};
+        const Id loop_merge{OpLabel()};
+        dispatch_merge = OpLabel();
+
+        OpBranch(loop_header);
+        AddLabel(loop_header);
+        OpLoopMerge(loop_merge, continue_label, spv::LoopControlMask::MaskNone);
+        OpBranch(dispatch_label);
+
+        AddLabel(dispatch_label);
+        OpSelectionMerge(dispatch_merge, spv::SelectionControlMask::MaskNone);
+        OpSwitch(OpLoad(u32_id, jmp_to_id), default_label, literals, block_labels);
+
+        auto label_it = labels.begin();
+        for (std::size_t i = 0; i < block_labels.size(); ++i, ++label_it) {
+            AddLabel(block_labels[i]);
+
+            const bool is_last = i + 1 == block_labels.size();
+            const u32 next_label = is_last ? subroutine.end : *std::next(label_it);
+            const u32 compile_end = CompileRange(*label_it, next_label);
+            if (compile_end == PROGRAM_END) {
+                continue;
+            }
+            if (compile_end > next_label) {
+                // This happens only when there is a label inside a IF/LOOP block
+                OpStore(jmp_to_id, ConstU32(compile_end));
+                OpBranch(dispatch_merge);
+            } else if (is_last) {
+                OpReturnValue(false_id);
+            } else {
+                // Fall through to the next block
+                OpBranch(block_labels[i + 1]);
+            }
+        }
+
+        AddLabel(default_label);
+        OpReturnValue(false_id);
+
+        AddLabel(dispatch_merge);
+        OpBranch(continue_label);
+
+        AddLabel(continue_label);
+        OpBranch(loop_header);
+
+        AddLabel(loop_merge);
+        OpUnreachable();
+
+        OpFunctionEnd();
+        return func;
+    }
+
+    /**
+     * Compiles a range of instructions from PICA to SPIR-V.
+     * @param begin the offset of the starting instruction.
+     * @param end the offset where the compilation should stop (exclusive).
+     * @return the offset of the next instruction to compile. PROGRAM_END if the program
+     * terminates, in which case the current block has been closed.
+     */
+    u32 CompileRange(u32 begin, u32 end) {
+        u32 program_counter;
+        for (program_counter = begin; program_counter < (begin > end ? PROGRAM_END : end);) {
+            program_counter = CompileInstr(program_counter);
+        }
+        return program_counter;
+    }
+
+    /**
+     * Adds code that calls a subroutine.
+     * @return false if the call always ends the program, which closes the current block.
+     */
+    bool CallSubroutine(const Subroutine& subroutine) {
+        const Id result{OpFunctionCall(bool_id, subroutine_funcs.at(&subroutine))};
+        switch (subroutine.exit_method) {
+        case ExitMethod::AlwaysEnd:
+            OpReturnValue(true_id);
+            return false;
+        case ExitMethod::Conditional: {
+            const Id end_label{OpLabel()};
+            const Id merge_label{OpLabel()};
+            OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+            OpBranchConditional(result, end_label, merge_label);
+            AddLabel(end_label);
+            OpReturnValue(true_id);
+            AddLabel(merge_label);
+            return true;
+        }
+        default:
+            return true;
+        }
+    }
+
+    /// Emits a call of the subroutine that only happens when condition holds.
+    void CallSubroutineIf(Id condition, const Subroutine& subroutine) {
+        const Id call_label{OpLabel()};
+        const Id merge_label{OpLabel()};
+        OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+        OpBranchConditional(condition, call_label, merge_label);
+        AddLabel(call_label);
+        if (CallSubroutine(subroutine)) {
+            OpBranch(merge_label);
+        }
+        AddLabel(merge_label);
+    }
+
+    /// Generates condition evaluation code for the flow control instruction.
+    Id EvaluateCondition(Instruction::FlowControlType flow_control) {
+        using Op = Instruction::FlowControlType::Op;
+
+        const Id conditional_code{OpLoad(bvec_ids.Get(2), conditional_code_id)};
+        const auto result = [&](u32 component, bool ref) {
+            const Id value{OpCompositeExtract(bool_id, conditional_code, component)};
+            return ref ? value : OpLogicalNot(bool_id, value);
+        };
+
+        switch (flow_control.op) {
+        case Op::JustX:
+            return result(0, flow_control.refx.Value());
+        case Op::JustY:
+            return result(1, flow_control.refy.Value());
+        case Op::Or:
+            return OpLogicalOr(bool_id, result(0, flow_control.refx.Value()),
+                               result(1, flow_control.refy.Value()));
+        case Op::And:
+            return OpLogicalAnd(bool_id, result(0, flow_control.refx.Value()),
+                                result(1, flow_control.refy.Value()));
+        default:
+            UNREACHABLE();
+            return {};
+        }
+    }
+
+    /// Generates code representing a bool uniform
+    Id GetUniformBool(u32 index, bool invert_test = false) {
+        const Id b{GetPicaUniform(u32_id, ConstS32(0))};
+        const Id masked{OpBitwiseAnd(u32_id, b, ConstU32(1U << index))};
+        return invert_test ? OpIEqual(bool_id, masked, ConstU32(0U))
+                           : OpINotEqual(bool_id, masked, ConstU32(0U));
+    }
+
+    /// Returns the private copy of an input register, which main fills from the vertex input.
+    Id GetInputRegister(u32 index) {
+        ASSERT(index < NUM_REGS);
+        if (!Sirit::ValidId(input_reg_ids[index])) {
+            input_reg_ids[index] = DefineVar(vec_ids.Get(4), spv::StorageClass::Private);
+            Name(input_reg_ids[index], fmt::format("vs_in_reg{}", index));
+        }
+        return input_reg_ids[index];
+    }
+
+    /// Reads a float uniform at base_index offset by an address register.
+    Id GetOffsetUniform(u32 base_index, u32 address_register_index) {
+        const Id offset{OpCompositeExtract(i32_id, OpLoad(ivec_ids.Get(3), address_registers_id),
+                                           address_register_index)};
+        const Id in_range{
+            OpLogicalAnd(bool_id, OpSGreaterThanEqual(bool_id, offset, ConstS32(-128)),
+                         OpSLessThanEqual(bool_id, offset, ConstS32(127)))};
+        const Id fixed_offset{OpSelect(i32_id, in_range, offset, ConstS32(0))};
+        const Id index{OpBitcast(
+            u32_id, OpBitwiseAnd(i32_id, OpIAdd(i32_id, ConstS32(static_cast<s32>(base_index)),
+                                                fixed_offset),
+                                 ConstS32(0x7F)))};
+        const Id is_valid{OpULessThan(bool_id, index, ConstU32(96U))};
+        const Id safe_index{OpSelect(u32_id, is_valid, index, ConstU32(0U))};
+        const Id value{GetPicaUniform(vec_ids.Get(4), ConstS32(2), safe_index)};
+        const Id is_valid_vec{
+            OpCompositeConstruct(bvec_ids.Get(4), is_valid, is_valid, is_valid, is_valid)};
+        return OpSelect(vec_ids.Get(4), is_valid_vec, value, ConstF32(1.f, 1.f, 1.f, 1.f));
+    }
+
+    /// Generates code representing a source register.
+    Id GetSourceRegister(const SourceRegister& source_reg, u32 address_register_index) {
+        const u32 index = static_cast<u32>(source_reg.GetIndex());
+
+        switch (source_reg.GetRegisterType()) {
+        case RegisterType::Input:
+            return OpLoad(vec_ids.Get(4), GetInputRegister(index));
+        case RegisterType::Temporary:
+            return OpLoad(vec_ids.Get(4), tmp_reg_ids[index]);
+        case RegisterType::FloatUniform:
+            if (address_register_index != 0) {
+                return GetOffsetUniform(index, address_register_index - 1);
+            }
+            return GetPicaUniform(vec_ids.Get(4), ConstS32(2), ConstS32(static_cast<s32>(index)));
+        default:
+            UNREACHABLE();
+            return {};
+        }
+    }
+
+    /// Generates code representing a swizzled and possibly negated source operand.
+    Id GetSource(const SourceRegister& source_reg, u32 address_register_index,
+                 const std::array<u32, 4>& selector, bool negate) {
+        Id value{GetSourceRegister(source_reg, address_register_index)};
+        if (selector != std::array<u32, 4>{0, 1, 2, 3}) {
+            value = OpVectorShuffle(vec_ids.Get(4), value, value, selector[0], selector[1],
+                                    selector[2], selector[3]);
+        }
+        return negate ? OpFNegate(vec_ids.Get(4), value) : value;
+    }
+
+    /// Generates code representing a destination register, invalid if the writes are dropped.
+    Id GetDestRegister(const DestRegister& dest_reg) const {
+        const u32 index = static_cast<u32>(dest_reg.GetIndex());
+
+        switch (dest_reg.GetRegisterType()) {
+        case RegisterType::Output:
+            return state.output_map[index] < state.num_outputs
+                       ? output_attr_ids[state.output_map[index]]
+                       : Id{};
+        case RegisterType::Temporary:
+            return tmp_reg_ids[index];
+        default:
+            return Id{};
+        }
+    }
+
+    /**
+     * Writes code that stores the enabled components of value to a register.
+     * @param value a vec4, or a float which is written to all enabled components.
+     */
+    void SetDest(const SwizzlePattern& swizzle, Id reg, Id value, bool is_scalar = false) {
+        std::array<u32, 4> components;
+        bool any_enabled = false;
+        bool all_enabled = true;
+        for (u32 i = 0; i < 4; ++i) {
+            const bool enabled = swizzle.DestComponentEnabled(static_cast<int>(i));
+            components[i] = enabled ? 4 + i : i;
+            any_enabled |= enabled;
+            all_enabled &= enabled;
+        }
+
+        if (!Sirit::ValidId(reg) || !any_enabled) {
+            return;
+        }
+
+        if (is_scalar) {
+            value = OpCompositeConstruct(vec_ids.Get(4), value, value, value, value);
+        }
+        if (!all_enabled) {
+            value = OpVectorShuffle(vec_ids.Get(4), OpLoad(vec_ids.Get(4), reg), value,
+                                    components[0], components[1], components[2], components[3]);
+        }
+        OpStore(reg, value);
+    }
+
+    /// Same as SetDest, but the register is only written when condition holds.
+    void SetDestIf(Id condition, const SwizzlePattern& swizzle, Id reg, Id value) {
+        const Id write_label{OpLabel()};
+        const Id merge_label{OpLabel()};
+        OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+        OpBranchConditional(condition, write_label, merge_label);
+        AddLabel(write_label);
+        SetDest(swizzle, reg, value, true);
+        OpBranch(merge_label);
+        AddLabel(merge_label);
+    }
+
+    /// Multiplies, treating 0 * inf as 0 like the PICA does.
+    Id SanitizeMul(Id lhs, Id rhs) {
+        const Id vec4{vec_ids.Get(4)};
+        const Id bvec4{bvec_ids.Get(4)};
+        const Id product{OpFMul(vec4, lhs, rhs)};
+        const Id zero{ConstF32(0.f, 0.f, 0.f, 0.f)};
+        const Id rhs_nan{OpSelect(vec4, OpIsNan(bvec4, rhs), product, zero)};
+        const Id lhs_nan{OpSelect(vec4, OpIsNan(bvec4, lhs), product, rhs_nan)};
+        return OpSelect(vec4, OpIsNan(bvec4, product), lhs_nan, product);
+    }
+
+    /// Returns the private counter of the loop started by the LOOP instruction at offset.
+    Id GetLoopCounter(u32 offset) {
+        auto [it, inserted] = loop_counter_ids.try_emplace(offset);
+        if (inserted) {
+            it->second = DefineVar(u32_id, spv::StorageClass::Private);
+            Name(it->second, fmt::format("loop{}", offset));
+        }
+        return it->second;
+    }
+
+    /// Adds value to the loop counter aL.
+    void AddToLoopRegister(Id value) {
+        const Id address_registers{OpLoad(ivec_ids.Get(3), address_registers_id)};
+        const Id loop_register{OpCompositeExtract(i32_id, address_registers, 2)};
+        OpStore(address_registers_id,
+                OpCompositeInsert(ivec_ids.Get(3), OpIAdd(i32_id, loop_register, value),
+                                  address_registers, 2));
+    }
+
+    void CompileArithmetic(const Instruction& instr, const SwizzlePattern& swizzle) {
+        const Id vec4{vec_ids.Get(4)};
+        const bool is_inverted =
+            (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+
+        const Id src1{GetSource(instr.common.GetSrc1(is_inverted),
+                                !is_inverted * instr.common.address_register_index,
+                                GetSelectorSrc1(swizzle), swizzle.negate_src1)};
+        // Unary instructions do not read the second operand
+        const auto src2 = [&] {
+            return GetSource(instr.common.GetSrc2(is_inverted),
+                             is_inverted * instr.common.address_register_index,
+                             GetSelectorSrc2(swizzle), swizzle.negate_src2);
+        };
+        const auto src1_x = [&] { return OpCompositeExtract(f32_id, src1, 0); };
+        const Id dest_reg{GetDestRegister(instr.common.dest.Value())};
+
+        switch (instr.opcode.Value().EffectiveOpCode()) {
+        case OpCode::Id::ADD:
+            SetDest(swizzle, dest_reg, OpFAdd(vec4, src1, src2()));
+            break;
+
+        case OpCode::Id::MUL:
+            SetDest(swizzle, dest_reg,
+                    state.sanitize_mul ? SanitizeMul(src1, src2()) : OpFMul(vec4, src1, src2()));
+            break;
+
+        case OpCode::Id::FLR:
+            SetDest(swizzle, dest_reg, OpFloor(vec4, src1));
+            break;
+
+        case OpCode::Id::MAX:
+        case OpCode::Id::MIN: {
+            const bool is_max = instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MAX;
+            const Id rhs{src2()};
+            if (state.sanitize_mul) {
+                // Pick the second operand if the comparison is false, like the PICA does for NaN
+                const Id cmp{is_max ? OpFOrdGreaterThan(bvec_ids.Get(4), src1, rhs)
+                                    : OpFOrdLessThan(bvec_ids.Get(4), src1, rhs)};
+                SetDest(swizzle, dest_reg, OpSelect(vec4, cmp, src1, rhs));
+            } else {
+                SetDest(swizzle, dest_reg,
+                        is_max ? OpFMax(vec4, src1, rhs) : OpFMin(vec4, src1, rhs));
+            }
+            break;
+        }
+
+        case OpCode::Id::DP3: {
+            const Id vec3{vec_ids.Get(3)};
+            Id dot;
+            if (state.sanitize_mul) {
+                const Id product{SanitizeMul(src1, src2())};
+                dot = OpDot(f32_id, OpVectorShuffle(vec3, product, product, 0, 1, 2),
+                            ConstF32(1.f, 1.f, 1.f));
+            } else {
+                const Id rhs{src2()};
+                dot = OpDot(f32_id, OpVectorShuffle(vec3, src1, src1, 0, 1, 2),
+                            OpVectorShuffle(vec3, rhs, rhs, 0, 1, 2));
+            }
+            SetDest(swizzle, dest_reg, dot, true);
+            break;
+        }
+
+        case OpCode::Id::DP4:
+        case OpCode::Id::DPH:
+        case OpCode::Id::DPHI: {
+            const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+            const Id lhs{opcode == OpCode::Id::DP4
+                             ? src1
+                             : OpCompositeInsert(vec4, ConstF32(1.f), src1, 3)};
+            const Id dot{state.sanitize_mul
+                             ? OpDot(f32_id, SanitizeMul(lhs, src2()), ConstF32(1.f, 1.f, 1.f, 1.f))
+                             : OpDot(f32_id, lhs, src2())};
+            SetDest(swizzle, dest_reg, dot, true);
+            break;
+        }
+
+        case OpCode::Id::RCP: {
+            const Id x{src1_x()};
+            const Id value{OpFDiv(f32_id, ConstF32(1.f), x)};
+            if (state.sanitize_mul) {
+                SetDest(swizzle, dest_reg, value, true);
+            } else {
+                // When accurate multiplication is OFF, NaN are not really handled. This is a
+                // workaround to cheaply avoid NaN. Fixes graphical issues in Ocarina of Time.
+                SetDestIf(OpFUnordNotEqual(bool_id, x, ConstF32(0.f)), swizzle, dest_reg, value);
+            }
+            break;
+        }
+
+        case OpCode::Id::RSQ: {
+            const Id x{src1_x()};
+            const Id value{OpInverseSqrt(f32_id, x)};
+            if (state.sanitize_mul) {
+                SetDest(swizzle, dest_reg, value, true);
+            } else {
+                // Same workaround as RCP
+                SetDestIf(OpFOrdGreaterThan(bool_id, x, ConstF32(0.f)), swizzle, dest_reg, value);
+            }
+            break;
+        }
+
+        case OpCode::Id::MOVA: {
+            const bool write_x = swizzle.DestComponentEnabled(0);
+            const bool write_y = swizzle.DestComponentEnabled(1);
+            if (!write_x && !write_y) {
+                break;
+            }
+            const Id value{OpConvertFToS(ivec_ids.Get(4), src1)};
+            const Id address_registers{OpLoad(ivec_ids.Get(3), address_registers_id)};
+            OpStore(address_registers_id,
+                    OpVectorShuffle(ivec_ids.Get(3), address_registers, value, write_x ? 3 : 0,
+                                    write_y ? 4 : 1, 2));
+            break;
+        }
+
+        case OpCode::Id::MOV:
+            SetDest(swizzle, dest_reg, src1);
+            break;
+
+        case OpCode::Id::SGE:
+        case OpCode::Id::SGEI:
+        case OpCode::Id::SLT:
+        case OpCode::Id::SLTI: {
+            const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+            const bool is_sge = opcode == OpCode::Id::SGE || opcode == OpCode::Id::SGEI;
+            const Id cmp{is_sge ? OpFOrdGreaterThanEqual(bvec_ids.Get(4), src1, src2())
+                                : OpFOrdLessThan(bvec_ids.Get(4), src1, src2())};
+            SetDest(
+                swizzle, dest_reg,
+                OpSelect(vec4, cmp, ConstF32(1.f, 1.f, 1.f, 1.f), ConstF32(0.f, 0.f, 0.f, 0.f)));
+            break;
+        }
+
+        case OpCode::Id::CMP: {
+            using CompareOp = Instruction::Common::CompareOpType::Op;
+            const auto compare = [this](CompareOp op, Id lhs, Id rhs) -> Id {
+                switch (op) {
+                case CompareOp::Equal:
+                    return OpFOrdEqual(bool_id, lhs, rhs);
+                case CompareOp::NotEqual:
+                    return OpFUnordNotEqual(bool_id, lhs, rhs);
+                case CompareOp::LessThan:
+                    return OpFOrdLessThan(bool_id, lhs, rhs);
+                case CompareOp::LessEqual:
+                    return OpFOrdLessThanEqual(bool_id, lhs, rhs);
+                case CompareOp::GreaterThan:
+                    return OpFOrdGreaterThan(bool_id, lhs, rhs);
+                case CompareOp::GreaterEqual:
+                    return OpFOrdGreaterThanEqual(bool_id, lhs, rhs);
+                default:
+                    return Id{};
+                }
+            };
+
+            const CompareOp op_x = instr.common.compare_op.x.Value();
+            const CompareOp op_y = instr.common.compare_op.y.Value();
+            const Id rhs{src2()};
+            const Id result_x{compare(op_x, src1_x(), OpCompositeExtract(f32_id, rhs, 0))};
+            const Id result_y{compare(op_y, OpCompositeExtract(f32_id, src1, 1),
+                                      OpCompositeExtract(f32_id, rhs, 1))};
+            if (!Sirit::ValidId(result_x)) {
+                LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", op_x);
+            } else if (!Sirit::ValidId(result_y)) {
+                LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", op_y);
+            } else {
+                OpStore(conditional_code_id,
+                        OpCompositeConstruct(bvec_ids.Get(2), result_x, result_y));
+            }
+            break;
+        }
+
+        case OpCode::Id::EX2:
+            SetDest(swizzle, dest_reg, OpExp2(f32_id, src1_x()), true);
+            break;
+
+        case OpCode::Id::LG2:
+            SetDest(swizzle, dest_reg, OpLog2(f32_id, src1_x()), true);
+            break;
+
+        default:
+            LOG_ERROR(HW_GPU, "Unhandled arithmetic instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)instr.opcode.Value().EffectiveOpCode(),
+                      instr.opcode.Value().GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+    }
+
+    void CompileMultiplyAdd(const Instruction& instr, const SwizzlePattern& swizzle) {
+        if ((instr.opcode.Value().EffectiveOpCode() != OpCode::Id::MAD) &&
+            (instr.opcode.Value().EffectiveOpCode() != OpCode::Id::MADI)) {
+            LOG_ERROR(HW_GPU, "Unhandled multiply-add instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)instr.opcode.Value().EffectiveOpCode(),
+                      instr.opcode.Value().GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+
+        const Id vec4{vec_ids.Get(4)};
+        const bool is_inverted = (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI);
+        const Id src1{GetSource(instr.mad.GetSrc1(is_inverted), 0, GetSelectorSrc1(swizzle),
+                                swizzle.negate_src1)};
+        const Id src2{GetSource(instr.mad.GetSrc2(is_inverted),
+                                !is_inverted * instr.mad.address_register_index,
+                                GetSelectorSrc2(swizzle), swizzle.negate_src2)};
+        const Id src3{GetSource(instr.mad.GetSrc3(is_inverted),
+                                is_inverted * instr.mad.address_register_index,
+                                GetSelectorSrc3(swizzle), swizzle.negate_src3)};
+
+        // Keep the multiplication and addition separate, a fused multiply-add rounds differently
+        const Id product{state.sanitize_mul ? SanitizeMul(src1, src2) : OpFMul(vec4, src1, src2)};
+        SetDest(swizzle, GetDestRegister(instr.mad.dest.Value()), OpFAdd(vec4, product, src3));
+    }
+
+    /**
+     * Compiles a single instruction from PICA to SPIR-V.
+     * @param offset the offset of the PICA shader instruction.
+     * @return the offset of the next instruction to execute, see NextOffset.
+     */
+    u32 CompileInstr(u32 offset) {
+        const Instruction instr = {program_code[offset]};
+
+        const std::size_t swizzle_offset =
+            instr.opcode.Value().GetInfo().type == OpCode::Type::MultiplyAdd
+                ? instr.mad.operand_desc_id
+                : instr.common.operand_desc_id;
+        const SwizzlePattern swizzle = {swizzle_data[swizzle_offset]};
+
+        switch (instr.opcode.Value().GetInfo().type) {
+        case OpCode::Type::Arithmetic:
+            CompileArithmetic(instr, swizzle);
+            break;
+
+        case OpCode::Type::MultiplyAdd:
+            CompileMultiplyAdd(instr, swizzle);
+            break;
+
+        default: {
+            switch (instr.opcode.Value()) {
+            case OpCode::Id::END:
+                OpReturnValue(true_id);
+                break;
+
+            case OpCode::Id::JMPC:
+            case OpCode::Id::JMPU: {
+                Id condition;
+                if (instr.opcode.Value() == OpCode::Id::JMPC) {
+                    condition = EvaluateCondition(instr.flow_control);
+                } else {
+                    const bool invert_test = instr.flow_control.num_instructions & 1;
+                    condition = GetUniformBool(instr.flow_control.bool_uniform_id, invert_test);
+                }
+
+                ASSERT(Sirit::ValidId(jmp_to_id));
+                const Id jump_label{OpLabel()};
+                const Id merge_label{OpLabel()};
+                OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+                OpBranchConditional(condition, jump_label, merge_label);
+                AddLabel(jump_label);
+                OpStore(jmp_to_id, ConstU32(instr.flow_control.dest_offset.Value()));
+                OpBranch(dispatch_merge);
+                AddLabel(merge_label);
+                break;
+            }
+
+            case OpCode::Id::CALL:
+            case OpCode::Id::CALLC:
+            case OpCode::Id::CALLU: {
+                const Subroutine& call_sub = GetSubroutine(
+                    instr.flow_control.dest_offset,
+                    instr.flow_control.dest_offset + instr.flow_control.num_instructions);
+                if (instr.opcode.Value() == OpCode::Id::CALLC) {
+                    CallSubroutineIf(EvaluateCondition(instr.flow_control), call_sub);
+                } else if (instr.opcode.Value() == OpCode::Id::CALLU) {
+                    CallSubroutineIf(GetUniformBool(instr.flow_control.bool_uniform_id),
+                                     call_sub);
+                } else {
+                    CallSubroutine(call_sub);
+                }
+                break;
+            }
+
+            case OpCode::Id::NOP:
+                break;
+
+            case OpCode::Id::IFC:
+            case OpCode::Id::IFU: {
+                const Id condition{instr.opcode.Value() == OpCode::Id::IFC
+                                       ? EvaluateCondition(instr.flow_control)
+                                       : GetUniformBool(instr.flow_control.bool_uniform_id)};
+
+                const u32 else_offset = instr.flow_control.dest_offset;
+                const u32 endif_offset = else_offset + instr.flow_control.num_instructions;
+                const bool has_else = instr.flow_control.num_instructions != 0;
+
+                const Id if_label{OpLabel()};
+                const Id else_label{has_else ? OpLabel() : Id{}};
+                const Id merge_label{OpLabel()};
+                OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+                OpBranchConditional(condition, if_label, has_else ? else_label : merge_label);
+
+                AddLabel(if_label);
+                bool reaches_merge = CallSubroutine(GetSubroutine(offset + 1, else_offset));
+                if (reaches_merge) {
+                    OpBranch(merge_label);
+                }
+
+                if (has_else) {
+                    AddLabel(else_label);
+                    const bool else_reaches_merge =
+                        CallSubroutine(GetSubroutine(else_offset, endif_offset));
+                    if (else_reaches_merge) {
+                        OpBranch(merge_label);
+                    }
+                    reaches_merge |= else_reaches_merge;
+                } else {
+                    reaches_merge = true;
+                }
+
+                AddLabel(merge_label);
+                if (!reaches_merge) {
+                    OpUnreachable();
+                }
+                break;
+            }
+
+            case OpCode::Id::LOOP: {
+                const Id int_uniform{GetPicaUniform(
+                    uvec_ids.Get(4), ConstS32(1),
+                    ConstS32(static_cast<s32>(instr.flow_control.int_uniform_id.Value())))};
+                const auto int_uniform_component = [&](u32 component) {
+                    return OpCompositeExtract(u32_id, int_uniform, component);
+                };
+
+                // aL = i.y
+                const Id address_registers{OpLoad(ivec_ids.Get(3), address_registers_id)};
+                OpStore(address_registers_id,
+                        OpCompositeInsert(ivec_ids.Get(3),
+                                          OpBitcast(i32_id, int_uniform_component(1)),
+                                          address_registers, 2));
+                const Id loop_counter{GetLoopCounter(offset)};
+                OpStore(loop_counter, ConstU32(0U));
+
+                // The body always runs at least once, so the loop condition is checked at the end
+                const Id header_label{OpLabel()};
+                const Id body_label{OpLabel()};
+                const Id continue_label{OpLabel()};
+                const Id merge_label{OpLabel()};
+                OpBranch(header_label);
+                AddLabel(header_label);
+                OpLoopMerge(merge_label, continue_label, spv::LoopControlMask::MaskNone);
+                OpBranch(body_label);
+
+                AddLabel(body_label);
+                const Subroutine& loop_sub =
+                    GetSubroutine(offset + 1, instr.flow_control.dest_offset + 1);
+                if (CallSubroutine(loop_sub)) {
+                    OpBranch(continue_label);
+                }
+
+                // aL += i.z, then loop while the counter is not above i.x
+                AddLabel(continue_label);
+                AddToLoopRegister(OpBitcast(i32_id, int_uniform_component(2)));
+                const Id next_count{
+                    OpIAdd(u32_id, OpLoad(u32_id, loop_counter), ConstU32(1U))};
+                OpStore(loop_counter, next_count);
+                OpBranchConditional(
+                    OpULessThanEqual(bool_id, next_count, int_uniform_component(0)),
+                    header_label, merge_label);
+
+                AddLabel(merge_label);
+                if (loop_sub.exit_method == ExitMethod::AlwaysEnd) {
+                    OpUnreachable();
+                }
+                break;
+            }
+
+            case OpCode::Id::EMIT:
+            case OpCode::Id::SETEMIT:
+                LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                break;
+
+            default:
+                LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
+                          (int)instr.opcode.Value().EffectiveOpCode(),
+                          instr.opcode.Value().GetInfo().name, instr.hex);
+                throw DecompileFail("Unhandled instruction");
+            }
+            break;
+        }
+        }
+
+        return NextOffset(offset);
+    }
+
+    /// Returns a component of the vertex with the given semantic, 1.0 if it is not output.
+    Id GetSemantic(const std::array<Id, NUM_REGS>& outputs, VSOutputAttributes::Semantic semantic) {
+        const auto& semantic_map = state.gs_state.semantic_maps[static_cast<u32>(semantic)];
+        if (semantic_map.attribute_index < state.gs_state.gs_output_attributes &&
+            semantic_map.attribute_index < state.num_outputs) {
+            return OpCompositeExtract(f32_id, outputs[semantic_map.attribute_index],
+                                      semantic_map.component_index);
+        }
+        return ConstF32(1.f);
+    }
+
+    /// Writes the vertex outputs to the fragment shader interface.
+    void WriteEmitVertex() {
+        std::array<Id, NUM_REGS> outputs{};
+        for (u32 i = 0; i < state.num_outputs; ++i) {
+            outputs[i] = OpLoad(vec_ids.Get(4), output_attr_ids[i]);
+        }
+        const auto semantic = [&](VSOutputAttributes::Semantic slot) {
+            return GetSemantic(outputs, slot);
+        };
+
+        // Undo tiny depth values that the host would clip away but the PICA does not
+        const Id x{semantic(VSOutputAttributes::POSITION_X)};
+        Id y{semantic(VSOutputAttributes::POSITION_Y)};
+        Id z{semantic(VSOutputAttributes::POSITION_Z)};
+        const Id w{semantic(VSOutputAttributes::POSITION_W)};
+        const Id ndc_z{OpFDiv(f32_id, z, w)};
+        const Id near_zero{OpLogicalAnd(bool_id, OpFOrdGreaterThan(bool_id, ndc_z, ConstF32(0.f)),
+                                        OpFOrdLessThan(bool_id, ndc_z, ConstF32(0.000001f)))};
+        const Id near_minus_one{
+            OpLogicalAnd(bool_id, OpFOrdLessThan(bool_id, ndc_z, ConstF32(-1.f)),
+                         OpFOrdGreaterThan(bool_id, ndc_z, ConstF32(-1.00001f)))};
+        z = OpSelect(f32_id, near_zero, ConstF32(0.f), z);
+        z = OpSelect(f32_id, near_minus_one, OpFNegate(f32_id, w), z);
+
+        const Id flip_viewport{OpINotEqual(bool_id, GetVSData(u32_id, ConstS32(1)), ConstU32(0U))};
+        y = OpSelect(f32_id, flip_viewport, OpFNegate(f32_id, y), y);
+
+        const Id vec4{vec_ids.Get(4)};
+        OpStore(gl_position_id, OpCompositeConstruct(vec4, x, y, OpFNegate(f32_id, z), w));
+
+        if (state.use_clip_planes) {
+            const Id clip_ptr{TypePointer(spv::StorageClass::Output, f32_id)};
+            // Fixed PICA clipping plane z <= 0
+            OpStore(OpAccessChain(clip_ptr, gl_clip_distance_id, ConstS32(0)),
+                    OpFNegate(f32_id, z));
+            const Id enable_clip1{
+                OpINotEqual(bool_id, GetVSData(u32_id, ConstS32(0)), ConstU32(0U))};
+            const Id vtx_pos{OpCompositeConstruct(vec4, x, y, z, w)};
+            const Id clip1{OpDot(f32_id, GetVSData(vec4, ConstS32(2)), vtx_pos)};
+            OpStore(OpAccessChain(clip_ptr, gl_clip_distance_id, ConstS32(1)),
+                    OpSelect(f32_id, enable_clip1, clip1, ConstF32(0.f)));
+        }
+
+        OpStore(normquat_id, OpCompositeConstruct(vec4, semantic(VSOutputAttributes::QUATERNION_X),
+                                                  semantic(VSOutputAttributes::QUATERNION_Y),
+                                                  semantic(VSOutputAttributes::QUATERNION_Z),
+                                                  semantic(VSOutputAttributes::QUATERNION_W)));
+
+        const Id vtx_color{OpCompositeConstruct(vec4, semantic(VSOutputAttributes::COLOR_R),
+                                                semantic(VSOutputAttributes::COLOR_G),
+                                                semantic(VSOutputAttributes::COLOR_B),
+                                                semantic(VSOutputAttributes::COLOR_A))};
+        OpStore(primary_color_id,
+                OpFMin(vec4, OpFAbs(vec4, vtx_color), ConstF32(1.f, 1.f, 1.f, 1.f)));
+
+        const Id vec2{vec_ids.Get(2)};
+        OpStore(texcoord_ids[0],
+                OpCompositeConstruct(vec2, semantic(VSOutputAttributes::TEXCOORD0_U),
+                                     semantic(VSOutputAttributes::TEXCOORD0_V)));
+        OpStore(texcoord_ids[1],
+                OpCompositeConstruct(vec2, semantic(VSOutputAttributes::TEXCOORD1_U),
+                                     semantic(VSOutputAttributes::TEXCOORD1_V)));
+        OpStore(texcoord0_w_id, semantic(VSOutputAttributes::TEXCOORD0_W));
+        OpStore(view_id, OpCompositeConstruct(vec_ids.Get(3), semantic(VSOutputAttributes::VIEW_X),
+                                              semantic(VSOutputAttributes::VIEW_Y),
+                                              semantic(VSOutputAttributes::VIEW_Z)));
+        OpStore(texcoord_ids[2],
+                OpCompositeConstruct(vec2, semantic(VSOutputAttributes::TEXCOORD2_U),
+                                     semantic(VSOutputAttributes::TEXCOORD2_V)));
+    }
+
+    void DefineEntryPoint(Id exec_shader) {
+        AddCapability(spv::Capability::Shader);
+        if (state.use_clip_planes && !state.use_geometry_shader) {
+            AddCapability(spv::Capability::ClipDistance);
+        }
+        SetMemoryModel(spv::AddressingModel::Logical, spv::MemoryModel::GLSL450);
+
+        const Id main_func{
+            OpFunction(void_id, spv::FunctionControlMask::MaskNone, TypeFunction(void_id))};
+        AddLabel(OpLabel());
+
+        // Load the input registers read by the program
+        for (u32 i = 0; i < NUM_REGS; ++i) {
+            if (!Sirit::ValidId(input_reg_ids[i])) {
+                continue;
+            }
+            const AttribLoadFlags flags = state.load_flags[i];
+            Id value;
+            if (True(flags & AttribLoadFlags::Float)) {
+                value = OpLoad(vec_ids.Get(4), DefineInputRegister(vec_ids.Get(4), i));
+            } else if (True(flags & AttribLoadFlags::Sint)) {
+                const Id input_id{DefineInputRegister(ivec_ids.Get(4), i)};
+                value = OpConvertSToF(vec_ids.Get(4), OpLoad(ivec_ids.Get(4), input_id));
+            } else if (True(flags & AttribLoadFlags::Uint)) {
+                const Id input_id{DefineInputRegister(uvec_ids.Get(4), i)};
+                value = OpConvertUToF(vec_ids.Get(4), OpLoad(uvec_ids.Get(4), input_id));
+            } else {
+                value = OpLoad(vec_ids.Get(4), DefineInputRegister(vec_ids.Get(4), i));
+            }
+            if (True(flags & AttribLoadFlags::ZeroW)) {
+                value = OpCompositeInsert(vec_ids.Get(4), ConstF32(0.f), value, 3);
+            }
+            OpStore(input_reg_ids[i], value);
+        }
+
+        const Id default_reg{ConstF32(0.f, 0.f, 0.f, 1.f)};
+        for (u32 i = 0; i < state.num_outputs; ++i) {
+            OpStore(output_attr_ids[i], default_reg);
+        }
+        for (u32 i = 0; i < NUM_REGS; ++i) {
+            OpStore(tmp_reg_ids[i], default_reg);
+        }
+        OpStore(conditional_code_id, ConstantComposite(bvec_ids.Get(2), false_id, false_id));
+        OpStore(address_registers_id, ConstantComposite(ivec_ids.Get(3), ConstS32(0),
+                                                        ConstS32(0), ConstS32(0)));
+
+        OpFunctionCall(bool_id, exec_shader);
+        if (!state.use_geometry_shader) {
+            WriteEmitVertex();
+        }
+        OpReturn();
+        OpFunctionEnd();
+
+        AddEntryPoint(spv::ExecutionModel::Vertex, main_func, "main", interface_ids);
+    }
+
+    void DefineArithmeticTypes() {
+        void_id = Name(TypeVoid(), "void_id");
+        bool_id = Name(TypeBool(), "bool_id");
+        f32_id = Name(TypeFloat(32), "f32_id");
+        i32_id = Name(TypeSInt(32), "i32_id");
+        u32_id = Name(TypeUInt(32), "u32_id");
+
+        for (u32 size = 2; size <= 4; size++) {
+            const u32 i = size - 2;
+            vec_ids.ids[i] = Name(TypeVector(f32_id, size), fmt::format("vec{}_id", size));
+            ivec_ids.ids[i] = Name(TypeVector(i32_id, size), fmt::format("ivec{}_id", size));
+            uvec_ids.ids[i] = Name(TypeVector(u32_id, size), fmt::format("uvec{}_id", size));
+            bvec_ids.ids[i] = Name(TypeVector(bool_id, size), fmt::format("bvec{}_id", size));
+        }
+
+        true_id = ConstantTrue(bool_id);
+        false_id = ConstantFalse(bool_id);
+    }
+
+    void DefineUniformStructs() {
+        // vs_pica_data, see VSPicaUniformData
+        const Id int_array_id{TypeArray(uvec_ids.Get(4), ConstU32(4U))};
+        const Id float_array_id{TypeArray(vec_ids.Get(4), ConstU32(96U))};
+        Decorate(int_array_id, spv::Decoration::ArrayStride, 16U);
+        Decorate(float_array_id, spv::Decoration::ArrayStride, 16U);
+
+        const Id pica_data_struct_id{TypeStruct(u32_id, int_array_id, float_array_id)};
+        MemberDecorate(pica_data_struct_id, 0, spv::Decoration::Offset, 0U);
+        MemberDecorate(pica_data_struct_id, 1, spv::Decoration::Offset, 16U);
+        MemberDecorate(pica_data_struct_id, 2, spv::Decoration::Offset, 80U);
+        Decorate(pica_data_struct_id, spv::Decoration::Block);
+
+        vs_pica_data_id = DefineUniform(pica_data_struct_id, 0);
+        Name(vs_pica_data_id, "vs_pica_data");
+
+        // vs_data, see VSUniformData
+        const Id vs_data_struct_id{TypeStruct(u32_id, u32_id, vec_ids.Get(4))};
+        MemberDecorate(vs_data_struct_id, 0, spv::Decoration::Offset, 0U);
+        MemberDecorate(vs_data_struct_id, 1, spv::Decoration::Offset, 4U);
+        MemberDecorate(vs_data_struct_id, 2, spv::Decoration::Offset, 16U);
+        Decorate(vs_data_struct_id, spv::Decoration::Block);
+
+        vs_data_id = DefineUniform(vs_data_struct_id, 1);
+        Name(vs_data_id, "vs_data");
+    }
+
+    void DefineInterface() {
+        for (u32 i = 0; i < NUM_REGS; ++i) {
+            tmp_reg_ids[i] = DefineVar(vec_ids.Get(4), spv::StorageClass::Private);
+            Name(tmp_reg_ids[i], fmt::format("reg_tmp{}", i));
+        }
+        conditional_code_id = DefineVar(bvec_ids.Get(2), spv::StorageClass::Private);
+        Name(conditional_code_id, "conditional_code");
+        address_registers_id = DefineVar(ivec_ids.Get(3), spv::StorageClass::Private);
+        Name(address_registers_id, "address_registers");
+
+        for (u32 i = 0; i < state.num_outputs; ++i) {
+            if (state.use_geometry_shader) {
+                // The geometry shader reads the output registers directly
+                output_attr_ids[i] = DefineOutput(vec_ids.Get(4), i);
+            } else {
+                output_attr_ids[i] = DefineVar(vec_ids.Get(4), spv::StorageClass::Private);
+            }
+            Name(output_attr_ids[i], fmt::format("vs_out_attr{}", i));
+        }
+        if (state.use_geometry_shader) {
+            return;
+        }
+
+        primary_color_id = DefineOutput(vec_ids.Get(4), ATTRIBUTE_COLOR);
+        texcoord_ids[0] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD0);
+        texcoord_ids[1] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD1);
+        texcoord_ids[2] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD2);
+        texcoord0_w_id = DefineOutput(f32_id, ATTRIBUTE_TEXCOORD0_W);
+        normquat_id = DefineOutput(vec_ids.Get(4), ATTRIBUTE_NORMQUAT);
+        view_id = DefineOutput(vec_ids.Get(3), ATTRIBUTE_VIEW);
+
+        gl_position_id = DefineVar(vec_ids.Get(4), spv::StorageClass::Output);
+        Decorate(gl_position_id, spv::Decoration::BuiltIn, spv::BuiltIn::Position);
+#ifdef __APPLE__
+        // Apple Silicon GPU drivers optimize more aggressively, which can create
+        // too much variance and cause visual artifacting in games like Pokemon.
+        Decorate(gl_position_id, spv::Decoration::Invariant);
+#endif
+        interface_ids.push_back(gl_position_id);
+
+        if (state.use_clip_planes) {
+            gl_clip_distance_id =
+                DefineVar(TypeArray(f32_id, ConstU32(2U)), spv::StorageClass::Output);
+            Decorate(gl_clip_distance_id, spv::Decoration::BuiltIn, spv::BuiltIn::ClipDistance);
+            interface_ids.push_back(gl_clip_distance_id);
+        }
+    }
+
+    /// Loads the member specified from the vs_pica_data uniform struct
+    template <typename... Ids>
+    [[nodiscard]] Id GetPicaUniform(Id type, Ids... ids) {
+        const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, type)};
+        return OpLoad(type, OpAccessChain(uniform_ptr, vs_pica_data_id, ids...));
+    }
+
+    /// Loads the member specified from the vs_data uniform struct
+    template <typename... Ids>
+    [[nodiscard]] Id GetVSData(Id type, Ids... ids) {
+        const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, type)};
+        return OpLoad(type, OpAccessChain(uniform_ptr, vs_data_id, ids...));
+    }
+
+    /// Defines the typed vertex input of an input register
+    [[nodiscard]] Id DefineInputRegister(Id type, u32 index) {
+        const Id input_id{DefineVar(type, spv::StorageClass::Input)};
+        Decorate(input_id, spv::Decoration::Location, index);
+        Name(input_id, fmt::format("vs_in_typed_reg{}", index));
+        interface_ids.push_back(input_id);
+        return input_id;
+    }
+
+    /// Defines an output variable
+    [[nodiscard]] Id DefineOutput(Id type, u32 location) {
+        const Id output_id{DefineVar(type, spv::StorageClass::Output)};
+        Decorate(output_id, spv::Decoration::Location, location);
+        interface_ids.push_back(output_id);
+        return output_id;
+    }
+
+    /// Defines a uniform buffer in the first descriptor set
+    [[nodiscard]] Id DefineUniform(Id type, u32 binding) {
+        const Id uniform_id{DefineVar(type, spv::StorageClass::Uniform)};
+        Decorate(uniform_id, spv::Decoration::DescriptorSet, 0U);
+        Decorate(uniform_id, spv::Decoration::Binding, binding);
+        return uniform_id;
+    }
+
+    template <bool global = true>
+    [[nodiscard]] Id DefineVar(Id type, spv::StorageClass storage_class) {
+        const Id pointer_type_id{TypePointer(storage_class, type)};
+        return global ? AddGlobalVariable(pointer_type_id, storage_class)
+                      : AddLocalVariable(pointer_type_id, storage_class);
+    }
+
+    /// Returns the id of an unsigned integer constant of value
+    [[nodiscard]] Id ConstU32(u32 value) {
+        return Constant(u32_id, value);
+    }
+
+    /// Returns the id of a signed integer constant of value
+    [[nodiscard]] Id ConstS32(s32 value) {
+        return Constant(i32_id, value);
+    }
+
+    /// Returns the id of a float constant of value
+    [[nodiscard]] Id ConstF32(f32 value) {
+        return Constant(f32_id, value);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] Id ConstF32(Args... values) {
+        constexpr u32 size = static_cast<u32>(sizeof...(values));
+        static_assert(size >= 2 && size <= 4);
+        const std::array constituents{Constant(f32_id, values)...};
+        return ConstantComposite(vec_ids.Get(size), constituents);
+    }
+
+private:
+    const std::set<Subroutine>& subroutines;
+    const ProgramCode& program_code;
+    const SwizzleData& swizzle_data;
+    const PicaVSConfigState& state;
+
+    Id void_id{};
+    Id bool_id{};
+    Id f32_id{};
+    Id i32_id{};
+    Id u32_id{};
+    Id true_id{};
+    Id false_id{};
+
+    VectorIds vec_ids{};
+    VectorIds ivec_ids{};
+    VectorIds uvec_ids{};
+    VectorIds bvec_ids{};
+
+    Id vs_pica_data_id{};
+    Id vs_data_id{};
+
+    std::array<Id, NUM_REGS> input_reg_ids{};
+    std::array<Id, NUM_REGS> tmp_reg_ids{};
+    std::array<Id, NUM_REGS> output_attr_ids{};
+    Id conditional_code_id{};
+    Id address_registers_id{};
+    std::map<u32, Id> loop_counter_ids;
+
+    Id gl_position_id{};
+    Id gl_clip_distance_id{};
+    Id primary_color_id{};
+    std::array<Id, 3> texcoord_ids{};
+    Id texcoord0_w_id{};
+    Id normquat_id{};
+    Id view_id{};
+    std::vector<Id> interface_ids;
+
+    std::map<const Subroutine*, Id> subroutine_funcs;
+    Id jmp_to_id{};      ///< Block to run next in the subroutine being defined
+    Id dispatch_merge{}; ///< Target of jumps in the subroutine being defined
+};
+
+} // Anonymous namespace
+
+std::vector<u32> GenerateVertexShader(const ShaderSetup& setup, const PicaVSConfig& config) {
+    try {
+        const auto subroutines = AnalyzeControlFlow(setup.program_code, config.state.main_offset);
+        VertexModule module{subroutines, setup, config};
+        module.Generate();
+        return module.Assemble();
+    } catch (const DecompileFail& exception) {
+        LOG_INFO(HW_GPU, "Shader decompilation failed: {}", exception.what());
+        return {};
+    }
+}
+
+} // namespace Pica::Shader::Generator::SPIRV
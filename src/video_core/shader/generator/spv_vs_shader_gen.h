@@ -0,0 +1,27 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+#include "common/common_types.h"
+
+namespace Pica {
+struct ShaderSetup;
+}
+
+namespace Pica::Shader::Generator {
+struct PicaVSConfig;
+}
+
+namespace Pica::Shader::Generator::SPIRV {
+
+/**
+ * Generates the SPIR-V vertex shader module for the given VS program. The module has the same
+ * interface as the one GLSL::GenerateVertexShader produces for a separable shader.
+ * @returns SPIR-V code of the module; empty on failure
+ */
+std::vector<u32> GenerateVertexShader(const Pica::ShaderSetup& setup, const PicaVSConfig& config);
+
+} // namespace Pica::Shader::Generator::SPIRV